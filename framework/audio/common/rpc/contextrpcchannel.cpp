@@ -54,6 +54,11 @@ void ContextRpcChannel::onMethod(Method method, Handler h)
     }
 }
 
+TransportMode ContextRpcChannel::transportMode() const
+{
+    return globalChannel()->transportMode();
+}
+
 void ContextRpcChannel::addStream(std::shared_ptr<IRpcStream> s)
 {
     s->setCtxId(contextId());
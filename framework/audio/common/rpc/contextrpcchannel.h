@@ -38,6 +38,7 @@ public:
     void onMethod(Method method, Handler h) override;
 
     // IStreamRpcChannel
+    TransportMode transportMode() const override;
     void addStream(std::shared_ptr<IRpcStream> s) override;
     void removeStream(StreamId id) override;
     void sendStream(const StreamMsg& msg) override;
@@ -22,6 +22,8 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <tuple>
 
 #include "global/modularity/imoduleinterface.h"
 
@@ -226,12 +228,36 @@ inline std::string to_string(MsgType t)
     return std::to_string(static_cast<int>(t));
 }
 
+//! NOTE Packed - the values are packed by RpcPacker (between processes),
+//! InProcess - the values are passed as a shared snapshot, without packing (between threads of one process)
+enum class TransportMode {
+    Packed = 0,
+    InProcess
+};
+
+//! NOTE Not packed values of a message (in-process transport),
+//! the values are immutable and shared by the sender and the receiver
+struct IRpcValues {
+    virtual ~IRpcValues() = default;
+};
+
+using RpcValuesPtr = std::shared_ptr<const IRpcValues>;
+
+template<typename ... Types>
+struct RpcValues : public IRpcValues {
+    const std::tuple<Types...> values;
+
+    RpcValues(const Types&... args)
+        : values(args ...) {}
+};
+
 struct Msg {
     CallId callId = 0;
     CtxId ctxId = 0;   // 0 - global, >0 - contextual
     Method method = Method::Undefined;
     MsgType type = MsgType::Undefined;
     ByteArray data;
+    RpcValuesPtr values;
 };
 
 using Handler = std::function<void (const Msg& msg)>;
@@ -295,8 +321,39 @@ struct StreamMsg {
     StreamName name = StreamName::Undefined;
     StreamId streamId = 0;
     ByteArray data;
+    RpcValuesPtr values;
 };
 
+//! NOTE Sets the data of the message (Msg or StreamMsg): packs the values,
+//! or with the in-process transport keeps them as is
+template<typename MsgT, typename ... Types>
+inline void pack_msg(TransportMode mode, MsgT& msg, const Types&... args)
+{
+    if (mode == TransportMode::InProcess) {
+        msg.values = std::make_shared<const RpcValues<Types...> >(args ...);
+        msg.data = ByteArray();
+    } else {
+        msg.data = RpcPacker::pack(args ...);
+        msg.values = nullptr;
+    }
+}
+
+template<typename MsgT, typename ... Types>
+inline bool unpack_msg(const MsgT& msg, Types&... args)
+{
+    if (!msg.values) {
+        return RpcPacker::unpack(msg.data, args ...);
+    }
+
+    const RpcValues<Types...>* values = dynamic_cast<const RpcValues<Types...>*>(msg.values.get());
+    if (!values) {
+        return false;
+    }
+
+    std::tie(args ...) = values->values;
+    return true;
+}
+
 using StreamHandler = std::function<void (const StreamMsg& msg)>;
 
 enum class StreamType {
@@ -359,6 +416,8 @@ class IStreamRpcChannel
 public:
     virtual ~IStreamRpcChannel() = default;
 
+    virtual TransportMode transportMode() const = 0;
+
     virtual void addStream(std::shared_ptr<IRpcStream> s) = 0;
     virtual void removeStream(StreamId id) = 0;
     virtual void sendStream(const StreamMsg& msg) = 0;
@@ -408,16 +467,17 @@ void RpcStream<Types...>::init()
     switch (m_type) {
     case StreamType::Send: {
         m_ch.onReceive(this, [this](const Types... args) {
-                ByteArray data = RpcPacker::pack(args ...);
-                m_rpc->sendStream(StreamMsg { m_ctxId, m_name, m_streamId, data });
+                StreamMsg msg { m_ctxId, m_name, m_streamId, ByteArray(), nullptr };
+                pack_msg(m_rpc->transportMode(), msg, args ...);
+                m_rpc->sendStream(msg);
             });
     } break;
     case StreamType::Receive: {
         m_rpc->onStream(m_streamId, [this](const StreamMsg& msg) {
                 std::function<void()> func = [this, msg]() {
                     std::tuple<Types...> values;
-                    bool success = std::apply([msg](auto&... args) {
-                        return RpcPacker::unpack(msg.data, args ...);
+                    bool success = std::apply([&msg](auto&... args) {
+                        return unpack_msg(msg, args ...);
                     }, values);
 
                     if (success) {
@@ -37,6 +37,17 @@ using namespace muse::audio::rpc;
 
 static thread_local bool s_isMainThread = false;
 
+//! NOTE A request and its response have the same callId, so the type is a part of the flow id
+static uint64_t traceFlowId(const Msg& m)
+{
+    return (static_cast<uint64_t>(m.callId) << 3) | static_cast<uint64_t>(m.type);
+}
+
+GeneralRpcChannel::GeneralRpcChannel(TransportMode mode)
+    : m_transportMode(mode)
+{
+}
+
 GeneralRpcChannel::~GeneralRpcChannel()
 {
     m_engineRpcData.streams.clear();
@@ -71,6 +82,9 @@ void GeneralRpcChannel::process()
 
 void GeneralRpcChannel::send(const Msg& msg, const Handler& onResponse)
 {
+    TRACE_ZONE("RpcChannel::send");
+    TRACE_FLOW_BEGIN("rpc", traceFlowId(msg));
+
     if (msg.type == MsgType::Stream) {
         RPCLOG() << "ctxId: " << msg.ctxId
                  << ", stream: " << to_string(static_cast<StreamName>(msg.method))
@@ -101,6 +115,9 @@ void GeneralRpcChannel::send(const Msg& msg, const Handler& onResponse)
 
 void GeneralRpcChannel::receive(RpcData& to, const Msg& m) const
 {
+    TRACE_ZONE("RpcChannel::receive");
+    TRACE_FLOW_END("rpc", traceFlowId(m));
+
     if (m.type == MsgType::Stream) {
         RPCLOG() << "ctxId: " << m.ctxId
                  << ", stream: " << to_string(static_cast<StreamName>(m.method))
@@ -126,6 +143,7 @@ void GeneralRpcChannel::receive(RpcData& to, const Msg& m) const
         msg.streamId = m.callId;
         msg.name = static_cast<StreamName>(m.method);
         msg.data = m.data;
+        msg.values = m.values;
         receive(to, msg);
         return;
     }
@@ -174,6 +192,7 @@ void GeneralRpcChannel::sendStream(const StreamMsg& msg)
     m.callId = msg.streamId;
     m.method = static_cast<Method>(msg.name);
     m.data = msg.data;
+    m.values = msg.values;
     send(m);
 }
 
@@ -185,6 +204,11 @@ void GeneralRpcChannel::receive(RpcData& to, const StreamMsg& m) const
     }
 }
 
+TransportMode GeneralRpcChannel::transportMode() const
+{
+    return m_transportMode;
+}
+
 void GeneralRpcChannel::addStream(std::shared_ptr<IRpcStream> s)
 {
     s->init();
@@ -28,7 +28,7 @@ namespace muse::audio::rpc {
 class GeneralRpcChannel : public IRpcChannel
 {
 public:
-    GeneralRpcChannel() = default;
+    GeneralRpcChannel(TransportMode mode = TransportMode::InProcess);
     ~GeneralRpcChannel() override;
 
     void setupOnMain() override;
@@ -43,6 +43,7 @@ public:
     void listenAll(Handler h) override;
 
     // stream
+    TransportMode transportMode() const override;
     void addStream(std::shared_ptr<IRpcStream> s) override;
     void removeStream(StreamId id) override;
     void sendStream(const StreamMsg& msg) override;
@@ -64,6 +65,8 @@ private:
     void receive(RpcData& to, const Msg& m) const;
     void receive(RpcData& to, const StreamMsg& m) const;
 
+    TransportMode m_transportMode = TransportMode::InProcess;
+
     RpcData m_engineRpcData;
     RpcData m_mainRpcData;
 
@@ -210,6 +210,12 @@ void WebRpcChannel::listenAll(Handler h)
     m_data.listenerAll = h;
 }
 
+TransportMode WebRpcChannel::transportMode() const
+{
+    //! NOTE The engine is in the worker, the data can be passed only packed
+    return TransportMode::Packed;
+}
+
 void WebRpcChannel::addStream(std::shared_ptr<IRpcStream> s)
 {
     s->init();
@@ -576,29 +576,32 @@ inline void unpack_custom(muse::msgpack::UnPacker& p, muse::mpe::PlaybackEvent&
         // no data
         break;
     case 1: {
-        muse::mpe::NoteEvent event;
-        p.process(event);
-        value = event;
+        //! NOTE Not via the default NoteEvent, its contexts allocate the maps which would be thrown away
+        muse::mpe::ArrangementContext arrCtx;
+        muse::mpe::PitchContext pitchCtx;
+        muse::mpe::ExpressionContext exprCtx;
+        p.process(arrCtx, pitchCtx, exprCtx);
+        value.emplace<muse::mpe::NoteEvent>(std::move(arrCtx), std::move(pitchCtx), std::move(exprCtx));
     } break;
     case 2: {
         muse::mpe::TextArticulationEvent event;
         p.process(event);
-        value = event;
+        value = std::move(event);
     } break;
     case 3: {
         muse::mpe::SoundPresetChangeEvent event;
         p.process(event);
-        value = event;
+        value = std::move(event);
     } break;
     case 4: {
         muse::mpe::SyllableEvent event;
         p.process(event);
-        value = event;
+        value = std::move(event);
     } break;
     case 5: {
         muse::mpe::ControllerChangeEvent event;
         p.process(event);
-        value = event;
+        value = std::move(event);
     } break;
     default: {
         assert(false && "unknown PlaybackEvent variant index");
@@ -238,6 +238,8 @@ samples_t AudioEngine::fillSilent(float* buffer, samples_t samplesPerChannel)
 
 samples_t AudioEngine::process(float* buffer, samples_t samplesPerChannel)
 {
+    TRACE_ZONE("AudioEngine::process");
+
     m_processing = true;
     DEFER {
         m_processing = false;
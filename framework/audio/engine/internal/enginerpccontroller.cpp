@@ -142,7 +142,7 @@ void EngineRpcController::init()
         AudioParams params;
         rpc::StreamId mainStreamId = 0;
         rpc::StreamId offStreamId = 0;
-        IF_ASSERT_FAILED(RpcPacker::unpack(msg.data, trackName, playbackData, params, mainStreamId, offStreamId)) {
+        IF_ASSERT_FAILED(rpc::unpack_msg(msg, trackName, playbackData, params, mainStreamId, offStreamId)) {
             return;
         }
 
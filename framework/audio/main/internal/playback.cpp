@@ -234,9 +234,14 @@ async::Promise<TrackId, AudioParams> Playback::addTrack(const TrackName& trackNa
         rpc::StreamId mainStreamId = channel()->addSendStream(StreamName::PlaybackDataMainStream, playbackData.mainStream);
         rpc::StreamId offStreamId = channel()->addSendStream(StreamName::PlaybackDataOffStream, playbackData.offStream);
 
-        ByteArray data = RpcPacker::pack(trackName, playbackData, params, mainStreamId, offStreamId);
-
-        Msg msg = rpc::make_request(Method::AddTrackWithPlaybackData, data);
+        //! NOTE The streams are passed by the ids, the engine has own channels for them
+        mpe::PlaybackData data;
+        data.originEvents = playbackData.originEvents;
+        data.setupData = playbackData.setupData;
+        data.dynamics = playbackData.dynamics;
+
+        Msg msg = rpc::make_request(Method::AddTrackWithPlaybackData);
+        rpc::pack_msg(channel()->transportMode(), msg, trackName, data, params, mainStreamId, offStreamId);
         channel()->send(msg, [resolve, reject](const Msg& res) {
             ONLY_AUDIO_MAIN_THREAD;
             RetVal2<TrackId, AudioParams> ret;
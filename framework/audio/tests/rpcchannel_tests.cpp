@@ -0,0 +1,206 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+//! NOTE The same as in rpcpacker_tests, the types must have the same layout in all the tests
+#pragma pack(push, 1)
+#include "audio/common/audiotypes.h"
+#pragma pack(pop)
+
+#include "audio/common/rpc/irpcchannel.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::rpc;
+
+class Audio_RpcChannelTests : public ::testing::Test
+{
+public:
+
+    //! NOTE Track events: chords of notes with an articulation
+    static mpe::PlaybackData makePlaybackData(size_t events)
+    {
+        mpe::PlaybackData data;
+        data.setupData.id = u"instrument";
+        data.setupData.category = mpe::SoundCategory::Keyboards;
+
+        mpe::ArticulationMeta meta;
+        meta.type = mpe::ArticulationType::Standard;
+        meta.pattern.insert({ 0, mpe::ArticulationPatternSegment() });
+
+        mpe::ArticulationMap articulations;
+        articulations.insert({ mpe::ArticulationType::Standard, mpe::ArticulationAppliedData(meta, 0, mpe::HUNDRED_PERCENT) });
+
+        for (size_t i = 0; i < events; ++i) {
+            const mpe::timestamp_t timestamp = static_cast<mpe::timestamp_t>(i / 4) * 500000;
+            const mpe::pitch_level_t pitch = static_cast<mpe::pitch_level_t>(i % 88) * mpe::PITCH_LEVEL_STEP;
+
+            data.originEvents[timestamp].emplace_back(mpe::NoteEvent(timestamp, 480000, 0, 0, pitch, mpe::MAX_DYNAMIC_LEVEL,
+                                                                     articulations, 2.0));
+
+            if (i % 64 == 0) {
+                data.dynamics[0][timestamp] = mpe::MAX_DYNAMIC_LEVEL;
+            }
+        }
+
+        return data;
+    }
+};
+
+TEST_F(Audio_RpcChannelTests, PackMsg_Packed)
+{
+    //! GIVEN
+    mpe::PlaybackData origin = makePlaybackData(100);
+
+    //! DO
+    Msg msg;
+    pack_msg(TransportMode::Packed, msg, std::string("track"), origin);
+
+    std::string trackName;
+    mpe::PlaybackData unpacked;
+    bool ok = unpack_msg(msg, trackName, unpacked);
+
+    //! CHECK
+    EXPECT_FALSE(msg.data.empty());
+    EXPECT_FALSE(msg.values);
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(trackName, "track");
+    EXPECT_TRUE(origin == unpacked);
+}
+
+TEST_F(Audio_RpcChannelTests, PackMsg_InProcess)
+{
+    //! GIVEN
+    mpe::PlaybackData origin = makePlaybackData(100);
+
+    //! DO
+    Msg msg;
+    pack_msg(TransportMode::InProcess, msg, std::string("track"), origin);
+
+    std::string trackName;
+    mpe::PlaybackData unpacked;
+    bool ok = unpack_msg(msg, trackName, unpacked);
+
+    //! CHECK The values are not packed, the events are shared
+    EXPECT_TRUE(msg.data.empty());
+    EXPECT_TRUE(msg.values);
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(trackName, "track");
+    EXPECT_TRUE(origin == unpacked);
+    EXPECT_EQ(&origin.originEvents.cbegin()->second, &unpacked.originEvents.cbegin()->second);
+
+    //! CHECK Changes of the sender don't affect the snapshot
+    origin.originEvents.clear();
+    mpe::PlaybackData unpacked2;
+    EXPECT_TRUE(unpack_msg(msg, trackName, unpacked2));
+    EXPECT_EQ(unpacked2.originEvents.size(), unpacked.originEvents.size());
+}
+
+TEST_F(Audio_RpcChannelTests, PackMsg_InProcess_OtherThread)
+{
+    //! GIVEN A stream message with the events
+    mpe::PlaybackData origin = makePlaybackData(1000);
+
+    StreamMsg msg;
+    pack_msg(TransportMode::InProcess, msg, origin.originEvents, origin.dynamics);
+
+    //! DO The sender changes the events while the receiver reads the snapshot
+    const size_t size = origin.originEvents.size();
+    size_t receivedSize = 0;
+    size_t receivedEvents = 0;
+    std::thread receiver([&msg, &receivedSize, &receivedEvents]() {
+        mpe::PlaybackEventsMap events;
+        mpe::DynamicLevelLayers dynamics;
+        if (unpack_msg(msg, events, dynamics)) {
+            receivedSize = events.size();
+            for (const auto& p : events) {
+                receivedEvents += p.second.size();
+            }
+        }
+    });
+
+    for (size_t i = 0; i < 100; ++i) {
+        origin.originEvents[static_cast<mpe::timestamp_t>(i)].clear();
+    }
+
+    receiver.join();
+
+    //! CHECK
+    EXPECT_EQ(receivedSize, size);
+    EXPECT_EQ(receivedEvents, 1000);
+}
+
+TEST_F(Audio_RpcChannelTests, UnpackMsg_WrongTypes)
+{
+    //! GIVEN
+    Msg msg;
+    pack_msg(TransportMode::InProcess, msg, std::string("track"), int64_t(42));
+
+    //! DO
+    std::string trackName;
+    int32_t val = 0;
+    bool ok = unpack_msg(msg, trackName, val);
+
+    //! CHECK
+    EXPECT_FALSE(ok);
+}
+
+TEST_F(Audio_RpcChannelTests, DISABLED_Transport_Benchmark)
+{
+    using clock = std::chrono::steady_clock;
+
+    const mpe::PlaybackData origin = makePlaybackData(100000);
+    const int iterations = 5;
+
+    for (TransportMode mode : { TransportMode::Packed, TransportMode::InProcess }) {
+        long long sendTime = 0;
+        long long receiveTime = 0;
+        size_t size = 0;
+
+        for (int i = 0; i < iterations; ++i) {
+            mpe::PlaybackData data;
+            std::string trackName;
+
+            //! NOTE As main stream update: send (pack), pass by the queue (copy), receive (unpack)
+            auto start = clock::now();
+            StreamMsg msg;
+            pack_msg(mode, msg, origin.originEvents, origin.dynamics);
+            StreamMsg queued = msg;
+            sendTime += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+            start = clock::now();
+            EXPECT_TRUE(unpack_msg(queued, data.originEvents, data.dynamics));
+            receiveTime += std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+            size = queued.data.size();
+        }
+
+        std::cout << (mode == TransportMode::Packed ? "packed" : "in-process")
+                  << ": events: 100000, data: " << size / 1024 << " KB"
+                  << ", send: " << sendTime / iterations << " us"
+                  << ", receive: " << receiveTime / iterations << " us" << std::endl;
+    }
+}
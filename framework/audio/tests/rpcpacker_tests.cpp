@@ -21,6 +21,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <iostream>
+
 #pragma pack(push, 1)
 #include "audio/common/audiotypes.h"
 #pragma pack(pop)
@@ -854,3 +857,86 @@ TEST_F(Audio_RpcPackerTests, Duration)
     EXPECT_TRUE(ok);
     EXPECT_TRUE(origin == unpacked);
 }
+
+//! NOTE Playback data of a track as it is sent when the track is added:
+//! chords of notes with articulations and the dynamics
+static mpe::PlaybackData makePlaybackData(size_t notes)
+{
+    mpe::PlaybackData data;
+    data.setupData.id = u"instrument";
+    data.setupData.category = mpe::SoundCategory::Keyboards;
+    data.setupData.subCategories = { u"piano" };
+
+    const mpe::ExpressionContext exprCtx = makeExpressionContext();
+    for (size_t i = 0; i < notes; ++i) {
+        const mpe::timestamp_t timestamp = static_cast<mpe::timestamp_t>(i / 4) * 500000;
+
+        mpe::ArrangementContext arrCtx = makeArrangementContext();
+        arrCtx.nominalTimestamp = timestamp;
+        arrCtx.actualTimestamp = timestamp;
+        arrCtx.nominalDuration = 500000;
+        arrCtx.actualDuration = 480000;
+
+        mpe::PitchContext pitchCtx = makePitchContext();
+        pitchCtx.nominalPitchLevel = static_cast<mpe::pitch_level_t>(i % 88) * mpe::PITCH_LEVEL_STEP;
+
+        mpe::ExpressionContext ctx = exprCtx;
+        data.originEvents[timestamp].emplace_back(mpe::NoteEvent(std::move(arrCtx), std::move(pitchCtx), std::move(ctx)));
+
+        if (i % 64 == 0) {
+            data.dynamics[0][timestamp] = static_cast<mpe::dynamic_level_t>(i % 100);
+        }
+    }
+
+    return data;
+}
+
+TEST_F(Audio_RpcPackerTests, MPE_PlaybackData_Large)
+{
+    //! GIVEN Playback data bigger than the packer buffer
+    mpe::PlaybackData origin = makePlaybackData(4000);
+
+    //! DO
+    ByteArray data = rpc::RpcPacker::pack(origin);
+
+    mpe::PlaybackData unpacked;
+    bool ok = rpc::RpcPacker::unpack(data, unpacked);
+
+    //! CHECK
+    EXPECT_GT(data.size(), rpc::RpcPacker::DEFAULT_CAPACITY);
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(origin == unpacked);
+}
+
+TEST_F(Audio_RpcPackerTests, DISABLED_MPE_PlaybackData_Benchmark)
+{
+    using clock = std::chrono::steady_clock;
+    auto us = [](clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+    };
+
+    for (size_t notes : { 100, 10000, 100000 }) {
+        const mpe::PlaybackData origin = makePlaybackData(notes);
+        const int iterations = notes > 10000 ? 5 : 50;
+
+        ByteArray data;
+        auto start = clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            data = rpc::RpcPacker::pack(origin);
+        }
+        auto packTime = us(start) / iterations;
+
+        //! NOTE Without the destruction of the unpacked data
+        long long unpackTime = 0;
+        for (int i = 0; i < iterations; ++i) {
+            mpe::PlaybackData unpacked;
+            start = clock::now();
+            EXPECT_TRUE(rpc::RpcPacker::unpack(data, unpacked));
+            unpackTime += us(start);
+        }
+        unpackTime /= iterations;
+
+        std::cout << "notes: " << notes << ", size: " << data.size() / 1024 << " KB"
+                  << ", pack: " << packTime << " us, unpack: " << unpackTime << " us" << std::endl;
+    }
+}
@@ -21,6 +21,8 @@
  */
 #include "bufferedpaintprovider.h"
 
+#include <functional>
+
 #include "utils/drawlogger.h"
 #include "log.h"
 
@@ -283,7 +285,59 @@ void BufferedPaintProvider::drawPath(const PainterPath& path)
     } else if (st.brush.style() == BrushStyle::NoBrush) {
         mode = DrawMode::Stroke;
     }
-    editableData().paths.push_back({ path, st.pen, st.brush, mode });
+    DrawData::Data& data = editableData();
+    data.paths.push_back({ sharedPath(path), st.pen, st.brush, mode });
+}
+
+static size_t pathHash(const PainterPath& path)
+{
+    size_t h = std::hash<int> {}(static_cast<int>(path.fillRule()));
+    for (size_t i = 0; i < path.elementCount(); ++i) {
+        PainterPath::Element e = path.elementAt(i);
+        h ^= std::hash<double> {}(e.x) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<double> {}(e.y) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= static_cast<size_t>(e.type) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+    return h;
+}
+
+static bool isSamePath(const PainterPath& p1, const PainterPath& p2)
+{
+    if (p1.isSharedWith(p2)) {
+        return true;
+    }
+
+    if (p1.elementCount() != p2.elementCount() || p1.fillRule() != p2.fillRule()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < p1.elementCount(); ++i) {
+        PainterPath::Element e1 = p1.elementAt(i);
+        PainterPath::Element e2 = p2.elementAt(i);
+        if (e1.x != e2.x || e1.y != e2.y || e1.type != e2.type) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! NOTE The same path (glyph outline, symbol) is often drawn many times with different transforms,
+//! the recorded copies share one storage of elements. Short paths are stored inline, nothing to share.
+const PainterPath& BufferedPaintProvider::sharedPath(const PainterPath& path)
+{
+    if (path.isInline()) {
+        return path;
+    }
+
+    const size_t h = pathHash(path);
+    auto range = m_paths.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (isSamePath(it->second, path)) {
+            return it->second;
+        }
+    }
+
+    return m_paths.emplace(h, path)->second;
 }
 
 void BufferedPaintProvider::drawPolygon(const PointF* points, size_t pointCount, PolygonMode mode)
@@ -292,17 +346,24 @@ void BufferedPaintProvider::drawPolygon(const PointF* points, size_t pointCount,
     for (size_t i = 0; i < pointCount; ++i) {
         pol[i] = PointF(points[i].x(), points[i].y());
     }
-    editableData().polygons.push_back(DrawPolygon { pol, mode });
+    DrawData::Data& data = editableData();
+    data.polygons.push_back(DrawPolygon { pol, mode });
 }
 
 void BufferedPaintProvider::drawText(const PointF& point, const String& text)
 {
-    editableData().texts.push_back(DrawText { DrawText::Point, RectF(point, SizeF()), 0, text });
+    addText(DrawText { DrawText::Point, RectF(point, SizeF()), 0, text });
 }
 
 void BufferedPaintProvider::drawText(const RectF& rect, int flags, const String& text)
 {
-    editableData().texts.push_back(DrawText { DrawText::Rect, rect, flags, text });
+    addText(DrawText { DrawText::Rect, rect, flags, text });
+}
+
+void BufferedPaintProvider::addText(DrawText&& text)
+{
+    DrawData::Data& data = editableData();
+    data.texts.push_back(std::move(text));
 }
 
 void BufferedPaintProvider::drawSymbol(const PointF& point, char32_t ucs4Code)
@@ -312,23 +373,29 @@ void BufferedPaintProvider::drawSymbol(const PointF& point, char32_t ucs4Code)
 
 void BufferedPaintProvider::drawPixmap(const PointF& p, const Pixmap& pm)
 {
-    editableData().pixmaps.push_back(DrawPixmap { DrawPixmap::Single, RectF(p, SizeF()), pm, PointF() });
+    addPixmap(DrawPixmap { DrawPixmap::Single, RectF(p, SizeF()), pm, PointF() });
 }
 
 void BufferedPaintProvider::drawTiledPixmap(const RectF& rect, const Pixmap& pm, const PointF& offset)
 {
-    editableData().pixmaps.push_back(DrawPixmap { DrawPixmap::Tiled, rect, pm, offset });
+    addPixmap(DrawPixmap { DrawPixmap::Tiled, rect, pm, offset });
+}
+
+void BufferedPaintProvider::addPixmap(DrawPixmap&& pixmap)
+{
+    DrawData::Data& data = editableData();
+    data.pixmaps.push_back(std::move(pixmap));
 }
 
 #ifndef NO_QT_SUPPORT
 void BufferedPaintProvider::drawPixmap(const PointF& p, const QPixmap& pm)
 {
-    editableData().pixmaps.push_back(DrawPixmap { DrawPixmap::Single, RectF(p, SizeF()), Pixmap::fromQPixmap(pm), PointF() });
+    addPixmap(DrawPixmap { DrawPixmap::Single, RectF(p, SizeF()), Pixmap::fromQPixmap(pm), PointF() });
 }
 
 void BufferedPaintProvider::drawTiledPixmap(const RectF& rect, const QPixmap& pm, const PointF& offset)
 {
-    editableData().pixmaps.push_back(DrawPixmap { DrawPixmap::Tiled, rect, Pixmap::fromQPixmap(pm), offset });
+    addPixmap(DrawPixmap { DrawPixmap::Tiled, rect, Pixmap::fromQPixmap(pm), offset });
 }
 
 #endif
@@ -362,5 +429,42 @@ DrawDataPtr BufferedPaintProvider::drawData() const
 void BufferedPaintProvider::clear()
 {
     m_buf = std::make_shared<DrawData>();
+    {
+        std::lock_guard lock(m_indexMutex);
+        m_isIndexBuilt = false;
+        m_bounds = DrawDataBounds::Item();
+        m_index.clear();
+    }
+    m_paths.clear();
     m_itemLevel = -1;
 }
+
+void BufferedPaintProvider::ensureIndex() const
+{
+    std::lock_guard lock(m_indexMutex);
+    if (m_isIndexBuilt || m_isActive) {
+        return;
+    }
+
+    m_bounds = DrawDataBounds::calculate(m_buf);
+    m_index.build(m_buf, m_bounds);
+    m_isIndexBuilt = true;
+}
+
+const DrawDataBounds::Item& BufferedPaintProvider::drawDataBounds() const
+{
+    ensureIndex();
+    return m_bounds;
+}
+
+const DrawDataIndex& BufferedPaintProvider::drawDataIndex() const
+{
+    ensureIndex();
+    return m_index;
+}
+
+void BufferedPaintProvider::paint(Painter* painter, const RectF& clip, const Color& overlay) const
+{
+    ensureIndex();
+    m_index.paint(painter, clip, overlay);
+}
@@ -22,10 +22,15 @@
 #ifndef MUSE_DRAW_BUFFEREDPAINTPROVIDER_H
 #define MUSE_DRAW_BUFFEREDPAINTPROVIDER_H
 
+#include <mutex>
+#include <unordered_map>
+
 #include "ipaintprovider.h"
 #include "types/drawdata.h"
 #include "types/pen.h"
 #include "types/brush.h"
+#include "utils/drawdatabounds.h"
+#include "utils/drawdataindex.h"
 
 namespace muse::draw {
 class DrawObjectsLogger;
@@ -94,6 +99,14 @@ public:
     DrawDataPtr drawData() const;
     void clear();
 
+    //! NOTE The bounds and the index are built from the finished data on the first request after the end of the target,
+    //! so recording doesn't pay for them (and doesn't need the font provider for the text bounds)
+    const DrawDataBounds::Item& drawDataBounds() const;
+    const DrawDataIndex& drawDataIndex() const;
+
+    //! NOTE Replays only the primitives intersecting the clip (in device coordinates)
+    void paint(Painter* painter, const RectF& clip, const Color& overlay = Color()) const;
+
 private:
 
     const DrawData::Item& currentItem() const;
@@ -107,7 +120,19 @@ private:
 
     void ensureItemInit(DrawData::Item& item) const;
 
+    void ensureIndex() const;
+
+    const PainterPath& sharedPath(const PainterPath& path);
+
+    void addText(DrawText&& text);
+    void addPixmap(DrawPixmap&& pixmap);
+
     DrawDataPtr m_buf = nullptr;
+    mutable std::mutex m_indexMutex;
+    mutable bool m_isIndexBuilt = false;
+    mutable DrawDataBounds::Item m_bounds;
+    mutable DrawDataIndex m_index;
+    std::unordered_multimap<size_t, PainterPath> m_paths; // by hash, to share identical paths
     int m_itemLevel = -1;
     bool m_stateIsUsed = false;
     int m_currentStateNo = 0;
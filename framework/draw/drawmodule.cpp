@@ -31,6 +31,7 @@
 #include "internal/fontprovider.h"
 #include "internal/fontsengine.h"
 #include "internal/fontsdatabase.h"
+#include "internal/svgrendercache.h"
 #endif
 
 #include "muse_framework_config.h"
@@ -65,3 +66,10 @@ void DrawModule::onInit(const IApplication::RunMode&)
     m_fontsEngine->init();
 #endif // DRAW_NO_INTERNAL
 }
+
+void DrawModule::onDeinit()
+{
+#ifndef DRAW_NO_INTERNAL
+    SvgRenderCache::releaseInstance();
+#endif // DRAW_NO_INTERNAL
+}
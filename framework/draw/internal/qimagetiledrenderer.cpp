@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "qimagetiledrenderer.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include <QPainter>
+
+#ifdef MUSE_THREADS_SUPPORT
+#include "concurrency/taskscheduler.h"
+#endif
+
+#include "../painter.h"
+#include "../utils/drawdatapaint.h"
+#include "qpainterprovider.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+namespace {
+using DecodedImages = std::unordered_map<unsigned int, QImage>;
+
+//! NOTE QPixmap and QPixmapCache can only be used on the main thread,
+//! so the pixmaps are decoded before painting and drawn as images
+class TilePainterProvider : public QPainterProvider
+{
+public:
+    TilePainterProvider(QPainter* painter, const DecodedImages& images)
+        : QPainterProvider(painter, true), m_images(images) {}
+
+    void drawPixmap(const PointF& point, const Pixmap& pm) override
+    {
+        auto it = m_images.find(pm.key());
+        if (it != m_images.end()) {
+            qpainter()->drawImage(point.toQPointF(), it->second);
+        }
+    }
+
+private:
+    const DecodedImages& m_images;
+};
+
+struct Tile {
+    QRect rect;
+    QImage image;
+};
+}
+
+//! NOTE Tiled pixmaps can be painted only with QPixmap, so such data is painted on the calling thread
+static bool hasTiledPixmaps(const DrawData::Item& item)
+{
+    for (const DrawData::Data& d : item.datas) {
+        for (const DrawPixmap& px : d.pixmaps) {
+            if (px.mode != DrawPixmap::Single) {
+                return true;
+            }
+        }
+    }
+
+    for (const DrawData::Item& ch : item.chilren) {
+        if (hasTiledPixmaps(ch)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void decodeImages(DecodedImages& images, const DrawData::Item& item)
+{
+    for (const DrawData::Data& d : item.datas) {
+        for (const DrawPixmap& px : d.pixmaps) {
+            if (images.find(px.pm.key()) != images.end()) {
+                continue;
+            }
+
+            QImage image;
+            image.loadFromData(px.pm.data().toQByteArrayNoCopy());
+
+            // the same format as QPixmap has on the raster platform
+            image.convertTo(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+            images.emplace(px.pm.key(), std::move(image));
+        }
+    }
+
+    for (const DrawData::Item& ch : item.chilren) {
+        decodeImages(images, ch);
+    }
+}
+
+static void paintTile(Tile& tile, double dpr, const DrawDataPtr& data, const DrawDataBounds::Item& bounds,
+                      const DecodedImages& images, const Color& overlay)
+{
+    RectF clip(tile.rect.x() / dpr, tile.rect.y() / dpr, tile.rect.width() / dpr, tile.rect.height() / dpr);
+
+    IPaintProviderPtr provider = std::make_shared<TilePainterProvider>(new QPainter(&tile.image), images);
+    //! NOTE Tiles are painted on worker threads, so not with the extended provider (it's for painting on the main thread)
+    Painter painter(provider, "tile", false);
+    DrawDataPaint::paintRegion(&painter, data, bounds, clip, overlay);
+    painter.endDraw();
+}
+
+static void stitchTile(QImage& image, const Tile& tile)
+{
+    const size_t bytesPerPixel = static_cast<size_t>(image.depth() / 8);
+    const size_t lineSize = static_cast<size_t>(tile.rect.width()) * bytesPerPixel;
+    for (int y = 0; y < tile.rect.height(); ++y) {
+        uchar* dst = image.scanLine(tile.rect.y() + y) + static_cast<size_t>(tile.rect.x()) * bytesPerPixel;
+        std::memcpy(dst, tile.image.constScanLine(y), lineSize);
+    }
+}
+
+QImageTiledRenderer::QImageTiledRenderer(size_t threadCount, int tileSize)
+    : m_threadCount(threadCount), m_tileSize(tileSize)
+{
+#ifdef MUSE_THREADS_SUPPORT
+    if (m_threadCount != 1) {
+        m_taskScheduler = std::make_unique<TaskScheduler>(static_cast<thread_pool_size_t>(m_threadCount));
+        m_threadCount = m_taskScheduler->threadPoolSize();
+    }
+#else
+    m_threadCount = 1;
+#endif
+}
+
+QImageTiledRenderer::~QImageTiledRenderer() = default;
+
+size_t QImageTiledRenderer::threadCount() const
+{
+    return m_threadCount;
+}
+
+int QImageTiledRenderer::tileSize() const
+{
+    return m_tileSize;
+}
+
+void QImageTiledRenderer::render(QImage& image, const DrawDataPtr& data, const Color& overlay)
+{
+    TRACEFUNC;
+
+    IF_ASSERT_FAILED(data && m_tileSize > 0) {
+        return;
+    }
+
+    if (image.isNull()) {
+        return;
+    }
+
+    //! NOTE Bounds are calculated before painting on the calling thread,
+    //! this also fills the lazy bounding rects of the paths, so workers only read the data
+    const DrawDataBounds::Item bounds = DrawDataBounds::calculate(data);
+
+    // stitching by bytes is not possible for less than 8 bits per pixel
+    if (m_threadCount == 1 || image.depth() % 8 != 0 || hasTiledPixmaps(data->item)) {
+        Painter painter(&image, "tiled");
+        DrawDataPaint::paint(&painter, data, overlay);
+        painter.endDraw();
+        return;
+    }
+
+    DecodedImages images;
+    decodeImages(images, data->item);
+
+    const double dpr = image.devicePixelRatio();
+
+    std::vector<Tile> tiles;
+    for (int y = 0; y < image.height(); y += m_tileSize) {
+        for (int x = 0; x < image.width(); x += m_tileSize) {
+            QRect rect(x, y, std::min(m_tileSize, image.width() - x), std::min(m_tileSize, image.height() - y));
+            RectF clip(rect.x() / dpr, rect.y() / dpr, rect.width() / dpr, rect.height() / dpr);
+            if (!bounds.rect.intersects(clip)) {
+                continue;
+            }
+
+            tiles.push_back(Tile { rect, image.copy(rect) });
+        }
+    }
+
+#ifdef MUSE_THREADS_SUPPORT
+    std::vector<std::future<void> > futures;
+    futures.reserve(tiles.size());
+    for (Tile& tile : tiles) {
+        futures.push_back(m_taskScheduler->submit([&tile, dpr, &data, &bounds, &images, &overlay]() {
+            paintTile(tile, dpr, data, bounds, images, overlay);
+        }));
+    }
+
+    for (std::future<void>& f : futures) {
+        f.get();
+    }
+#else
+    for (Tile& tile : tiles) {
+        paintTile(tile, dpr, data, bounds, images, overlay);
+    }
+#endif
+
+    for (const Tile& tile : tiles) {
+        stitchTile(image, tile);
+    }
+}
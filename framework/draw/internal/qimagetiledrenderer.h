@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+
+#include <QImage>
+
+#include "muse_framework_config.h"
+
+#include "../types/drawdata.h"
+
+namespace muse {
+class TaskScheduler;
+}
+
+namespace muse::draw {
+//! NOTE Rasterises DrawData into an image by tiles in parallel.
+//! Each tile is painted on a worker thread with its own QPainter,
+//! only the items that intersect the tile are replayed.
+//! The result is the same as painting DrawData with DrawDataPaint::paint on the whole image.
+class QImageTiledRenderer
+{
+public:
+    static constexpr int DEFAULT_TILE_SIZE = 256;
+
+    //! NOTE threadCount = 0 - default thread pool size, 1 - paint on the calling thread
+    QImageTiledRenderer(size_t threadCount = 0, int tileSize = DEFAULT_TILE_SIZE);
+    ~QImageTiledRenderer();
+
+    size_t threadCount() const;
+    int tileSize() const;
+
+    void render(QImage& image, const DrawDataPtr& data, const Color& overlay = Color());
+
+private:
+    size_t m_threadCount = 0;
+    int m_tileSize = DEFAULT_TILE_SIZE;
+
+#ifdef MUSE_THREADS_SUPPORT
+    std::unique_ptr<TaskScheduler> m_taskScheduler;
+#endif
+};
+}
@@ -0,0 +1,272 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "svgrendercache.h"
+
+#include <cstring>
+#include <functional>
+#include <string_view>
+
+#include <QPainter>
+#include <QSvgRenderer>
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+static uint64_t contentHash(const ByteArray& data)
+{
+    return std::hash<std::string_view> {}(std::string_view(reinterpret_cast<const char*>(data.constData()), data.size()));
+}
+
+static bool isSameData(const ByteArray& d1, const ByteArray& d2)
+{
+    return d1.size() == d2.size() && (d1.size() == 0 || std::memcmp(d1.constData(), d2.constData(), d1.size()) == 0);
+}
+
+size_t SvgRenderCache::ImageKeyHash::operator()(const ImageKey& k) const
+{
+    size_t h = std::hash<uint64_t> {}(k.docId);
+    h ^= std::hash<int> {}(k.width) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<int> {}(k.height) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<qreal> {}(k.dpr) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+static std::mutex s_instanceMutex;
+static std::unique_ptr<SvgRenderCache> s_instance;
+
+SvgRenderCache* SvgRenderCache::instance()
+{
+    std::lock_guard lock(s_instanceMutex);
+    if (!s_instance) {
+        s_instance = std::make_unique<SvgRenderCache>();
+    }
+    return s_instance.get();
+}
+
+void SvgRenderCache::releaseInstance()
+{
+    std::lock_guard lock(s_instanceMutex);
+    s_instance.reset();
+}
+
+SvgRenderCache::SvgRenderCache(size_t byteBudget, size_t maxDocuments)
+    : m_byteBudget(byteBudget), m_maxDocuments(maxDocuments)
+{
+}
+
+SvgRenderCache::~SvgRenderCache()
+{
+    clear();
+}
+
+SvgDocumentPtr SvgRenderCache::findDocument(uint64_t hash, const ByteArray& data)
+{
+    auto range = m_documentsByHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        DocumentList::iterator docIt = it->second;
+        if (isSameData((*docIt)->data, data)) {
+            m_documents.splice(m_documents.begin(), m_documents, docIt);
+            return *docIt;
+        }
+    }
+
+    return nullptr;
+}
+
+SvgDocumentPtr SvgRenderCache::document(const ByteArray& data)
+{
+    const uint64_t hash = contentHash(data);
+
+    {
+        std::lock_guard lock(m_mutex);
+        if (SvgDocumentPtr found = findDocument(hash, data)) {
+            return found;
+        }
+    }
+
+    //! NOTE Parsed without the cache lock, so other documents are found and rendered meanwhile
+    auto doc = std::make_shared<SvgDocument>();
+    doc->hash = hash;
+    doc->data = data;
+    doc->renderer = std::make_shared<QSvgRenderer>(data.toQByteArray());
+
+    std::lock_guard lock(m_mutex);
+
+    //! NOTE Another thread could have parsed the same data meanwhile
+    if (SvgDocumentPtr found = findDocument(hash, data)) {
+        return found;
+    }
+
+    doc->id = ++m_lastDocumentId;
+    m_documents.push_front(doc);
+    m_documentsByHash.emplace(hash, m_documents.begin());
+
+    //! NOTE Evicted documents stay alive while they are used by renderers,
+    //! their images are dropped (they are cached again, if the renderers ask for them)
+    while (m_documents.size() > m_maxDocuments) {
+        const SvgDocumentPtr& last = m_documents.back();
+        removeImages(last->id);
+        auto lastRange = m_documentsByHash.equal_range(last->hash);
+        for (auto it = lastRange.first; it != lastRange.second; ++it) {
+            if (*it->second == last) {
+                m_documentsByHash.erase(it);
+                break;
+            }
+        }
+        m_documents.pop_back();
+    }
+
+    return doc;
+}
+
+QImage SvgRenderCache::image(const SvgDocumentPtr& doc, const QSize& pixelSize, qreal dpr)
+{
+    IF_ASSERT_FAILED(doc && !pixelSize.isEmpty()) {
+        return QImage();
+    }
+
+    const ImageKey key { doc->id, pixelSize.width(), pixelSize.height(), dpr };
+    const size_t bytes = static_cast<size_t>(pixelSize.width()) * static_cast<size_t>(pixelSize.height()) * 4;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto found = m_imagesByKey.find(key);
+        if (found != m_imagesByKey.end()) {
+            ++m_hits;
+            m_images.splice(m_images.begin(), m_images, found->second);
+            return found->second->image;
+        }
+
+        ++m_misses;
+    }
+
+    //! NOTE Rendered without the cache lock, so other documents are rendered and hit meanwhile
+    QImage image(pixelSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        std::lock_guard renderLock(doc->renderMutex);
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        doc->renderer->render(&painter, QRectF(0, 0, pixelSize.width(), pixelSize.height()));
+    }
+    image.setDevicePixelRatio(dpr);
+
+    std::lock_guard lock(m_mutex);
+
+    //! NOTE Too big for the cache, just return
+    if (bytes > m_byteBudget) {
+        return image;
+    }
+
+    //! NOTE Another thread could have rendered the same image meanwhile
+    auto found = m_imagesByKey.find(key);
+    if (found != m_imagesByKey.end()) {
+        m_images.splice(m_images.begin(), m_images, found->second);
+        return found->second->image;
+    }
+
+    evict(m_byteBudget - bytes);
+
+    m_images.push_front({ key, image });
+    m_imagesByKey.emplace(key, m_images.begin());
+    m_bytes += bytes;
+
+    return image;
+}
+
+void SvgRenderCache::render(const SvgDocumentPtr& doc, QPainter* painter, const QRectF& rect)
+{
+    IF_ASSERT_FAILED(doc) {
+        return;
+    }
+
+    std::lock_guard lock(doc->renderMutex);
+    doc->renderer->render(painter, rect);
+}
+
+void SvgRenderCache::evict(size_t budget)
+{
+    while (m_bytes > budget && !m_images.empty()) {
+        const ImageEntry& last = m_images.back();
+        m_bytes -= static_cast<size_t>(last.key.width) * static_cast<size_t>(last.key.height) * 4;
+        m_imagesByKey.erase(last.key);
+        m_images.pop_back();
+        ++m_evictions;
+    }
+}
+
+void SvgRenderCache::removeImages(uint64_t docId)
+{
+    for (auto it = m_images.begin(); it != m_images.end();) {
+        if (it->key.docId == docId) {
+            m_bytes -= static_cast<size_t>(it->key.width) * static_cast<size_t>(it->key.height) * 4;
+            m_imagesByKey.erase(it->key);
+            it = m_images.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t SvgRenderCache::byteBudget() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_byteBudget;
+}
+
+void SvgRenderCache::setByteBudget(size_t bytes)
+{
+    std::lock_guard lock(m_mutex);
+    m_byteBudget = bytes;
+    evict(m_byteBudget);
+}
+
+SvgRenderCache::Stats SvgRenderCache::stats() const
+{
+    std::lock_guard lock(m_mutex);
+
+    Stats s;
+    s.documents = m_documents.size();
+    s.images = m_images.size();
+    s.bytes = m_bytes;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.evictions = m_evictions;
+    return s;
+}
+
+void SvgRenderCache::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_imagesByKey.clear();
+    m_images.clear();
+    m_documentsByHash.clear();
+    m_documents.clear();
+    m_bytes = 0;
+    m_hits = 0;
+    m_misses = 0;
+    m_evictions = 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <QImage>
+
+#include "global/types/bytearray.h"
+
+class QSvgRenderer;
+class QPainter;
+class QRectF;
+
+namespace muse::draw {
+struct SvgDocument {
+    uint64_t id = 0;     // unique, the content hash may collide
+    uint64_t hash = 0;
+    ByteArray data;
+    std::shared_ptr<QSvgRenderer> renderer;
+    //! NOTE The renderer is shared, so rendering of the document is serialized (not of the whole cache)
+    mutable std::mutex renderMutex;
+};
+using SvgDocumentPtr = std::shared_ptr<const SvgDocument>;
+
+//! NOTE Cache of parsed SVG documents (by content hash)
+//! and of their rasterised images (by document, size in device pixels and device pixel ratio).
+//! Images are evicted in LRU order when the byte budget is exceeded.
+class SvgRenderCache
+{
+public:
+    static constexpr size_t DEFAULT_BYTE_BUDGET = 32 * 1024 * 1024;
+    static constexpr size_t DEFAULT_MAX_DOCUMENTS = 128;
+
+    //! NOTE Created on the first use, released by the draw module on deinit,
+    //! so the parsed documents (QObjects) are not destroyed at the static destruction
+    static SvgRenderCache* instance();
+    static void releaseInstance();
+
+    SvgRenderCache(size_t byteBudget = DEFAULT_BYTE_BUDGET, size_t maxDocuments = DEFAULT_MAX_DOCUMENTS);
+    ~SvgRenderCache();
+
+    //! NOTE Parses the data or returns the already parsed document
+    SvgDocumentPtr document(const ByteArray& data);
+
+    //! NOTE Rasterises the document or returns the cached image, the image has the given device pixel ratio
+    QImage image(const SvgDocumentPtr& doc, const QSize& pixelSize, qreal dpr);
+
+    //! NOTE Renders the document without caching (documents are shared, so rendering of a document is serialized)
+    void render(const SvgDocumentPtr& doc, QPainter* painter, const QRectF& rect);
+
+    size_t byteBudget() const;
+    void setByteBudget(size_t bytes);
+
+    struct Stats {
+        size_t documents = 0;
+        size_t images = 0;
+        size_t bytes = 0;
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+    };
+
+    Stats stats() const;
+    void clear();
+
+private:
+
+    struct ImageKey {
+        uint64_t docId = 0;
+        int width = 0;
+        int height = 0;
+        qreal dpr = 1.0;
+
+        bool operator==(const ImageKey& o) const
+        {
+            return docId == o.docId && width == o.width && height == o.height && dpr == o.dpr;
+        }
+    };
+
+    struct ImageKeyHash {
+        size_t operator()(const ImageKey& k) const;
+    };
+
+    struct ImageEntry {
+        ImageKey key;
+        QImage image;
+    };
+
+    using ImageList = std::list<ImageEntry>;
+    using DocumentList = std::list<SvgDocumentPtr>;
+
+    SvgDocumentPtr findDocument(uint64_t hash, const ByteArray& data);
+    void evict(size_t budget);
+    void removeImages(uint64_t docId);
+
+    mutable std::mutex m_mutex;
+    size_t m_byteBudget = DEFAULT_BYTE_BUDGET;
+    size_t m_maxDocuments = DEFAULT_MAX_DOCUMENTS;
+    uint64_t m_lastDocumentId = 0;
+
+    // front - most recently used
+    DocumentList m_documents;
+    std::unordered_multimap<uint64_t, DocumentList::iterator> m_documentsByHash;
+    ImageList m_images;
+    std::unordered_map<ImageKey, ImageList::iterator, ImageKeyHash> m_imagesByKey;
+
+    size_t m_bytes = 0;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    size_t m_evictions = 0;
+};
+}
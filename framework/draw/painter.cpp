@@ -36,22 +36,22 @@ using namespace muse::draw;
 IPaintProviderPtr Painter::extended;
 bool PainterItemMarker::enabled = true;
 
-Painter::Painter(IPaintProviderPtr provider, const std::string& name)
-    : m_provider(provider), m_name(name)
+Painter::Painter(IPaintProviderPtr provider, const std::string& name, bool isExtended)
+    : m_provider(provider), m_extended(isExtended ? extended : nullptr), m_name(name)
 {
     init();
 }
 
 #ifndef NO_QT_SUPPORT
 Painter::Painter(QPaintDevice* dp, const std::string& name)
-    : m_name(name)
+    : m_extended(extended), m_name(name)
 {
     m_provider = QPainterProvider::make(dp);
     init();
 }
 
 Painter::Painter(QPainter* qp, const std::string& name, bool ownsQPainter)
-    : m_name(name)
+    : m_extended(extended), m_name(name)
 {
     m_provider = QPainterProvider::make(qp, ownsQPainter);
     init();
@@ -67,8 +67,8 @@ Painter::~Painter()
 void Painter::init()
 {
     m_provider->beginTarget(m_name);
-    if (extended) {
-        extended->beginTarget(m_name);
+    if (m_extended) {
+        m_extended->beginTarget(m_name);
     }
 
     State st;
@@ -101,13 +101,13 @@ bool Painter::endDraw()
 bool Painter::endTarget(bool endDraw)
 {
     m_provider->beforeEndTargetHook(this);
-    if (extended) {
-        extended->beforeEndTargetHook(this);
+    if (m_extended) {
+        m_extended->beforeEndTargetHook(this);
     }
 
     bool ok = m_provider->endTarget(endDraw);
-    if (extended) {
-        extended->endTarget(endDraw);
+    if (m_extended) {
+        m_extended->endTarget(endDraw);
     }
     return ok;
 }
@@ -120,40 +120,40 @@ bool Painter::isActive() const
 void Painter::beginObject(const std::string& name)
 {
     m_provider->beginObject(name);
-    if (extended) {
-        extended->beginObject(name);
+    if (m_extended) {
+        m_extended->beginObject(name);
     }
 }
 
 void Painter::endObject()
 {
     m_provider->endObject();
-    if (extended) {
-        extended->endObject();
+    if (m_extended) {
+        m_extended->endObject();
     }
 }
 
 void Painter::setAntialiasing(bool arg)
 {
     m_provider->setAntialiasing(arg);
-    if (extended) {
-        extended->setAntialiasing(arg);
+    if (m_extended) {
+        m_extended->setAntialiasing(arg);
     }
 }
 
 void Painter::setCompositionMode(CompositionMode mode)
 {
     m_provider->setCompositionMode(mode);
-    if (extended) {
-        extended->setCompositionMode(mode);
+    if (m_extended) {
+        m_extended->setCompositionMode(mode);
     }
 }
 
 void Painter::setFont(const Font& font)
 {
     m_provider->setFont(font);
-    if (extended) {
-        extended->setFont(font);
+    if (m_extended) {
+        m_extended->setFont(font);
     }
 }
 
@@ -165,8 +165,8 @@ const Font& Painter::font() const
 void Painter::setPen(const Pen& pen)
 {
     m_provider->setPen(pen);
-    if (extended) {
-        extended->setPen(pen);
+    if (m_extended) {
+        m_extended->setPen(pen);
     }
 }
 
@@ -183,8 +183,8 @@ const Pen& Painter::pen() const
 void Painter::setBrush(const Brush& brush)
 {
     m_provider->setBrush(brush);
-    if (extended) {
-        extended->setBrush(brush);
+    if (m_extended) {
+        m_extended->setBrush(brush);
     }
 }
 
@@ -199,8 +199,8 @@ void Painter::save()
     m_states.push(newSt);
 
     m_provider->save();
-    if (extended) {
-        extended->save();
+    if (m_extended) {
+        m_extended->save();
     }
 }
 
@@ -211,8 +211,8 @@ void Painter::restore()
     }
 
     m_provider->restore();
-    if (extended) {
-        extended->restore();
+    if (m_extended) {
+        m_extended->restore();
     }
 }
 
@@ -276,8 +276,8 @@ void Painter::setWindow(const RectF& window)
 
     // for debug purpose
     m_provider->setWindow(window);
-    if (extended) {
-        extended->setWindow(window);
+    if (m_extended) {
+        m_extended->setWindow(window);
     }
 }
 
@@ -295,8 +295,8 @@ void Painter::setViewport(const RectF& viewport)
 
     // for debug purpose
     m_provider->setViewport(viewport);
-    if (extended) {
-        extended->setViewport(viewport);
+    if (m_extended) {
+        m_extended->setViewport(viewport);
     }
 }
 
@@ -331,8 +331,8 @@ void Painter::strokePath(const PainterPath& path, const Pen& pen)
 void Painter::drawPath(const PainterPath& path)
 {
     m_provider->drawPath(path);
-    if (extended) {
-        extended->drawPath(path);
+    if (m_extended) {
+        m_extended->drawPath(path);
     }
 }
 
@@ -371,16 +371,16 @@ void Painter::drawEllipse(const RectF& rect)
     PainterPath path;
     path.addEllipse(rect);
     m_provider->drawPath(path);
-    if (extended) {
-        extended->drawPath(path);
+    if (m_extended) {
+        m_extended->drawPath(path);
     }
 }
 
 void Painter::drawPolyline(const PointF* points, size_t pointCount)
 {
     m_provider->drawPolygon(points, pointCount, PolygonMode::Polyline);
-    if (extended) {
-        extended->drawPolygon(points, pointCount, PolygonMode::Polyline);
+    if (m_extended) {
+        m_extended->drawPolygon(points, pointCount, PolygonMode::Polyline);
     }
 }
 
@@ -388,16 +388,16 @@ void Painter::drawPolygon(const PointF* points, size_t pointCount, FillRule fill
 {
     PolygonMode mode = (fillRule == FillRule::OddEvenFill) ? PolygonMode::OddEven : PolygonMode::Winding;
     m_provider->drawPolygon(points, pointCount, mode);
-    if (extended) {
-        extended->drawPolygon(points, pointCount, mode);
+    if (m_extended) {
+        m_extended->drawPolygon(points, pointCount, mode);
     }
 }
 
 void Painter::drawConvexPolygon(const PointF* points, size_t pointCount)
 {
     m_provider->drawPolygon(points, pointCount, PolygonMode::Convex);
-    if (extended) {
-        extended->drawPolygon(points, pointCount, PolygonMode::Convex);
+    if (m_extended) {
+        m_extended->drawPolygon(points, pointCount, PolygonMode::Convex);
     }
 }
 
@@ -439,8 +439,8 @@ void Painter::drawText(const PointF& point, const String& text)
     applyFontSizeScaling();
 
     m_provider->drawText(point, text);
-    if (extended) {
-        extended->drawText(point, text);
+    if (m_extended) {
+        m_extended->drawText(point, text);
     }
 }
 
@@ -449,8 +449,8 @@ void Painter::drawText(const RectF& rect, int flags, const String& text)
     applyFontSizeScaling();
 
     m_provider->drawText(rect, flags, text);
-    if (extended) {
-        extended->drawText(rect, flags, text);
+    if (m_extended) {
+        m_extended->drawText(rect, flags, text);
     }
 }
 
@@ -459,8 +459,8 @@ void Painter::drawSymbol(const PointF& point, char32_t ucs4Code)
     applyFontSizeScaling();
 
     m_provider->drawSymbol(point, ucs4Code);
-    if (extended) {
-        extended->drawSymbol(point, ucs4Code);
+    if (m_extended) {
+        m_extended->drawSymbol(point, ucs4Code);
     }
 }
 
@@ -480,16 +480,16 @@ void Painter::fillRect(const RectF& rect, const Brush& brush)
 void Painter::drawPixmap(const PointF& point, const Pixmap& pm)
 {
     m_provider->drawPixmap(point, pm);
-    if (extended) {
-        extended->drawPixmap(point, pm);
+    if (m_extended) {
+        m_extended->drawPixmap(point, pm);
     }
 }
 
 void Painter::drawTiledPixmap(const RectF& rect, const Pixmap& pm, const PointF& offset)
 {
     m_provider->drawTiledPixmap(rect, pm, offset);
-    if (extended) {
-        extended->drawTiledPixmap(rect, pm, offset);
+    if (m_extended) {
+        m_extended->drawTiledPixmap(rect, pm, offset);
     }
 }
 
@@ -497,16 +497,16 @@ void Painter::drawTiledPixmap(const RectF& rect, const Pixmap& pm, const PointF&
 void Painter::drawPixmap(const PointF& point, const QPixmap& pm)
 {
     m_provider->drawPixmap(point, pm);
-    if (extended) {
-        extended->drawPixmap(point, pm);
+    if (m_extended) {
+        m_extended->drawPixmap(point, pm);
     }
 }
 
 void Painter::drawTiledPixmap(const RectF& rect, const QPixmap& pm, const PointF& offset)
 {
     m_provider->drawTiledPixmap(rect, pm, offset);
-    if (extended) {
-        extended->drawTiledPixmap(rect, pm, offset);
+    if (m_extended) {
+        m_extended->drawTiledPixmap(rect, pm, offset);
     }
 }
 
@@ -540,8 +540,8 @@ void Painter::updateMatrix()
     }
 
     m_provider->setTransform(st.transform);
-    if (extended) {
-        extended->setTransform(st.transform);
+    if (m_extended) {
+        m_extended->setTransform(st.transform);
     }
 }
 
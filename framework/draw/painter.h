@@ -44,7 +44,9 @@ namespace muse::draw {
 class Painter
 {
 public:
-    Painter(IPaintProviderPtr provider, const std::string& name);
+    //! NOTE isExtended - the calls are repeated to the `extended` provider, it is taken once on construction.
+    //! Painters on worker threads must not be extended, the provider isn't thread-safe
+    Painter(IPaintProviderPtr provider, const std::string& name, bool isExtended = true);
 
 #ifndef NO_QT_SUPPORT
     Painter(QPaintDevice* dp, const std::string& name);
@@ -152,7 +154,8 @@ public:
     void setClipping(bool enable);
 
     //! NOTE Provider for tests.
-    //! We're not ready to use DI (ModuleIoC) here yet
+    //! We're not ready to use DI (ModuleIoC) here yet.
+    //! Set it on the main thread, when no painting is in progress
     static IPaintProviderPtr extended;
 
 private:
@@ -178,6 +181,7 @@ private:
     bool endTarget(bool endDraw);
 
     IPaintProviderPtr m_provider;
+    IPaintProviderPtr m_extended;
     std::string m_name;
     std::stack<State> m_states;
 };
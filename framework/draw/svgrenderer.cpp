@@ -22,10 +22,14 @@
 #include "svgrenderer.h"
 
 #ifndef DRAW_NO_QSVGRENDER
+#include <cmath>
+
+#include <QPaintEngine>
 #include <QPainter>
 #include <QSvgRenderer>
 
 #include "internal/qpainterprovider.h"
+#include "internal/svgrendercache.h"
 #endif
 
 #include "log.h"
@@ -37,37 +41,74 @@ using namespace muse::draw;
 SvgRenderer::SvgRenderer(const ByteArray& data)
 {
 #ifndef DRAW_NO_QSVGRENDER
-    m_qSvgRenderer = new QSvgRenderer(data.toQByteArray());
+    m_document = SvgRenderCache::instance()->document(data);
 #else
     NOT_SUPPORTED;
     UNUSED(data);
 #endif
 }
 
-SvgRenderer::~SvgRenderer()
-{
-#ifndef DRAW_NO_QSVGRENDER
-    delete m_qSvgRenderer;
-#endif
-}
+SvgRenderer::~SvgRenderer() = default;
 
 muse::SizeF SvgRenderer::defaultSize() const
 {
 #ifndef DRAW_NO_QSVGRENDER
-    return SizeF::fromQSizeF(m_qSvgRenderer->defaultSize());
+    return SizeF::fromQSizeF(m_document->renderer->defaultSize());
 #else
     NOT_SUPPORTED;
     return SizeF();
 #endif
 }
 
+#ifndef DRAW_NO_QSVGRENDER
+//! NOTE Bigger images are rendered directly
+static constexpr int MAX_CACHED_IMAGE_SIDE = 2048;
+
+static bool renderCached(QPainter* qp, const SvgDocumentPtr& doc, const QRectF& rect)
+{
+    //! NOTE Only raster devices, vector devices (PDF, SVG, printer) get the vector rendering
+    if (!qp->paintEngine() || qp->paintEngine()->type() != QPaintEngine::Raster) {
+        return false;
+    }
+
+    //! NOTE Only scale and translation, no rotation, shear or mirroring
+    const QTransform t = qp->combinedTransform();
+    if (t.type() > QTransform::TxScale || t.m11() <= 0.0 || t.m22() <= 0.0) {
+        return false;
+    }
+
+    const QRectF deviceRect = t.mapRect(rect);
+    const qreal dpr = qp->device() ? qp->device()->devicePixelRatioF() : 1.0;
+    const QSize pixelSize(static_cast<int>(std::lround(deviceRect.width() * dpr)),
+                          static_cast<int>(std::lround(deviceRect.height() * dpr)));
+    if (pixelSize.isEmpty() || pixelSize.width() > MAX_CACHED_IMAGE_SIDE || pixelSize.height() > MAX_CACHED_IMAGE_SIDE) {
+        return false;
+    }
+
+    QImage image = SvgRenderCache::instance()->image(doc, pixelSize, dpr);
+
+    //! NOTE At the same place as the vector rendering, only the size is rounded to device pixels
+    qp->save();
+    qp->setViewTransformEnabled(false);
+    qp->setWorldTransform(QTransform());
+    qp->drawImage(QRectF(deviceRect.topLeft(), QSizeF(pixelSize.width() / dpr, pixelSize.height() / dpr)), image);
+    qp->restore();
+
+    return true;
+}
+
+#endif
+
 void SvgRenderer::render(Painter* painter, const RectF& rect)
 {
 #ifndef DRAW_NO_QSVGRENDER
     IPaintProviderPtr paintProvider = painter->provider();
     std::shared_ptr<QPainterProvider> qPaintProvider = std::dynamic_pointer_cast<QPainterProvider>(paintProvider);
     if (qPaintProvider) {
-        m_qSvgRenderer->render(qPaintProvider->qpainter(), rect.toQRectF());
+        QPainter* qp = qPaintProvider->qpainter();
+        if (!renderCached(qp, m_document, rect.toQRectF())) {
+            SvgRenderCache::instance()->render(m_document, qp, rect.toQRectF());
+        }
     }
 #else
     NOT_SUPPORTED;
@@ -22,14 +22,15 @@
 #ifndef MUSE_DRAW_SVGRENDERER_H
 #define MUSE_DRAW_SVGRENDERER_H
 
+#include <memory>
+
 #include "global/types/bytearray.h"
 
 #include "types/geometry.h"
 #include "painter.h"
 
-class QSvgRenderer;
-
 namespace muse::draw {
+struct SvgDocument;
 class SvgRenderer
 {
 public:
@@ -38,10 +39,11 @@ public:
 
     SizeF defaultSize() const;
 
+    //! NOTE With axis-aligned transform the rasterised image is cached (see SvgRenderCache)
     void render(Painter* painter, const RectF& rect);
 
 private:
-    QSvgRenderer* m_qSvgRenderer = nullptr;
+    std::shared_ptr<const SvgDocument> m_document;
 };
 }
 
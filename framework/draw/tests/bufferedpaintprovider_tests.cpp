@@ -0,0 +1,304 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "draw/painter.h"
+#include "draw/bufferedpaintprovider.h"
+#include "draw/utils/drawdatapaint.h"
+#include "draw/utils/drawdatacomp.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+class Draw_BufferedPaintProviderTests : public ::testing::Test
+{
+public:
+
+    //! NOTE Synthetic page: systems with staff lines and notes with stems
+    static std::shared_ptr<BufferedPaintProvider> makePage(size_t systems)
+    {
+        auto provider = std::make_shared<BufferedPaintProvider>();
+        Painter painter(provider, "page");
+        painter.setAntialiasing(true);
+        painter.scale(0.5, 0.5);
+
+        for (size_t s = 0; s < systems; ++s) {
+            const double top = 60.0 + static_cast<double>(s) * 180.0;
+
+            painter.beginObject("System");
+            painter.setPen(Pen(Color::BLACK, 1.0));
+            for (int l = 0; l < 5; ++l) {
+                painter.drawLine(40.0, top + l * 10.0, 1960.0, top + l * 10.0);
+            }
+
+            for (size_t n = 0; n < 90; ++n) {
+                const double x = 80.0 + static_cast<double>(n) * 20.0;
+                const double y = top + static_cast<double>(n % 9) * 5.0;
+
+                painter.beginObject("Note");
+                painter.setPen(Pen(Color::BLUE, 3.0));
+                painter.setBrush(Brush(Color::BLACK));
+                painter.drawEllipse(RectF(x, y - 4.0, 12.0, 8.0));
+                painter.drawLine(x + 12.0, y, x + 12.0, y - 35.0);
+                painter.endObject();
+            }
+            painter.endObject();
+        }
+
+        painter.endDraw();
+        return provider;
+    }
+
+    static size_t primitivesCount(const DrawData::Item& item)
+    {
+        size_t count = 0;
+        for (const DrawData::Data& d : item.datas) {
+            count += d.paths.size() + d.polygons.size() + d.texts.size() + d.pixmaps.size();
+        }
+
+        for (const DrawData::Item& ch : item.chilren) {
+            count += primitivesCount(ch);
+        }
+
+        return count;
+    }
+
+    static void collect(const DrawData::Item& item, std::vector<DrawPath>& paths, std::vector<DrawPolygon>& polygons)
+    {
+        for (const DrawData::Data& d : item.datas) {
+            paths.insert(paths.end(), d.paths.begin(), d.paths.end());
+            polygons.insert(polygons.end(), d.polygons.begin(), d.polygons.end());
+        }
+
+        for (const DrawData::Item& ch : item.chilren) {
+            collect(ch, paths, polygons);
+        }
+    }
+
+    static void expectSameBounds(const DrawDataBounds::Item& bounds, const DrawDataBounds::Item& expected)
+    {
+        EXPECT_EQ(bounds.rect, expected.rect);
+        ASSERT_EQ(bounds.datas.size(), expected.datas.size());
+        for (size_t i = 0; i < bounds.datas.size(); ++i) {
+            EXPECT_EQ(bounds.datas.at(i).rect, expected.datas.at(i).rect);
+            EXPECT_EQ(bounds.datas.at(i).paths, expected.datas.at(i).paths);
+            EXPECT_EQ(bounds.datas.at(i).polygons, expected.datas.at(i).polygons);
+        }
+
+        ASSERT_EQ(bounds.children.size(), expected.children.size());
+        for (size_t i = 0; i < bounds.children.size(); ++i) {
+            expectSameBounds(bounds.children.at(i), expected.children.at(i));
+        }
+    }
+};
+
+TEST_F(Draw_BufferedPaintProviderTests, Bounds_BuiltFromFinishedData)
+{
+    //! GIVEN Recorded page
+    std::shared_ptr<BufferedPaintProvider> page = makePage(3);
+
+    //! CHECK Bounds are the same as calculated from the data
+    expectSameBounds(page->drawDataBounds(), DrawDataBounds::calculate(page->drawData()));
+
+    //! CHECK All primitives are indexed, the page is scaled
+    EXPECT_EQ(page->drawDataIndex().size(), primitivesCount(page->drawData()->item));
+    EXPECT_TRUE(page->drawDataIndex().rect().contains(RectF(20.0, 30.0, 960.0, 200.0)));
+    EXPECT_FALSE(page->drawDataIndex().rect().intersects(RectF(0.0, 300.0, 1000.0, 1000.0)));
+
+    //! CHECK The next target is indexed again
+    {
+        Painter painter(page, "page2");
+        painter.drawLine(0.0, 0.0, 10.0, 10.0);
+        painter.endDraw();
+    }
+    EXPECT_EQ(page->drawDataIndex().size(), 1);
+}
+
+TEST_F(Draw_BufferedPaintProviderTests, Bounds_TextWithoutFontProvider)
+{
+    //! GIVEN There is no font provider (not registered in these tests)
+
+    //! DO Record a text
+    auto provider = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(provider, "page");
+        painter.drawText(PointF(10.0, 10.0), String(u"text"));
+        painter.drawLine(0.0, 0.0, 10.0, 10.0);
+        painter.endDraw();
+    }
+
+    //! CHECK The text is recorded, its bounds are unknown, so it is painted for any clip
+    EXPECT_EQ(provider->drawDataIndex().size(), 2);
+
+    std::vector<size_t> hits;
+    provider->drawDataIndex().query(RectF(5000.0, 5000.0, 10.0, 10.0), hits);
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(provider->drawDataIndex().primitive(hits.front()).kind, DrawDataIndex::Kind::Text);
+}
+
+TEST_F(Draw_BufferedPaintProviderTests, Bounds_PolygonWithLastPathPen)
+{
+    //! GIVEN Data with a polygon and a path after it with a wide pen (as it can be read from a file)
+    auto data = std::make_shared<DrawData>();
+    data->states[0] = DrawData::State();
+    data->states[0].pen = Pen(Color::BLACK, 1.0);
+
+    DrawData::Data& d = data->item.datas.emplace_back();
+    d.state = 0;
+    d.polygons.push_back(DrawPolygon { PolygonF({ PointF(0.0, 0.0), PointF(10.0, 0.0), PointF(10.0, 10.0) }), PolygonMode::Polyline });
+
+    PainterPath path;
+    path.moveTo(100.0, 100.0);
+    path.lineTo(110.0, 110.0);
+    d.paths.push_back({ path, Pen(Color::BLACK, 20.0), Brush(), DrawMode::Stroke });
+
+    //! DO
+    DrawDataBounds::Item bounds = DrawDataBounds::calculate(data);
+
+    //! CHECK The polygon is painted with the pen of the last path, so its bounds include the wide stroke
+    ASSERT_EQ(bounds.datas.size(), 1);
+    ASSERT_EQ(bounds.datas.front().polygons.size(), 1);
+    EXPECT_TRUE(bounds.datas.front().polygons.front().contains(RectF(-20.0, -20.0, 50.0, 50.0)));
+}
+
+TEST_F(Draw_BufferedPaintProviderTests, Paint_FullClip)
+{
+    //! GIVEN Recorded page
+    std::shared_ptr<BufferedPaintProvider> page = makePage(3);
+
+    //! DO Full replay
+    auto expected = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(expected, "replay");
+        DrawDataPaint::paint(&painter, page->drawData());
+        painter.endDraw();
+    }
+
+    //! DO Replay with clip that covers the page
+    auto replayed = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(replayed, "replay");
+        page->paint(&painter, RectF(-1000.0, -1000.0, 10000.0, 10000.0));
+        painter.endDraw();
+    }
+
+    //! CHECK
+    EXPECT_EQ(primitivesCount(replayed->drawData()->item), primitivesCount(page->drawData()->item));
+    EXPECT_TRUE(DrawDataComp::compare(replayed->drawData(), expected->drawData()).empty());
+}
+
+TEST_F(Draw_BufferedPaintProviderTests, Paint_Clip)
+{
+    //! GIVEN Recorded page
+    std::shared_ptr<BufferedPaintProvider> page = makePage(3);
+    const RectF clip(200.0, 40.0, 100.0, 40.0);
+
+    //! DO Full replay
+    auto full = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(full, "replay");
+        DrawDataPaint::paint(&painter, page->drawData());
+        painter.endDraw();
+    }
+
+    //! DO Replay with small clip
+    auto replayed = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(replayed, "replay");
+        page->paint(&painter, clip);
+        painter.endDraw();
+    }
+
+    //! CHECK Only intersecting primitives are painted, and they are painted the same way
+    std::vector<size_t> hits;
+    page->drawDataIndex().query(clip, hits);
+    EXPECT_FALSE(hits.empty());
+    EXPECT_LT(hits.size(), page->drawDataIndex().size() / 10);
+    for (size_t idx : hits) {
+        EXPECT_TRUE(page->drawDataIndex().primitive(idx).rect.intersects(clip));
+    }
+
+    EXPECT_EQ(primitivesCount(replayed->drawData()->item), hits.size());
+
+    std::vector<DrawPath> fullPaths;
+    std::vector<DrawPolygon> fullPolygons;
+    collect(full->drawData()->item, fullPaths, fullPolygons);
+
+    std::vector<DrawPath> paths;
+    std::vector<DrawPolygon> polygons;
+    collect(replayed->drawData()->item, paths, polygons);
+
+    for (const DrawPath& p : paths) {
+        EXPECT_NE(std::find(fullPaths.begin(), fullPaths.end(), p), fullPaths.end());
+    }
+
+    for (const DrawPolygon& p : polygons) {
+        EXPECT_NE(std::find(fullPolygons.begin(), fullPolygons.end(), p), fullPolygons.end());
+    }
+}
+
+TEST_F(Draw_BufferedPaintProviderTests, DISABLED_Paint_ScrollZoomBenchmark)
+{
+    //! NOTE Large page, the view is scrolled and zoomed over it
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<BufferedPaintProvider> page = makePage(200);
+    auto record = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    const RectF pageRect = page->drawDataIndex().rect();
+    auto index = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "record: " << record.count() << " us, index on the first request: " << index.count() << " us" << std::endl;
+
+    auto replayed = std::make_shared<BufferedPaintProvider>();
+
+    for (double zoom : { 1.0, 4.0, 16.0 }) {
+        const double viewWidth = pageRect.width() / zoom;
+        const double viewHeight = viewWidth * 0.6;
+        const int frames = 50;
+
+        start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            Painter painter(replayed, "replay");
+            DrawDataPaint::paint(&painter, page->drawData());
+            painter.endDraw();
+        }
+        auto full = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) {
+            const double y = pageRect.top() + (pageRect.height() - viewHeight) * f / frames;
+            Painter painter(replayed, "replay");
+            page->paint(&painter, RectF(pageRect.left(), y, viewWidth, viewHeight));
+            painter.endDraw();
+        }
+        auto clipped = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "primitives: " << page->drawDataIndex().size() << ", zoom: " << zoom
+                  << ", full replay: " << full.count() / frames << " us/frame"
+                  << ", clip replay: " << clipped.count() / frames << " us/frame" << std::endl;
+    }
+}
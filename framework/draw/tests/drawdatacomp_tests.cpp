@@ -0,0 +1,186 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "draw/utils/drawdatacomp.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+class Draw_DrawDataCompTests : public ::testing::Test
+{
+public:
+
+    static DrawPath makeNoteHead(double x, double y)
+    {
+        DrawPath p;
+        p.path.moveTo(x, y);
+        p.path.cubicTo(x + 2.0, y - 3.0, x + 8.0, y - 3.0, x + 10.0, y);
+        p.path.cubicTo(x + 8.0, y + 3.0, x + 2.0, y + 3.0, x, y);
+        p.mode = DrawMode::Fill;
+        return p;
+    }
+
+    static DrawPolygon makeBeam(double x, double y)
+    {
+        DrawPolygon p;
+        p.polygon = PolygonF({ PointF(x, y), PointF(x + 40.0, y - 5.0), PointF(x + 40.0, y - 2.0), PointF(x, y + 3.0) });
+        return p;
+    }
+
+    static DrawText makeText(double x, double y, const String& text)
+    {
+        DrawText t;
+        t.mode = DrawText::Point;
+        t.rect = RectF(x, y, 0.0, 0.0);
+        t.text = text;
+        return t;
+    }
+
+    //! NOTE Synthetic page: systems of staves with notes, beams and texts
+    static DrawDataPtr makePage(size_t notes)
+    {
+        DrawDataPtr dd = std::make_shared<DrawData>();
+        dd->name = "page";
+        dd->viewport = RectF(0.0, 0.0, 2100.0, 2970.0);
+        dd->states[0] = DrawData::State();
+
+        const size_t perSystem = 200;
+        for (size_t i = 0; i < notes; ++i) {
+            const double x = 50.0 + static_cast<double>(i % perSystem) * 10.0;
+            const double y = 100.0 + static_cast<double>(i / perSystem) * 40.0 + static_cast<double>(i % 7) * 2.5;
+
+            DrawData::Item item("Note");
+            DrawData::Data data;
+            data.paths.push_back(makeNoteHead(x, y));
+            if (i % 4 == 0) {
+                data.polygons.push_back(makeBeam(x, y - 30.0));
+            }
+            if (i % 50 == 0) {
+                data.texts.push_back(makeText(x, y + 20.0, String(u"p")));
+            }
+            item.datas.push_back(data);
+
+            dd->item.chilren.push_back(item);
+        }
+
+        return dd;
+    }
+
+    static size_t primitivesCount(const DrawData::Item& item)
+    {
+        size_t count = 0;
+        for (const DrawData::Data& d : item.datas) {
+            count += d.paths.size() + d.polygons.size() + d.texts.size() + d.pixmaps.size();
+        }
+
+        for (const DrawData::Item& ch : item.chilren) {
+            count += primitivesCount(ch);
+        }
+
+        return count;
+    }
+};
+
+TEST_F(Draw_DrawDataCompTests, Compare_Equal)
+{
+    //! GIVEN Two identical pages
+    DrawDataPtr data = makePage(1000);
+    DrawDataPtr origin = makePage(1000);
+
+    //! DO
+    Diff diff = DrawDataComp::compare(data, origin);
+
+    //! CHECK
+    EXPECT_TRUE(diff.empty());
+}
+
+TEST_F(Draw_DrawDataCompTests, Compare_Moved)
+{
+    //! GIVEN Page with one moved note head
+    DrawDataPtr origin = makePage(1000);
+    DrawDataPtr data = makePage(1000);
+    data->item.chilren[500].datas[0].paths[0] = makeNoteHead(3.0, 4.0);
+
+    //! DO
+    Diff diff = DrawDataComp::compare(data, origin);
+
+    //! CHECK Old position is added, new position is removed
+    EXPECT_FALSE(diff.empty());
+    ASSERT_EQ(diff.dataAdded->item.chilren.size(), 1);
+    ASSERT_EQ(diff.dataRemoved->item.chilren.size(), 1);
+    EXPECT_EQ(primitivesCount(diff.dataAdded->item), 1);
+    EXPECT_EQ(primitivesCount(diff.dataRemoved->item), 1);
+    EXPECT_EQ(diff.dataAdded->item.chilren[0].datas[0].paths[0], origin->item.chilren[500].datas[0].paths[0]);
+    EXPECT_EQ(diff.dataRemoved->item.chilren[0].datas[0].paths[0], data->item.chilren[500].datas[0].paths[0]);
+}
+
+TEST_F(Draw_DrawDataCompTests, Compare_Tolerance)
+{
+    //! GIVEN Page with slightly shifted beam
+    DrawDataPtr origin = makePage(1000);
+    DrawDataPtr data = makePage(1000);
+    PolygonF& polygon = data->item.chilren[400].datas[0].polygons[0].polygon;
+    for (size_t i = 0; i < polygon.size(); ++i) {
+        polygon[i] += PointF(0.05, 0.05);
+    }
+
+    //! CHECK Without tolerance there is a difference
+    EXPECT_FALSE(DrawDataComp::compare(data, origin).empty());
+
+    //! CHECK With tolerance there is no difference
+    EXPECT_TRUE(DrawDataComp::compare(data, origin, DrawDataComp::Tolerance(0.1)).empty());
+}
+
+TEST_F(Draw_DrawDataCompTests, Compare_DifferentContent)
+{
+    //! GIVEN Page with changed text at the same position
+    DrawDataPtr origin = makePage(1000);
+    DrawDataPtr data = makePage(1000);
+    data->item.chilren[100].datas[0].texts[0].text = String(u"f");
+
+    //! DO
+    Diff diff = DrawDataComp::compare(data, origin);
+
+    //! CHECK
+    EXPECT_EQ(primitivesCount(diff.dataAdded->item), 1);
+    EXPECT_EQ(primitivesCount(diff.dataRemoved->item), 1);
+}
+
+TEST_F(Draw_DrawDataCompTests, DISABLED_Compare_Benchmark)
+{
+    for (size_t notes : { 5000, 20000, 80000 }) {
+        DrawDataPtr origin = makePage(notes);
+        DrawDataPtr data = makePage(notes);
+        data->item.chilren[notes / 2].datas[0].paths[0] = makeNoteHead(3.0, 4.0);
+
+        auto start = std::chrono::steady_clock::now();
+        Diff diff = DrawDataComp::compare(data, origin);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        EXPECT_EQ(primitivesCount(diff.dataAdded->item), 1);
+        std::cout << "primitives: " << primitivesCount(origin->item) << ", compare: " << elapsed.count() << " ms" << std::endl;
+    }
+}
@@ -25,6 +25,8 @@
 #include <QImage>
 
 #include "draw/painter.h"
+#include "draw/bufferedpaintprovider.h"
+#include "draw/utils/drawdatacomp.h"
 
 #include "draw/internal/qpainterprovider.h"
 
@@ -156,3 +158,29 @@ TEST_F(Draw_PainterTests, Painter_SaveRestore)
 
     EXPECT_EQ(painter.provider()->transform(), worldTransform * expectedViewTransform);
 }
+
+TEST_F(Draw_PainterTests, Painter_Extended)
+{
+    //! GIVEN Extended provider
+    auto extended = std::make_shared<BufferedPaintProvider>();
+    Painter::extended = extended;
+
+    //! DO Paint with an extended painter and a not extended one
+    auto provider = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(provider, "extended");
+        Painter notExtended(std::make_shared<BufferedPaintProvider>(), "notExtended", false);
+
+        //! DO Reset the extended provider while painting
+        Painter::extended = nullptr;
+
+        painter.drawLine(0.0, 0.0, 10.0, 10.0);
+        notExtended.drawLine(0.0, 0.0, 10.0, 10.0);
+        notExtended.endDraw();
+        painter.endDraw();
+    }
+
+    //! CHECK The extended provider is taken on construction, only the extended painter repeats the calls to it
+    EXPECT_EQ(extended->drawData()->name, "extended");
+    EXPECT_TRUE(DrawDataComp::compare(extended->drawData(), provider->drawData()).empty());
+}
@@ -0,0 +1,264 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+
+#include "draw/painter.h"
+#include "draw/bufferedpaintprovider.h"
+#include "draw/types/painterpath.h"
+#include "draw/types/transform.h"
+#include "draw/utils/drawdatabounds.h"
+
+#include "testing/heapcounter.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+class Draw_PainterPathTests : public ::testing::Test
+{
+public:
+
+    //! NOTE Dense page: staff lines, the same note head outline, stems, beams and unique slurs
+    static std::shared_ptr<BufferedPaintProvider> recordPage(size_t systems)
+    {
+        PainterPath noteHead;
+        noteHead.addEllipse(RectF(0.0, -4.0, 12.0, 8.0));
+
+        auto provider = std::make_shared<BufferedPaintProvider>();
+        Painter painter(provider, "page");
+        painter.setAntialiasing(true);
+
+        for (size_t s = 0; s < systems; ++s) {
+            const double top = 60.0 + static_cast<double>(s) * 180.0;
+
+            painter.beginObject("System");
+            for (int l = 0; l < 5; ++l) {
+                painter.drawLine(40.0, top + l * 10.0, 1960.0, top + l * 10.0);
+            }
+
+            for (size_t n = 0; n < 90; ++n) {
+                const double x = 80.0 + static_cast<double>(n) * 20.0;
+                const double y = top + static_cast<double>(n % 9) * 5.0;
+
+                painter.beginObject("Note");
+                painter.save();
+                painter.translate(x, y);
+                painter.drawPath(noteHead);
+                painter.restore();
+
+                painter.drawLine(x + 12.0, y, x + 12.0, y - 35.0);
+
+                if (n % 4 == 0) {
+                    PainterPath beam;
+                    beam.addRect(RectF(x + 11.0, y - 36.0, 62.0, 4.0));
+                    painter.drawPath(beam);
+                }
+
+                if (n % 8 == 0) {
+                    PainterPath slur;
+                    slur.moveTo(x, y + 10.0);
+                    slur.cubicTo(x + 20.0, y + 25.0, x + 120.0, y + 25.0, x + 140.0, y + 10.0);
+                    slur.cubicTo(x + 120.0, y + 22.0, x + 20.0, y + 22.0, x, y + 10.0);
+                    painter.drawPath(slur);
+                }
+                painter.endObject();
+            }
+            painter.endObject();
+        }
+
+        painter.endDraw();
+        return provider;
+    }
+};
+
+TEST_F(Draw_PainterPathTests, Storage_Inline)
+{
+    //! GIVEN Short and long paths
+    PainterPath line;
+    line.moveTo(0.0, 0.0);
+    line.lineTo(10.0, 10.0);
+
+    PainterPath rect;
+    rect.addRect(RectF(0.0, 0.0, 10.0, 10.0));
+
+    PainterPath ellipse;
+    ellipse.addEllipse(RectF(0.0, 0.0, 10.0, 10.0));
+
+    //! CHECK
+    EXPECT_TRUE(line.isInline());
+    EXPECT_TRUE(rect.isInline());
+    EXPECT_FALSE(ellipse.isInline());
+    EXPECT_EQ(rect.elementCount(), 5);
+    EXPECT_EQ(ellipse.elementCount(), 13);
+    EXPECT_EQ(rect.boundingRect(), RectF(0.0, 0.0, 10.0, 10.0));
+}
+
+TEST_F(Draw_PainterPathTests, Storage_CopyOnWrite)
+{
+    //! GIVEN Long path
+    PainterPath ellipse;
+    ellipse.addEllipse(RectF(0.0, 0.0, 10.0, 10.0));
+
+    //! DO Copy
+    PainterPath copy = ellipse;
+
+    //! CHECK Copy shares the elements
+    EXPECT_TRUE(copy.isSharedWith(ellipse));
+    EXPECT_EQ(copy, ellipse);
+
+    //! DO Modify the copy
+    copy.translate(5.0, 5.0);
+
+    //! CHECK The original is not changed
+    EXPECT_FALSE(copy.isSharedWith(ellipse));
+    EXPECT_EQ(ellipse.boundingRect(), RectF(0.0, 0.0, 10.0, 10.0));
+    EXPECT_EQ(copy.boundingRect(), RectF(5.0, 5.0, 10.0, 10.0));
+
+    //! DO Map copy of the original
+    PainterPath mapped = Transform().scale(2.0, 2.0).map(ellipse);
+
+    //! CHECK The original is not changed
+    EXPECT_EQ(ellipse.boundingRect(), RectF(0.0, 0.0, 10.0, 10.0));
+    EXPECT_EQ(mapped.boundingRect(), RectF(0.0, 0.0, 20.0, 20.0));
+
+    {
+        //! GIVEN Long closed polyline and its copy
+        PainterPath polyline;
+        polyline.moveTo(0.0, 0.0);
+        for (int i = 1; i <= 6; ++i) {
+            polyline.lineTo(i, i % 2);
+        }
+        polyline.lineTo(0.0, 0.0);
+        PainterPath polylineCopy = polyline;
+
+        //! DO Calls that only read the elements (the point is the same, already closed)
+        polylineCopy.lineTo(0.0, 0.0);
+        polylineCopy.closeSubpath();
+
+        //! CHECK Still shared
+        EXPECT_TRUE(polylineCopy.isSharedWith(polyline));
+        EXPECT_EQ(polylineCopy, polyline);
+    }
+}
+
+TEST_F(Draw_PainterPathTests, Flatten_Tolerance)
+{
+    //! GIVEN Circle and line
+    const double radius = 100.0;
+    PainterPath path;
+    path.addEllipse(RectF(-radius, -radius, 2 * radius, 2 * radius));
+    path.moveTo(200.0, 0.0);
+    path.lineTo(300.0, 0.0);
+
+    for (double tolerance : { 1.0, 0.25, 0.01 }) {
+        //! DO
+        std::vector<PolygonF> polygons = path.toSubpathPolygons(tolerance);
+
+        //! CHECK Subpaths are closed circle and line
+        ASSERT_EQ(polygons.size(), 2);
+        EXPECT_EQ(polygons.at(0).front(), polygons.at(0).back());
+        EXPECT_EQ(polygons.at(1).size(), 2);
+
+        //! CHECK Points and middles of segments are on the circle with the tolerance
+        //! (and the error of the circle approximation by cubics, about 0.03% of the radius)
+        const PolygonF& circle = polygons.at(0);
+        const double maxError = tolerance + radius * 0.0003;
+        for (size_t i = 1; i < circle.size(); ++i) {
+            PointF p = circle.at(i);
+            PointF m = (circle.at(i - 1) + circle.at(i)) / 2.0;
+            EXPECT_NEAR(std::hypot(p.x(), p.y()), radius, radius * 0.0003);
+            EXPECT_NEAR(std::hypot(m.x(), m.y()), radius, maxError);
+        }
+
+        //! CHECK Not too many segments
+        EXPECT_LT(circle.size(), 4 * std::sqrt(radius / tolerance) + 8);
+    }
+}
+
+TEST_F(Draw_PainterPathTests, Bounds_RotatedCurve)
+{
+    //! GIVEN Stroked circle, rotated by 45 degrees
+    DrawPath circle;
+    circle.path.addEllipse(RectF(-100.0, -100.0, 200.0, 200.0));
+    circle.pen = Pen(Color::BLACK, 2.0);
+    circle.mode = DrawMode::Stroke;
+
+    DrawData::State st;
+    st.transform.rotate(45.0);
+
+    //! DO
+    RectF bounds = DrawDataBounds::pathBounds(circle, st);
+
+    //! CHECK Covers the circle with the stroke, but not the rotated square around it (288 wide)
+    EXPECT_TRUE(bounds.contains(RectF(-101.0, -101.0, 202.0, 202.0)));
+    EXPECT_LT(bounds.width(), 215.0);
+    EXPECT_LT(bounds.height(), 215.0);
+}
+
+TEST_F(Draw_PainterPathTests, Record_SharedPaths)
+{
+    //! GIVEN Page with the same note head outline drawn many times
+    std::shared_ptr<BufferedPaintProvider> provider = recordPage(2);
+
+    //! CHECK All recorded note heads share the elements
+    const PainterPath* first = nullptr;
+    size_t shared = 0;
+    for (const DrawData::Item& system : provider->drawData()->item.chilren) {
+        for (const DrawData::Item& note : system.chilren) {
+            for (const DrawData::Data& d : note.datas) {
+                for (const DrawPath& p : d.paths) {
+                    if (p.path.elementCount() != 13) {
+                        continue;
+                    }
+                    if (!first) {
+                        first = &p.path;
+                    } else if (first->isSharedWith(p.path)) {
+                        ++shared;
+                    }
+                }
+            }
+        }
+    }
+
+    EXPECT_EQ(shared, 2 * 90 - 1);
+}
+
+TEST_F(Draw_PainterPathTests, DISABLED_Record_AllocationsBenchmark)
+{
+    const size_t systems = 200;
+
+    muse::testing::HeapCounter::start();
+    std::shared_ptr<BufferedPaintProvider> provider = recordPage(systems);
+    muse::testing::HeapCounter::Stats heap = muse::testing::HeapCounter::stop();
+
+    if (!muse::testing::HeapCounter::isAvailable()) {
+        std::cout << "the heap counter is not available" << std::endl;
+    }
+
+    std::cout << "systems: " << systems
+              << ", allocations: " << heap.allocs
+              << ", live bytes: " << heap.liveBytes
+              << ", sizeof(PainterPath): " << sizeof(PainterPath)
+              << ", sizeof(DrawPath): " << sizeof(DrawPath) << std::endl;
+}
@@ -0,0 +1,316 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <QImage>
+
+#include "modularity/ioc.h"
+
+#include "draw/painter.h"
+#include "draw/bufferedpaintprovider.h"
+#include "draw/internal/qfontprovider.h"
+#include "draw/internal/qimagetiledrenderer.h"
+#include "draw/utils/drawdatapaint.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+class Draw_QImageTiledRendererTests : public ::testing::Test
+{
+public:
+
+    //! NOTE Text bounds are calculated with the font metrics
+    void SetUp() override
+    {
+        globalIoc()->registerExport<IFontProvider>("tests", std::make_shared<QFontProvider>());
+    }
+
+    void TearDown() override
+    {
+        globalIoc()->unregister<IFontProvider>("tests");
+    }
+
+    //! NOTE Synthetic page: staff lines, note heads, stems and beams
+    static DrawDataPtr makePage(int systems)
+    {
+        DrawDataPtr dd = std::make_shared<DrawData>();
+        dd->name = "page";
+
+        DrawData::State st;
+        st.isAntialiasing = true;
+        st.transform.scale(0.5, 0.5);
+        dd->states[0] = st;
+
+        DrawData::State thick = st;
+        thick.pen = Pen(Color(20, 40, 200), 3.0);
+        thick.brush = Brush(Color(20, 40, 200));
+        dd->states[1] = thick;
+
+        for (int s = 0; s < systems; ++s) {
+            const double top = 60.0 + s * 180.0;
+
+            DrawData::Item staff("Staff");
+            DrawData::Data lines;
+            for (int l = 0; l < 5; ++l) {
+                DrawPath line;
+                line.path.moveTo(40.0, top + l * 15.0);
+                line.path.lineTo(1960.0, top + l * 15.0);
+                line.pen = Pen(Color::BLACK, 1.5);
+                line.mode = DrawMode::Stroke;
+                lines.paths.push_back(line);
+            }
+            staff.datas.push_back(lines);
+
+            for (int n = 0; n < 90; ++n) {
+                const double x = 80.0 + n * 20.5;
+                const double y = top + (n % 9) * 7.5;
+
+                DrawData::Item note("Note");
+                DrawData::Data head;
+                DrawPath p;
+                p.path.addEllipse(RectF(x, y - 5.0, 14.0, 10.0));
+                p.brush = Brush(Color::BLACK);
+                p.mode = DrawMode::Fill;
+                head.paths.push_back(p);
+                note.datas.push_back(head);
+
+                DrawData::Data stem;
+                stem.state = 1;
+                DrawPolygon beam;
+                beam.polygon = PolygonF({ PointF(x + 13.0, y), PointF(x + 15.0, y), PointF(x + 15.0, y - 50.0),
+                                          PointF(x + 13.0, y - 50.0) });
+                stem.polygons.push_back(beam);
+                note.datas.push_back(stem);
+
+                staff.chilren.push_back(note);
+            }
+
+            dd->item.chilren.push_back(staff);
+        }
+
+        return dd;
+    }
+
+    //! NOTE Texts and pixmaps crossing the tile borders, with a fractional state transform
+    static DrawDataPtr makeTextPage()
+    {
+        DrawDataPtr dd = std::make_shared<DrawData>();
+        dd->name = "texts";
+
+        DrawData::State st;
+        st.isAntialiasing = true;
+        st.pen = Pen(Color(30, 30, 30), 1.0);
+        st.font.setPointSizeF(15.0);
+        st.transform.translate(10.5, 20.25);
+        st.transform.scale(0.75, 0.75);
+        dd->states[0] = st;
+
+        DrawData::State italic = st;
+        italic.font.setItalic(true);
+        italic.transform = Transform();
+        dd->states[1] = italic;
+
+        QImage source(37, 23, QImage::Format_ARGB32);
+        for (int y = 0; y < source.height(); ++y) {
+            for (int x = 0; x < source.width(); ++x) {
+                source.setPixel(x, y, qRgba(x * 7, y * 11, (x + y) * 4, 128 + (x * y) % 128));
+            }
+        }
+        const Pixmap pm = Pixmap::fromQImage(source);
+
+        for (int i = 0; i < 60; ++i) {
+            const double x = 30.0 + (i % 10) * 97.3;
+            const double y = 40.0 + (i / 10) * 123.7;
+
+            DrawData::Item item("Text");
+            DrawData::Data scaled;
+
+            DrawText point;
+            point.mode = DrawText::Point;
+            point.rect = RectF(x, y, 0.0, 0.0);
+            point.text = String(u"Allegro \u2669 = 120");
+            scaled.texts.push_back(point);
+
+            DrawPixmap px;
+            px.mode = DrawPixmap::Single;
+            px.rect = RectF(x + 40.0, y + 60.0, 0.0, 0.0);
+            px.pm = pm;
+            scaled.pixmaps.push_back(px);
+            item.datas.push_back(scaled);
+
+            DrawData::Data plain;
+            plain.state = 1;
+
+            DrawText rect;
+            rect.mode = DrawText::Rect;
+            rect.rect = RectF(x, y + 30.0, 90.0, 40.0);
+            rect.flags = static_cast<int>(AlignCenter) | TextDontClip;
+            rect.text = String(u"pizz. \u00E9");
+            plain.texts.push_back(rect);
+
+            px.rect = RectF(x + 3.0, y + 5.0, 0.0, 0.0);
+            plain.pixmaps.push_back(px);
+            item.datas.push_back(plain);
+
+            dd->item.chilren.push_back(item);
+        }
+
+        return dd;
+    }
+
+    static QImage makeImage(double dpr = 1.0)
+    {
+        QImage image(1003, 1419, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(dpr);
+        image.fill(Qt::white);
+        return image;
+    }
+
+    static QImage paintSerial(const DrawDataPtr& data, const Color& overlay = Color(), double dpr = 1.0)
+    {
+        QImage image = makeImage(dpr);
+        Painter painter(&image, "serial");
+        DrawDataPaint::paint(&painter, data, overlay);
+        painter.endDraw();
+        return image;
+    }
+};
+
+TEST_F(Draw_QImageTiledRendererTests, Render_SameAsSerial)
+{
+    //! GIVEN Page and serially rendered image
+    DrawDataPtr data = makePage(15);
+    QImage expected = paintSerial(data);
+
+    //! DO Render by tiles that don't fit the image size
+    QImageTiledRenderer renderer(4, 100);
+    QImage image = makeImage();
+    renderer.render(image, data);
+
+    //! CHECK
+    EXPECT_EQ(image, expected);
+}
+
+TEST_F(Draw_QImageTiledRendererTests, Render_NotExtended)
+{
+    //! GIVEN Page, and the extended provider is set
+    DrawDataPtr data = makePage(15);
+    QImage expected = paintSerial(data);
+
+    auto extended = std::make_shared<BufferedPaintProvider>();
+    Painter::extended = extended;
+
+    //! DO Render by tiles on worker threads
+    QImageTiledRenderer renderer(4, 100);
+    QImage image = makeImage();
+    renderer.render(image, data);
+
+    Painter::extended = nullptr;
+
+    //! CHECK The tile painters don't use the extended provider (it isn't thread-safe)
+    EXPECT_EQ(image, expected);
+    EXPECT_TRUE(extended->drawData()->item.datas.empty());
+}
+
+TEST_F(Draw_QImageTiledRendererTests, Render_Overlay)
+{
+    //! GIVEN Page and serially rendered image with overlay color
+    DrawDataPtr data = makePage(15);
+    Color overlay(200, 0, 0);
+    QImage expected = paintSerial(data, overlay);
+
+    //! DO
+    QImageTiledRenderer renderer(3, 128);
+    QImage image = makeImage();
+    renderer.render(image, data, overlay);
+
+    //! CHECK
+    EXPECT_EQ(image, expected);
+}
+
+TEST_F(Draw_QImageTiledRendererTests, Render_TextsAndPixmaps)
+{
+    //! GIVEN Texts and pixmaps and serially rendered image
+    DrawDataPtr data = makeTextPage();
+    QImage expected = paintSerial(data);
+
+    //! DO Render by tiles, the texts and pixmaps are clipped and offset by the tiles
+    QImageTiledRenderer renderer(4, 64);
+    QImage image = makeImage();
+    renderer.render(image, data);
+
+    //! CHECK
+    EXPECT_EQ(image, expected);
+}
+
+TEST_F(Draw_QImageTiledRendererTests, Render_DevicePixelRatio)
+{
+    //! GIVEN Pages and serially rendered images with device pixel ratio
+    for (const DrawDataPtr& data : { makePage(8), makeTextPage() }) {
+        QImage expected = paintSerial(data, Color(), 2.0);
+
+        //! DO
+        QImageTiledRenderer renderer(4, 100);
+        QImage image = makeImage(2.0);
+        renderer.render(image, data);
+
+        //! CHECK
+        EXPECT_EQ(image, expected);
+    }
+}
+
+TEST_F(Draw_QImageTiledRendererTests, Bounds_Culling)
+{
+    //! GIVEN Page with one system
+    DrawDataPtr data = makePage(1);
+
+    //! DO
+    DrawDataBounds::Item bounds = DrawDataBounds::calculate(data);
+
+    //! CHECK Bounds follow the item tree and cover the staff (with the state scale)
+    ASSERT_EQ(bounds.children.size(), 1);
+    EXPECT_EQ(bounds.children.at(0).children.size(), 90);
+    EXPECT_TRUE(bounds.rect.contains(RectF(20.0, 30.0, 960.0, 30.0)));
+    EXPECT_FALSE(bounds.rect.intersects(RectF(0.0, 200.0, 1000.0, 1000.0)));
+}
+
+TEST_F(Draw_QImageTiledRendererTests, DISABLED_Render_Benchmark)
+{
+    DrawDataPtr data = makePage(15);
+
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        QImageTiledRenderer renderer(threads);
+        QImage image = makeImage();
+
+        const int iterations = 20;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            renderer.render(image, data);
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "threads: " << renderer.threadCount() << ", pages/s: " << iterations * 1000.0 / elapsed << std::endl;
+    }
+}
@@ -0,0 +1,254 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+
+#include <QImage>
+#include <QPainter>
+#include <QPicture>
+#include <QSvgRenderer>
+
+#include "draw/painter.h"
+#include "draw/svgrenderer.h"
+#include "draw/internal/svgrendercache.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+static const char* ICON_SVG
+    = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\" viewBox=\"0 0 24 24\">"
+      "<circle cx=\"12\" cy=\"12\" r=\"9\" fill=\"none\" stroke=\"#2060C0\" stroke-width=\"2\"/>"
+      "<path d=\"M7 12 L11 16 L17 8\" fill=\"none\" stroke=\"#20A040\" stroke-width=\"2.5\"/>"
+      "<rect x=\"4\" y=\"4\" width=\"3\" height=\"3\" fill=\"#C02020\"/>"
+      "</svg>";
+
+static const char* SQUARE_SVG
+    = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\" viewBox=\"0 0 24 24\">"
+      "<rect x=\"2\" y=\"2\" width=\"20\" height=\"20\" fill=\"#20A040\"/>"
+      "</svg>";
+
+class Draw_SvgRendererTests : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        SvgRenderCache::instance()->clear();
+        SvgRenderCache::instance()->setByteBudget(SvgRenderCache::DEFAULT_BYTE_BUDGET);
+    }
+
+    static QImage makeImage(int w = 200, int h = 200)
+    {
+        QImage image(w, h, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+        return image;
+    }
+};
+
+TEST_F(Draw_SvgRendererTests, Render_SameAsDirect)
+{
+    //! GIVEN Icon
+    ByteArray data(ICON_SVG);
+    const RectF rect(10.0, 20.0, 48.0, 48.0);
+
+    //! DO Render directly
+    QImage expected = makeImage();
+    {
+        QSvgRenderer qsvg(data.toQByteArray());
+        QImage icon(48, 48, QImage::Format_ARGB32_Premultiplied);
+        icon.fill(Qt::transparent);
+        {
+            QPainter qp(&icon);
+            qp.setRenderHint(QPainter::Antialiasing);
+            qp.setRenderHint(QPainter::SmoothPixmapTransform);
+            qsvg.render(&qp, QRectF(0, 0, 48, 48));
+        }
+        QPainter qp(&expected);
+        qp.drawImage(QPointF(10.0, 20.0), icon);
+    }
+
+    //! DO Render with cache twice
+    QImage image = makeImage();
+    {
+        Painter painter(&image, "test");
+        SvgRenderer renderer(data);
+        renderer.render(&painter, rect);
+        renderer.render(&painter, rect);
+        painter.endDraw();
+    }
+
+    //! CHECK
+    EXPECT_EQ(image, expected);
+
+    SvgRenderCache::Stats stats = SvgRenderCache::instance()->stats();
+    EXPECT_EQ(stats.documents, 1);
+    EXPECT_EQ(stats.images, 1);
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.hits, 1);
+}
+
+TEST_F(Draw_SvgRendererTests, Cache_DocumentShared)
+{
+    //! GIVEN Two renderers with the same data
+    ByteArray data(ICON_SVG);
+    SvgRenderer r1(data);
+    SvgRenderer r2(ByteArray(ICON_SVG));
+
+    //! CHECK The document is parsed once
+    EXPECT_EQ(SvgRenderCache::instance()->stats().documents, 1);
+    EXPECT_EQ(r1.defaultSize(), SizeF(24.0, 24.0));
+    EXPECT_EQ(r2.defaultSize(), SizeF(24.0, 24.0));
+}
+
+TEST_F(Draw_SvgRendererTests, Cache_Eviction)
+{
+    //! GIVEN Cache for two 32x32 images
+    SvgRenderCache cache(2 * 32 * 32 * 4);
+    SvgDocumentPtr doc = cache.document(ByteArray(ICON_SVG));
+
+    //! DO
+    cache.image(doc, QSize(32, 32), 1.0);
+    cache.image(doc, QSize(32, 32), 2.0);
+    cache.image(doc, QSize(32, 32), 1.0);  // hit, becomes recently used
+    cache.image(doc, QSize(32, 33), 1.0);  // evicts dpr 2.0
+
+    //! CHECK
+    SvgRenderCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.images, 2);
+    EXPECT_EQ(stats.hits, 1);
+    EXPECT_EQ(stats.evictions, 1);
+    EXPECT_LE(stats.bytes, cache.byteBudget());
+
+    cache.image(doc, QSize(32, 32), 1.0);
+    EXPECT_EQ(cache.stats().hits, 2);
+
+    cache.image(doc, QSize(32, 32), 2.0);
+    EXPECT_EQ(cache.stats().misses, 4);
+}
+
+TEST_F(Draw_SvgRendererTests, Cache_ImagesByDocument)
+{
+    //! GIVEN Two different documents
+    SvgRenderCache cache;
+    SvgDocumentPtr doc1 = cache.document(ByteArray(ICON_SVG));
+    SvgDocumentPtr doc2 = cache.document(ByteArray(SQUARE_SVG));
+
+    //! DO Rasterise both at the same size
+    QImage image1 = cache.image(doc1, QSize(32, 32), 1.0);
+    QImage image2 = cache.image(doc2, QSize(32, 32), 1.0);
+
+    //! CHECK Each document has its own image
+    SvgRenderCache::Stats stats = cache.stats();
+    EXPECT_EQ(stats.images, 2);
+    EXPECT_EQ(stats.misses, 2);
+    EXPECT_NE(image1, image2);
+    EXPECT_EQ(cache.image(doc1, QSize(32, 32), 1.0), image1);
+    EXPECT_EQ(cache.image(doc2, QSize(32, 32), 1.0), image2);
+}
+
+TEST_F(Draw_SvgRendererTests, Render_RotatedNotCached)
+{
+    //! GIVEN Rotated painter
+    QImage image = makeImage();
+    Painter painter(&image, "test");
+    painter.rotate(30.0);
+
+    //! DO
+    SvgRenderer renderer(ByteArray(ICON_SVG));
+    renderer.render(&painter, RectF(50.0, 0.0, 48.0, 48.0));
+    painter.endDraw();
+
+    //! CHECK
+    EXPECT_EQ(SvgRenderCache::instance()->stats().images, 0);
+    EXPECT_NE(image, makeImage());
+}
+
+TEST_F(Draw_SvgRendererTests, Render_VectorDeviceNotCached)
+{
+    //! GIVEN Painter on a vector device
+    QPicture picture;
+    Painter painter(&picture, "test");
+
+    //! DO
+    SvgRenderer renderer(ByteArray(ICON_SVG));
+    renderer.render(&painter, RectF(10.5, 20.25, 48.0, 48.0));
+    painter.endDraw();
+
+    //! CHECK The document is drawn as vectors, not as an image
+    EXPECT_EQ(SvgRenderCache::instance()->stats().images, 0);
+    EXPECT_FALSE(picture.boundingRect().isEmpty());
+}
+
+TEST_F(Draw_SvgRendererTests, Cache_ReleaseInstance)
+{
+    //! GIVEN Renderer with a cached document
+    SvgRenderer renderer(ByteArray(ICON_SVG));
+    ASSERT_EQ(SvgRenderCache::instance()->stats().documents, 1);
+
+    //! DO Release the cache (the draw module does it on deinit)
+    SvgRenderCache::releaseInstance();
+
+    //! CHECK The renderer keeps its document, the new cache is empty
+    EXPECT_EQ(renderer.defaultSize(), SizeF(24.0, 24.0));
+    EXPECT_EQ(SvgRenderCache::instance()->stats().documents, 0);
+}
+
+TEST_F(Draw_SvgRendererTests, DISABLED_Render_IconsBenchmark)
+{
+    //! NOTE Toolbar-like repainting: the same icon at a few sizes many times
+    ByteArray data(ICON_SVG);
+    QImage image = makeImage(1000, 200);
+    const int iterations = 200;
+    const int icons = 40;
+
+    auto iconRect = [](int n) {
+        const double size = 16.0 + 8.0 * (n % 3);
+        return RectF(n * 24.0, (n % 3) * 40.0, size, size);
+    };
+
+    // parse and render on every call
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        QPainter qp(&image);
+        for (int n = 0; n < icons; ++n) {
+            QSvgRenderer qsvg(data.toQByteArray());
+            qsvg.render(&qp, iconRect(n).toQRectF());
+        }
+    }
+    auto direct = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        Painter painter(&image, "bench");
+        for (int n = 0; n < icons; ++n) {
+            SvgRenderer renderer(data);
+            renderer.render(&painter, iconRect(n));
+        }
+        painter.endDraw();
+    }
+    auto cached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::cout << "direct: " << direct.count() / double(iterations * icons) << " us/icon"
+              << ", cached: " << cached.count() / double(iterations * icons) << " us/icon" << std::endl;
+}
@@ -21,6 +21,10 @@
  */
 
 #include "bezier.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "global/realfn.h"
 
 using namespace muse;
@@ -106,3 +110,59 @@ PointF Bezier::pointAt(double t) const
     }
     return PointF(x, y);
 }
+
+void Bezier::addToPolygon(PolygonF& polygon, double tolerance) const
+{
+    //! NOTE The number of segments by Wang's formula, the points are calculated by forward differencing
+    static constexpr int MAX_SEGMENTS = 1024;
+
+    const double ddx = std::max(std::fabs(m_x1 - 2 * m_x2 + m_x3), std::fabs(m_x2 - 2 * m_x3 + m_x4));
+    const double ddy = std::max(std::fabs(m_y1 - 2 * m_y2 + m_y3), std::fabs(m_y2 - 2 * m_y3 + m_y4));
+    const double dd = std::sqrt(ddx * ddx + ddy * ddy);
+
+    int segments = 1;
+    if (tolerance > 0.0 && dd > 0.0) {
+        segments = static_cast<int>(std::ceil(std::sqrt(0.75 * dd / tolerance)));
+        segments = std::clamp(segments, 1, MAX_SEGMENTS);
+    }
+
+    if (segments == 1) {
+        polygon.push_back(pt4());
+        return;
+    }
+
+    // B(t) = a*t^3 + b*t^2 + c*t + d
+    const double ax = -m_x1 + 3 * m_x2 - 3 * m_x3 + m_x4;
+    const double ay = -m_y1 + 3 * m_y2 - 3 * m_y3 + m_y4;
+    const double bx = 3 * m_x1 - 6 * m_x2 + 3 * m_x3;
+    const double by = 3 * m_y1 - 6 * m_y2 + 3 * m_y3;
+    const double cx = 3 * (m_x2 - m_x1);
+    const double cy = 3 * (m_y2 - m_y1);
+
+    const double h = 1.0 / segments;
+    const double h2 = h * h;
+    const double h3 = h2 * h;
+
+    double x = m_x1;
+    double y = m_y1;
+    double d1x = ax * h3 + bx * h2 + cx * h;
+    double d1y = ay * h3 + by * h2 + cy * h;
+    double d2x = 6 * ax * h3 + 2 * bx * h2;
+    double d2y = 6 * ay * h3 + 2 * by * h2;
+    const double d3x = 6 * ax * h3;
+    const double d3y = 6 * ay * h3;
+
+    polygon.reserve(polygon.size() + segments);
+    for (int i = 1; i < segments; ++i) {
+        x += d1x;
+        y += d1y;
+        d1x += d2x;
+        d1y += d2y;
+        d2x += d3x;
+        d2y += d3y;
+        polygon.push_back(PointF(x, y));
+    }
+
+    // exactly the end point
+    polygon.push_back(pt4());
+}
@@ -43,6 +43,10 @@ public:
 
     PointF pointAt(double t) const;
 
+    //! NOTE Appends the curve approximated by lines (without the start point),
+    //! the distance to the curve is not more than the tolerance
+    void addToPolygon(PolygonF& polygon, double tolerance = 0.25) const;
+
 private:
     void parameterSplitLeft(double t, Bezier* left);
 
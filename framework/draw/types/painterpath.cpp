@@ -48,8 +48,9 @@ void PainterPath::moveTo(const PointF& p)
     assert(!m_elements.empty());
     m_requireMoveTo = false;
     if (m_elements.back().type == ElementType::MoveToElement) {
-        m_elements.back().x = p.x();
-        m_elements.back().y = p.y();
+        Element& last = m_elements.mutBack();
+        last.x = p.x();
+        last.y = p.y();
     } else {
         m_elements.push_back({ p.x(), p.y(), ElementType::MoveToElement });
     }
@@ -117,7 +118,7 @@ void PainterPath::translate(double dx, double dy)
     }
 
     setDirty();
-    PainterPath::Element* element = m_elements.data();
+    PainterPath::Element* element = m_elements.mutData();
     assert(element);
     while (m_elementsLeft--) {
         element->x += dx;
@@ -352,12 +353,13 @@ void PainterPath::closeSubpath()
     }
     setDirty();
     m_requireMoveTo = true;
-    const Element& first = m_elements.at(m_cStart);
-    Element& last = m_elements.back();
+    const Element first = m_elements.at(m_cStart);
+    const Element& last = m_elements.back();
     if (first.x != last.x || first.y != last.y) {
         if (RealIsEqual(first.x, last.x) && RealIsEqual(first.y, last.y)) {
-            last.x = first.x;
-            last.y = first.y;
+            Element& mutLast = m_elements.mutBack();
+            mutLast.x = first.x;
+            mutLast.y = first.y;
         } else {
             m_elements.push_back({ first.x, first.y, ElementType::LineToElement });
         }
@@ -382,11 +384,49 @@ void PainterPath::setFillRule(PainterPath::FillRule fillRule)
 void PainterPath::ensureData()
 {
     if (m_elements.empty()) {
-        m_elements.reserve(16);
         m_elements.push_back({ 0, 0, ElementType::MoveToElement });
     }
 }
 
+std::vector<PolygonF> PainterPath::toSubpathPolygons(double tolerance) const
+{
+    std::vector<PolygonF> polygons;
+    PolygonF current;
+
+    const size_t count = m_elements.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Element& e = m_elements[i];
+        switch (e.type) {
+        case ElementType::MoveToElement:
+            if (current.size() > 1) {
+                polygons.push_back(std::move(current));
+            }
+            current = PolygonF();
+            current.push_back(e);
+            break;
+        case ElementType::LineToElement:
+            current.push_back(e);
+            break;
+        case ElementType::CurveToElement: {
+            IF_ASSERT_FAILED(i > 0 && i + 2 < count) {
+                break;
+            }
+            Bezier b = Bezier::fromPoints(m_elements[i - 1], e, m_elements[i + 1], m_elements[i + 2]);
+            b.addToPolygon(current, tolerance);
+            i += 2;
+        } break;
+        case ElementType::CurveToDataElement:
+            break;
+        }
+    }
+
+    if (current.size() > 1) {
+        polygons.push_back(std::move(current));
+    }
+
+    return polygons;
+}
+
 bool PainterPath::hasValidCoords(const PointF& p)
 {
     return isValidCoord(p.x()) && isValidCoord(p.y());
@@ -23,7 +23,11 @@
 #ifndef MUSE_DRAW_PAINTERPATH_H
 #define MUSE_DRAW_PAINTERPATH_H
 
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 #include "global/realfn.h"
 
@@ -128,6 +132,13 @@ public:
     PainterPath::FillRule fillRule() const;
     void setFillRule(PainterPath::FillRule fillRule);
 
+    //! NOTE Short paths are stored inline, longer ones are shared between copies until modified
+    bool isInline() const { return m_elements.isInline(); }
+    bool isSharedWith(const PainterPath& other) const { return m_elements.isSharedWith(other.m_elements); }
+
+    //! NOTE Approximates curves by lines, the distance to the curve is not more than the tolerance
+    std::vector<PolygonF> toSubpathPolygons(double tolerance = 0.25) const;
+
 #ifndef NO_QT_SUPPORT
     QPainterPath toQPainterPath() const { return toQPainterPath(*this); }
     static QPainterPath toQPainterPath(const PainterPath& path);
@@ -135,6 +146,80 @@ public:
 
 private:
 
+    //! NOTE Small buffer and copy-on-write storage of elements
+    class Elements
+    {
+    public:
+        static constexpr size_t INLINE_CAPACITY = 5; // line, rect
+
+        bool empty() const { return size() == 0; }
+        size_t size() const { return m_shared ? m_shared->size() : m_size; }
+
+        //! NOTE Reading never detaches, only the explicit mut* accessors do
+        const Element* data() const { return m_shared ? m_shared->data() : m_inline.data(); }
+        Element* mutData() { detach(); return m_shared ? m_shared->data() : m_inline.data(); }
+
+        const Element& at(size_t i) const { assert(i < size()); return data()[i]; }
+        const Element& operator[](size_t i) const { return data()[i]; }
+        const Element& front() const { return at(0); }
+        const Element& back() const { return at(size() - 1); }
+        Element& mutBack() { return mutData()[size() - 1]; }
+
+        void push_back(const Element& e)
+        {
+            if (!m_shared && m_size < INLINE_CAPACITY) {
+                m_inline[m_size++] = e;
+                return;
+            }
+
+            detach();
+            if (!m_shared) {
+                m_shared = std::make_shared<std::vector<Element> >();
+                m_shared->reserve(16);
+                m_shared->assign(m_inline.begin(), m_inline.begin() + m_size);
+                m_size = 0;
+            }
+            m_shared->push_back(e);
+        }
+
+        bool isInline() const { return !m_shared; }
+        bool isSharedWith(const Elements& o) const { return m_shared && m_shared == o.m_shared; }
+
+        bool operator==(const Elements& o) const
+        {
+            if (isSharedWith(o)) {
+                return true;
+            }
+
+            const size_t count = size();
+            if (count != o.size()) {
+                return false;
+            }
+
+            const Element* d1 = data();
+            const Element* d2 = o.data();
+            for (size_t i = 0; i < count; ++i) {
+                if (d1[i] != d2[i]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+
+        void detach()
+        {
+            if (m_shared && m_shared.use_count() > 1) {
+                m_shared = std::make_shared<std::vector<Element> >(*m_shared);
+            }
+        }
+
+        std::array<Element, INLINE_CAPACITY> m_inline;
+        size_t m_size = 0; // inline
+        std::shared_ptr<std::vector<Element> > m_shared;
+    };
+
     void ensureData();
 
     void computeBoundingRect() const;
@@ -175,7 +260,7 @@ private:
     bool m_convex = false;
     FillRule m_fillRule = FillRule::OddEvenFill;
 
-    std::vector<Element> m_elements;
+    Elements m_elements;
 
     friend class Transform;
 };
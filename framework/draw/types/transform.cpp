@@ -442,9 +442,10 @@ PainterPath Transform::map(const PainterPath& path) const
     if (t == TransformationType::Translate) {
         copy.translate(m_affine.m_dx, m_affine.m_dy);
     } else {
-        // Full xform
+        // Full xform, detaches the shared elements once
+        PainterPath::Element* elements = copy.m_elements.mutData();
         for (size_t i = 0; i < path.elementCount(); ++i) {
-            PainterPath::Element& e = copy.m_elements[i];
+            PainterPath::Element& e = elements[i];
             mapElement(e.x, e.y, t);
         }
 
@@ -0,0 +1,186 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "drawdatabounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../fontmetrics.h"
+#include "../ifontprovider.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+//! NOTE Margin in device pixels for antialiasing
+static constexpr double AA_MARGIN = 2.0;
+
+static double strokeMargin(const Pen& pen)
+{
+    if (pen.style() == PenStyle::NoPen) {
+        return 0.0;
+    }
+
+    //! NOTE Miter joins can stick out up to the miter limit (2 by default) of half of the width
+    return pen.widthF();
+}
+
+static RectF deviceRect(const RectF& logical, double margin, const Transform& transform)
+{
+    return transform.map(logical.padded(margin)).padded(AA_MARGIN);
+}
+
+//! NOTE Curves are flattened with this tolerance (in logical units) for the bounds under rotation
+static constexpr double FLATTEN_TOLERANCE = 0.5;
+
+static bool isRotatingAffine(const Transform& transform)
+{
+    return (!RealIsNull(transform.m12()) || !RealIsNull(transform.m21()))
+           && RealIsNull(transform.m13()) && RealIsNull(transform.m23());
+}
+
+RectF DrawDataBounds::pathBounds(const DrawPath& path, const DrawData::State& st)
+{
+    const Transform& t = st.transform;
+    const double margin = strokeMargin(path.pen);
+    if (!isRotatingAffine(t)) {
+        return deviceRect(path.path.boundingRect(), margin, t);
+    }
+
+    //! NOTE The mapped bounding rect of a rotated curve is loose (up to 41% wider for a circle at 45 degrees),
+    //! the mapped flattened curve is not
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+    for (const PolygonF& polygon : path.path.toSubpathPolygons(FLATTEN_TOLERANCE)) {
+        for (const PointF& p : polygon) {
+            const PointF m = t.map(p);
+            minX = std::min(minX, m.x());
+            minY = std::min(minY, m.y());
+            maxX = std::max(maxX, m.x());
+            maxY = std::max(maxY, m.y());
+        }
+    }
+
+    if (minX > maxX) {
+        return deviceRect(path.path.boundingRect(), margin, t);
+    }
+
+    // the largest stretch of the transform is not more than the Frobenius norm
+    const double scale = std::sqrt(t.m11() * t.m11() + t.m12() * t.m12() + t.m21() * t.m21() + t.m22() * t.m22());
+    return RectF(minX, minY, maxX - minX, maxY - minY).padded((margin + FLATTEN_TOLERANCE) * scale + AA_MARGIN);
+}
+
+//! NOTE Polygons are painted with the pen of the last path of the data, if there are paths (see DrawDataPaint),
+//! so the data must be finished
+RectF DrawDataBounds::polygonBounds(const DrawPolygon& polygon, const DrawData::Data& data, const DrawData::State& st)
+{
+    const double margin = strokeMargin(data.paths.empty() ? st.pen : data.paths.back().pen);
+
+    return deviceRect(polygon.polygon.boundingRect(), margin, st.transform);
+}
+
+RectF DrawDataBounds::textBounds(const DrawText& text, const DrawData::State& st)
+{
+    RectF br = FontMetrics::boundingRect(st.font, text.text);
+
+    //! NOTE Glyphs can overhang the metrics (italic, accents), so extend by the text height
+    RectF r;
+    if (text.mode == DrawText::Point) {
+        r = br.translated(text.rect.topLeft()).padded(br.height());
+    } else {
+        r = text.rect.adjusted(-br.width(), -br.height(), br.width(), br.height());
+    }
+
+    return deviceRect(r, 0.0, st.transform);
+}
+
+RectF DrawDataBounds::pixmapBounds(const DrawPixmap& pixmap, const DrawData::State& st)
+{
+    if (pixmap.mode == DrawPixmap::Single) {
+        return deviceRect(RectF(pixmap.rect.topLeft(), SizeF(pixmap.pm.width(), pixmap.pm.height())), 0.0, st.transform);
+    }
+
+    return deviceRect(pixmap.rect, 0.0, st.transform);
+}
+
+RectF DrawDataBounds::unbounded()
+{
+    //! NOTE Not infinite, so that it can be safely united, mapped and intersected
+    static constexpr double HALF = 1e12;
+    return RectF(-HALF, -HALF, 2 * HALF, 2 * HALF);
+}
+
+static void dataBounds(DrawDataBounds::Data& bounds, const DrawData::Data& d, const DrawData::State& st, bool hasFonts)
+{
+    bounds.paths.reserve(d.paths.size());
+    for (const DrawPath& path : d.paths) {
+        bounds.paths.push_back(DrawDataBounds::pathBounds(path, st));
+        bounds.rect.unite(bounds.paths.back());
+    }
+
+    bounds.polygons.reserve(d.polygons.size());
+    for (const DrawPolygon& pl : d.polygons) {
+        bounds.polygons.push_back(DrawDataBounds::polygonBounds(pl, d, st));
+        bounds.rect.unite(bounds.polygons.back());
+    }
+
+    bounds.texts.reserve(d.texts.size());
+    for (const DrawText& t : d.texts) {
+        bounds.texts.push_back(hasFonts ? DrawDataBounds::textBounds(t, st) : DrawDataBounds::unbounded());
+        bounds.rect.unite(bounds.texts.back());
+    }
+
+    bounds.pixmaps.reserve(d.pixmaps.size());
+    for (const DrawPixmap& px : d.pixmaps) {
+        bounds.pixmaps.push_back(DrawDataBounds::pixmapBounds(px, st));
+        bounds.rect.unite(bounds.pixmaps.back());
+    }
+}
+
+static void itemBounds(DrawDataBounds::Item& bounds, const DrawData::Item& item, const std::map<int, DrawData::State>& states,
+                       bool hasFonts)
+{
+    bounds.datas.resize(item.datas.size());
+    for (size_t i = 0; i < item.datas.size(); ++i) {
+        const DrawData::Data& d = item.datas.at(i);
+        dataBounds(bounds.datas.at(i), d, states.at(d.state), hasFonts);
+        bounds.rect.unite(bounds.datas.at(i).rect);
+    }
+
+    bounds.children.resize(item.chilren.size());
+    for (size_t i = 0; i < item.chilren.size(); ++i) {
+        itemBounds(bounds.children.at(i), item.chilren.at(i), states, hasFonts);
+        bounds.rect.unite(bounds.children.at(i).rect);
+    }
+}
+
+DrawDataBounds::Item DrawDataBounds::calculate(const DrawDataPtr& data)
+{
+    GlobalInject<IFontProvider> fontProvider;
+    const bool hasFonts = fontProvider() != nullptr;
+
+    Item bounds;
+    itemBounds(bounds, data->item, data->states, hasFonts);
+    return bounds;
+}
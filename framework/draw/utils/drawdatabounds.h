@@ -0,0 +1,61 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_DRAW_DRAWDATABOUNDS_H
+#define MUSE_DRAW_DRAWDATABOUNDS_H
+
+#include "../types/drawdata.h"
+
+namespace muse::draw {
+//! NOTE Bounds of the painted area in device coordinates (after the state transform).
+//! They are conservative: stroke width and antialiasing are included.
+//! Without the font provider the bounds of texts are unknown, they are unbounded (see unbounded()).
+class DrawDataBounds
+{
+public:
+
+    struct Data {
+        RectF rect;
+        std::vector<RectF> paths;
+        std::vector<RectF> polygons;
+        std::vector<RectF> texts;
+        std::vector<RectF> pixmaps;
+    };
+
+    //! NOTE The tree follows DrawData::Item
+    struct Item {
+        RectF rect; // with children
+        std::vector<Data> datas;
+        std::vector<Item> children;
+    };
+
+    static Item calculate(const DrawDataPtr& data);
+
+    static RectF unbounded();
+
+    static RectF pathBounds(const DrawPath& path, const DrawData::State& st);
+    static RectF polygonBounds(const DrawPolygon& polygon, const DrawData::Data& data, const DrawData::State& st);
+    static RectF textBounds(const DrawText& text, const DrawData::State& st);
+    static RectF pixmapBounds(const DrawPixmap& pixmap, const DrawData::State& st);
+};
+}
+
+#endif // MUSE_DRAW_DRAWDATABOUNDS_H
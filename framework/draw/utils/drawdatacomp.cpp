@@ -22,9 +22,10 @@
 #include "drawdatacomp.h"
 
 #include <list>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "global/realfn.h"
-#include "global/containers.h"
 
 #include "log.h"
 
@@ -526,22 +527,232 @@ static void difference(std::vector<T>& diff, const std::vector<T>& v1, const std
     }
 }
 
+// Spatial index
+// Every primitive is put into a bucket by a hash of the fields that are compared exactly
+// (object name, state, mode, pen, brush, text, number of points...) and by the quantised
+// position of its first point. Two equal primitives always have equal content hashes and
+// their first points lie in the same or neighbouring cells, so only those buckets need to
+// be checked with `isEqual`. The result is the same as comparing each pair.
+
+struct BucketKey {
+    size_t content = 0;
+    int64_t cx = 0;
+    int64_t cy = 0;
+
+    bool operator==(const BucketKey& o) const { return content == o.content && cx == o.cx && cy == o.cy; }
+};
+
+struct BucketKeyHash {
+    size_t operator()(const BucketKey& k) const noexcept
+    {
+        size_t h = k.content;
+        hashCombine(h, std::hash<int64_t> {}(k.cx));
+        hashCombine(h, std::hash<int64_t> {}(k.cy));
+        return h;
+    }
+
+    static void hashCombine(size_t& seed, size_t v)
+    {
+        seed ^= v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+};
+
 template<class T>
-static bool contains(const std::list<T>& v1, const T& val, DrawDataComp::Tolerance tolerance)
+static void hashCombine(size_t& seed, const T& v)
 {
-    for (const T& t : v1) {
-        if (isEqual(t, val, tolerance)) {
-            return true;
+    BucketKeyHash::hashCombine(seed, std::hash<T> {}(v));
+}
+
+static void hashCombine(size_t& seed, const Color& c)
+{
+    hashCombine(seed, c.red());
+    hashCombine(seed, c.green());
+    hashCombine(seed, c.blue());
+    hashCombine(seed, c.alpha());
+    hashCombine(seed, c.isValid());
+}
+
+//! NOTE Pen width is compared fuzzy, so it is not hashed
+static void hashCombine(size_t& seed, const Pen& p)
+{
+    hashCombine(seed, static_cast<int>(p.style()));
+    hashCombine(seed, p.color());
+}
+
+static void hashCombine(size_t& seed, const Brush& b)
+{
+    hashCombine(seed, static_cast<int>(b.style()));
+    hashCombine(seed, b.color());
+}
+
+template<class T>
+static size_t baseHash(const T& p)
+{
+    size_t h = std::hash<std::string> {}(p.obj->name);
+    hashCombine(h, p.data->state);
+    return h;
+}
+
+static size_t contentHash(const Path& p)
+{
+    size_t h = baseHash(p);
+    hashCombine(h, static_cast<int>(p.path->mode));
+    hashCombine(h, p.path->pen);
+    hashCombine(h, p.path->brush);
+    hashCombine(h, p.path->path.elementCount());
+    for (size_t i = 0; i < p.path->path.elementCount(); ++i) {
+        hashCombine(h, static_cast<int>(p.path->path.elementAt(i).type));
+    }
+    return h;
+}
+
+static size_t contentHash(const Polygon& p)
+{
+    size_t h = baseHash(p);
+    hashCombine(h, static_cast<int>(p.polygon->mode));
+    hashCombine(h, p.polygon->polygon.size());
+    return h;
+}
+
+static size_t contentHash(const Text& p)
+{
+    size_t h = baseHash(p);
+    hashCombine(h, static_cast<int>(p.text->mode));
+    hashCombine(h, p.text->flags);
+    hashCombine(h, p.text->text);
+    return h;
+}
+
+static size_t contentHash(const comp::Pixmap& p)
+{
+    size_t h = baseHash(p);
+    hashCombine(h, static_cast<int>(p.pixmap->mode));
+    hashCombine(h, p.pixmap->pm.size().width());
+    hashCombine(h, p.pixmap->pm.size().height());
+    return h;
+}
+
+static PointF anchor(const Path& p)
+{
+    return p.path->path.elementCount() > 0 ? PointF(p.path->path.elementAt(0)) : PointF();
+}
+
+static PointF anchor(const Polygon& p)
+{
+    return p.polygon->polygon.empty() ? PointF() : p.polygon->polygon.at(0);
+}
+
+static PointF anchor(const Text& p)
+{
+    return p.text->rect.topLeft();
+}
+
+static PointF anchor(const comp::Pixmap& p)
+{
+    return p.pixmap->rect.topLeft();
+}
+
+template<class T>
+class Buckets
+{
+public:
+    Buckets(const std::list<T>& items, double cellSize)
+        : m_cellSize(cellSize)
+    {
+        m_buckets.reserve(items.size());
+        for (const T& t : items) {
+            BucketKey key;
+            if (makeKey(t, key)) {
+                m_buckets[key].push_back(&t);
+            }
         }
     }
-    return false;
+
+    bool contains(const T& val, DrawDataComp::Tolerance tolerance) const
+    {
+        BucketKey key;
+        if (!makeKey(val, key)) {
+            // not finite coordinates are never equal to anything
+            return false;
+        }
+
+        const int64_t cx = key.cx;
+        const int64_t cy = key.cy;
+        for (int64_t dx = -1; dx <= 1; ++dx) {
+            for (int64_t dy = -1; dy <= 1; ++dy) {
+                key.cx = cx + dx;
+                key.cy = cy + dy;
+                auto it = m_buckets.find(key);
+                if (it == m_buckets.end()) {
+                    continue;
+                }
+
+                for (const T* t : it->second) {
+                    if (isEqual(*t, val, tolerance)) {
+                        return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+private:
+    bool makeKey(const T& t, BucketKey& key) const
+    {
+        const PointF p = anchor(t);
+        if (!std::isfinite(p.x()) || !std::isfinite(p.y())) {
+            return false;
+        }
+
+        key.content = contentHash(t);
+        key.cx = static_cast<int64_t>(std::floor(RealFloor(p.x(), DEFAULT_PREC) / m_cellSize));
+        key.cy = static_cast<int64_t>(std::floor(RealFloor(p.y(), DEFAULT_PREC) / m_cellSize));
+        return true;
+    }
+
+    double m_cellSize = 1.0;
+    std::unordered_map<BucketKey, std::vector<const T*>, BucketKeyHash> m_buckets;
+};
+
+template<class T>
+static double maxAbsCoord(const std::list<T>& v)
+{
+    double m = 0.0;
+    for (const T& t : v) {
+        const PointF p = anchor(t);
+        if (std::isfinite(p.x()) && std::isfinite(p.y())) {
+            m = std::max({ m, std::abs(p.x()), std::abs(p.y()) });
+        }
+    }
+    return m;
+}
+
+//! NOTE Cell size must be not less than the maximal distance between two values that are still
+//! equal for `isEqual(double, double, tolerance)`, so that equal values are in the same or neighbouring cells.
+//! Without tolerance values are compared with relative precision, so this distance depends on their magnitude.
+//! It is also limited below to keep the cell indexes in range.
+static double cellSize(double maxAbs, DrawDataComp::Tolerance tolerance)
+{
+    const double minPrecision = 1.0 / _pow10(DEFAULT_PREC);
+    const double relative = (maxAbs + 1.0) / _compare_double_epsilon;
+    const double indexLimit = maxAbs / 1e15;
+    return 2.0 * std::max({ tolerance.base > 0 ? tolerance.base : 0.0, minPrecision, relative, indexLimit });
 }
 
 template<class T>
 static void difference(std::list<T>& diff, const std::list<T>& v1, const std::list<T>& v2, DrawDataComp::Tolerance tolerance)
 {
+    if (v1.empty()) {
+        return;
+    }
+
+    const double cell = cellSize(std::max(maxAbsCoord(v1), maxAbsCoord(v2)), tolerance);
+    const Buckets<T> buckets(v2, cell);
+
     for (const T& t : v1) {
-        if (!contains(v2, t, tolerance)) {
+        if (!buckets.contains(t, tolerance)) {
             diff.push_back(t);
         }
     }
@@ -590,25 +801,24 @@ static void fillDrawData(DrawDataPtr& dd, const comp::Data& cd)
 
     // collect objects (save order)
     std::vector<const DrawData::Item*> objs;
-    for (const comp::Path& p : cd.paths) {
-        if (!muse::contains(objs, p.obj)) {
-            objs.push_back(p.obj);
+    std::unordered_set<const DrawData::Item*> added;
+    auto addObj = [&objs, &added](const DrawData::Item* obj) {
+        if (added.insert(obj).second) {
+            objs.push_back(obj);
         }
+    };
+
+    for (const comp::Path& p : cd.paths) {
+        addObj(p.obj);
     }
     for (const comp::Polygon& p : cd.polygons) {
-        if (!muse::contains(objs, p.obj)) {
-            objs.push_back(p.obj);
-        }
+        addObj(p.obj);
     }
     for (const comp::Text& p : cd.texts) {
-        if (!muse::contains(objs, p.obj)) {
-            objs.push_back(p.obj);
-        }
+        addObj(p.obj);
     }
     for (const comp::Pixmap& p : cd.pixmaps) {
-        if (!muse::contains(objs, p.obj)) {
-            objs.push_back(p.obj);
-        }
+        addObj(p.obj);
     }
 
     // collect data
@@ -0,0 +1,288 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "drawdataindex.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "../painter.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+static constexpr uint32_t LEAF_SIZE = 8;
+
+static void addPrimitives(std::vector<DrawDataIndex::Primitive>& primitives, const DrawData::Data& d, uint32_t dataNo,
+                          DrawDataIndex::Kind kind, const std::vector<RectF>& rects)
+{
+    for (size_t i = 0; i < rects.size(); ++i) {
+        if (rects.at(i).isNull()) {
+            continue;
+        }
+        primitives.push_back({ &d, dataNo, kind, static_cast<uint32_t>(i), rects.at(i) });
+    }
+}
+
+void DrawDataIndex::addItem(const DrawData::Item& item, const DrawDataBounds::Item& bounds)
+{
+    IF_ASSERT_FAILED(item.datas.size() == bounds.datas.size() && item.chilren.size() == bounds.children.size()) {
+        return;
+    }
+
+    // the same order as DrawDataPaint
+    for (size_t i = 0; i < item.datas.size(); ++i) {
+        const DrawData::Data& d = item.datas.at(i);
+        const DrawDataBounds::Data& b = bounds.datas.at(i);
+        addPrimitives(m_primitives, d, m_dataCount, Kind::Path, b.paths);
+        addPrimitives(m_primitives, d, m_dataCount, Kind::Polygon, b.polygons);
+        addPrimitives(m_primitives, d, m_dataCount, Kind::Text, b.texts);
+        addPrimitives(m_primitives, d, m_dataCount, Kind::Pixmap, b.pixmaps);
+        ++m_dataCount;
+    }
+
+    for (size_t i = 0; i < item.chilren.size(); ++i) {
+        addItem(item.chilren.at(i), bounds.children.at(i));
+    }
+}
+
+uint32_t DrawDataIndex::buildNode(uint32_t first, uint32_t count)
+{
+    const uint32_t nodeNo = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    RectF rect;
+    double minX = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double minY = minX;
+    double maxY = maxX;
+    for (uint32_t i = first; i < first + count; ++i) {
+        const RectF& r = m_primitives.at(m_order.at(i)).rect;
+        rect.unite(r);
+        PointF c = r.center();
+        minX = std::min(minX, c.x());
+        maxX = std::max(maxX, c.x());
+        minY = std::min(minY, c.y());
+        maxY = std::max(maxY, c.y());
+    }
+
+    m_nodes[nodeNo].rect = rect;
+
+    //! NOTE All centers in one point - can't be split
+    if (count <= LEAF_SIZE || (maxX <= minX && maxY <= minY)) {
+        m_nodes[nodeNo].first = first;
+        m_nodes[nodeNo].count = count;
+        return nodeNo;
+    }
+
+    // split by median on the longest axis
+    const bool byX = (maxX - minX) >= (maxY - minY);
+    const uint32_t half = count / 2;
+    auto begin = m_order.begin() + first;
+    std::nth_element(begin, begin + half, begin + count, [this, byX](uint32_t a, uint32_t b) {
+        PointF ca = m_primitives.at(a).rect.center();
+        PointF cb = m_primitives.at(b).rect.center();
+        return byX ? ca.x() < cb.x() : ca.y() < cb.y();
+    });
+
+    uint32_t left = buildNode(first, half);
+    uint32_t right = buildNode(first + half, count - half);
+    m_nodes[nodeNo].left = left;
+    m_nodes[nodeNo].right = right;
+
+    return nodeNo;
+}
+
+void DrawDataIndex::build(const DrawDataPtr& data, const DrawDataBounds::Item& bounds)
+{
+    TRACEFUNC;
+
+    clear();
+
+    if (!data) {
+        return;
+    }
+
+    m_data = data;
+    addItem(data->item, bounds);
+
+    if (m_primitives.empty()) {
+        return;
+    }
+
+    m_order.resize(m_primitives.size());
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        m_order[i] = static_cast<uint32_t>(i);
+    }
+
+    m_nodes.reserve(2 * m_primitives.size() / LEAF_SIZE + 1);
+    buildNode(0, static_cast<uint32_t>(m_order.size()));
+}
+
+void DrawDataIndex::clear()
+{
+    m_data = nullptr;
+    m_dataCount = 0;
+    m_primitives.clear();
+    m_order.clear();
+    m_nodes.clear();
+}
+
+bool DrawDataIndex::empty() const
+{
+    return m_primitives.empty();
+}
+
+size_t DrawDataIndex::size() const
+{
+    return m_primitives.size();
+}
+
+const DrawDataIndex::Primitive& DrawDataIndex::primitive(size_t idx) const
+{
+    return m_primitives.at(idx);
+}
+
+RectF DrawDataIndex::rect() const
+{
+    return m_nodes.empty() ? RectF() : m_nodes.front().rect;
+}
+
+void DrawDataIndex::query(const RectF& rect, std::vector<size_t>& result) const
+{
+    result.clear();
+    if (m_nodes.empty()) {
+        return;
+    }
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+    while (!stack.empty()) {
+        const Node& node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        if (!node.rect.intersects(rect)) {
+            continue;
+        }
+
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                uint32_t idx = m_order[i];
+                if (m_primitives[idx].rect.intersects(rect)) {
+                    result.push_back(idx);
+                }
+            }
+            continue;
+        }
+
+        stack.push_back(node.right);
+        stack.push_back(node.left);
+    }
+
+    // primitives are stored in paint order
+    std::sort(result.begin(), result.end());
+}
+
+void DrawDataIndex::paint(Painter* painter, const RectF& clip, const Color& overlay) const
+{
+    TRACEFUNC;
+
+    std::vector<size_t> hits;
+    query(clip, hits);
+    if (hits.empty()) {
+        return;
+    }
+
+    IPaintProviderPtr provider = painter->provider();
+
+    const DrawData::Data* current = nullptr;
+    bool lastPathPenSet = false;
+    for (size_t idx : hits) {
+        const Primitive& p = m_primitives[idx];
+        const DrawData::Data& d = *p.data;
+
+        if (p.data != current) {
+            current = p.data;
+            lastPathPenSet = false;
+
+            DrawData::State st = m_data->states.at(d.state);
+            if (overlay.isValid()) {
+                st.pen.setColor(overlay);
+                st.brush.setColor(overlay);
+            }
+
+            provider->setPen(st.pen);
+            provider->setBrush(st.brush);
+            provider->setFont(st.font);
+            provider->setTransform(st.transform);
+            provider->setAntialiasing(st.isAntialiasing);
+            provider->setCompositionMode(st.compositionMode);
+        }
+
+        if (p.kind == Kind::Path) {
+            const DrawPath& path = d.paths[p.index];
+            provider->setPen(path.pen);
+            provider->setBrush(path.brush);
+            provider->drawPath(path.path);
+            lastPathPenSet = p.index + 1 == d.paths.size();
+            continue;
+        }
+
+        //! NOTE The rest are painted with the pen of the last path (see DrawDataPaint)
+        if (!lastPathPenSet) {
+            lastPathPenSet = true;
+            if (!d.paths.empty()) {
+                provider->setPen(d.paths.back().pen);
+                provider->setBrush(d.paths.back().brush);
+            }
+        }
+
+        switch (p.kind) {
+        case Kind::Polygon: {
+            const DrawPolygon& pl = d.polygons[p.index];
+            if (!pl.polygon.empty()) {
+                provider->drawPolygon(&pl.polygon[0], pl.polygon.size(), pl.mode);
+            }
+        } break;
+        case Kind::Text: {
+            const DrawText& t = d.texts[p.index];
+            if (t.mode == DrawText::Point) {
+                provider->drawText(t.rect.topLeft(), t.text);
+            } else {
+                provider->drawText(t.rect, t.flags, t.text);
+            }
+        } break;
+        case Kind::Pixmap: {
+            const DrawPixmap& px = d.pixmaps[p.index];
+            if (px.mode == DrawPixmap::Single) {
+                provider->drawPixmap(px.rect.topLeft(), px.pm);
+            } else {
+                provider->drawTiledPixmap(px.rect, px.pm, px.offset);
+            }
+        } break;
+        case Kind::Path:
+            break;
+        }
+    }
+}
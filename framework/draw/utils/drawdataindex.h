@@ -0,0 +1,93 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_DRAW_DRAWDATAINDEX_H
+#define MUSE_DRAW_DRAWDATAINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../types/drawdata.h"
+#include "drawdatabounds.h"
+
+namespace muse::draw {
+class Painter;
+
+//! NOTE Bounding volume hierarchy over the primitives of DrawData.
+//! Allows to find and replay only the primitives visible in the given region.
+//! The index refers to the data, so the data must not be changed while the index is used.
+class DrawDataIndex
+{
+public:
+    DrawDataIndex() = default;
+
+    enum class Kind : uint8_t {
+        Path,
+        Polygon,
+        Text,
+        Pixmap
+    };
+
+    struct Primitive {
+        const DrawData::Data* data = nullptr;
+        uint32_t dataNo = 0;    // in paint order
+        Kind kind = Kind::Path;
+        uint32_t index = 0;     // in the list of the kind
+        RectF rect;             // in device coordinates
+    };
+
+    void build(const DrawDataPtr& data, const DrawDataBounds::Item& bounds);
+    void clear();
+
+    bool empty() const;
+    size_t size() const;
+    const Primitive& primitive(size_t idx) const;
+    RectF rect() const;
+
+    //! NOTE Indexes of primitives intersecting the rect, in paint order
+    void query(const RectF& rect, std::vector<size_t>& result) const;
+
+    //! NOTE Paints only primitives intersecting the clip (in device coordinates),
+    //! as DrawDataPaint::paint would paint them
+    void paint(Painter* painter, const RectF& clip, const Color& overlay = Color()) const;
+
+private:
+
+    struct Node {
+        RectF rect;
+        uint32_t first = 0; // in m_order, for leaf
+        uint32_t count = 0; // 0 - not leaf
+        uint32_t left = 0;
+        uint32_t right = 0;
+    };
+
+    void addItem(const DrawData::Item& item, const DrawDataBounds::Item& bounds);
+    uint32_t buildNode(uint32_t first, uint32_t count);
+
+    DrawDataPtr m_data;
+    uint32_t m_dataCount = 0;
+    std::vector<Primitive> m_primitives;
+    std::vector<uint32_t> m_order;
+    std::vector<Node> m_nodes;
+};
+}
+
+#endif // MUSE_DRAW_DRAWDATAINDEX_H
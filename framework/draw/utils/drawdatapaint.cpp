@@ -26,62 +26,90 @@
 using namespace muse;
 using namespace muse::draw;
 
-static void drawItem(IPaintProviderPtr& provider, const DrawData::Item& item, const std::map<int, DrawData::State>& states,
-                     const Color& overlay)
+struct PaintContext {
+    const std::map<int, DrawData::State>& states;
+    Color overlay;
+    const RectF* clip = nullptr;
+    Transform offset;
+};
+
+static void drawData(IPaintProviderPtr& provider, const DrawData::Data& d, const PaintContext& ctx)
 {
-    // first draw obj itself
-    for (const DrawData::Data& d : item.datas) {
-        DrawData::State st = states.at(d.state);
-        if (overlay.isValid()) {
-            st.pen.setColor(overlay);
-            st.brush.setColor(overlay);
-        }
+    DrawData::State st = ctx.states.at(d.state);
+    if (ctx.overlay.isValid()) {
+        st.pen.setColor(ctx.overlay);
+        st.brush.setColor(ctx.overlay);
+    }
 
-        provider->setPen(st.pen);
-        provider->setBrush(st.brush);
-        provider->setFont(st.font);
-        provider->setTransform(st.transform);
-        provider->setAntialiasing(st.isAntialiasing);
-        provider->setCompositionMode(st.compositionMode);
+    provider->setPen(st.pen);
+    provider->setBrush(st.brush);
+    provider->setFont(st.font);
+    provider->setTransform(ctx.clip ? st.transform * ctx.offset : st.transform);
+    provider->setAntialiasing(st.isAntialiasing);
+    provider->setCompositionMode(st.compositionMode);
 
-        for (const DrawPath& path : d.paths) {
-            provider->setPen(path.pen);
-            provider->setBrush(path.brush);
-            provider->drawPath(path.path);
+    for (const DrawPath& path : d.paths) {
+        provider->setPen(path.pen);
+        provider->setBrush(path.brush);
+        provider->drawPath(path.path);
+    }
+
+    for (const DrawPolygon& pl : d.polygons) {
+        if (pl.polygon.empty()) {
+            continue;
         }
+        provider->drawPolygon(&pl.polygon[0], pl.polygon.size(), pl.mode);
+    }
 
-        for (const DrawPolygon& pl : d.polygons) {
-            if (pl.polygon.empty()) {
-                continue;
-            }
-            provider->drawPolygon(&pl.polygon[0], pl.polygon.size(), pl.mode);
+    for (const DrawText& t : d.texts) {
+        if (t.mode == DrawText::Point) {
+            provider->drawText(t.rect.topLeft(), t.text);
+        } else {
+            provider->drawText(t.rect, t.flags, t.text);
         }
+    }
 
-        for (const DrawText& t : d.texts) {
-            if (t.mode == DrawText::Point) {
-                provider->drawText(t.rect.topLeft(), t.text);
-            } else {
-                provider->drawText(t.rect, t.flags, t.text);
-            }
+    for (const DrawPixmap& px : d.pixmaps) {
+        if (px.mode == DrawPixmap::Single) {
+            provider->drawPixmap(px.rect.topLeft(), px.pm);
+        } else {
+            provider->drawTiledPixmap(px.rect, px.pm, px.offset);
         }
+    }
+}
 
-        for (const DrawPixmap& px : d.pixmaps) {
-            if (px.mode == DrawPixmap::Single) {
-                provider->drawPixmap(px.rect.topLeft(), px.pm);
-            } else {
-                provider->drawTiledPixmap(px.rect, px.pm, px.offset);
-            }
+static void drawItem(IPaintProviderPtr& provider, const DrawData::Item& item, const DrawDataBounds::Item* bounds,
+                     const PaintContext& ctx)
+{
+    if (ctx.clip && !bounds->rect.intersects(*ctx.clip)) {
+        return;
+    }
+
+    // first draw obj itself
+    for (size_t i = 0; i < item.datas.size(); ++i) {
+        if (ctx.clip && !bounds->datas.at(i).rect.intersects(*ctx.clip)) {
+            continue;
         }
+        drawData(provider, item.datas.at(i), ctx);
     }
 
     // second draw chilren
-    for (const DrawData::Item& ch : item.chilren) {
-        drawItem(provider, ch, states, overlay);
+    for (size_t i = 0; i < item.chilren.size(); ++i) {
+        drawItem(provider, item.chilren.at(i), ctx.clip ? &bounds->children.at(i) : nullptr, ctx);
     }
 }
 
 void DrawDataPaint::paint(Painter* painter, const DrawDataPtr& data, const Color& overlay)
 {
     IPaintProviderPtr provider = painter->provider();
-    drawItem(provider, data->item, data->states, overlay);
+    PaintContext ctx { data->states, overlay, nullptr, Transform() };
+    drawItem(provider, data->item, nullptr, ctx);
+}
+
+void DrawDataPaint::paintRegion(Painter* painter, const DrawDataPtr& data, const DrawDataBounds::Item& bounds, const RectF& clip,
+                                const Color& overlay)
+{
+    IPaintProviderPtr provider = painter->provider();
+    PaintContext ctx { data->states, overlay, &clip, Transform().translate(-clip.x(), -clip.y()) };
+    drawItem(provider, data->item, &bounds, ctx);
 }
@@ -24,6 +24,7 @@
 
 #include "../painter.h"
 #include "../types/drawdata.h"
+#include "drawdatabounds.h"
 
 namespace muse::draw {
 class DrawDataPaint
@@ -32,6 +33,11 @@ public:
     DrawDataPaint() = default;
 
     static void paint(Painter* painter, const DrawDataPtr& data, const Color& overlay = Color());
+
+    //! NOTE Paints only the datas that intersect the clip (in device coordinates),
+    //! the top left corner of the clip is painted at the device origin of the painter
+    static void paintRegion(Painter* painter, const DrawDataPtr& data, const DrawDataBounds::Item& bounds, const RectF& clip,
+                            const Color& overlay = Color());
 };
 }
 
@@ -34,12 +34,58 @@ using namespace muse;
 
 int ObjectAllocator::s_used = 0;
 size_t ObjectAllocator::DEFAULT_BLOCK_SIZE(1024 * 256); // 256 kB
+size_t ObjectAllocator::CACHE_BATCH_SIZE(32);
 
 static inline size_t align(size_t n)
 {
     return (n + sizeof(intptr_t) - 1) & ~(sizeof(intptr_t) - 1);
 }
 
+// ============================================
+// Thread caches
+// ============================================
+
+//! NOTE Alive allocators by id, to return the thread caches on thread exit.
+//! Not destroyed, so it is available on any thread exit.
+static std::mutex& aliveMutex()
+{
+    static std::mutex* m = new std::mutex();
+    return *m;
+}
+
+static std::vector<ObjectAllocator*>& aliveAllocators()
+{
+    static std::vector<ObjectAllocator*>* v = new std::vector<ObjectAllocator*>();
+    return *v;
+}
+
+static size_t registerAlive(ObjectAllocator* a)
+{
+    std::lock_guard<std::mutex> lock(aliveMutex());
+    aliveAllocators().push_back(a);
+    return aliveAllocators().size() - 1;
+}
+
+namespace muse {
+struct ThreadCaches
+{
+    std::vector<ObjectAllocator::ThreadCache*> caches; // by allocator id
+
+    ~ThreadCaches()
+    {
+        std::lock_guard<std::mutex> lock(aliveMutex());
+        for (size_t id = 0; id < caches.size(); ++id) {
+            ObjectAllocator* a = aliveAllocators().at(id);
+            if (a && caches.at(id)) {
+                a->releaseCache(caches.at(id));
+            }
+        }
+    }
+};
+}
+
+static thread_local ThreadCaches s_threadCaches;
+
 // ============================================
 // ObjectAllocator
 // ============================================
@@ -58,7 +104,7 @@ void ObjectAllocator::unused()
 }
 
 ObjectAllocator::ObjectAllocator(const char* module, const char* name, destroyer_t dtor)
-    : m_module(module), m_name(name), m_dtor(dtor)
+    : m_id(registerAlive(this)), m_module(module), m_name(name), m_dtor(dtor)
 {
     AllocatorsRegister::instance()->reg(this);
 }
@@ -66,6 +112,9 @@ ObjectAllocator::ObjectAllocator(const char* module, const char* name, destroyer
 ObjectAllocator::~ObjectAllocator()
 {
     AllocatorsRegister::instance()->unreg(this);
+
+    std::lock_guard<std::mutex> lock(aliveMutex());
+    aliveAllocators()[m_id] = nullptr;
 }
 
 const char* ObjectAllocator::module() const
@@ -78,65 +127,200 @@ const char* ObjectAllocator::name() const
     return m_name;
 }
 
+ObjectAllocator::ThreadCache* ObjectAllocator::threadCache()
+{
+    std::vector<ThreadCache*>& caches = s_threadCaches.caches;
+    if (m_id < caches.size() && caches[m_id]) {
+        return caches[m_id];
+    }
+
+    ThreadCache* cache = acquireCache();
+    if (caches.size() <= m_id) {
+        caches.resize(m_id + 1, nullptr);
+    }
+    caches[m_id] = cache;
+    return cache;
+}
+
+ObjectAllocator::ThreadCache* ObjectAllocator::acquireCache()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    //! NOTE Reuse a cache of an exited thread (keeps its counters)
+    for (const std::unique_ptr<ThreadCache>& c : m_caches) {
+        if (!c->owned) {
+            c->owned = true;
+            return c.get();
+        }
+    }
+
+    m_caches.push_back(std::make_unique<ThreadCache>());
+    m_caches.back()->owned = true;
+    return m_caches.back().get();
+}
+
+void ObjectAllocator::releaseCache(ThreadCache* cache)
+{
+    flush(cache, cache->freeCount.load(std::memory_order_relaxed));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    cache->owned = false;
+}
+
 void* ObjectAllocator::alloc(size_t size)
 {
     size = align(size);
 
-    if (!m_chunkSize) {
-        m_chunkSize = size;
+    size_t chunkSize = 0;
+    if (!m_chunkSize.compare_exchange_strong(chunkSize, size, std::memory_order_relaxed)) {
+        DO_ASSERT(chunkSize == size);
     }
 
-    assert(m_chunkSize == size);
-
-    if (!m_free) {
-        Block b = allocateBlock(m_chunkSize);
-        m_blocks.push_back(b);
-        m_free = b.begin;
+    ThreadCache* cache = threadCache();
+    if (!cache->free) {
+        refill(cache);
     }
 
     // The return value is the current position of
     // the allocation pointer:
-    Chunk* freeChunk = m_free;
+    Chunk* freeChunk = cache->free;
 
     // Advance (bump) the allocation pointer to the next chunk.
     //
-    // When no chunks left, the `m_free` will be set to `nullptr`, and
-    // this will cause allocation of a new block on the next request:
-    m_free = m_free->next;
+    // When no chunks left, the `free` will be set to `nullptr`, and
+    // this will cause the refill from the depot on the next request:
+    cache->free = freeChunk->next;
 
-    m_statistic.totalAllocatedCount++;
+    //! NOTE Only the owner thread writes, so no need in atomic increment
+    cache->freeCount.store(cache->freeCount.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    cache->allocatedCount.store(cache->allocatedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 
     return freeChunk;
 }
 
 void ObjectAllocator::free(void* chunk)
 {
+    ThreadCache* cache = threadCache();
+
     // The freed chunk's next pointer points to the
     // current allocation pointer:
-    reinterpret_cast<Chunk*>(chunk)->next = m_free;
+    reinterpret_cast<Chunk*>(chunk)->next = cache->free;
 
     // And the allocation pointer is now set
     // to the returned (free) chunk:
-    m_free = reinterpret_cast<Chunk*>(chunk);
+    cache->free = reinterpret_cast<Chunk*>(chunk);
+
+    const size_t freeCount = cache->freeCount.load(std::memory_order_relaxed) + 1;
+    cache->freeCount.store(freeCount, std::memory_order_relaxed);
+    cache->freedCount.store(cache->freedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 
-    m_statistic.totalFreeCount++;
+    //! NOTE Objects freed on another thread than they were allocated on
+    //! return to the allocating threads through the depot
+    if (freeCount > CACHE_BATCH_SIZE * 2) {
+        flush(cache, CACHE_BATCH_SIZE);
+    }
+}
+
+void ObjectAllocator::refill(ThreadCache* cache)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_depot) {
+        Block b = allocateBlock(m_chunkSize.load(std::memory_order_relaxed));
+        m_blocks.push_back(b);
+        m_depot = b.begin;
+        m_depotCount = b.chunkCount;
+    }
+
+    // Take a batch of chunks from the depot
+    Chunk* first = m_depot;
+    Chunk* last = m_depot;
+    size_t count = 1;
+    while (count < CACHE_BATCH_SIZE && last->next) {
+        last = last->next;
+        ++count;
+    }
+
+    m_depot = last->next;
+    m_depotCount -= count;
+
+    last->next = cache->free;
+    cache->free = first;
+    cache->freeCount.store(cache->freeCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+
+    updatePeak();
+}
+
+void ObjectAllocator::flush(ThreadCache* cache, size_t count)
+{
+    if (count == 0 || !cache->free) {
+        return;
+    }
+
+    // Detach `count` chunks from the cache
+    Chunk* first = cache->free;
+    Chunk* last = first;
+    size_t detached = 1;
+    while (detached < count && last->next) {
+        last = last->next;
+        ++detached;
+    }
+
+    cache->free = last->next;
+    cache->freeCount.store(cache->freeCount.load(std::memory_order_relaxed) - detached, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    last->next = m_depot;
+    m_depot = first;
+    m_depotCount += detached;
+
+    updatePeak();
+}
+
+void ObjectAllocator::updatePeak()
+{
+    uint64_t allocated = 0;
+    uint64_t freed = 0;
+    for (const std::unique_ptr<ThreadCache>& c : m_caches) {
+        allocated += c->allocatedCount.load(std::memory_order_relaxed);
+        freed += c->freedCount.load(std::memory_order_relaxed);
+    }
+
+    if (allocated > freed) {
+        m_peakLiveCount = std::max(m_peakLiveCount, allocated - freed);
+    }
 }
 
 void ObjectAllocator::cleanup()
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     if (m_blocks.empty()) {
         return;
     }
 
     std::set<Chunk*> freeChunks;
     {
-        Chunk* free = m_free;
+        Chunk* free = m_depot;
         while (free) {
             freeChunks.insert(free);
             free = free->next;
         }
+
+        for (const std::unique_ptr<ThreadCache>& c : m_caches) {
+            free = c->free;
+            while (free) {
+                freeChunks.insert(free);
+                free = free->next;
+            }
+
+            //! NOTE All chunks will be in the depot, the destroyed objects are counted as freed
+            c->free = nullptr;
+            c->freeCount.store(0, std::memory_order_relaxed);
+        }
     }
 
+    uint64_t destroyed = 0;
     for (size_t bi = 0; bi < m_blocks.size(); ++bi) {
         const Block& b = m_blocks.at(bi);
         Chunk* chunk = b.begin;
@@ -144,6 +328,7 @@ void ObjectAllocator::cleanup()
             // if not free chunk, then destroy object
             if (freeChunks.find(chunk) == freeChunks.cend()) {
                 m_dtor(reinterpret_cast<void*>(chunk));
+                ++destroyed;
             }
 
             chunk->next = reinterpret_cast<Chunk*>(reinterpret_cast<uint8_t*>(chunk) + b.chunkSize);
@@ -152,6 +337,7 @@ void ObjectAllocator::cleanup()
 
         if (freeChunks.find(chunk) == freeChunks.cend()) {
             m_dtor(reinterpret_cast<void*>(chunk));
+            ++destroyed;
         }
 
         if (bi < (m_blocks.size() - 1)) {
@@ -161,7 +347,16 @@ void ObjectAllocator::cleanup()
         }
     }
 
-    m_free = m_blocks.front().begin;
+    m_depot = m_blocks.front().begin;
+    m_depotCount = 0;
+    for (const Block& b : m_blocks) {
+        m_depotCount += b.chunkCount;
+    }
+
+    if (!m_caches.empty()) {
+        ThreadCache* c = m_caches.front().get();
+        c->freedCount.store(c->freedCount.load(std::memory_order_relaxed) + destroyed, std::memory_order_relaxed);
+    }
 }
 
 ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize) const
@@ -198,24 +393,29 @@ void* ObjectAllocator::not_supported(const char* info)
 
 ObjectAllocator::Info ObjectAllocator::stateInfo() const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
     Info info;
     info.module = m_module;
     info.name = m_name;
-    info.chunkSize = m_chunkSize;
+    info.chunkSize = m_chunkSize.load(std::memory_order_relaxed);
     info.blockCount = m_blocks.size();
-    info.totalAllocatedCount = m_statistic.totalAllocatedCount;
-    info.totalFreeCount = m_statistic.totalFreeCount;
+    info.threadCaches = m_caches.size();
 
     for (const Block& b : m_blocks) {
         info.totalChunks += b.chunkCount;
     }
 
-    Chunk* free = m_free;
-    while (free) {
-        ++info.freeChunks;
-        free = free->next;
+    info.freeChunks = m_depotCount;
+    for (const std::unique_ptr<ThreadCache>& c : m_caches) {
+        info.freeChunks += c->freeCount.load(std::memory_order_relaxed);
+        info.totalAllocatedCount += c->allocatedCount.load(std::memory_order_relaxed);
+        info.totalFreeCount += c->freedCount.load(std::memory_order_relaxed);
     }
 
+    info.liveCount = info.totalAllocatedCount > info.totalFreeCount ? info.totalAllocatedCount - info.totalFreeCount : 0;
+    info.peakLiveCount = std::max(m_peakLiveCount, info.liveCount);
+
     return info;
 }
 
@@ -224,16 +424,31 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
 // ============================================
 void AllocatorsRegister::reg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.push_back(a);
 }
 
 void AllocatorsRegister::unreg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.remove(a);
 }
 
+std::vector<ObjectAllocator::Info> AllocatorsRegister::stateInfos() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<ObjectAllocator::Info> infos;
+    infos.reserve(m_allocators.size());
+    for (const ObjectAllocator* a : m_allocators) {
+        infos.push_back(a->stateInfo());
+    }
+    return infos;
+}
+
 void AllocatorsRegister::cleanupAll(const std::string& module)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     for (ObjectAllocator* a : m_allocators) {
         if (a->module() == module) {
             a->cleanup();
@@ -249,26 +464,29 @@ void AllocatorsRegister::printStatistic(const std::string& title)
 {
     std::stringstream stream;
     stream << "\n\n";
+    const std::vector<ObjectAllocator::Info> infos = stateInfos();
+
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
-    stream << TITLE("Object") << TITLE("Total alloc") << TITLE("Total free") << TITLE("Used (leak?)") << TITLE("Object size") << "\n";
+    stream << "allocators: " << infos.size() << '\n';
+    stream << TITLE("Object") << TITLE("Total alloc") << TITLE("Total free") << TITLE("Used (leak?)") << TITLE("Peak used")
+           << TITLE("Object size") << "\n";
 
     uint64_t totalBytes = 0;
     uint64_t totalAllocatedCount = 0;
     uint64_t totalFreeCount = 0;
     uint64_t totalUsedCount = 0;
-    for (ObjectAllocator* a : m_allocators) {
-        ObjectAllocator::Info info = a->stateInfo();
+    for (const ObjectAllocator::Info& info : infos) {
         stream << FORMAT(info.name, 20)
                << VALUE(info.totalAllocatedCount)
                << VALUE(info.totalFreeCount)
-               << VALUE(info.usedChunks())
+               << VALUE(info.liveCount)
+               << VALUE(info.peakLiveCount)
                << VALUE(info.chunkSize)
                << "\n";
 
         totalAllocatedCount += info.totalAllocatedCount;
         totalFreeCount += info.totalFreeCount;
-        totalUsedCount += info.usedChunks();
+        totalUsedCount += info.liveCount;
         totalBytes += info.allocatedBytes();
     }
 
@@ -283,14 +501,15 @@ void AllocatorsRegister::printState(const std::string& title)
 {
     std::stringstream stream;
     stream << "\n\n";
+    const std::vector<ObjectAllocator::Info> infos = stateInfos();
+
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
+    stream << "allocators: " << infos.size() << '\n';
     stream << TITLE("Object") << TITLE("blockCount") << TITLE("totalChunks") << TITLE("freeChunks") << TITLE("chunkSize")
            << TITLE("allocatedBytes") << "\n";
 
     uint64_t totalBytes = 0;
-    for (ObjectAllocator* a : m_allocators) {
-        ObjectAllocator::Info info = a->stateInfo();
+    for (const ObjectAllocator::Info& info : infos) {
         stream << FORMAT(info.name, 20)
                << VALUE(info.blockCount)
                << VALUE(info.totalChunks)
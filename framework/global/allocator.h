@@ -22,9 +22,12 @@
 #ifndef MUSE_GLOBAL_ALLOCATOR_H
 #define MUSE_GLOBAL_ALLOCATOR_H
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace muse {
@@ -59,6 +62,9 @@ public: \
     } \
 private:
 
+//! NOTE Thread-safe: each thread allocates from its own cache (free list) without locks,
+//! the caches exchange chunks with the shared depot in batches (under the mutex),
+//! so an object can be freed on any thread
 class ObjectAllocator
 {
 public:
@@ -69,12 +75,15 @@ public:
     ~ObjectAllocator();
 
     static size_t DEFAULT_BLOCK_SIZE;
+    static size_t CACHE_BATCH_SIZE; // chunks, a thread cache keeps up to two batches
 
     const char* module() const;
     const char* name() const;
 
     void* alloc(size_t size);
     void free(void* ptr);
+
+    //! NOTE Destroys the living objects, must not be called concurrently with alloc/free
     void cleanup();
 
     template<class T>
@@ -98,6 +107,10 @@ public:
         uint64_t totalAllocatedCount = 0;
         uint64_t totalFreeCount = 0;
 
+        uint64_t liveCount = 0;     // objects, allocated and not freed
+        uint64_t peakLiveCount = 0; // approximate, within the thread caches batches
+        size_t threadCaches = 0;
+
         uint64_t usedChunks() const { return totalChunks - freeChunks; }
         uint64_t allocatedBytes() const { return totalChunks * chunkSize; }
     };
@@ -111,6 +124,8 @@ public:
     static int s_used;
 private:
 
+    friend struct ThreadCaches;
+
     struct Chunk {
         /**
          * When a chunk is free, the `next` contains the
@@ -128,22 +143,37 @@ private:
         size_t chunkSize = 0;
     };
 
+    //! NOTE Written only by the owner thread,
+    //! the counters are atomics to read statistics from other threads
+    struct ThreadCache {
+        Chunk* free = nullptr;
+        std::atomic<size_t> freeCount = 0;
+        std::atomic<uint64_t> allocatedCount = 0;
+        std::atomic<uint64_t> freedCount = 0;
+        bool owned = false;
+    };
+
     Block allocateBlock(size_t chunkSize) const;
 
+    ThreadCache* threadCache();
+    ThreadCache* acquireCache();
+    void releaseCache(ThreadCache* cache);
+    void refill(ThreadCache* cache);
+    void flush(ThreadCache* cache, size_t count);
+    void updatePeak();
+
+    const size_t m_id = 0;
     const char* m_module = nullptr;
     const char* m_name = nullptr;
-    size_t m_chunkSize = 0;
+    std::atomic<size_t> m_chunkSize = 0;
     destroyer_t m_dtor = nullptr;
-    Chunk* m_free = nullptr;
-    std::vector<Block> m_blocks;
 
-    struct Statistic
-    {
-        uint64_t totalAllocatedCount = 0;
-        uint64_t totalFreeCount = 0;
-    };
-
-    Statistic m_statistic;
+    mutable std::mutex m_mutex;
+    Chunk* m_depot = nullptr;
+    size_t m_depotCount = 0;
+    std::vector<Block> m_blocks;
+    std::vector<std::unique_ptr<ThreadCache> > m_caches;
+    uint64_t m_peakLiveCount = 0;
 };
 
 class AllocatorsRegister
@@ -161,10 +191,13 @@ public:
 
     void cleanupAll(const std::string& module);
 
+    std::vector<ObjectAllocator::Info> stateInfos() const;
+
     void printStatistic(const std::string& title);
     void printState(const std::string& title);
 
 private:
+    mutable std::mutex m_mutex;
     std::list<ObjectAllocator*> m_allocators;
 };
 }
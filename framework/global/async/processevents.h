@@ -34,6 +34,11 @@ inline void processMessages(const std::thread::id& th)
     kors::async::processMessages(th);
 }
 
+inline void setWakeup(const std::thread::id& th, const std::function<void()>& wakeup)
+{
+    kors::async::setWakeup(th, wakeup);
+}
+
 inline void terminate()
 {
     kors::async::terminate();
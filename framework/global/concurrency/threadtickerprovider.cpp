@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "threadtickerprovider.h"
+
+#ifdef MUSE_THREADS_SUPPORT
+
+#include <algorithm>
+
+#include "runtime.h"
+
+using namespace muse;
+
+ThreadTickerProvider::ThreadTickerProvider(std::chrono::microseconds tickInterval)
+    : m_tickInterval(std::max(tickInterval, std::chrono::microseconds(1))), m_startTime(Clock::now())
+{
+}
+
+ThreadTickerProvider::~ThreadTickerProvider()
+{
+    stop();
+}
+
+void ThreadTickerProvider::start()
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    if (m_thread.joinable()) {
+        return;
+    }
+
+    m_stop = false;
+    m_thread = std::thread([this]() {
+        runtime::setThreadName("ticker");
+        threadLoop();
+    });
+}
+
+void ThreadTickerProvider::stop()
+{
+    {
+        std::lock_guard<std::recursive_mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    if (m_thread.get_id() == std::this_thread::get_id()) {
+        //! NOTE Stopped from a task
+        m_thread.detach();
+    } else {
+        m_thread.join();
+    }
+}
+
+void ThreadTickerProvider::forceSchedule()
+{
+    start();
+    m_cv.notify_all();
+}
+
+ThreadTickerProvider::Clock::time_point ThreadTickerProvider::tickTime(TimerWheel::Tick tick) const
+{
+    return m_startTime + m_tickInterval * static_cast<int64_t>(tick + 1);
+}
+
+TimerWheel::Tick ThreadTickerProvider::dueTicks(Clock::time_point time) const
+{
+    if (time <= m_startTime) {
+        return 0;
+    }
+
+    return static_cast<TimerWheel::Tick>((time - m_startTime) / m_tickInterval);
+}
+
+size_t ThreadTickerProvider::wakeupsCount() const
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    return m_wakeupsCount;
+}
+
+uint32_t ThreadTickerProvider::addTask(const Task& task)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+
+    const TimerWheel::Tick interval = std::max(task.interval, uint32_t(1));
+    const TimerWheel::Tick period = task.repeat ? interval : 0;
+
+    //! NOTE The wheel is advanced on wake up, so the ticks passed since are added
+    const TimerWheel::Tick due = dueTicks(Clock::now());
+    const TimerWheel::Tick lag = due > m_wheel.now() ? due - m_wheel.now() : 0;
+
+    const uint32_t id = m_wheel.add(interval + lag, period, task.call);
+    m_cv.notify_all();
+
+    return id;
+}
+
+void ThreadTickerProvider::removeTask(const uint32_t& taskId)
+{
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_wheel.cancel(taskId);
+}
+
+void ThreadTickerProvider::threadLoop()
+{
+    std::unique_lock<std::recursive_mutex> lock(m_mutex);
+    while (!m_stop) {
+        const TimerWheel::Tick next = m_wheel.nextExpiry();
+        if (next == TimerWheel::NO_EXPIRY) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        const Clock::time_point wakeTime = tickTime(m_wheel.now() + next - 1);
+        if (Clock::now() < wakeTime) {
+            m_cv.wait_until(lock, wakeTime);
+            continue;
+        }
+
+        ++m_wakeupsCount;
+
+        const TimerWheel::Tick due = dueTicks(Clock::now());
+        if (due > m_wheel.now()) {
+            m_wheel.advance(due - m_wheel.now());
+        }
+    }
+}
+
+#endif // MUSE_THREADS_SUPPORT
@@ -0,0 +1,76 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "muse_framework_config.h"
+
+#ifdef MUSE_THREADS_SUPPORT
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "../itickerprovider.h"
+#include "../timerwheel.h"
+
+namespace muse {
+//! NOTE Ticker provider without event loop, the tasks are called on its own thread.
+//! The thread sleeps until the next tick with tasks, the ticks are counted from the start,
+//! so a late wake up is caught up (the tasks of the passed ticks are called).
+//! The tasks can be added and removed from any thread (including the tasks).
+class ThreadTickerProvider : public ITickerProvider
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ThreadTickerProvider(std::chrono::microseconds tickInterval = std::chrono::milliseconds(16));
+    ~ThreadTickerProvider() override;
+
+    void start() override;
+    void stop() override;
+    void forceSchedule() override;
+
+    uint32_t /*id*/ addTask(const Task& task) override;
+    void removeTask(const uint32_t& taskId) override;
+
+    Clock::time_point tickTime(TimerWheel::Tick tick) const; // when the tick is due
+    size_t wakeupsCount() const;
+
+private:
+    void threadLoop();
+    TimerWheel::Tick dueTicks(Clock::time_point time) const;
+
+    const std::chrono::microseconds m_tickInterval;
+    Clock::time_point m_startTime;
+
+    mutable std::recursive_mutex m_mutex;
+    std::condition_variable_any m_cv;
+    TimerWheel m_wheel;
+    bool m_stop = false;
+    size_t m_wakeupsCount = 0;
+    std::thread m_thread;
+};
+}
+
+#endif // MUSE_THREADS_SUPPORT
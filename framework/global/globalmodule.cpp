@@ -21,6 +21,8 @@
  */
 #include "globalmodule.h"
 
+#include <cstdlib>
+
 #include "muse_framework_config.h"
 
 #include "modularity/ioc.h"
@@ -164,6 +166,13 @@ void GlobalModule::onPreInit(const IApplication::RunMode& mode)
     LOGI() << "log path: " << logFilePath;
 #endif // end of not MUSE_CONFIGURATION_IS_WEB
 
+#ifdef MUSE_THREADS_SUPPORT
+    //! NOTE Threads (including the audio engine) don't wait for the console and the file
+    logger->setAsync(true, 4096, OverflowPolicy::CountAndReport);
+    //! NOTE Writing the queued messages on a crash is opt-in (Logger::setIsFlushOnCrash installs signal handlers),
+    //! an application with its own crash reporter can call Logger::crashWrite from it instead
+#endif
+
     if (m_loggerLevel) {
         logger->setLevel(m_loggerLevel.value());
     } else {
@@ -200,6 +209,12 @@ void GlobalModule::onPreInit(const IApplication::RunMode& mode)
     Profiler* profiler = Profiler::instance();
     profiler->setup(profOpt, new MyPrinter());
 
+    //! NOTE Tracing is enabled without rebuilding, the trace is saved on deinit
+    if (const char* traceFile = std::getenv("MUSE_TRACE_FILE")) {
+        LOGI() << "tracing enabled, trace file: " << traceFile;
+        Tracer::instance()->start();
+    }
+
     //! --- Setup Ticker ---
     m_tickerProvider->start();
 
@@ -250,8 +265,19 @@ void GlobalModule::onInit(const IApplication::RunMode&)
 void GlobalModule::onDeinit()
 {
     m_tickerProvider->stop();
+    settings()->flush();
     muse::async::terminate();
 
+    if (const char* traceFile = std::getenv("MUSE_TRACE_FILE")) {
+        muse::profiler::Tracer* tracer = muse::profiler::Tracer::instance();
+        tracer->stop();
+        if (!tracer->save(traceFile)) {
+            LOGE() << "failed save trace file: " << traceFile;
+        }
+    }
+
+    muse::logger::Logger::instance()->flush();
+
 #ifdef Q_OS_WIN
     if (m_endTimePeriod) {
         timeEndPeriod(1);
@@ -23,6 +23,7 @@
 
 #include "global/types/version.h"
 #include "global/globalmodule.h"
+#include "global/modularity/moduleinitscheduler.h"
 #include "global/async/processevents.h"
 
 #include "muse_framework_config.h"
@@ -171,23 +172,26 @@ void BaseApplication::doSetup(const std::shared_ptr<CmdOptions>& options)
 
     modularity::globalIoc()->registerExport<IApplication>("global", shared_from_this());
 
+    modularity::ModuleInitScheduler scheduler;
+    scheduler.setModules(m_modules);
+
     m_globalModule = new GlobalModule();
     m_globalModule->registerResources();
     m_globalModule->registerExports();
     m_globalModule->registerUiTypes();
 
-    for (modularity::IModuleSetup* m : m_modules) {
+    scheduler.runSequential("registerExports", [](modularity::IModuleSetup* m) {
         m->registerResources();
         m->registerExports();
-    }
+    });
 
     m_globalModule->resolveImports();
     m_globalModule->registerApi();
-    for (modularity::IModuleSetup* m : m_modules) {
+    scheduler.runSequential("resolveImports", [](modularity::IModuleSetup* m) {
         m->registerUiTypes();
         m->resolveImports();
         m->registerApi();
-    }
+    });
 
     // ====================================================
     // Setup modules: apply the command line options
@@ -198,25 +202,29 @@ void BaseApplication::doSetup(const std::shared_ptr<CmdOptions>& options)
     // Setup modules: onPreInit
     // ====================================================
     m_globalModule->onPreInit(runMode);
-    for (modularity::IModuleSetup* m : m_modules) {
+    scheduler.runSequential("onPreInit", [runMode](modularity::IModuleSetup* m) {
         m->onPreInit(runMode);
-    }
+    });
 
     // ====================================================
     // Setup modules: onInit
     // ====================================================
+    //! NOTE Modules run by their dependencies, concurrent modules on worker threads
     m_globalModule->onInit(runMode);
-    for (modularity::IModuleSetup* m : m_modules) {
+    scheduler.runScheduled("onInit", [runMode](modularity::IModuleSetup* m) {
         m->onInit(runMode);
-    }
+    });
 
     // ====================================================
     // Setup modules: onAllInited
     // ====================================================
     m_globalModule->onAllInited(runMode);
-    for (modularity::IModuleSetup* m : m_modules) {
+    scheduler.runScheduled("onAllInited", [runMode](modularity::IModuleSetup* m) {
         m->onAllInited(runMode);
-    }
+    });
+
+    //! NOTE The report is multi-line, so only in the debug log
+    LOGD() << scheduler.timingReport();
 
     // ====================================================
     // Setup modules: onStartApp (on next event loop)
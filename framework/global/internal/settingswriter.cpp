@@ -0,0 +1,152 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "settingswriter.h"
+
+#include <algorithm>
+
+#include "runtime.h"
+
+#include "muse_framework_config.h"
+
+using namespace muse;
+
+SettingsWriter::SettingsWriter(const WriteFunc& func, std::chrono::milliseconds delay, std::chrono::milliseconds maxDelay)
+    : m_func(func), m_delay(delay), m_maxDelay(std::max(delay, maxDelay))
+{
+}
+
+SettingsWriter::~SettingsWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    flush();
+}
+
+void SettingsWriter::setValue(const std::string& key, const Val& value)
+{
+#ifdef MUSE_THREADS_SUPPORT
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Clock::time_point now = Clock::now();
+        if (m_pending.empty()) {
+            m_firstChangeTime = now;
+        }
+        m_lastChangeTime = now;
+        m_pending[key] = value;
+
+        if (!m_thread.joinable()) {
+            startThread();
+        }
+    }
+    m_cv.notify_one();
+#else
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending[key] = value;
+    }
+    writePending();
+#endif
+}
+
+void SettingsWriter::startThread()
+{
+    m_thread = std::thread([this]() {
+        runtime::setThreadName("settings_writer");
+        threadLoop();
+    });
+}
+
+void SettingsWriter::threadLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stop) {
+        if (m_pending.empty()) {
+            m_cv.wait(lock);
+            continue;
+        }
+
+        const Clock::time_point writeTime = std::min(m_lastChangeTime + m_delay, m_firstChangeTime + m_maxDelay);
+        if (Clock::now() < writeTime) {
+            m_cv.wait_until(lock, writeTime);
+            continue;
+        }
+
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> writeLock(m_writeMutex);
+            writePending();
+        }
+        lock.lock();
+    }
+}
+
+void SettingsWriter::writePending()
+{
+    Values values;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        values.swap(m_pending);
+    }
+
+    if (values.empty()) {
+        return;
+    }
+
+    m_func(values);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_writesCount;
+}
+
+void SettingsWriter::flush()
+{
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    writePending();
+}
+
+void SettingsWriter::discard()
+{
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.clear();
+}
+
+size_t SettingsWriter::pendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+size_t SettingsWriter::writesCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writesCount;
+}
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "types/val.h"
+
+namespace muse {
+//! NOTE Write-behind for the settings.
+//! The values are collected (coalesced by key) and written by batches
+//! on a background thread, after there have been no changes for the delay time
+//! (but no later than maxDelay after the first not written change).
+//! The batches are written in order, one at a time.
+//! Without threads support, each value is written immediately.
+class SettingsWriter
+{
+public:
+    using Values = std::map<std::string, Val>;
+    using WriteFunc = std::function<void (const Values& values)>;
+
+    SettingsWriter(const WriteFunc& func, std::chrono::milliseconds delay = std::chrono::milliseconds(500),
+                   std::chrono::milliseconds maxDelay = std::chrono::milliseconds(3000));
+    ~SettingsWriter(); // flush
+
+    void setValue(const std::string& key, const Val& value);
+
+    //! NOTE Writes the pending values on the calling thread (waits for the current batch)
+    void flush();
+
+    //! NOTE Drops the pending values (waits for the current batch)
+    void discard();
+
+    size_t pendingCount() const;
+    size_t writesCount() const; // number of written batches
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void startThread();
+    void threadLoop();
+    void writePending(); // m_writeMutex must be locked
+
+    WriteFunc m_func;
+    const std::chrono::milliseconds m_delay;
+    const std::chrono::milliseconds m_maxDelay;
+
+    std::mutex m_writeMutex; // serializes the batches
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    Values m_pending;
+    Clock::time_point m_firstChangeTime;
+    Clock::time_point m_lastChangeTime;
+    size_t m_writesCount = 0;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+}
@@ -20,6 +20,8 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include <QTimer>
 
 #include "tickerprovider.h"
@@ -29,23 +31,14 @@ using namespace muse;
 // heuristic value
 static const int ONE_TICK_INTERVAL_MS = 16;
 
-static uint32_t newTaskId()
-{
-    static uint32_t lastId = 0;
-    ++lastId;
-    return lastId;
-}
-
 void TickerProvider::start()
 {
-    m_ticks = 0;
     m_timer = std::make_shared<QTimer>();
-    m_timer->setInterval(ONE_TICK_INTERVAL_MS);
     m_timer->setSingleShot(true);
     QObject::connect(m_timer.get(), &QTimer::timeout, [this]() {
         process();
     });
-    m_timer->start();
+    sleep(1);
 }
 
 void TickerProvider::stop()
@@ -61,62 +54,76 @@ void TickerProvider::forceSchedule()
     if (!m_timer) {
         start();
     } else if (!m_timer->isActive()) {
-        m_timer->start();
+        sleep(1);
     }
 }
 
-void TickerProvider::addPending()
+void TickerProvider::sleep(TimerWheel::Tick ticks)
 {
-    for (const auto& p : m_pendingToAdd) {
-        m_tasks.insert({ p.first, p.second });
-    }
-    m_pendingToAdd.clear();
+    m_sleepTicks = ticks;
+    m_sleepStart = Clock::now();
+    m_timer->start(static_cast<int>(ticks * ONE_TICK_INTERVAL_MS));
 }
 
-void TickerProvider::removePending()
+void TickerProvider::schedule()
 {
-    for (uint32_t taskId : m_pendingToRemove) {
-        auto it = m_tasks.find(taskId);
-        if (it != m_tasks.end()) {
-            m_tasks.erase(it);
-        }
+    if (!m_timer) {
+        return;
     }
-    m_pendingToRemove.clear();
+
+    const TimerWheel::Tick next = m_wheel.nextExpiry();
+    if (next == TimerWheel::NO_EXPIRY) {
+        //! NOTE No tasks, will be started on add
+        m_sleepTicks = 0;
+        return;
+    }
+
+    sleep(next);
 }
 
 void TickerProvider::process()
 {
-    addPending();
-
-    removePending();
+    //! NOTE The tasks may process events (see BaseApplication::processEvents),
+    //! so this can be called recursively
+    ++m_processing;
+    m_wheel.advance(std::max(m_sleepTicks, TimerWheel::Tick(1)));
+    --m_processing;
+
+    if (m_processing == 0 && m_timer && !m_timer->isActive()) {
+        schedule();
+    }
+}
 
-    for (auto& p : m_tasks) {
-        Task& task = p.second;
-        if (task.interval == 0 || m_ticks % task.interval == 0) {
-            task.call();
+uint32_t TickerProvider::addTask(const Task& task)
+{
+    const TimerWheel::Tick interval = std::max(task.interval, uint32_t(1));
+    const TimerWheel::Tick period = task.repeat ? interval : 0;
 
-            if (!task.repeat) {
-                m_pendingToRemove.push_back(p.first);
-            }
+    if (!m_timer || !m_timer->isActive()) {
+        const uint32_t id = m_wheel.add(interval, period, task.call);
+        if (m_timer && m_processing == 0) {
+            sleep(interval);
         }
+        return id;
     }
 
-    removePending();
+    //! NOTE The wheel is advanced on wake up, so the ticks passed during the current sleep are added
+    const auto sleptMs = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_sleepStart).count();
+    const TimerWheel::Tick slept = std::min(static_cast<TimerWheel::Tick>(sleptMs / ONE_TICK_INTERVAL_MS), m_sleepTicks - 1);
+    const TimerWheel::Tick delay = interval + slept;
 
-    ++m_ticks;
+    const uint32_t id = m_wheel.add(delay, period, task.call);
 
-    // next iteration
-    m_timer->start();
-}
+    if (delay < m_sleepTicks) {
+        m_sleepTicks = delay;
+        const auto left = static_cast<int>(delay * ONE_TICK_INTERVAL_MS - sleptMs);
+        m_timer->start(std::max(left, 0));
+    }
 
-uint32_t TickerProvider::addTask(const Task& task)
-{
-    uint32_t taskId = newTaskId();
-    m_pendingToAdd.insert({ taskId, task });
-    return taskId;
+    return id;
 }
 
 void TickerProvider::removeTask(const uint32_t& taskId)
 {
-    m_pendingToRemove.push_back(taskId);
+    m_wheel.cancel(taskId);
 }
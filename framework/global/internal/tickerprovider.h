@@ -21,13 +21,15 @@
  */
 #pragma once
 
-#include <vector>
-#include <map>
+#include <chrono>
+#include <memory>
 
 #include "../itickerprovider.h"
+#include "../timerwheel.h"
 
 class QTimer;
 namespace muse {
+//! NOTE The tasks are kept in the timer wheel, the timer sleeps until the next tick with tasks
 class TickerProvider : public ITickerProvider
 {
 public:
@@ -41,16 +43,16 @@ public:
     void removeTask(const uint32_t& taskId) override;
 
 private:
+    using Clock = std::chrono::steady_clock;
 
     void process();
+    void schedule();
+    void sleep(TimerWheel::Tick ticks);
 
-    void addPending();
-    void removePending();
-
-    uint32_t m_ticks = 0;
     std::shared_ptr<QTimer> m_timer;
-    std::map<uint32_t /*id*/, Task> m_tasks;
-    std::vector<uint32_t /*ids*/> m_pendingToRemove;
-    std::map<uint32_t /*id*/, Task> m_pendingToAdd;
+    TimerWheel m_wheel;
+    TimerWheel::Tick m_sleepTicks = 0;
+    Clock::time_point m_sleepStart;
+    int m_processing = 0;
 };
 }
@@ -0,0 +1,273 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "chunkedfilereader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ioretcodes.h"
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::io;
+
+ChunkedFileReader::ChunkedFileReader(const path_t& filePath, size_t chunkSize, AccessHint hint)
+    : m_filePath(filePath), m_chunkSize(std::max(chunkSize, size_t(1))), m_hint(hint)
+{
+}
+
+ChunkedFileReader::~ChunkedFileReader()
+{
+    closeFile();
+}
+
+const path_t& ChunkedFileReader::filePath() const
+{
+    return m_filePath;
+}
+
+bool ChunkedFileReader::doOpen(OpenMode m)
+{
+    closeFile();
+
+    if (m != OpenMode::ReadOnly) {
+        setError(int(Err::FSReadError), "ChunkedFileReader supports only ReadOnly mode");
+        return false;
+    }
+
+#ifdef _WIN32
+    DWORD flags = FILE_ATTRIBUTE_NORMAL;
+    if (m_hint == AccessHint::Sequential) {
+        flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+    } else if (m_hint == AccessHint::Random) {
+        flags |= FILE_FLAG_RANDOM_ACCESS;
+    }
+
+    const std::wstring path = m_filePath.toString().toStdWString();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, flags, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        setError(int(Err::FSReadError), "Failed to open file: " + m_filePath.toStdString());
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        setError(int(Err::FSReadError), "Not a regular file: " + m_filePath.toStdString());
+        return false;
+    }
+
+    m_handle = file;
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = ::open(m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        setError(int(Err::FSReadError), "Failed to open file: " + m_filePath.toStdString());
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        setError(int(Err::FSReadError), "Not a regular file: " + m_filePath.toStdString());
+        return false;
+    }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    int advice = POSIX_FADV_NORMAL;
+    if (m_hint == AccessHint::Sequential) {
+        advice = POSIX_FADV_SEQUENTIAL;
+    } else if (m_hint == AccessHint::Random) {
+        advice = POSIX_FADV_RANDOM;
+    }
+    ::posix_fadvise(fd, 0, 0, advice);
+#elif defined(F_RDAHEAD)
+    ::fcntl(fd, F_RDAHEAD, m_hint == AccessHint::Random ? 0 : 1);
+#endif
+
+    m_fd = fd;
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return true;
+}
+
+void ChunkedFileReader::closeFile()
+{
+#ifdef _WIN32
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+    }
+#else
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+#endif
+
+    m_size = 0;
+    m_chunk.clear();
+    m_chunk.shrink_to_fit();
+    m_chunkPos = 0;
+    m_chunkLen = 0;
+    m_all = ByteArray();
+    m_allLoaded = false;
+}
+
+size_t ChunkedFileReader::dataSize() const
+{
+    return m_size;
+}
+
+const uint8_t* ChunkedFileReader::rawData() const
+{
+    if (!m_allLoaded) {
+        m_all = ByteArray(m_size);
+        m_all.resize(readFile(0, m_all.data(), m_size));
+        m_allLoaded = true;
+    }
+
+    return m_all.constData();
+}
+
+bool ChunkedFileReader::resizeData(size_t)
+{
+    return false;
+}
+
+size_t ChunkedFileReader::writeData(const uint8_t*, size_t)
+{
+    return 0;
+}
+
+size_t ChunkedFileReader::copyData(size_t pos, uint8_t* data, size_t len)
+{
+    size_t done = 0;
+    while (done < len) {
+        const size_t p = pos + done;
+        const size_t left = len - done;
+
+        if (p >= m_chunkPos && p < m_chunkPos + m_chunkLen) {
+            const size_t n = std::min(left, m_chunkPos + m_chunkLen - p);
+            std::memcpy(data + done, m_chunk.data() + (p - m_chunkPos), n);
+            done += n;
+            continue;
+        }
+
+        //! NOTE Large reads go directly to the destination
+        if (left >= m_chunkSize) {
+            const size_t n = readFile(p, data + done, left);
+            if (n == 0) {
+                break;
+            }
+            done += n;
+            readAhead(p + n);
+            continue;
+        }
+
+        if (!loadChunk(p)) {
+            break;
+        }
+    }
+
+    return done;
+}
+
+ByteArray ChunkedFileReader::sliceData(size_t pos, size_t len)
+{
+    ByteArray result(len);
+    result.resize(copyData(pos, result.data(), len));
+    return result;
+}
+
+bool ChunkedFileReader::loadChunk(size_t pos)
+{
+    if (m_chunk.empty()) {
+        m_chunk.resize(m_chunkSize);
+    }
+
+    m_chunkPos = pos - pos % m_chunkSize;
+    m_chunkLen = m_chunkPos < m_size ? readFile(m_chunkPos, m_chunk.data(), std::min(m_chunkSize, m_size - m_chunkPos)) : 0;
+
+    readAhead(m_chunkPos + m_chunkLen);
+
+    return pos < m_chunkPos + m_chunkLen;
+}
+
+void ChunkedFileReader::readAhead(size_t pos)
+{
+    if (m_hint != AccessHint::Sequential || pos >= m_size) {
+        return;
+    }
+
+    //! NOTE On Windows the read-ahead is done by the system for FILE_FLAG_SEQUENTIAL_SCAN
+#if defined(POSIX_FADV_WILLNEED)
+    ::posix_fadvise(m_fd, static_cast<off_t>(pos), static_cast<off_t>(std::min(m_chunkSize, m_size - pos)), POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+    struct radvisory ra;
+    ra.ra_offset = static_cast<off_t>(pos);
+    ra.ra_count = static_cast<int>(std::min(m_chunkSize, m_size - pos));
+    ::fcntl(m_fd, F_RDADVISE, &ra);
+#endif
+}
+
+size_t ChunkedFileReader::readFile(size_t pos, uint8_t* data, size_t len) const
+{
+    size_t done = 0;
+    while (done < len) {
+#ifdef _WIN32
+        OVERLAPPED ov = {};
+        const uint64_t offset = static_cast<uint64_t>(pos + done);
+        ov.Offset = static_cast<DWORD>(offset & 0xffffffff);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD read = 0;
+        const DWORD count = static_cast<DWORD>(std::min(len - done, size_t(1) << 30));
+        if (!ReadFile(m_handle, data + done, count, &read, &ov) || read == 0) {
+            break;
+        }
+#else
+        const ssize_t read = ::pread(m_fd, data + done, len - done, static_cast<off_t>(pos + done));
+        if (read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (read <= 0) {
+            break;
+        }
+#endif
+        done += static_cast<size_t>(read);
+    }
+
+    return done;
+}
@@ -0,0 +1,83 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+
+#include "iodevice.h"
+#include "ioenums.h"
+#include "path.h"
+
+namespace muse::io {
+//! NOTE Reads the file by chunks, only the current chunk is kept in memory.
+//! With the Sequential hint the system is asked to read ahead the next chunk while the current one is processed.
+//! Read only, regular files only.
+//! readData() has to load the whole file, so it's better to use File (or MappedFile) for such consumers.
+class ChunkedFileReader : public IODevice
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 256 * 1024;
+
+    ChunkedFileReader() = default;
+    explicit ChunkedFileReader(const path_t& filePath, size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                               AccessHint hint = AccessHint::Sequential);
+    ~ChunkedFileReader() override;
+
+    ChunkedFileReader(const ChunkedFileReader&) = delete;
+    ChunkedFileReader& operator=(const ChunkedFileReader&) = delete;
+
+    const path_t& filePath() const;
+
+protected:
+    bool doOpen(OpenMode m) override;
+    size_t dataSize() const override;
+    const uint8_t* rawData() const override;
+    bool resizeData(size_t size) override;
+    size_t writeData(const uint8_t* data, size_t len) override;
+    size_t copyData(size_t pos, uint8_t* data, size_t len) override;
+    ByteArray sliceData(size_t pos, size_t len) override;
+
+private:
+    void closeFile();
+    size_t readFile(size_t pos, uint8_t* data, size_t len) const;
+    bool loadChunk(size_t pos);
+    void readAhead(size_t pos);
+
+    path_t m_filePath;
+    size_t m_chunkSize = DEFAULT_CHUNK_SIZE;
+    AccessHint m_hint = AccessHint::Sequential;
+    size_t m_size = 0;
+
+    std::vector<uint8_t> m_chunk;
+    size_t m_chunkPos = 0;
+    size_t m_chunkLen = 0;
+
+    mutable ByteArray m_all;
+    mutable bool m_allLoaded = false;
+
+#ifdef _WIN32
+    void* m_handle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+}
@@ -142,3 +142,13 @@ size_t File::writeData(const uint8_t* data, size_t len)
     }
     return len;
 }
+
+ByteArray File::sliceData(size_t pos, size_t len)
+{
+    //! NOTE The whole data is shared, not copied (it may be mapped)
+    if (pos == 0 && len == m_data.size()) {
+        return m_data;
+    }
+
+    return IODevice::sliceData(pos, len);
+}
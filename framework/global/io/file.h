@@ -57,6 +57,7 @@ protected:
     const uint8_t* rawData() const override;
     bool resizeData(size_t size) override;
     size_t writeData(const uint8_t* data, size_t len) override;
+    ByteArray sliceData(size_t pos, size_t len) override;
 
 private:
 
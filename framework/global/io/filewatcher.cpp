@@ -24,49 +24,128 @@
 
 #ifndef NO_QT_SUPPORT
 #include <QFileSystemWatcher>
+#include <QTimer>
 #endif
 
-namespace muse::io {
-#ifndef NO_QT_SUPPORT
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+#include "internal/inotifywatcher.h"
+#endif
 
+#include "log.h"
+
+namespace muse::io {
 FileWatcher::FileWatcher()
-    : m_watcher(std::make_unique<QFileSystemWatcher>())
+    : FileWatcher(Options())
+{
+}
+
+FileWatcher::FileWatcher(const Options& options)
+    : m_options(options)
 {
-    QObject::connect(m_watcher.get(), &QFileSystemWatcher::fileChanged,
-                     [this](const QString& path) {
-        m_channel.send(path.toStdString());
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+    m_inotify = std::make_unique<InotifyWatcher>([this](const std::string& path) {
+        m_channel.send(path);
+    }, std::chrono::milliseconds(options.debounceMs), options.recursive);
+
+    if (m_inotify->isValid()) {
+        return;
+    }
+
+    LOGW() << "inotify is not available, QFileSystemWatcher will be used";
+    m_inotify.reset();
+#endif
+
+#ifndef NO_QT_SUPPORT
+    m_watcher = std::make_unique<QFileSystemWatcher>();
+    QObject::connect(m_watcher.get(), &QFileSystemWatcher::fileChanged, [this](const QString& path) {
+        onChanged(path.toStdString());
     });
+    QObject::connect(m_watcher.get(), &QFileSystemWatcher::directoryChanged, [this](const QString& path) {
+        onChanged(path.toStdString());
+    });
+
+    if (m_options.debounceMs > 0) {
+        m_debounceTimer = std::make_unique<QTimer>();
+        m_debounceTimer->setSingleShot(true);
+        m_debounceTimer->setInterval(m_options.debounceMs);
+        QObject::connect(m_debounceTimer.get(), &QTimer::timeout, [this]() {
+            std::set<std::string> paths;
+            paths.swap(m_changedPaths);
+            for (const std::string& path : paths) {
+                m_channel.send(path);
+            }
+        });
+    }
+
+    if (m_options.recursive) {
+        LOGW() << "recursive watching is not supported by QFileSystemWatcher";
+    }
+#endif
 }
 
-FileWatcher::~FileWatcher() = default;
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+    //! NOTE Stop the watcher thread before the channel is destroyed
+    m_inotify.reset();
+#endif
+}
 
 void FileWatcher::startWatching(const std::string& path)
 {
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+    if (m_inotify) {
+        if (!m_inotify->addPath(path)) {
+            LOGW() << "failed start watching: " << path;
+        }
+        return;
+    }
+#endif
+
+#ifndef NO_QT_SUPPORT
     m_watcher->addPath(QString::fromStdString(path));
+#endif
 }
 
 void FileWatcher::stopWatching(const std::string& path)
 {
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+    if (m_inotify) {
+        if (path.empty()) {
+            m_inotify->removeAll();
+        } else {
+            m_inotify->removePath(path);
+        }
+        return;
+    }
+#endif
+
+#ifndef NO_QT_SUPPORT
     if (path.empty()) {
-        const auto watchedPaths = m_watcher->files();
+        QStringList watchedPaths = m_watcher->files();
+        watchedPaths << m_watcher->directories();
         if (!watchedPaths.isEmpty()) {
             m_watcher->removePaths(watchedPaths);
         }
         return;
     }
     m_watcher->removePath(QString::fromStdString(path));
+#endif
 }
 
-#else
-
-FileWatcher::FileWatcher() = default;
-FileWatcher::~FileWatcher() = default;
-
-void FileWatcher::startWatching(const std::string&) {}
-void FileWatcher::stopWatching(const std::string&) {}
-
+void FileWatcher::onChanged(const std::string& path)
+{
+#ifndef NO_QT_SUPPORT
+    if (m_debounceTimer) {
+        m_changedPaths.insert(path);
+        m_debounceTimer->start();
+        return;
+    }
 #endif
 
+    m_channel.send(path);
+}
+
 muse::async::Channel<std::string> FileWatcher::fileChanged() const
 {
     return m_channel;
@@ -23,16 +23,34 @@
 
 #include "global/async/channel.h"
 
+#include "muse_framework_config.h"
+
+#include <set>
 #include <string>
 #include <memory>
 
 class QFileSystemWatcher;
+class QTimer;
 
 namespace muse::io {
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+class InotifyWatcher;
+#endif
+
+//! NOTE On Linux, inotify is used, otherwise (or if inotify is not available) QFileSystemWatcher.
+//! A path can be a file or a directory, the watched path is sent on any change in it.
+//! The changes within the debounce time are coalesced into one notification per watched path.
+//! Recursive watching of directories is supported only with inotify.
 class FileWatcher final
 {
 public:
+    struct Options {
+        int debounceMs = 0;
+        bool recursive = false;
+    };
+
     FileWatcher();
+    explicit FileWatcher(const Options& options);
     ~FileWatcher();
 
     void startWatching(const std::string& path);
@@ -40,8 +58,16 @@ public:
     muse::async::Channel<std::string> fileChanged() const;
 
 private:
+    void onChanged(const std::string& path);
+
+    Options m_options;
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+    std::unique_ptr<InotifyWatcher> m_inotify;
+#endif
 #ifndef NO_QT_SUPPORT
     std::unique_ptr<QFileSystemWatcher> m_watcher;
+    std::unique_ptr<QTimer> m_debounceTimer;
+    std::set<std::string> m_changedPaths;
 #endif
     muse::async::Channel<std::string> m_channel;
 };
@@ -197,10 +197,16 @@ Ret FileSystem::readFile(const io::path_t& filePath, ByteArray& data) const
     return ret;
 }
 
-Ret FileSystem::writeFile(const io::path_t& filePath, const ByteArray& data)
+Ret FileSystem::writeFile(const io::path_t& filePath, const ByteArray& data_)
 {
     Ret ret = muse::make_ok();
 
+    //! NOTE The data may be the mapping of this file, which is truncated on open
+    ByteArray data = data_;
+    if (data.isMapped()) {
+        data = ByteArray(data_.constData(), data_.size());
+    }
+
     QFile file(filePath.toQString());
     if (!file.open(QIODevice::WriteOnly)) {
         ret = make_ret(Err::FSWriteError);
@@ -0,0 +1,502 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "inotifywatcher.h"
+
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#include <dirent.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "runtime.h"
+
+#include "log.h"
+
+using namespace muse::io;
+
+static constexpr uint32_t WATCH_MASK = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB
+                                       | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+
+static std::string normalizedPath(const std::string& path)
+{
+    std::string p = path;
+    while (p.size() > 1 && p.back() == '/') {
+        p.pop_back();
+    }
+    return p;
+}
+
+static std::string joinPath(const std::string& dir, const std::string& name)
+{
+    return dir == "/" ? dir + name : dir + "/" + name;
+}
+
+static bool isSubPath(const std::string& path, const std::string& dir)
+{
+    return path.size() > dir.size() && path.compare(0, dir.size(), dir) == 0 && path[dir.size()] == '/';
+}
+
+InotifyWatcher::InotifyWatcher(const Callback& callback, std::chrono::milliseconds debounce, bool recursive)
+    : m_callback(callback), m_debounce(debounce), m_recursive(recursive)
+{
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        LOGE() << "failed inotify_init1, err: " << strerror(errno);
+        return;
+    }
+
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0) {
+        LOGE() << "failed eventfd, err: " << strerror(errno);
+        close(m_fd);
+        m_fd = -1;
+        return;
+    }
+
+    m_thread = std::thread([this]() {
+        muse::runtime::setThreadName("file_watcher");
+        threadLoop();
+    });
+}
+
+InotifyWatcher::~InotifyWatcher()
+{
+    if (m_thread.joinable()) {
+        m_stop = true;
+        const uint64_t one = 1;
+        UNUSED(write(m_wakeFd, &one, sizeof(one)));
+        m_thread.join();
+    }
+
+    if (m_wakeFd >= 0) {
+        close(m_wakeFd);
+    }
+
+    if (m_fd >= 0) {
+        close(m_fd);
+    }
+}
+
+bool InotifyWatcher::isValid() const
+{
+    return m_fd >= 0;
+}
+
+bool InotifyWatcher::addPath(const std::string& path_)
+{
+    const std::string path = normalizedPath(path_);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_roots.find(path) != m_roots.end()) {
+        return true;
+    }
+
+    Root root;
+    if (!addRoot(path, root)) {
+        return false;
+    }
+
+    m_roots[path] = std::move(root);
+    return true;
+}
+
+void InotifyWatcher::removePath(const std::string& path_)
+{
+    const std::string path = normalizedPath(path_);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_roots.find(path);
+    if (it == m_roots.end()) {
+        return;
+    }
+
+    removeRoot(it->first, it->second);
+    m_roots.erase(it);
+}
+
+void InotifyWatcher::removeAll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& p : m_roots) {
+        removeRoot(p.first, p.second);
+    }
+    m_roots.clear();
+}
+
+std::vector<std::string> InotifyWatcher::paths() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> result;
+    result.reserve(m_roots.size());
+    for (const auto& p : m_roots) {
+        result.push_back(p.first);
+    }
+    return result;
+}
+
+size_t InotifyWatcher::watchesCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_watches.size();
+}
+
+size_t InotifyWatcher::overflowsCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_overflowsCount;
+}
+
+bool InotifyWatcher::addRoot(const std::string& path, Root& root)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        root.isDir = true;
+        root.dirPath = path;
+        if (m_recursive) {
+            addTree(path, root, path);
+        } else {
+            addWatch(path, root, path);
+        }
+    } else {
+        const size_t pos = path.rfind('/');
+        root.isDir = false;
+        root.dirPath = pos == std::string::npos ? std::string(".") : (pos == 0 ? std::string("/") : path.substr(0, pos));
+        root.fileName = pos == std::string::npos ? path : path.substr(pos + 1);
+        addWatch(path, root, root.dirPath);
+    }
+
+    return !root.wds.empty();
+}
+
+void InotifyWatcher::removeRoot(const std::string& path, Root& root)
+{
+    const std::set<int> wds = root.wds;
+    for (int wd : wds) {
+        removeWatch(path, root, wd);
+    }
+}
+
+int InotifyWatcher::addWatch(const std::string& rootPath, Root& root, const std::string& dirPath)
+{
+    //! NOTE If the directory is already watched, the same wd is returned
+    const int wd = inotify_add_watch(m_fd, dirPath.c_str(), WATCH_MASK);
+    if (wd < 0) {
+        LOGW() << "failed add watch: " << dirPath << ", err: " << strerror(errno);
+        return -1;
+    }
+
+    Watch& w = m_watches[wd];
+    w.path = dirPath;
+    w.roots.insert(rootPath);
+    root.wds.insert(wd);
+
+    return wd;
+}
+
+void InotifyWatcher::addTree(const std::string& rootPath, Root& root, const std::string& dirPath)
+{
+    if (addWatch(rootPath, root, dirPath) < 0) {
+        return;
+    }
+
+    DIR* dir = opendir(dirPath.c_str());
+    if (!dir) {
+        return;
+    }
+
+    std::vector<std::string> subdirs;
+    while (dirent* ent = readdir(dir)) {
+        if (std::strcmp(ent->d_name, ".") == 0 || std::strcmp(ent->d_name, "..") == 0) {
+            continue;
+        }
+
+        const std::string subPath = joinPath(dirPath, ent->d_name);
+        bool isDir = ent->d_type == DT_DIR;
+        if (ent->d_type == DT_UNKNOWN) {
+            struct stat st;
+            isDir = lstat(subPath.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+        }
+
+        if (isDir) {
+            subdirs.push_back(subPath);
+        }
+    }
+    closedir(dir);
+
+    for (const std::string& subPath : subdirs) {
+        addTree(rootPath, root, subPath);
+    }
+}
+
+void InotifyWatcher::removeWatch(const std::string& rootPath, Root& root, int wd)
+{
+    root.wds.erase(wd);
+
+    auto it = m_watches.find(wd);
+    if (it == m_watches.end()) {
+        return;
+    }
+
+    it->second.roots.erase(rootPath);
+    if (it->second.roots.empty()) {
+        inotify_rm_watch(m_fd, wd);
+        m_watches.erase(it);
+    }
+}
+
+void InotifyWatcher::removeTree(const std::string& dirPath)
+{
+    std::vector<int> wds;
+    for (const auto& p : m_watches) {
+        if (p.second.path == dirPath || isSubPath(p.second.path, dirPath)) {
+            wds.push_back(p.first);
+        }
+    }
+
+    for (int wd : wds) {
+        const Watch watch = m_watches.at(wd);
+        for (const std::string& rootPath : watch.roots) {
+            auto rit = m_roots.find(rootPath);
+            //! NOTE The watched directory itself is kept, it is reported via IN_MOVE_SELF
+            if (rit != m_roots.end() && rit->second.isDir && rit->second.dirPath != watch.path) {
+                removeWatch(rootPath, rit->second, wd);
+            }
+        }
+    }
+}
+
+void InotifyWatcher::renameTree(const std::string& oldPath, const std::string& newPath)
+{
+    for (auto& p : m_watches) {
+        if (p.second.path == oldPath) {
+            p.second.path = newPath;
+        } else if (isSubPath(p.second.path, oldPath)) {
+            p.second.path = newPath + p.second.path.substr(oldPath.size());
+        }
+    }
+}
+
+void InotifyWatcher::markChanged(Root& root)
+{
+    root.changed = true;
+    root.deadline = Clock::now() + m_debounce;
+}
+
+void InotifyWatcher::threadLoop()
+{
+    pollfd fds[2];
+    fds[0].fd = m_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+
+    while (!m_stop) {
+        fds[0].revents = 0;
+        fds[1].revents = 0;
+
+        const int ret = poll(fds, 2, timeoutMs());
+        if (ret < 0 && errno != EINTR) {
+            LOGE() << "failed poll, err: " << strerror(errno);
+            break;
+        }
+
+        if (m_stop) {
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            readEvents();
+        }
+
+        sendChanged();
+    }
+}
+
+int InotifyWatcher::timeoutMs() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    bool hasChanged = false;
+    Clock::time_point deadline = Clock::time_point::max();
+    for (const auto& p : m_roots) {
+        if (p.second.changed) {
+            hasChanged = true;
+            deadline = std::min(deadline, p.second.deadline);
+        }
+    }
+
+    if (!hasChanged) {
+        return -1;
+    }
+
+    const auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    return static_cast<int>(std::clamp<decltype(left)>(left, 0, INT_MAX));
+}
+
+void InotifyWatcher::readEvents()
+{
+    alignas(inotify_event) char buf[64 * 1024];
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    while (true) {
+        const ssize_t len = read(m_fd, buf, sizeof(buf));
+        if (len <= 0) {
+            break;
+        }
+
+        for (char* ptr = buf; ptr < buf + len;) {
+            const inotify_event* ev = reinterpret_cast<const inotify_event*>(ptr);
+            handleEvent(ev);
+            ptr += sizeof(inotify_event) + ev->len;
+        }
+    }
+
+    handleMovedOut();
+}
+
+void InotifyWatcher::handleEvent(const inotify_event* ev)
+{
+    if (ev->mask & IN_Q_OVERFLOW) {
+        LOGW() << "inotify queue overflow, rescan";
+        rescan();
+        return;
+    }
+
+    auto it = m_watches.find(ev->wd);
+    if (it == m_watches.end()) {
+        return;
+    }
+
+    if (ev->mask & IN_IGNORED) {
+        for (const std::string& rootPath : it->second.roots) {
+            auto rit = m_roots.find(rootPath);
+            if (rit != m_roots.end()) {
+                rit->second.wds.erase(ev->wd);
+            }
+        }
+        m_watches.erase(it);
+        return;
+    }
+
+    const std::string dirPath = it->second.path;
+    const std::string name = ev->len > 0 ? std::string(ev->name) : std::string();
+    const std::set<std::string> roots = it->second.roots;
+
+    bool recursiveDir = false;
+    for (const std::string& rootPath : roots) {
+        auto rit = m_roots.find(rootPath);
+        if (rit == m_roots.end()) {
+            continue;
+        }
+
+        Root& root = rit->second;
+        if (root.isDir) {
+            recursiveDir = recursiveDir || m_recursive;
+            markChanged(root);
+        } else if (!name.empty() && name == root.fileName) {
+            markChanged(root);
+        }
+    }
+
+    if (!recursiveDir || !(ev->mask & IN_ISDIR) || name.empty()) {
+        return;
+    }
+
+    const std::string path = joinPath(dirPath, name);
+
+    if (ev->mask & IN_MOVED_FROM) {
+        m_movedFrom[ev->cookie] = path;
+        return;
+    }
+
+    if (ev->mask & IN_MOVED_TO) {
+        auto mit = m_movedFrom.find(ev->cookie);
+        if (mit != m_movedFrom.end()) {
+            //! NOTE Renamed inside the watched tree, the watches are kept
+            renameTree(mit->second, path);
+            m_movedFrom.erase(mit);
+            return;
+        }
+    }
+
+    if (ev->mask & (IN_CREATE | IN_MOVED_TO)) {
+        for (const std::string& rootPath : roots) {
+            auto rit = m_roots.find(rootPath);
+            if (rit != m_roots.end() && rit->second.isDir) {
+                addTree(rootPath, rit->second, path);
+            }
+        }
+    }
+}
+
+void InotifyWatcher::handleMovedOut()
+{
+    //! NOTE Moved out of the watched tree (or the pair event was not read yet,
+    //! in this case the tree will be added on IN_MOVED_TO)
+    for (const auto& p : m_movedFrom) {
+        removeTree(p.second);
+    }
+    m_movedFrom.clear();
+}
+
+void InotifyWatcher::rescan()
+{
+    ++m_overflowsCount;
+    m_movedFrom.clear();
+
+    for (auto& p : m_roots) {
+        removeRoot(p.first, p.second);
+        p.second = Root();
+        addRoot(p.first, p.second);
+        markChanged(p.second);
+    }
+}
+
+void InotifyWatcher::sendChanged()
+{
+    std::vector<std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Clock::time_point now = Clock::now();
+        for (auto& p : m_roots) {
+            if (p.second.changed && p.second.deadline <= now) {
+                p.second.changed = false;
+                changed.push_back(p.first);
+            }
+        }
+    }
+
+    for (const std::string& path : changed) {
+        m_callback(path);
+    }
+}
+
+#endif
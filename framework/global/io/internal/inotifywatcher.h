@@ -0,0 +1,116 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "muse_framework_config.h"
+
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct inotify_event;
+
+namespace muse::io {
+//! NOTE Linux backend of the FileWatcher.
+//! A watched file is watched via its directory (so that an atomic replace by rename is noticed),
+//! a watched directory is watched recursively if required (new and moved subdirectories are added).
+//! The changes of a watched path are coalesced, the callback is called (on the watcher thread)
+//! once there have been no changes for the debounce time.
+//! On the queue overflow, the watches are rebuilt and all watched paths are reported as changed.
+class InotifyWatcher
+{
+public:
+    using Callback = std::function<void (const std::string& path)>;
+
+    InotifyWatcher(const Callback& callback, std::chrono::milliseconds debounce, bool recursive);
+    ~InotifyWatcher();
+
+    bool isValid() const;
+
+    bool addPath(const std::string& path);
+    void removePath(const std::string& path);
+    void removeAll();
+
+    std::vector<std::string> paths() const;
+    size_t watchesCount() const;
+    size_t overflowsCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Watch {
+        std::string path;
+        std::set<std::string> roots;
+    };
+
+    struct Root {
+        bool isDir = false;
+        std::string dirPath;
+        std::string fileName; // if is not dir
+        std::set<int> wds;
+        bool changed = false;
+        Clock::time_point deadline;
+    };
+
+    void threadLoop();
+    int timeoutMs() const;
+    void readEvents();
+    void handleEvent(const inotify_event* ev);
+    void handleMovedOut();
+    void rescan();
+    void sendChanged();
+
+    bool addRoot(const std::string& path, Root& root);
+    void removeRoot(const std::string& path, Root& root);
+    int addWatch(const std::string& rootPath, Root& root, const std::string& dirPath);
+    void addTree(const std::string& rootPath, Root& root, const std::string& dirPath);
+    void removeWatch(const std::string& rootPath, Root& root, int wd);
+    void removeTree(const std::string& dirPath);
+    void renameTree(const std::string& oldPath, const std::string& newPath);
+    void markChanged(Root& root);
+
+    Callback m_callback;
+    const std::chrono::milliseconds m_debounce;
+    const bool m_recursive;
+
+    int m_fd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stop = false;
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    std::map<int /*wd*/, Watch> m_watches;
+    std::map<std::string /*path*/, Root> m_roots;
+    std::map<uint32_t /*cookie*/, std::string /*path*/> m_movedFrom;
+    size_t m_overflowsCount = 0;
+};
+}
+
+#endif
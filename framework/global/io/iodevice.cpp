@@ -141,7 +141,7 @@ size_t IODevice::read(uint8_t* data, size_t len)
         len = left;
     }
 
-    std::memcpy(data, cdataOffsetted(), len);
+    len = copyData(m_pos, data, len);
 
     m_pos += len;
     return len;
@@ -166,20 +166,32 @@ ByteArray IODevice::read(size_t len)
         len = left;
     }
 
-    ByteArray result(cdataOffsetted(), len);
+    ByteArray result = sliceData(m_pos, len);
 
-    m_pos += len;
+    m_pos += result.size();
 
     return result;
 }
 
-const uint8_t* IODevice::cdataOffsetted() const
+size_t IODevice::copyData(size_t pos, uint8_t* data, size_t len)
 {
     const uint8_t* d = rawData();
     IF_ASSERT_FAILED(d) {
-        return nullptr;
+        return 0;
     }
-    return d + m_pos;
+
+    std::memcpy(data, d + pos, len);
+    return len;
+}
+
+ByteArray IODevice::sliceData(size_t pos, size_t len)
+{
+    const uint8_t* d = rawData();
+    IF_ASSERT_FAILED(d) {
+        return ByteArray();
+    }
+
+    return ByteArray(d + pos, len);
 }
 
 ByteArray IODevice::readAll()
@@ -80,6 +80,11 @@ protected:
     virtual bool resizeData(size_t size) = 0;
     virtual size_t writeData(const uint8_t* data, size_t len) = 0;
 
+    //! NOTE By default the data is copied from rawData(),
+    //! devices that don't keep the data in memory read it here
+    virtual size_t copyData(size_t pos, uint8_t* data, size_t len);
+    virtual ByteArray sliceData(size_t pos, size_t len);
+
     bool isOpenModeReadable() const;
     bool isOpenModeWriteable() const;
 
@@ -87,8 +92,6 @@ protected:
 
 private:
 
-    const uint8_t* cdataOffsetted() const;
-
     OpenMode m_mode = OpenMode::Unknown;
     size_t m_pos = 0;
     std::map<std::string, std::string> m_meta;
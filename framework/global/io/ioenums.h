@@ -45,6 +45,13 @@ enum class EntryType {
     File,
     Dir
 };
+
+//! NOTE Hint for the system how the file data will be read, used to tune the read-ahead
+enum class AccessHint {
+    Normal,
+    Sequential,
+    Random
+};
 }
 
 #endif // MUSE_IO_IOENUMS_H
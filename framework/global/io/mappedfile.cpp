@@ -0,0 +1,260 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "mappedfile.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::io;
+
+MappedFile::MappedFile(const path_t& filePath)
+    : m_filePath(filePath)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+const path_t& MappedFile::filePath() const
+{
+    return m_filePath;
+}
+
+bool MappedFile::open()
+{
+    if (m_isOpen) {
+        return true;
+    }
+
+#if defined(_WIN32)
+    const std::wstring path = m_filePath.toString().toStdWString();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+
+    //! NOTE Empty files can't be mapped
+    if (size.QuadPart > 0) {
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping) {
+            m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+
+        if (!m_data) {
+            if (m_mapping) {
+                CloseHandle(m_mapping);
+                m_mapping = nullptr;
+            }
+            CloseHandle(file);
+            return false;
+        }
+    }
+
+    CloseHandle(file);
+    m_size = static_cast<size_t>(size.QuadPart);
+    m_isOpen = true;
+    return true;
+
+#elif !defined(__EMSCRIPTEN__)
+    const int fd = ::open(m_filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    //! NOTE Empty files can't be mapped
+    if (st.st_size > 0) {
+        void* addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(addr);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    m_size = static_cast<size_t>(st.st_size);
+    m_isOpen = true;
+    return true;
+
+#else
+    return false;
+#endif
+}
+
+void MappedFile::close()
+{
+    if (!m_isOpen) {
+        return;
+    }
+
+#if defined(_WIN32)
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+#elif !defined(__EMSCRIPTEN__)
+    if (m_data) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_isOpen;
+}
+
+const uint8_t* MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+void MappedFile::setAccessHint(AccessHint hint)
+{
+    if (!m_data) {
+        return;
+    }
+
+#if defined(_WIN32) || defined(__EMSCRIPTEN__)
+    UNUSED(hint);
+#else
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case AccessHint::Normal:
+        advice = MADV_NORMAL;
+        break;
+    case AccessHint::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case AccessHint::Random:
+        advice = MADV_RANDOM;
+        break;
+    }
+
+    ::madvise(const_cast<uint8_t*>(m_data), m_size, advice);
+#endif
+}
+
+// ByteArray
+
+static bool readFileBuffered(const path_t& filePath, ByteArray& data)
+{
+#ifdef _WIN32
+    std::FILE* file = ::_wfopen(filePath.toString().toStdWString().c_str(), L"rb");
+#else
+    std::FILE* file = std::fopen(filePath.c_str(), "rb");
+#endif
+    if (!file) {
+        return false;
+    }
+
+    //! NOTE The size may be unknown (pipes, devices), so read until the end
+    constexpr size_t CHUNK_SIZE = 64 * 1024;
+    std::vector<uint8_t>& buf = data.vdata();
+    size_t size = 0;
+    for (;;) {
+        buf.resize(size + CHUNK_SIZE + 1);
+        size_t read = std::fread(buf.data() + size, 1, CHUNK_SIZE, file);
+        size += read;
+        if (read < CHUNK_SIZE) {
+            break;
+        }
+    }
+
+    const bool ok = std::ferror(file) == 0;
+    std::fclose(file);
+
+    buf.resize(size + 1);
+    buf[size] = 0;
+    return ok;
+}
+
+ByteArray ByteArray::fromMappedFile(const std::shared_ptr<MappedFile>& file)
+{
+    IF_ASSERT_FAILED(file && file->isOpen()) {
+        return ByteArray();
+    }
+
+    ByteArray ba;
+    ba.m_raw.data = file->data();
+    ba.m_raw.size = file->size();
+    ba.m_raw.file = file;
+    return ba;
+}
+
+ByteArray ByteArray::fromMappedFile(const path_t& filePath, bool* ok)
+{
+    auto file = std::make_shared<MappedFile>(filePath);
+    if (file->open()) {
+        if (ok) {
+            *ok = true;
+        }
+        return fromMappedFile(file);
+    }
+
+    ByteArray ba;
+    bool read = readFileBuffered(filePath, ba);
+    if (ok) {
+        *ok = read;
+    }
+
+    return read ? ba : ByteArray();
+}
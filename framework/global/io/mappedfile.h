@@ -0,0 +1,67 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ioenums.h"
+#include "path.h"
+
+namespace muse::io {
+//! NOTE Read-only view of a whole file mapped into memory.
+//! The pages are loaded by the system when they are accessed, so the file is not read upfront.
+//! Works with regular files only, open() fails for others (and on platforms without mapping),
+//! the callers fall back to reading the file.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const path_t& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const path_t& filePath() const;
+
+    bool open();
+    void close();
+    bool isOpen() const;
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+    //! NOTE Should be set after open(), ignored if not supported by the system
+    void setAccessHint(AccessHint hint);
+
+private:
+    path_t m_filePath;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_isOpen = false;
+
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#endif
+};
+}
@@ -31,6 +31,7 @@ using Logger = kors::logger::Logger;
 using Type = kors::logger::Type;
 using Level = kors::logger::Level;
 using Color = kors::logger::Color;
+using OverflowPolicy = kors::logger::OverflowPolicy;
 using LogMsg = kors::logger::LogMsg;
 using LogLayout = kors::logger::LogLayout;
 using IThreadNameProvider = kors::logger::IThreadNameProvider;
@@ -24,6 +24,7 @@
 #define MU_MODULARITY_IMODULESETUP_H
 
 #include <string>
+#include <vector>
 
 #include "ioc.h"
 #include "../iapplication.h"
@@ -60,6 +61,16 @@ public:
 
     virtual std::string moduleName() const = 0;
 
+    //! NOTE Names of the modules whose onInit/onAllInited must be done before this module's ones
+    virtual std::vector<std::string> dependencies() const { return {}; }
+
+    enum class InitPolicy {
+        MainThread,
+        Concurrent  // onInit/onAllInited can run on a worker thread, concurrently with other modules
+    };
+
+    virtual InitPolicy initPolicy() const { return InitPolicy::MainThread; }
+
     ModulesGlobalIoC* globalIoc() const { return muse::modularity::globalIoc(); }
 
     virtual void registerExports() {}
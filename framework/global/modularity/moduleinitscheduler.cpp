@@ -0,0 +1,302 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "moduleinitscheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#include "muse_framework_config.h"
+
+#include "runtime.h"
+#include "log.h"
+
+using namespace muse::modularity;
+
+static double nowMs()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+ModuleInitScheduler::ModuleInitScheduler(size_t maxThreads)
+    : m_maxThreads(maxThreads > 0 ? maxThreads : std::max(2u, std::thread::hardware_concurrency()))
+{
+}
+
+bool ModuleInitScheduler::setModules(const std::vector<IModuleSetup*>& modules)
+{
+    m_nodes.clear();
+    m_nodes.reserve(modules.size());
+
+    std::unordered_map<std::string, size_t> indexes;
+    for (IModuleSetup* m : modules) {
+        Node n;
+        n.module = m;
+        n.name = m->moduleName();
+#ifdef MUSE_THREADS_SUPPORT
+        n.concurrent = m->initPolicy() == IModuleSetup::InitPolicy::Concurrent;
+#endif
+        indexes[n.name] = m_nodes.size();
+        m_nodes.push_back(std::move(n));
+    }
+
+    for (Node& n : m_nodes) {
+        for (const std::string& dep : n.module->dependencies()) {
+            auto it = indexes.find(dep);
+            if (it == indexes.end()) {
+                //! NOTE The module may be not built
+                LOGD() << "module: " << n.name << ", not found dependency: " << dep;
+                continue;
+            }
+
+            if (it->second != indexes.at(n.name)) {
+                n.deps.push_back(it->second);
+            }
+        }
+    }
+
+    //! NOTE Check cycles (Kahn's algorithm)
+    std::vector<size_t> inDegree(m_nodes.size(), 0);
+    std::vector<std::vector<size_t> > dependents(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        inDegree[i] = m_nodes[i].deps.size();
+        for (size_t d : m_nodes[i].deps) {
+            dependents[d].push_back(i);
+        }
+    }
+
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (inDegree[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    size_t visited = 0;
+    while (!ready.empty()) {
+        size_t i = ready.back();
+        ready.pop_back();
+        ++visited;
+        for (size_t d : dependents[i]) {
+            if (--inDegree[d] == 0) {
+                ready.push_back(d);
+            }
+        }
+    }
+
+    if (visited != m_nodes.size()) {
+        LOGE() << "modules dependencies have a cycle, all modules will be inited sequentially";
+        for (Node& n : m_nodes) {
+            n.deps.clear();
+            n.concurrent = false;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+double ModuleInitScheduler::runNode(const std::string& stage, const Stage& func, const Node& node, double stageBeginMs)
+{
+    const double beginMs = nowMs();
+    func(node.module);
+    const double endMs = nowMs();
+
+    Timing t;
+    t.stage = stage;
+    t.module = node.name;
+    t.beginMs = beginMs - stageBeginMs;
+    t.durationMs = endMs - beginMs;
+    t.concurrent = node.concurrent;
+    addTiming(std::move(t));
+
+    return endMs - beginMs;
+}
+
+void ModuleInitScheduler::addTiming(Timing&& t)
+{
+    std::lock_guard<std::mutex> lock(m_timingsMutex);
+    m_timings.push_back(std::move(t));
+}
+
+void ModuleInitScheduler::runSequential(const std::string& stage, const Stage& func)
+{
+    const double stageBeginMs = nowMs();
+    double sumMs = 0.0;
+    for (const Node& n : m_nodes) {
+        Node seqNode = n;
+        seqNode.concurrent = false;
+        sumMs += runNode(stage, func, seqNode, stageBeginMs);
+    }
+
+    m_stageTimings.push_back({ stage, nowMs() - stageBeginMs, sumMs });
+}
+
+void ModuleInitScheduler::runScheduled(const std::string& stage, const Stage& func)
+{
+    const double stageBeginMs = nowMs();
+
+    enum class State {
+        Pending,
+        Running,
+        Done
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<State> states(m_nodes.size(), State::Pending);
+    size_t doneCount = 0;
+    double sumMs = 0.0;
+
+    auto isReady = [this, &states](size_t i) {
+        for (size_t d : m_nodes[i].deps) {
+            if (states[d] != State::Done) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    //! NOTE Must be called with locked mutex, unlocks it while the module is running
+    auto tryRunNext = [&](std::unique_lock<std::mutex>& lock, bool concurrent) {
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i].concurrent != concurrent || states[i] != State::Pending || !isReady(i)) {
+                continue;
+            }
+
+            states[i] = State::Running;
+            lock.unlock();
+            const double durationMs = runNode(stage, func, m_nodes[i], stageBeginMs);
+            lock.lock();
+            sumMs += durationMs;
+            states[i] = State::Done;
+            ++doneCount;
+            cv.notify_all();
+            return true;
+        }
+        return false;
+    };
+
+    auto hasPending = [this, &states](bool concurrent) {
+        for (size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i].concurrent == concurrent && states[i] == State::Pending) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::vector<std::thread> workers;
+
+#ifdef MUSE_THREADS_SUPPORT
+    const size_t concurrentCount = std::count_if(m_nodes.begin(), m_nodes.end(), [](const Node& n) { return n.concurrent; });
+    const size_t threadsCount = std::min(m_maxThreads, concurrentCount);
+    for (size_t t = 0; t < threadsCount; ++t) {
+        workers.emplace_back([&]() {
+            muse::runtime::setThreadName("module_init");
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                if (tryRunNext(lock, true)) {
+                    continue;
+                }
+
+                if (!hasPending(true)) {
+                    return;
+                }
+
+                cv.wait(lock);
+            }
+        });
+    }
+#endif
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (doneCount < m_nodes.size()) {
+            if (tryRunNext(lock, false)) {
+                continue;
+            }
+
+            cv.wait(lock);
+        }
+    }
+
+    for (std::thread& th : workers) {
+        th.join();
+    }
+
+    m_stageTimings.push_back({ stage, nowMs() - stageBeginMs, sumMs });
+}
+
+const std::vector<ModuleInitScheduler::Timing>& ModuleInitScheduler::timings() const
+{
+    return m_timings;
+}
+
+const std::vector<ModuleInitScheduler::StageTiming>& ModuleInitScheduler::stageTimings() const
+{
+    return m_stageTimings;
+}
+
+std::string ModuleInitScheduler::timingReport() const
+{
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    double wallMs = 0.0;
+    double sumMs = 0.0;
+    for (const StageTiming& st : m_stageTimings) {
+        wallMs += st.wallMs;
+        sumMs += st.sumMs;
+    }
+
+    ss << "modules startup: " << wallMs << " ms (sum of modules: " << sumMs << " ms)\n";
+
+    for (const StageTiming& st : m_stageTimings) {
+        ss << "stage: " << st.stage << ", wall: " << st.wallMs << " ms, sum: " << st.sumMs << " ms\n";
+
+        std::vector<Timing> stageTimings;
+        for (const Timing& t : m_timings) {
+            if (t.stage == st.stage) {
+                stageTimings.push_back(t);
+            }
+        }
+
+        std::sort(stageTimings.begin(), stageTimings.end(), [](const Timing& t1, const Timing& t2) {
+            return t1.durationMs > t2.durationMs;
+        });
+
+        for (const Timing& t : stageTimings) {
+            ss << "    " << std::left << std::setw(24) << t.module << std::right
+               << std::setw(10) << t.durationMs << " ms, begin: " << std::setw(10) << t.beginMs << " ms"
+               << (t.concurrent ? ", concurrent" : "") << "\n";
+        }
+    }
+
+    return ss.str();
+}
@@ -0,0 +1,89 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_MODULARITY_MODULEINITSCHEDULER_H
+#define MU_MODULARITY_MODULEINITSCHEDULER_H
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "imodulesetup.h"
+
+namespace muse::modularity {
+//! NOTE Runs a setup stage over the modules.
+//! A scheduled stage respects the declared dependencies (IModuleSetup::dependencies),
+//! runs the modules with InitPolicy::Concurrent on worker threads
+//! and the other modules on the calling thread.
+//! Modules without dependencies on the calling thread keep the registration order.
+class ModuleInitScheduler
+{
+public:
+    explicit ModuleInitScheduler(size_t maxThreads = 0); // 0 - by hardware concurrency
+
+    using Stage = std::function<void (IModuleSetup* m)>;
+
+    struct Timing {
+        std::string stage;
+        std::string module;
+        double beginMs = 0.0; // from the stage begin
+        double durationMs = 0.0;
+        bool concurrent = false;
+    };
+
+    struct StageTiming {
+        std::string stage;
+        double wallMs = 0.0;
+        double sumMs = 0.0;
+    };
+
+    //! NOTE Returns false if the dependencies have a cycle, in this case the dependencies are ignored
+    bool setModules(const std::vector<IModuleSetup*>& modules);
+
+    void runSequential(const std::string& stage, const Stage& func);
+    void runScheduled(const std::string& stage, const Stage& func);
+
+    const std::vector<Timing>& timings() const;
+    const std::vector<StageTiming>& stageTimings() const;
+    std::string timingReport() const;
+
+private:
+    struct Node {
+        IModuleSetup* module = nullptr;
+        std::string name;
+        bool concurrent = false;
+        std::vector<size_t> deps;
+    };
+
+    double runNode(const std::string& stage, const Stage& func, const Node& node, double stageBeginMs);
+    void addTiming(Timing&& t);
+
+    size_t m_maxThreads = 0;
+    std::vector<Node> m_nodes;
+    std::mutex m_timingsMutex;
+    std::vector<Timing> m_timings;
+    std::vector<StageTiming> m_stageTimings;
+};
+}
+
+#endif // MU_MODULARITY_MODULEINITSCHEDULER_H
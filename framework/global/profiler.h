@@ -23,9 +23,11 @@
 #define MU_PROFILER_H
 
 #include "thirdparty/kors_profiler/profiler/profiler.h" // IWYU pragma: export
+#include "thirdparty/kors_profiler/profiler/tracer.h" // IWYU pragma: export
 
 namespace muse::profiler {
 using Profiler = kors::profiler::Profiler;
+using Tracer = kors::profiler::Tracer;
 }
 
 #endif // MU_PROFILER_H
@@ -33,11 +33,14 @@
 #include "log.h"
 #endif
 
+#include "profiler.h"
+
 static thread_local std::string s_threadName;
 
 void muse::runtime::setThreadName(const std::string& name)
 {
     s_threadName = name;
+    muse::profiler::Tracer::instance()->setThreadName(name);
 #if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
     // Set thread name through pthreads to aid debuggers that display such names.
     // Thread names are limited to 16 bytes on Linux, including the
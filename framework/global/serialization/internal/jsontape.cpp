@@ -0,0 +1,613 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "jsontape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+
+using namespace muse;
+
+static inline bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+static inline void skipSpaces(const char*& p, const char* end)
+{
+    while (p != end && isSpace(*p)) {
+        ++p;
+    }
+}
+
+static inline bool isNumberChar(char ch)
+{
+    return (ch >= '0' && ch <= '9') || ch == '+' || ch == '-' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+static inline int hexValue(char ch)
+{
+    if (ch >= '0' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'a' && ch <= 'f') {
+        return ch - 'a' + 10;
+    }
+    if (ch >= 'A' && ch <= 'F') {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+static bool parseQuadHex(const char*& p, const char* end, int& value)
+{
+    if (end - p < 4) {
+        return false;
+    }
+
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int h = hexValue(p[i]);
+        if (h < 0) {
+            return false;
+        }
+        value = value * 16 + h;
+    }
+    p += 4;
+    return true;
+}
+
+static void appendUtf8(std::string& out, uint32_t ch)
+{
+    if (ch < 0x80) {
+        out.push_back(static_cast<char>(ch));
+    } else if (ch < 0x800) {
+        out.push_back(static_cast<char>(0xc0 | (ch >> 6)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+    } else if (ch < 0x10000) {
+        out.push_back(static_cast<char>(0xe0 | (ch >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+    } else {
+        out.push_back(static_cast<char>(0xf0 | (ch >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 12) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | ((ch >> 6) & 0x3f)));
+        out.push_back(static_cast<char>(0x80 | (ch & 0x3f)));
+    }
+}
+
+// =======================================
+// JsonTape
+// =======================================
+
+//! NOTE p points after the opening quote, on success - after the closing one
+bool JsonTape::parseString(const char*& p, const char* end)
+{
+    Entry e;
+    e.type = Type::String;
+    e.offset = m_strings.size();
+
+    while (true) {
+        //! NOTE Copy the run of plain characters at once
+        const char* run = p;
+        while (p != end && *p != '"' && *p != '\\' && static_cast<unsigned char>(*p) >= 0x20) {
+            ++p;
+        }
+        m_strings.append(run, static_cast<size_t>(p - run));
+
+        if (p == end || static_cast<unsigned char>(*p) < 0x20) {
+            return false;
+        }
+
+        if (*p == '"') {
+            ++p;
+            break;
+        }
+
+        // escape
+        ++p;
+        if (p == end) {
+            return false;
+        }
+
+        switch (*p++) {
+        case '"': m_strings.push_back('"');
+            break;
+        case '\\': m_strings.push_back('\\');
+            break;
+        case '/': m_strings.push_back('/');
+            break;
+        case 'b': m_strings.push_back('\b');
+            break;
+        case 'f': m_strings.push_back('\f');
+            break;
+        case 'n': m_strings.push_back('\n');
+            break;
+        case 'r': m_strings.push_back('\r');
+            break;
+        case 't': m_strings.push_back('\t');
+            break;
+        case 'u': {
+            int ch = 0;
+            if (!parseQuadHex(p, end, ch)) {
+                return false;
+            }
+
+            if (ch >= 0xd800 && ch <= 0xdfff) {
+                // a low surrogate without a high one
+                if (ch >= 0xdc00) {
+                    return false;
+                }
+
+                int low = 0;
+                if (end - p < 2 || p[0] != '\\' || p[1] != 'u') {
+                    return false;
+                }
+                p += 2;
+                if (!parseQuadHex(p, end, low) || low < 0xdc00 || low > 0xdfff) {
+                    return false;
+                }
+                ch = (((ch - 0xd800) << 10) | ((low - 0xdc00) & 0x3ff)) + 0x10000;
+            }
+            appendUtf8(m_strings, static_cast<uint32_t>(ch));
+        } break;
+        default:
+            return false;
+        }
+    }
+
+    e.size = static_cast<uint32_t>(m_strings.size() - e.offset);
+    m_entries.push_back(e);
+    return true;
+}
+
+//! NOTE Like picojson, takes all the characters that may be a part of a number,
+//! and the whole of them must be a number
+bool JsonTape::parseNumber(const char*& p, const char* end)
+{
+    const char* b = p;
+    while (p != end && isNumberChar(*p)) {
+        ++p;
+    }
+
+    if (b == p) {
+        return false;
+    }
+
+    Entry e;
+    e.type = Type::Number;
+
+#ifdef __cpp_lib_to_chars
+    //! NOTE from_chars does not take a leading '+', but a number never starts with it here
+    const std::from_chars_result r = std::from_chars(b, p, e.number);
+    if (r.ec == std::errc() && r.ptr == p) {
+        m_entries.push_back(e);
+        return true;
+    }
+
+    if (r.ec != std::errc::result_out_of_range) {
+        return false;
+    }
+#endif
+
+    // out of range values are left to strtod, it gives inf as picojson does
+    const std::string str(b, p);
+    char* strEnd = nullptr;
+    e.number = std::strtod(str.c_str(), &strEnd);
+    if (strEnd != str.c_str() + str.size()) {
+        return false;
+    }
+
+    m_entries.push_back(e);
+    return true;
+}
+
+bool JsonTape::parse(std::string_view json, std::string* err)
+{
+    m_entries.clear();
+    m_strings.clear();
+
+    m_entries.reserve(json.size() / 8 + 1);
+    m_strings.reserve(json.size() / 2);
+
+    struct Level {
+        size_t pos = 0;
+        uint32_t size = 0;
+        bool object = false;
+    };
+
+    std::vector<Level> levels;
+
+    const char* begin = json.data();
+    const char* p = begin;
+    const char* end = begin + json.size();
+
+    bool ok = false;
+
+    auto expectKey = [&]() {
+        skipSpaces(p, end);
+        if (p == end || *p != '"') {
+            return false;
+        }
+        ++p;
+        if (!parseString(p, end)) {
+            return false;
+        }
+        skipSpaces(p, end);
+        if (p == end || *p != ':') {
+            return false;
+        }
+        ++p;
+        return true;
+    };
+
+    auto match = [&](const char* text, size_t len) {
+        if (static_cast<size_t>(end - p) < len || std::memcmp(p, text, len) != 0) {
+            return false;
+        }
+        p += len;
+        return true;
+    };
+
+    while (true) {
+        // value
+        skipSpaces(p, end);
+        if (p == end) {
+            break;
+        }
+
+        bool opened = false;
+        const char ch = *p;
+        if (ch == '"') {
+            ++p;
+            if (!parseString(p, end)) {
+                break;
+            }
+        } else if (ch == '{' || ch == '[') {
+            if (levels.size() >= MAX_DEPTH) {
+                break;
+            }
+
+            ++p;
+            Entry e;
+            e.type = ch == '{' ? Type::Object : Type::Array;
+            levels.push_back({ m_entries.size(), 0, ch == '{' });
+            m_entries.push_back(e);
+
+            skipSpaces(p, end);
+            if (p != end && *p == (ch == '{' ? '}' : ']')) {
+                ++p;
+                m_entries[levels.back().pos].end = m_entries.size();
+                levels.pop_back();
+            } else {
+                opened = true;
+                if (ch == '{' && !expectKey()) {
+                    break;
+                }
+            }
+        } else if (ch == 'n') {
+            if (!match("null", 4)) {
+                break;
+            }
+            m_entries.emplace_back();
+        } else if (ch == 't') {
+            if (!match("true", 4)) {
+                break;
+            }
+            m_entries.emplace_back().type = Type::True;
+        } else if (ch == 'f') {
+            if (!match("false", 5)) {
+                break;
+            }
+            m_entries.emplace_back().type = Type::False;
+        } else if ((ch >= '0' && ch <= '9') || ch == '-') {
+            if (!parseNumber(p, end)) {
+                break;
+            }
+        } else {
+            break;
+        }
+
+        if (opened) {
+            continue;
+        }
+
+        // after value: a separator or closing of the levels
+        bool failed = false;
+        bool next = false;
+        while (!levels.empty()) {
+            Level& level = levels.back();
+            ++level.size;
+
+            skipSpaces(p, end);
+            if (p == end) {
+                failed = true;
+                break;
+            }
+
+            if (*p == ',') {
+                ++p;
+                if (level.object && !expectKey()) {
+                    failed = true;
+                }
+                next = true;
+                break;
+            }
+
+            if (*p != (level.object ? '}' : ']')) {
+                failed = true;
+                break;
+            }
+
+            ++p;
+            Entry& e = m_entries[level.pos];
+            e.size = level.size;
+            e.end = m_entries.size();
+            levels.pop_back();
+        }
+
+        if (failed) {
+            break;
+        }
+
+        if (!next) {
+            ok = true;
+            break;
+        }
+    }
+
+    if (!ok) {
+        if (err) {
+            //! NOTE The same format as picojson
+            const size_t pos = static_cast<size_t>(p - begin);
+            const int line = 1 + static_cast<int>(std::count(begin, p, '\n'));
+            *err = "syntax error at line " + std::to_string(line) + " near: ";
+            for (size_t i = pos; i < json.size() && json[i] != '\n'; ++i) {
+                if (static_cast<unsigned char>(json[i]) >= ' ') {
+                    err->push_back(json[i]);
+                }
+            }
+        }
+
+        m_entries.clear();
+        m_strings.clear();
+        return false;
+    }
+
+    if (err) {
+        err->clear();
+    }
+
+    return true;
+}
+
+// =======================================
+// JsonWriter
+// =======================================
+
+JsonWriter::JsonWriter(std::string& out, bool indented)
+    : m_out(out), m_indented(indented)
+{
+}
+
+void JsonWriter::newLine()
+{
+    m_out.push_back('\n');
+    m_out.append(m_counts.size() * 2, ' ');
+}
+
+void JsonWriter::beforeValue()
+{
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+
+    if (m_counts.empty()) {
+        return;
+    }
+
+    if (m_counts.back()++ > 0) {
+        m_out.push_back(',');
+    }
+
+    if (m_indented) {
+        newLine();
+    }
+}
+
+void JsonWriter::afterValue()
+{
+    if (m_indented && m_counts.empty()) {
+        m_out.push_back('\n');
+    }
+}
+
+void JsonWriter::beginArray()
+{
+    beforeValue();
+    m_out.push_back('[');
+    m_counts.push_back(0);
+}
+
+void JsonWriter::endArray()
+{
+    const size_t count = m_counts.back();
+    m_counts.pop_back();
+    if (m_indented && count > 0) {
+        newLine();
+    }
+    m_out.push_back(']');
+    afterValue();
+}
+
+void JsonWriter::beginObject()
+{
+    beforeValue();
+    m_out.push_back('{');
+    m_counts.push_back(0);
+}
+
+void JsonWriter::endObject()
+{
+    const size_t count = m_counts.back();
+    m_counts.pop_back();
+    if (m_indented && count > 0) {
+        newLine();
+    }
+    m_out.push_back('}');
+    afterValue();
+}
+
+void JsonWriter::key(std::string_view key)
+{
+    beforeValue();
+    writeString(key);
+    m_out.push_back(':');
+    if (m_indented) {
+        m_out.push_back(' ');
+    }
+    m_afterKey = true;
+}
+
+void JsonWriter::null()
+{
+    beforeValue();
+    m_out.append("null");
+    afterValue();
+}
+
+void JsonWriter::boolean(bool v)
+{
+    beforeValue();
+    m_out.append(v ? "true" : "false");
+    afterValue();
+}
+
+//! NOTE Integers are written as is, other values with 6 decimals and without the trailing zeros
+void JsonWriter::number(double v)
+{
+    beforeValue();
+
+    double intPart = 0.0;
+    if (std::fabs(v) < static_cast<double>(1ULL << 53) && std::modf(v, &intPart) == 0) {
+        char buf[24];
+        const int len = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v));
+        m_out.append(buf, static_cast<size_t>(len));
+        afterValue();
+        return;
+    }
+
+    std::string s;
+#ifdef __cpp_lib_to_chars
+    char buf[512];
+    const std::to_chars_result r = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::fixed, 6);
+    if (r.ec == std::errc()) {
+        s.assign(buf, r.ptr);
+    }
+#endif
+    if (s.empty()) {
+        std::stringstream stream;
+        stream << std::fixed << std::setprecision(6) << v;
+        s = stream.str();
+    }
+
+    // remove extra '0'
+    size_t len = s.size();
+    if (s.find('.') != std::string::npos) {
+        while (len > 1 && s[len - 1] == '0') {
+            --len;
+        }
+        if (s[len - 1] == '.') {
+            --len;
+        }
+    }
+
+    m_out.append(s, 0, len);
+    afterValue();
+}
+
+void JsonWriter::string(std::string_view v)
+{
+    beforeValue();
+    writeString(v);
+    afterValue();
+}
+
+void JsonWriter::writeString(std::string_view v)
+{
+    m_out.push_back('"');
+
+    const char* p = v.data();
+    const char* end = p + v.size();
+    while (p != end) {
+        //! NOTE Copy the run of plain characters at once
+        const char* run = p;
+        while (p != end) {
+            const unsigned char ch = static_cast<unsigned char>(*p);
+            if (ch < 0x20 || ch == 0x7f || ch == '"' || ch == '\\' || ch == '/') {
+                break;
+            }
+            ++p;
+        }
+        m_out.append(run, static_cast<size_t>(p - run));
+
+        if (p == end) {
+            break;
+        }
+
+        const char ch = *p++;
+        switch (ch) {
+        case '"': m_out.append("\\\"");
+            break;
+        case '\\': m_out.append("\\\\");
+            break;
+        case '/': m_out.append("\\/");
+            break;
+        case '\b': m_out.append("\\b");
+            break;
+        case '\f': m_out.append("\\f");
+            break;
+        case '\n': m_out.append("\\n");
+            break;
+        case '\r': m_out.append("\\r");
+            break;
+        case '\t': m_out.append("\\t");
+            break;
+        default: {
+            char buf[7];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", ch & 0xff);
+            m_out.append(buf, 6);
+        } break;
+        }
+    }
+
+    m_out.push_back('"');
+}
@@ -0,0 +1,126 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_GLOBAL_JSONTAPE_H
+#define MUSE_GLOBAL_JSONTAPE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace muse {
+//! NOTE Parsed JSON document as a flat array of entries (tape), filled in a single pass.
+//! An array or object entry is followed by its children and knows where they end,
+//! so a subtree can be skipped without looking at it.
+//! An object child is a key (a string entry) followed by the value.
+//! The unescaped strings and keys are stored in one buffer.
+//! Parsing follows picojson: the first value is parsed, the rest of the input is ignored.
+class JsonTape
+{
+public:
+    enum class Type : uint8_t {
+        Null,
+        False,
+        True,
+        Number,
+        String,
+        Array,
+        Object
+    };
+
+    struct Entry {
+        Type type = Type::Null;
+        uint32_t size = 0;      // children for array and object, length for string
+        union {
+            double number;
+            size_t offset;      // string: position in the strings buffer
+            size_t end;         // array and object: index after the last child
+        };
+
+        Entry()
+            : end(0) {}
+    };
+
+    //! NOTE As picojson (DEFAULT_MAX_DEPTHS), deeper documents are a parse error
+    static constexpr size_t MAX_DEPTH = 100;
+
+    bool parse(std::string_view json, std::string* err = nullptr);
+
+    bool empty() const { return m_entries.empty(); }
+    size_t size() const { return m_entries.size(); }
+
+    const Entry& at(size_t i) const { return m_entries[i]; }
+    Type type(size_t i) const { return m_entries[i].type; }
+    double number(size_t i) const { return m_entries[i].number; }
+    std::string_view string(size_t i) const
+    {
+        const Entry& e = m_entries[i];
+        return std::string_view(m_strings.data() + e.offset, e.size);
+    }
+
+    //! NOTE Index of the next sibling
+    size_t next(size_t i) const
+    {
+        const Entry& e = m_entries[i];
+        return (e.type == Type::Array || e.type == Type::Object) ? e.end : i + 1;
+    }
+
+private:
+    bool parseString(const char*& p, const char* end);
+    bool parseNumber(const char*& p, const char* end);
+
+    std::vector<Entry> m_entries;
+    std::string m_strings;
+};
+
+//! NOTE Writes JSON as it goes, the output is the same as picojson::value::serialize
+class JsonWriter
+{
+public:
+    JsonWriter(std::string& out, bool indented);
+
+    void beginArray();
+    void endArray();
+    void beginObject();
+    void endObject();
+
+    void key(std::string_view key);
+
+    void null();
+    void boolean(bool v);
+    void number(double v);
+    void string(std::string_view v);
+
+private:
+    void beforeValue();
+    void afterValue();
+    void newLine();
+    void writeString(std::string_view v);
+
+    std::string& m_out;
+    bool m_indented = false;
+    bool m_afterKey = false;
+    std::vector<size_t> m_counts; // values written at each open level
+};
+}
+
+#endif // MUSE_GLOBAL_JSONTAPE_H
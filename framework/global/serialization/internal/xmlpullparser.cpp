@@ -0,0 +1,772 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "xmlpullparser.h"
+
+#include <cstring>
+
+#include "log.h"
+
+using namespace muse;
+using namespace muse::io;
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static inline bool isNameEnd(char c)
+{
+    return isSpace(c) || c == '/' || c == '>' || c == '=' || c == '<' || c == '"' || c == '\'';
+}
+
+static void appendCodePoint(std::string& out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+//! NOTE p points to '&', returns the position after the entity
+static const char* decodeEntity(const char* p, const char* e, std::string& out)
+{
+    struct Entity {
+        const char* name;
+        size_t len;
+        char ch;
+    };
+
+    static constexpr Entity ENTITIES[] = {
+        { "&amp;", 5, '&' },
+        { "&lt;", 4, '<' },
+        { "&gt;", 4, '>' },
+        { "&quot;", 6, '"' },
+        { "&apos;", 6, '\'' },
+    };
+
+    const size_t left = static_cast<size_t>(e - p);
+    for (const Entity& en : ENTITIES) {
+        if (left >= en.len && std::memcmp(p, en.name, en.len) == 0) {
+            out.push_back(en.ch);
+            return p + en.len;
+        }
+    }
+
+    if (left > 3 && p[1] == '#') {
+        const bool hex = p[2] == 'x';
+        const char* d = p + (hex ? 3 : 2);
+        uint32_t cp = 0;
+        const char* start = d;
+        while (d < e && *d != ';' && (d - start) < 8) {
+            const char c = *d;
+            uint32_t v = 0;
+            if (c >= '0' && c <= '9') {
+                v = static_cast<uint32_t>(c - '0');
+            } else if (hex && c >= 'a' && c <= 'f') {
+                v = static_cast<uint32_t>(c - 'a' + 10);
+            } else if (hex && c >= 'A' && c <= 'F') {
+                v = static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                break;
+            }
+            cp = cp * (hex ? 16 : 10) + v;
+            ++d;
+        }
+
+        if (d < e && *d == ';' && d > start && cp <= 0x10FFFF) {
+            appendCodePoint(out, cp);
+            return d + 1;
+        }
+    }
+
+    // unknown entity, left as is
+    out.push_back('&');
+    return p + 1;
+}
+
+static void decodeText(const char* b, const char* e, std::string& out, bool attr)
+{
+    out.clear();
+
+    const char* p = b;
+    while (p < e) {
+        const char* s = p;
+        while (p < e && *p != '&' && *p != '\r' && !(attr && (*p == '\n' || *p == '\t'))) {
+            ++p;
+        }
+        out.append(s, static_cast<size_t>(p - s));
+        if (p == e) {
+            break;
+        }
+
+        const char c = *p;
+        if (c == '\r') {
+            out.push_back(attr ? ' ' : '\n');
+            ++p;
+            if (p < e && *p == '\n') {
+                ++p;
+            }
+        } else if (c == '&') {
+            p = decodeEntity(p, e, out);
+        } else {
+            out.push_back(' ');
+            ++p;
+        }
+    }
+}
+
+static void normalizeEol(const char* b, const char* e, std::string& out)
+{
+    out.clear();
+
+    const char* p = b;
+    while (p < e) {
+        const char* r = static_cast<const char*>(std::memchr(p, '\r', static_cast<size_t>(e - p)));
+        if (!r) {
+            out.append(p, static_cast<size_t>(e - p));
+            break;
+        }
+        out.append(p, static_cast<size_t>(r - p));
+        out.push_back('\n');
+        p = r + 1;
+        if (p < e && *p == '\n') {
+            ++p;
+        }
+    }
+}
+
+XmlPullParser::XmlPullParser(IODevice* device, size_t chunkSize)
+    : m_device(device), m_chunkSize(chunkSize)
+{
+    m_chunk.resize(m_chunkSize);
+}
+
+XmlPullParser::Status XmlPullParser::init()
+{
+    // read the first bytes as is, to detect encoding
+    std::vector<uint8_t> head;
+    while (head.size() < 4) {
+        size_t read = m_device->read(m_chunk.data(), m_chunkSize);
+        if (read == 0) {
+            break;
+        }
+        head.insert(head.end(), m_chunk.begin(), m_chunk.begin() + read);
+    }
+
+    if (head.size() < 4) {
+        m_deviceEnd = true;
+        return Status::EmptyDocument;
+    }
+
+    m_encoding = UtfCodec::xmlEncoding(ByteArray::fromRawData(head.data(), head.size()));
+    if (m_encoding == UtfCodec::Encoding::Unknown) {
+        m_deviceEnd = true;
+        return Status::UnknownEncoding;
+    }
+
+    if (m_encoding == UtfCodec::Encoding::UTF_8) {
+        appendUtf8(head.data(), head.size());
+    } else {
+        appendUtf16(head.data(), head.size());
+    }
+
+    // skip BOM
+    if (m_buf.size() >= 3 && std::memcmp(m_buf.data(), "\xEF\xBB\xBF", 3) == 0) {
+        m_pos = 3;
+    }
+
+    return Status::Ok;
+}
+
+void XmlPullParser::appendUtf8(const uint8_t* data, size_t len)
+{
+    m_buf.append(reinterpret_cast<const char*>(data), len);
+}
+
+void XmlPullParser::appendUtf16(const uint8_t* data, size_t len)
+{
+    const bool le = m_encoding == UtfCodec::Encoding::UTF_16LE;
+
+    auto unit = [le](const uint8_t* p) {
+        return le ? static_cast<char16_t>(p[0] | (p[1] << 8)) : static_cast<char16_t>((p[0] << 8) | p[1]);
+    };
+
+    auto append = [this](char16_t u) {
+        if (m_highSurrogate) {
+            if (u >= 0xDC00 && u <= 0xDFFF) {
+                uint32_t cp = 0x10000 + ((static_cast<uint32_t>(m_highSurrogate) - 0xD800) << 10) + (u - 0xDC00);
+                appendCodePoint(m_buf, cp);
+                m_highSurrogate = 0;
+                return;
+            }
+            appendCodePoint(m_buf, 0xFFFD);
+            m_highSurrogate = 0;
+        }
+
+        if (u >= 0xD800 && u <= 0xDBFF) {
+            m_highSurrogate = u;
+        } else {
+            appendCodePoint(m_buf, u);
+        }
+    };
+
+    size_t i = 0;
+    if (!m_utf16Tail.empty() && len > 0) {
+        uint8_t pair[2] = { m_utf16Tail.front(), data[0] };
+        append(unit(pair));
+        m_utf16Tail.clear();
+        i = 1;
+    }
+
+    m_buf.reserve(m_buf.size() + len);
+    for (; i + 1 < len; i += 2) {
+        append(unit(data + i));
+    }
+
+    if (i < len) {
+        m_utf16Tail.push_back(data[i]);
+    }
+}
+
+bool XmlPullParser::fill()
+{
+    if (m_deviceEnd) {
+        return false;
+    }
+
+    size_t read = m_device->read(m_chunk.data(), m_chunkSize);
+    if (read == 0) {
+        m_deviceEnd = true;
+        return false;
+    }
+
+    if (m_encoding == UtfCodec::Encoding::UTF_8) {
+        appendUtf8(m_chunk.data(), read);
+    } else {
+        appendUtf16(m_chunk.data(), read);
+    }
+
+    return true;
+}
+
+int XmlPullParser::charAtSlow(size_t off)
+{
+    while (m_pos + off >= m_buf.size()) {
+        if (!fill()) {
+            return -1;
+        }
+    }
+    return static_cast<unsigned char>(m_buf[m_pos + off]);
+}
+
+bool XmlPullParser::startsWith(const char* str, size_t len)
+{
+    if (charAt(len - 1) < 0) {
+        return false;
+    }
+    return std::memcmp(m_buf.data() + m_pos, str, len) == 0;
+}
+
+size_t XmlPullParser::find(const char* str, size_t len, size_t from)
+{
+    size_t searchFrom = m_pos + from;
+    for (;;) {
+        size_t idx = m_buf.find(str, searchFrom, len);
+        if (idx != std::string::npos) {
+            return idx - m_pos;
+        }
+
+        // continue from the place where the string can start
+        searchFrom = m_buf.size() >= len ? std::max(searchFrom, m_buf.size() - len + 1) : searchFrom;
+        if (!fill()) {
+            return std::string::npos;
+        }
+    }
+}
+
+size_t XmlPullParser::findChar(char c, size_t from)
+{
+    size_t searchFrom = m_pos + from;
+    for (;;) {
+        if (searchFrom < m_buf.size()) {
+            const void* found = std::memchr(m_buf.data() + searchFrom, c, m_buf.size() - searchFrom);
+            if (found) {
+                return static_cast<size_t>(static_cast<const char*>(found) - m_buf.data()) - m_pos;
+            }
+            searchFrom = m_buf.size();
+        }
+
+        if (!fill()) {
+            return std::string::npos;
+        }
+    }
+}
+
+void XmlPullParser::compact()
+{
+    //! NOTE Keep the buffer about the chunk size, the tokens are copied out of it
+    if (m_pos > m_chunkSize || (m_pos > 0 && m_pos == m_buf.size())) {
+        m_buf.erase(0, m_pos);
+        m_base += static_cast<int64_t>(m_pos);
+        m_pos = 0;
+    }
+}
+
+size_t XmlPullParser::bufferCapacity() const
+{
+    return m_buf.capacity() + m_chunk.capacity();
+}
+
+const std::string* XmlPullParser::intern(const char* str, size_t len)
+{
+    //! NOTE Names live as long as the parser, so views to them stay valid
+    m_nameKey.assign(str, len);
+    auto it = m_names.find(m_nameKey);
+    if (it == m_names.end()) {
+        it = m_names.insert(m_nameKey).first;
+    }
+    return &*it;
+}
+
+void XmlPullParser::setError(Token& t, const char* message, bool premature)
+{
+    m_error = true;
+    m_premature = premature;
+    m_errorString = message;
+    t.type = TokenType::Error;
+    t.offset = m_base + static_cast<int64_t>(m_pos);
+}
+
+bool XmlPullParser::hasError() const
+{
+    return m_error;
+}
+
+bool XmlPullParser::isPrematureEnd() const
+{
+    return m_premature;
+}
+
+const std::string& XmlPullParser::errorString() const
+{
+    return m_errorString;
+}
+
+const XmlPullParser::Token& XmlPullParser::current() const
+{
+    return m_current;
+}
+
+const XmlPullParser::Token& XmlPullParser::next()
+{
+    if (!m_ahead.empty()) {
+        m_spare.push_back(std::move(m_current));
+        m_current = std::move(m_ahead.front());
+        m_ahead.pop_front();
+        return m_current;
+    }
+
+    parseToken(m_current);
+    return m_current;
+}
+
+const XmlPullParser::Token& XmlPullParser::peek(size_t n)
+{
+    while (m_ahead.size() <= n) {
+        if (!m_ahead.empty()) {
+            TokenType last = m_ahead.back().type;
+            if (last == TokenType::EndDocument || last == TokenType::Error) {
+                return m_ahead.back();
+            }
+        } else if (m_current.type == TokenType::EndDocument || m_current.type == TokenType::Error) {
+            return m_current;
+        }
+
+        if (!m_spare.empty()) {
+            m_ahead.push_back(std::move(m_spare.back()));
+            m_spare.pop_back();
+        } else {
+            m_ahead.emplace_back();
+        }
+        parseToken(m_ahead.back());
+    }
+
+    return m_ahead.at(n);
+}
+
+size_t XmlPullParser::parseName(size_t from)
+{
+    size_t len = 0;
+    for (;;) {
+        int c = charAt(from + len);
+        if (c < 0 || isNameEnd(static_cast<char>(c))) {
+            return len;
+        }
+        ++len;
+    }
+}
+
+void XmlPullParser::parseToken(Token& t)
+{
+    t.type = TokenType::None;
+    t.name = nullptr;
+    t.attributesCount = 0;
+    t.selfClosing = false;
+    t.hasChildren = false;
+
+    if (m_error) {
+        t.type = TokenType::Error;
+        return;
+    }
+
+    if (m_end) {
+        t.type = TokenType::EndDocument;
+        return;
+    }
+
+    if (m_pendingEnd) {
+        m_pendingEnd = false;
+        t.type = TokenType::EndElement;
+        t.name = m_stack.back().name;
+        t.hasChildren = false;
+        t.offset = m_base + static_cast<int64_t>(m_pos);
+        m_stack.pop_back();
+        return;
+    }
+
+    for (;;) {
+        compact();
+
+        const int c = charAt(0);
+        if (c < 0) {
+            if (!m_stack.empty()) {
+                setError(t, "Start-end tags mismatch", true);
+            } else if (!m_hasRoot) {
+                setError(t, "No document element found", true);
+            } else {
+                m_end = true;
+                t.type = TokenType::EndDocument;
+                t.offset = m_base + static_cast<int64_t>(m_pos);
+            }
+            return;
+        }
+
+        if (c == '<') {
+            if (parseMarkup(t)) {
+                return;
+            }
+
+            if (m_error) {
+                return;
+            }
+            continue;
+        }
+
+        // text
+        size_t end = findChar('<', 0);
+        if (end == std::string::npos) {
+            end = m_buf.size() - m_pos;
+        }
+
+        const char* b = m_buf.data() + m_pos;
+        const char* e = b + end;
+        const int64_t offset = m_base + static_cast<int64_t>(m_pos);
+        m_pos += end;
+
+        bool whitespace = true;
+        for (const char* p = b; p < e; ++p) {
+            if (!isSpace(*p)) {
+                whitespace = false;
+                break;
+            }
+        }
+
+        // whitespace and text outside of the root element are skipped
+        if (whitespace || m_stack.empty()) {
+            continue;
+        }
+
+        decodeText(b, e, t.text, false);
+        t.type = TokenType::Text;
+        t.offset = offset;
+        m_stack.back().hasChildren = true;
+        return;
+    }
+}
+
+//! NOTE Returns false if the markup does not produce a token (processing instruction)
+bool XmlPullParser::parseMarkup(Token& t)
+{
+    const int c1 = charAt(1);
+
+    if (c1 == '/') {
+        return parseEndTag(t);
+    }
+
+    if (c1 == '?') {
+        size_t end = find("?>", 2, 2);
+        if (end == std::string::npos) {
+            setError(t, "Error parsing document declaration/processing instruction", true);
+            return false;
+        }
+
+        // <?xml ... ?>
+        const int c5 = charAt(5);
+        const bool isDeclaration = startsWith("<?xml", 5) && (c5 == '?' || isSpace(static_cast<char>(c5)));
+        if (isDeclaration && !m_stack.empty()) {
+            setError(t, "Error parsing document declaration/processing instruction");
+            return false;
+        }
+
+        t.offset = m_base + static_cast<int64_t>(m_pos);
+        m_pos += end + 2;
+
+        if (isDeclaration) {
+            t.type = TokenType::Declaration;
+            return true;
+        }
+
+        return false;
+    }
+
+    if (c1 == '!') {
+        if (startsWith("<!--", 4)) {
+            size_t end = find("-->", 3, 4);
+            if (end == std::string::npos) {
+                setError(t, "Error parsing comment", true);
+                return false;
+            }
+
+            normalizeEol(m_buf.data() + m_pos + 4, m_buf.data() + m_pos + end, t.text);
+            t.type = TokenType::Comment;
+            t.offset = m_base + static_cast<int64_t>(m_pos);
+            m_pos += end + 3;
+
+            if (!m_stack.empty()) {
+                m_stack.back().hasChildren = true;
+            }
+            return true;
+        }
+
+        if (startsWith("<![CDATA[", 9)) {
+            size_t end = find("]]>", 3, 9);
+            if (end == std::string::npos) {
+                setError(t, "Error parsing CDATA section", true);
+                return false;
+            }
+
+            if (m_stack.empty()) {
+                setError(t, "Error parsing CDATA section");
+                return false;
+            }
+
+            normalizeEol(m_buf.data() + m_pos + 9, m_buf.data() + m_pos + end, t.text);
+            t.type = TokenType::Text;
+            t.offset = m_base + static_cast<int64_t>(m_pos);
+            m_pos += end + 3;
+            m_stack.back().hasChildren = true;
+            return true;
+        }
+
+        if (startsWith("<!DOCTYPE", 9)) {
+            // until '>' outside of the internal subset and quotes
+            size_t i = 9;
+            int depth = 0;
+            char quote = 0;
+            for (;; ++i) {
+                int c = charAt(i);
+                if (c < 0) {
+                    setError(t, "Error parsing document type declaration", true);
+                    return false;
+                }
+
+                if (quote) {
+                    if (c == quote) {
+                        quote = 0;
+                    }
+                } else if (c == '"' || c == '\'') {
+                    quote = static_cast<char>(c);
+                } else if (c == '[') {
+                    ++depth;
+                } else if (c == ']') {
+                    --depth;
+                } else if (c == '>' && depth <= 0) {
+                    break;
+                }
+            }
+
+            size_t b = 9;
+            while (b < i && isSpace(m_buf[m_pos + b])) {
+                ++b;
+            }
+
+            t.text.assign(m_buf.data() + m_pos + b, i - b);
+            t.type = TokenType::Doctype;
+            t.offset = m_base + static_cast<int64_t>(m_pos);
+            m_pos += i + 1;
+            return true;
+        }
+
+        setError(t, "Unrecognized tag");
+        return false;
+    }
+
+    return parseStartTag(t);
+}
+
+bool XmlPullParser::parseStartTag(Token& t)
+{
+    const size_t nameLen = parseName(1);
+    if (nameLen == 0) {
+        setError(t, "Error parsing start element tag");
+        return false;
+    }
+
+    t.name = intern(m_buf.data() + m_pos + 1, nameLen);
+    t.offset = m_base + static_cast<int64_t>(m_pos) + 1;
+
+    size_t i = 1 + nameLen;
+    for (;;) {
+        int c = charAt(i);
+        while (c >= 0 && isSpace(static_cast<char>(c))) {
+            c = charAt(++i);
+        }
+
+        if (c < 0) {
+            setError(t, "Error parsing start element tag", true);
+            return false;
+        }
+
+        if (c == '>') {
+            ++i;
+            break;
+        }
+
+        if (c == '/') {
+            if (charAt(i + 1) != '>') {
+                setError(t, "Error parsing start element tag");
+                return false;
+            }
+            i += 2;
+            t.selfClosing = true;
+            break;
+        }
+
+        // attribute
+        const size_t attrNameLen = parseName(i);
+        if (attrNameLen == 0) {
+            setError(t, "Error parsing attribute name");
+            return false;
+        }
+        const size_t attrName = i;
+        i += attrNameLen;
+
+        c = charAt(i);
+        while (c >= 0 && isSpace(static_cast<char>(c))) {
+            c = charAt(++i);
+        }
+        if (c != '=') {
+            setError(t, "Attribute value is expected", c < 0);
+            return false;
+        }
+
+        c = charAt(++i);
+        while (c >= 0 && isSpace(static_cast<char>(c))) {
+            c = charAt(++i);
+        }
+        if (c != '"' && c != '\'') {
+            setError(t, "Attribute value is expected", c < 0);
+            return false;
+        }
+
+        const size_t valueEnd = findChar(static_cast<char>(c), i + 1);
+        if (valueEnd == std::string::npos) {
+            setError(t, "Error parsing attribute value", true);
+            return false;
+        }
+
+        if (t.attributes.size() <= t.attributesCount) {
+            t.attributes.emplace_back();
+        }
+
+        Attribute& a = t.attributes[t.attributesCount++];
+        a.name = intern(m_buf.data() + m_pos + attrName, attrNameLen);
+        decodeText(m_buf.data() + m_pos + i + 1, m_buf.data() + m_pos + valueEnd, a.value, true);
+
+        i = valueEnd + 1;
+    }
+
+    m_pos += i;
+
+    if (!m_stack.empty()) {
+        m_stack.back().hasChildren = true;
+    }
+
+    m_stack.push_back({ t.name, false });
+    m_hasRoot = true;
+    m_pendingEnd = t.selfClosing;
+
+    t.type = TokenType::StartElement;
+    return true;
+}
+
+bool XmlPullParser::parseEndTag(Token& t)
+{
+    const size_t nameLen = parseName(2);
+    size_t i = 2 + nameLen;
+
+    int c = charAt(i);
+    while (c >= 0 && isSpace(static_cast<char>(c))) {
+        c = charAt(++i);
+    }
+
+    if (c != '>') {
+        setError(t, "Error parsing end element tag", c < 0);
+        return false;
+    }
+
+    if (m_stack.empty() || m_stack.back().name->size() != nameLen
+        || std::memcmp(m_stack.back().name->data(), m_buf.data() + m_pos + 2, nameLen) != 0) {
+        setError(t, "Start-end tags mismatch");
+        return false;
+    }
+
+    t.type = TokenType::EndElement;
+    t.name = m_stack.back().name;
+    t.hasChildren = m_stack.back().hasChildren;
+    t.offset = m_base + static_cast<int64_t>(m_pos) + 2;
+    m_stack.pop_back();
+
+    m_pos += i + 1;
+    return true;
+}
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_GLOBAL_XMLPULLPARSER_H
+#define MUSE_GLOBAL_XMLPULLPARSER_H
+
+#include <deque>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "io/iodevice.h"
+#include "types/string.h"
+
+namespace muse {
+//! NOTE Incremental XML tokenizer, reads the device by chunks and produces tokens as it goes.
+//! Only the current token (and the tokens looked ahead) are kept in memory.
+//! It follows the pugixml parse_default behaviour used by XmlStreamReader:
+//! - whitespace-only text and text outside of the root element are skipped
+//! - processing instructions are skipped
+//! - the standard and numeric entities are decoded, line ends are normalized
+//! - whitespace in attribute values is converted to spaces
+class XmlPullParser
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+    explicit XmlPullParser(io::IODevice* device, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    enum class Status {
+        Ok,
+        EmptyDocument,
+        UnknownEncoding
+    };
+
+    //! NOTE Detects the encoding by the first bytes
+    Status init();
+
+    enum class TokenType {
+        None,
+        Declaration,
+        Doctype,
+        StartElement,
+        EndElement,
+        Text,
+        Comment,
+        EndDocument,
+        Error
+    };
+
+    struct Attribute {
+        const std::string* name = nullptr; // interned
+        std::string value;
+    };
+
+    struct Token {
+        TokenType type = TokenType::None;
+        const std::string* name = nullptr; // interned, for elements
+        std::vector<Attribute> attributes;
+        size_t attributesCount = 0;
+        std::string text;                  // text, comment, doctype
+        bool selfClosing = false;          // for StartElement
+        bool hasChildren = false;          // for EndElement
+        int64_t offset = 0;
+    };
+
+    const Token& next();
+    const Token& current() const;
+
+    //! NOTE Looks ahead without changing the current token, n = 0 - the next token
+    const Token& peek(size_t n = 0);
+
+    bool hasError() const;
+    bool isPrematureEnd() const;
+    const std::string& errorString() const;
+
+    //! NOTE Size of the internal buffer, for diagnostics
+    size_t bufferCapacity() const;
+
+private:
+
+    bool fill();
+    int charAt(size_t off)
+    {
+        const size_t i = m_pos + off;
+        return i < m_buf.size() ? static_cast<unsigned char>(m_buf[i]) : charAtSlow(off);
+    }
+
+    int charAtSlow(size_t off);
+    bool startsWith(const char* str, size_t len);
+    size_t find(const char* str, size_t len, size_t from);
+    size_t findChar(char c, size_t from);
+    void compact();
+
+    void parseToken(Token& t);
+    bool parseMarkup(Token& t);
+    bool parseStartTag(Token& t);
+    bool parseEndTag(Token& t);
+    size_t parseName(size_t from);
+
+    void setError(Token& t, const char* message, bool premature = false);
+    const std::string* intern(const char* str, size_t len);
+
+    void appendUtf8(const uint8_t* data, size_t len);
+    void appendUtf16(const uint8_t* data, size_t len);
+
+    io::IODevice* m_device = nullptr;
+    size_t m_chunkSize = DEFAULT_CHUNK_SIZE;
+    UtfCodec::Encoding m_encoding = UtfCodec::Encoding::UTF_8;
+    std::vector<uint8_t> m_chunk;
+    std::vector<uint8_t> m_utf16Tail; // incomplete code unit
+    char16_t m_highSurrogate = 0;
+    bool m_deviceEnd = false;
+
+    std::string m_buf;
+    size_t m_pos = 0;
+    int64_t m_base = 0;    // offset of m_buf begin in the document
+
+    struct Element {
+        const std::string* name = nullptr;
+        bool hasChildren = false;
+    };
+
+    std::vector<Element> m_stack;
+    bool m_pendingEnd = false;
+    bool m_hasRoot = false;
+    bool m_end = false;
+    bool m_error = false;
+    bool m_premature = false;
+    std::string m_errorString;
+
+    std::unordered_set<std::string> m_names;
+    std::string m_nameKey;
+
+    Token m_current;
+    std::deque<Token> m_ahead;
+    std::vector<Token> m_spare;
+};
+}
+
+#endif // MUSE_GLOBAL_XMLPULLPARSER_H
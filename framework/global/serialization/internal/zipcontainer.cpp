@@ -23,15 +23,20 @@
 
 #include <ctime>
 #include <cstring>
+#include <deque>
+#include <unordered_map>
 #include <zlib.h>
 
 #include "global/io/dir.h"
+#include "global/concurrency/taskscheduler.h"
 
 #include "log.h"
 
 // Zip standard version for archives handled by this API
 // (actually, the only basic support of this version is implemented but it is enough for now)
 #define ZIP_VERSION 20
+// Zip64 extensions, only the sizes and offsets are needed to read such archives
+#define ZIP64_VERSION 45
 
 #if 0
 #define ZDEBUG LOGD
@@ -56,6 +61,11 @@ static inline ushort readUShort(const uint8_t* data)
     return (data[0]) + (data[1] << 8);
 }
 
+static inline uint64_t readUInt64(const uint8_t* data)
+{
+    return uint64_t(readUInt(data)) + (uint64_t(readUInt(data + 4)) << 32);
+}
+
 static inline void writeUInt(uint8_t* data, uint i)
 {
     data[0] = i & 0xff;
@@ -110,76 +120,79 @@ static void writeMSDosDate(uint8_t* dest, const std::tm& dt)
     }
 }
 
-static int inflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
+// Files are compressed by chunks, each chunk is deflated independently with the end of the previous one
+// as the dictionary and is flushed to a byte boundary, so the chunks are joined into one deflate stream.
+// The chunks don't depend on each other, they are compressed in parallel, and the output is the same
+// for any number of threads.
+static constexpr size_t CHUNK_SIZE = 256 * 1024;
+static constexpr size_t DICTIONARY_SIZE = 32 * 1024;
+
+static constexpr size_t DEFAULT_MEMORY_LIMIT = 64 * 1024 * 1024;
+
+// With bigger files the compressed size may not fit in 32 bits, so the local header gets the Zip64 field
+// (deflate adds less than 1% in the worst case)
+static constexpr uint64_t ZIP64_LOCAL_LIMIT = 0xff000000;
+
+struct CompressedChunk
 {
-    z_stream stream;
-    int err;
+    ByteArray data;
+    uLong crc = 0;
+    bool ok = true;
+};
 
-    stream.next_in = const_cast<Bytef*>(source);
-    stream.avail_in = (uInt)sourceLen;
-    if ((uLong)stream.avail_in != sourceLen) {
-        return Z_BUF_ERROR;
-    }
+static CompressedChunk compressChunk(const uint8_t* input, size_t dictSize, size_t size, bool compress, bool last)
+{
+    CompressedChunk result;
+    const uint8_t* data = input + dictSize;
+    result.crc = ::crc32(::crc32(0, 0, 0), data, (uInt)size);
 
-    stream.next_out = dest;
-    stream.avail_out = (uInt) * destLen;
-    if ((uLong)stream.avail_out != *destLen) {
-        return Z_BUF_ERROR;
+    if (!compress) {
+        result.data = ByteArray(data, size);
+        return result;
     }
 
-    stream.zalloc = (alloc_func)0;
-    stream.zfree = (free_func)0;
-
-    err = inflateInit2(&stream, -MAX_WBITS);
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(z_stream));
+    int err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
     if (err != Z_OK) {
-        return err;
+        LOGW("Zip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
+        result.ok = false;
+        return result;
     }
 
-    err = inflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        inflateEnd(&stream);
-        if (err == Z_NEED_DICT || (err == Z_BUF_ERROR && stream.avail_in == 0)) {
-            return Z_DATA_ERROR;
-        }
-        return err;
+    if (dictSize > 0) {
+        deflateSetDictionary(&stream, input, (uInt)dictSize);
     }
-    *destLen = stream.total_out;
 
-    err = inflateEnd(&stream);
-    return err;
-}
+    // the bound is for Z_FINISH, the flush adds a few bytes
+    result.data.resize(deflateBound(&stream, (uLong)size) + 16);
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = (uInt)size;
+    stream.next_out = result.data.data();
+    stream.avail_out = (uInt)result.data.size();
 
-static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
-{
-    z_stream stream;
-    int err;
-
-    stream.next_in = const_cast<Bytef*>(source);
-    stream.avail_in = (uInt)sourceLen;
-    stream.next_out = dest;
-    stream.avail_out = (uInt) * destLen;
-    if ((uLong)stream.avail_out != *destLen) {
-        return Z_BUF_ERROR;
-    }
+    for (;;) {
+        err = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if (last ? err == Z_STREAM_END : (err == Z_OK && stream.avail_out > 0)) {
+            break;
+        }
 
-    stream.zalloc = (alloc_func)0;
-    stream.zfree = (free_func)0;
-    stream.opaque = (voidpf)0;
+        if (err != Z_OK && err != Z_BUF_ERROR) {
+            LOGW("Zip: Failed to compress file, error: %d", err);
+            result.ok = false;
+            break;
+        }
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
-    if (err != Z_OK) {
-        return err;
+        const size_t done = stream.total_out;
+        result.data.resize(result.data.size() * 2);
+        stream.next_out = result.data.data() + done;
+        stream.avail_out = (uInt)(result.data.size() - done);
     }
 
-    err = deflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        deflateEnd(&stream);
-        return err == Z_OK ? Z_BUF_ERROR : err;
-    }
-    *destLen = stream.total_out;
+    result.data.resize(stream.total_out);
+    deflateEnd(&stream);
 
-    err = deflateEnd(&stream);
-    return err;
+    return result;
 }
 
 namespace WindowsFileAttributes {
@@ -345,14 +358,70 @@ struct EndOfDirectory
     uint8_t comment_length[2];
 };
 
+struct Zip64EndOfDirectory
+{
+    uint8_t signature[4]; // 0x06064b50
+    uint8_t record_size[8];
+    uint8_t version_made[2];
+    uint8_t version_needed[2];
+    uint8_t this_disk[4];
+    uint8_t start_of_directory_disk[4];
+    uint8_t num_dir_entries_this_disk[8];
+    uint8_t num_dir_entries[8];
+    uint8_t directory_size[8];
+    uint8_t dir_start_offset[8];
+};
+
+struct Zip64EndOfDirectoryLocator
+{
+    uint8_t signature[4]; // 0x07064b50
+    uint8_t start_of_directory_disk[4];
+    uint8_t end_of_directory_offset[8];
+    uint8_t num_disks[4];
+};
+
 struct FileHeader
 {
     CentralFileHeader h;
     ByteArray file_name;
     ByteArray extra_field;
     ByteArray file_comment;
+
+    // from the header or from the Zip64 extra field
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint64_t localHeaderOffset = 0;
 };
 
+// Zip64 extended information: the values are present only if the 32-bit ones are 0xffffffff
+static void readZip64ExtraField(FileHeader& header)
+{
+    const uint8_t* p = header.extra_field.constData();
+    const uint8_t* end = p + header.extra_field.size();
+    while (end - p >= 4) {
+        const ushort id = readUShort(p);
+        const ushort len = readUShort(p + 2);
+        p += 4;
+        if (len > end - p) {
+            return;
+        }
+
+        if (id == 0x0001) {
+            const uint8_t* f = p;
+            const uint8_t* fend = p + len;
+            for (uint64_t* v : { &header.uncompressedSize, &header.compressedSize, &header.localHeaderOffset }) {
+                if (*v == 0xffffffff && fend - f >= 8) {
+                    *v = readUInt64(f);
+                    f += 8;
+                }
+            }
+            return;
+        }
+
+        p += len;
+    }
+}
+
 LocalFileHeader CentralFileHeader::toLocalHeader() const
 {
     LocalFileHeader h;
@@ -375,16 +444,52 @@ struct ZipContainer::Impl {
     bool dirtyFileTree = true;
     std::vector<FileHeader> fileHeaders;
     ByteArray comment;
-    uint start_of_directory = 0;
+    uint64_t start_of_directory = 0;
     ZipContainer::Status status = ZipContainer::NoError;
 
     ZipContainer::CompressionPolicy compressionPolicy = ZipContainer::AlwaysCompress;
 
+    // Write
+    struct Chunk
+    {
+        size_t entry = 0;
+        size_t size = 0;
+        size_t memory = 0;
+        bool first = false;
+        bool last = false;
+        CompressedChunk result;
+#ifdef MUSE_THREADS_SUPPORT
+        std::future<CompressedChunk> future;
+#endif
+    };
+
+    size_t threadCount = 1;
+    size_t memoryLimit = DEFAULT_MEMORY_LIMIT;
+#ifdef MUSE_THREADS_SUPPORT
+    std::unique_ptr<TaskScheduler> taskScheduler;
+#endif
+    std::deque<Chunk> chunks; // compressing, in the order of writing
+    size_t chunksMemory = 0;
+    uLong entryCrc = 0;       // of the written chunks of the current entry
+
+    // Read
+    // the whole archive, the device data or a mapped file
+    const uint8_t* archiveData = nullptr;
+    size_t archiveSize = 0;
+    std::vector<std::string> filePaths; // fixed paths of fileHeaders
+    std::unordered_map<std::string_view, size_t> fileIndex;
+
     enum EntryType {
         Directory, File, Symlink
     };
 
     void addEntry(EntryType type, const std::string& fileName, const ByteArray& contents);
+    void addEntry(EntryType type, const std::string& fileName, IODevice* source);
+    size_t beginEntry(EntryType type, const std::string& fileName, uint64_t size, bool& compress);
+    void addChunk(size_t entry, const uint8_t* input, size_t dictSize, size_t size, bool compress, bool first, bool last);
+    void writeChunk(Chunk& chunk);
+    void writeChunks(size_t memory);
+    void writeDirectory();
     bool writeToDevice(const uint8_t* data, size_t len);
     bool writeToDevice(const ByteArray& data);
 
@@ -392,6 +497,8 @@ struct ZipContainer::Impl {
         : device(d) {}
 
     void scanFiles();
+    void buildIndex();
+    size_t findFile(const std::string& fileName) const;
     ZipContainer::FileInfo fillFileInfo(size_t index) const;
 
     std::string fixFilePath(const ByteArray& path) const;
@@ -413,85 +520,143 @@ void ZipContainer::Impl::scanFiles()
         return;
     }
 
+    archiveData = device->readData();
+    archiveSize = device->size();
+    if (!archiveData && archiveSize > 0) {
+        status = ZipContainer::FileReadError;
+        return;
+    }
+
     dirtyFileTree = false;
-    uint8_t tmp[4];
-    device->read(tmp, 4);
-    if (readUInt(tmp) != 0x04034b50) {
+    if (archiveSize < 4 || readUInt(archiveData) != 0x04034b50) {
         LOGW("Zip: not a zip file!");
         return;
     }
 
     // find EndOfDirectory header
-    int i = 0;
-    int start_of_directory_local = -1;
-    int num_dir_entries = 0;
-    EndOfDirectory eod;
-    while (start_of_directory_local == -1) {
-        const int pos = int(device->size()) - int(sizeof(EndOfDirectory)) - i;
-        if (pos < 0 || i > 65535) {
+    size_t eodPos = 0;
+    size_t i = 0;
+    for (;; ++i) {
+        if (archiveSize < sizeof(EndOfDirectory) + i || i > 65535) {
             LOGW("Zip: EndOfDirectory not found");
             return;
         }
 
-        device->seek(pos);
-        device->read((uint8_t*)&eod, sizeof(EndOfDirectory));
-        if (readUInt(eod.signature) == 0x06054b50) {
+        eodPos = archiveSize - sizeof(EndOfDirectory) - i;
+        if (readUInt(archiveData + eodPos) == 0x06054b50) {
             break;
         }
-        ++i;
     }
 
     // have the eod
-    start_of_directory_local = readUInt(eod.dir_start_offset);
-    num_dir_entries = readUShort(eod.num_dir_entries);
-    ZDEBUG("start_of_directory at %d, num_dir_entries=%d", start_of_directory_local, num_dir_entries);
-    int comment_length = readUShort(eod.comment_length);
+    EndOfDirectory eod;
+    std::memcpy(&eod, archiveData + eodPos, sizeof(EndOfDirectory));
+    uint64_t start_of_directory_local = readUInt(eod.dir_start_offset);
+    uint64_t num_dir_entries = readUShort(eod.num_dir_entries);
+    size_t comment_length = readUShort(eod.comment_length);
     if (comment_length != i) {
         LOGW("Zip: failed to parse zip file.");
     }
-    comment = device->read(std::min(comment_length, i));
+    comment = ByteArray(archiveData + eodPos + sizeof(EndOfDirectory), std::min(comment_length, i));
+
+    // Zip64 locator is right before the eod
+    if (eodPos >= sizeof(Zip64EndOfDirectoryLocator)) {
+        Zip64EndOfDirectoryLocator locator;
+        std::memcpy(&locator, archiveData + eodPos - sizeof(Zip64EndOfDirectoryLocator), sizeof(Zip64EndOfDirectoryLocator));
+        if (readUInt(locator.signature) == 0x07064b50) {
+            const uint64_t zip64EodPos = readUInt64(locator.end_of_directory_offset);
+            if (zip64EodPos <= eodPos - sizeof(Zip64EndOfDirectoryLocator) - sizeof(Zip64EndOfDirectory)
+                && readUInt(archiveData + zip64EodPos) == 0x06064b50) {
+                Zip64EndOfDirectory eod64;
+                std::memcpy(&eod64, archiveData + zip64EodPos, sizeof(Zip64EndOfDirectory));
+                start_of_directory_local = readUInt64(eod64.dir_start_offset);
+                num_dir_entries = readUInt64(eod64.num_dir_entries);
+            } else {
+                LOGW("Zip: Zip64 EndOfDirectory not found");
+            }
+        }
+    }
 
-    device->seek(start_of_directory_local);
-    for (i = 0; i < num_dir_entries; ++i) {
+    ZDEBUG("start_of_directory at %llu, num_dir_entries=%llu", (unsigned long long)start_of_directory_local,
+           (unsigned long long)num_dir_entries);
+
+    // every entry takes at least the header
+    fileHeaders.reserve(fileHeaders.size() + std::min<uint64_t>(num_dir_entries, archiveSize / sizeof(CentralFileHeader)));
+
+    uint64_t pos = start_of_directory_local;
+    auto readBytes = [this, &pos](ByteArray& out, size_t len) {
+        if (pos > archiveSize || archiveSize - pos < len) {
+            return false;
+        }
+        out = ByteArray(archiveData + pos, len);
+        pos += len;
+        return true;
+    };
+
+    for (uint64_t n = 0; n < num_dir_entries; ++n) {
         FileHeader header;
-        int read = (int)device->read((uint8_t*)&header.h, sizeof(CentralFileHeader));
-        if (read < (int)sizeof(CentralFileHeader)) {
+        if (pos > archiveSize || archiveSize - pos < sizeof(CentralFileHeader)) {
             LOGW("Zip: Failed to read complete header, index may be incomplete");
             break;
         }
+        std::memcpy(&header.h, archiveData + pos, sizeof(CentralFileHeader));
+        pos += sizeof(CentralFileHeader);
         if (readUInt(header.h.signature) != 0x02014b50) {
             LOGW("Zip: invalid header signature, index may be incomplete");
             break;
         }
 
-        size_t l = readUShort(header.h.file_name_length);
-        header.file_name = device->read(l);
-        if (header.file_name.size() != l) {
+        if (!readBytes(header.file_name, readUShort(header.h.file_name_length))) {
             LOGW("Zip: Failed to read filename from zip index, index may be incomplete");
             break;
         }
-        l = readUShort(header.h.extra_field_length);
-        header.extra_field = device->read(l);
-        if (header.extra_field.size() != l) {
+        if (!readBytes(header.extra_field, readUShort(header.h.extra_field_length))) {
             LOGW("Zip: Failed to read extra field in zip file, skipping file, index may be incomplete");
             break;
         }
-        l = readUShort(header.h.file_comment_length);
-        header.file_comment = device->read(l);
-        if (header.file_comment.size() != l) {
+        if (!readBytes(header.file_comment, readUShort(header.h.file_comment_length))) {
             LOGW("Zip: Failed to read read file comment, index may be incomplete");
             break;
         }
 
-        ZDEBUG("found file '%s'", header.file_name.data());
-        fileHeaders.push_back(header);
+        header.compressedSize = readUInt(header.h.compressed_size);
+        header.uncompressedSize = readUInt(header.h.uncompressed_size);
+        header.localHeaderOffset = readUInt(header.h.offset_local_header);
+        readZip64ExtraField(header);
+
+        ZDEBUG("found file '%s'", header.file_name.constChar());
+        fileHeaders.push_back(std::move(header));
     }
+
+    buildIndex();
+}
+
+void ZipContainer::Impl::buildIndex()
+{
+    filePaths.clear();
+    filePaths.reserve(fileHeaders.size());
+    for (const FileHeader& header : fileHeaders) {
+        filePaths.push_back(fixFilePath(header.file_name));
+    }
+
+    // the views refer to filePaths, so it is filled first
+    fileIndex.clear();
+    fileIndex.reserve(filePaths.size());
+    for (size_t i = 0; i < filePaths.size(); ++i) {
+        fileIndex.emplace(filePaths[i], i); // the first of the same paths is found, as before
+    }
+}
+
+size_t ZipContainer::Impl::findFile(const std::string& fileName) const
+{
+    auto it = fileIndex.find(fileName);
+    return it != fileIndex.end() ? it->second : muse::nidx;
 }
 
 ZipContainer::FileInfo ZipContainer::Impl::fillFileInfo(size_t index) const
 {
     ZipContainer::FileInfo fileInfo;
-    FileHeader header = fileHeaders.at(index);
+    const FileHeader& header = fileHeaders.at(index);
     uint32_t mode = readUInt(header.h.external_file_attributes);
     const HostOS hostOS = HostOS(readUShort(header.h.version_made) >> 8);
     switch (hostOS) {
@@ -533,38 +698,93 @@ ZipContainer::FileInfo ZipContainer::Impl::fillFileInfo(size_t index) const
     // ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     // const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
-    fileInfo.filePath = fixFilePath(header.file_name);
+    fileInfo.filePath = filePaths.at(index);
     fileInfo.crc = readUInt(header.h.crc_32);
-    fileInfo.size = readUInt(header.h.uncompressed_size);
+    fileInfo.size = static_cast<int64_t>(header.uncompressedSize);
     fileInfo.lastModified = readMSDosDate(header.h.last_mod_file);
 
     return fileInfo;
 }
 
 void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents)
+{
+    const uint64_t size = contents.size();
+    bool compress = false;
+    const size_t entry = beginEntry(type, fileName, size, compress);
+    if (entry == muse::nidx) {
+        return;
+    }
+
+    const uint8_t* data = contents.constData();
+    size_t offset = 0;
+    do {
+        const size_t len = std::min(CHUNK_SIZE, contents.size() - offset);
+        const size_t dictSize = std::min(DICTIONARY_SIZE, offset);
+        addChunk(entry, data + offset - dictSize, dictSize, len, compress, offset == 0, offset + len == size);
+        offset += len;
+    } while (offset < size);
+}
+
+void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, IODevice* source)
+{
+    if (!(source->isOpen() || source->open(IODevice::ReadOnly))) {
+        status = ZipContainer::FileReadError;
+        return;
+    }
+
+    const uint64_t size = source->size() - source->pos();
+    bool compress = false;
+    const size_t entry = beginEntry(type, fileName, size, compress);
+    if (entry == muse::nidx) {
+        return;
+    }
+
+    // the dictionary and the chunk
+    std::vector<uint8_t> buf(DICTIONARY_SIZE + CHUNK_SIZE);
+    size_t dictSize = 0;
+    uint64_t offset = 0;
+    do {
+        const size_t len = static_cast<size_t>(std::min<uint64_t>(CHUNK_SIZE, size - offset));
+        const size_t read = source->read(buf.data() + dictSize, len);
+        if (read != len) {
+            LOGW("Zip: Failed to read file data");
+            std::memset(buf.data() + dictSize + read, 0, len - read);
+            status = ZipContainer::FileReadError;
+        }
+
+        addChunk(entry, buf.data(), dictSize, len, compress, offset == 0, offset + len == size);
+        offset += len;
+
+        const size_t newDictSize = std::min(DICTIONARY_SIZE, dictSize + len);
+        std::memmove(buf.data(), buf.data() + dictSize + len - newDictSize, newDictSize);
+        dictSize = newDictSize;
+    } while (offset < size);
+}
+
+size_t ZipContainer::Impl::beginEntry(EntryType type, const std::string& fileName, uint64_t size, bool& compress)
 {
     if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
         status = ZipContainer::FileOpenError;
-        return;
+        return muse::nidx;
     }
-    device->seek(start_of_directory);
 
     // don't compress small files
     ZipContainer::CompressionPolicy compression = compressionPolicy;
     if (compressionPolicy == ZipContainer::AutoCompress) {
-        if (contents.size() < 64) {
+        if (size < 64) {
             compression = ZipContainer::NeverCompress;
         } else {
             compression = ZipContainer::AlwaysCompress;
         }
     }
+    compress = compression == ZipContainer::AlwaysCompress;
 
     FileHeader header;
     std::memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
-    writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, (uint)contents.size());
+    writeUShort(header.h.version_needed, size >= ZIP64_LOCAL_LIMIT ? ZIP64_VERSION : ZIP_VERSION);
+    header.uncompressedSize = size;
 
     std::time_t t = std::time(0);   // get time now
     std::tm now;
@@ -574,37 +794,9 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     localtime_r(&t, &now);
 #endif
     writeMSDosDate(header.h.last_mod_file, now);
-    ByteArray data = contents;
-    if (compression == ZipContainer::AlwaysCompress) {
+    if (compress) {
         writeUShort(header.h.compression_method, CompressionMethodDeflated);
-
-        ulong len = (ulong)contents.size();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size());
-
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                LOGW("Zip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
     }
-// TODO add a check if data.size() > contents.size().  Then try to store the original and revert the compression method to be uncompressed
-    writeUInt(header.h.compressed_size, (uint)data.size());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uint8_t*)contents.constData(), (uint)contents.size());
-    writeUInt(header.h.crc_32, crc_32);
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
@@ -646,19 +838,220 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
         break;
     }
     writeUInt(header.h.external_file_attributes, mode << 16);
-    writeUInt(header.h.offset_local_header, start_of_directory);
 
     fileHeaders.push_back(header);
+    dirtyFileTree = true;
+
+    return fileHeaders.size() - 1;
+}
+
+void ZipContainer::Impl::addChunk(size_t entry, const uint8_t* input, size_t dictSize, size_t size, bool compress, bool first,
+                                  bool last)
+{
+    Chunk chunk;
+    chunk.entry = entry;
+    chunk.size = size;
+    chunk.first = first;
+    chunk.last = last;
+
+#ifdef MUSE_THREADS_SUPPORT
+    if (taskScheduler) {
+        ByteArray data(input, dictSize + size);
+        chunk.future = taskScheduler->submit([data, dictSize, size, compress, last]() {
+            return compressChunk(data.constData(), dictSize, size, compress, last);
+        });
+
+        chunk.memory = data.size();
+        chunksMemory += chunk.memory;
+        chunks.push_back(std::move(chunk));
+        writeChunks(memoryLimit);
+        return;
+    }
+#endif
+
+    chunk.result = compressChunk(input, dictSize, size, compress, last);
+    writeChunk(chunk);
+}
+
+//! NOTE Writes the compressed chunks in order until the rest fits in the memory,
+//! the done ones are written anyway
+void ZipContainer::Impl::writeChunks(size_t memory)
+{
+#ifdef MUSE_THREADS_SUPPORT
+    while (!chunks.empty()) {
+        Chunk& chunk = chunks.front();
+        const bool ready = chunk.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (!ready && chunksMemory <= memory) {
+            break;
+        }
+
+        chunk.result = chunk.future.get();
+        writeChunk(chunk);
+
+        chunksMemory -= chunk.memory;
+        chunks.pop_front();
+    }
+#else
+    UNUSED(memory);
+#endif
+}
+
+void ZipContainer::Impl::writeChunk(Chunk& chunk)
+{
+    FileHeader& header = fileHeaders.at(chunk.entry);
+    const bool zip64Local = header.uncompressedSize >= ZIP64_LOCAL_LIMIT;
+
+    bool ok = chunk.result.ok;
+
+    if (chunk.first) {
+        device->seek(start_of_directory);
+        header.localHeaderOffset = start_of_directory;
+        header.compressedSize = 0;
+        entryCrc = ::crc32(0, 0, 0);
+
+        // with one chunk the header is complete, else it is updated after the last chunk
+        if (chunk.last) {
+            writeUInt(header.h.crc_32, chunk.result.crc);
+            header.compressedSize = chunk.result.data.size();
+        }
+
+        LocalFileHeader h = header.h.toLocalHeader();
+        writeUInt(h.compressed_size, zip64Local ? 0xffffffff : (uint)header.compressedSize);
+        writeUInt(h.uncompressed_size, zip64Local ? 0xffffffff : (uint)header.uncompressedSize);
+        writeUShort(h.extra_field_length, zip64Local ? 20 : 0);
+        ok &= writeToDevice((const uint8_t*)&h, sizeof(LocalFileHeader));
+        ok &= writeToDevice(header.file_name);
+
+        if (zip64Local) {
+            uint8_t extra[20];
+            writeUShort(extra, 0x0001);
+            writeUShort(extra + 2, 16);
+            writeUInt(extra + 4, (uint)header.uncompressedSize);
+            writeUInt(extra + 8, (uint)(header.uncompressedSize >> 32));
+            writeUInt(extra + 12, (uint)header.compressedSize);
+            writeUInt(extra + 16, (uint)(header.compressedSize >> 32));
+            ok &= writeToDevice(extra, sizeof(extra));
+        }
+
+        header.compressedSize = 0;
+    }
+
+    ok &= writeToDevice(chunk.result.data);
+    entryCrc = ::crc32_combine(entryCrc, chunk.result.crc, (z_off_t)chunk.size);
+    header.compressedSize += chunk.result.data.size();
+
+    if (chunk.last) {
+        start_of_directory = device->pos();
+        writeUInt(header.h.crc_32, (uint)entryCrc);
+
+        if (!chunk.first) {
+            uint8_t sizes[8];
+            writeUInt(sizes, (uint)entryCrc);
+            writeUInt(sizes + 4, (uint)header.compressedSize);
+            device->seek(header.localHeaderOffset + 14);
+            ok &= writeToDevice(sizes, zip64Local ? 4 : 8);
+
+            if (zip64Local) {
+                writeUInt(sizes, (uint)header.compressedSize);
+                writeUInt(sizes + 4, (uint)(header.compressedSize >> 32));
+                device->seek(header.localHeaderOffset + sizeof(LocalFileHeader) + header.file_name.size() + 12);
+                ok &= writeToDevice(sizes, 8);
+            }
+
+            device->seek(start_of_directory);
+        }
+    }
+
+    if (!ok) {
+        status = ZipContainer::FileWriteError;
+    }
+}
 
+void ZipContainer::Impl::writeDirectory()
+{
     bool ok = true;
 
-    LocalFileHeader h = header.h.toLocalHeader();
-    ok &= writeToDevice((const uint8_t*)&h, sizeof(LocalFileHeader));
-    ok &= writeToDevice(header.file_name);
-    ok &= writeToDevice(data);
+    device->seek(start_of_directory);
+    // write new directory
+    for (FileHeader& header : fileHeaders) {
+        // the values that don't fit are in the Zip64 extra field
+        uint8_t extra[28];
+        size_t extraSize = 4;
+        auto setValue = [&extra, &extraSize](uint8_t* field, uint64_t v) {
+            if (v < 0xffffffff) {
+                writeUInt(field, (uint)v);
+                return;
+            }
+            writeUInt(field, 0xffffffff);
+            writeUInt(extra + extraSize, (uint)v);
+            writeUInt(extra + extraSize + 4, (uint)(v >> 32));
+            extraSize += 8;
+        };
+
+        setValue(header.h.uncompressed_size, header.uncompressedSize);
+        setValue(header.h.compressed_size, header.compressedSize);
+        setValue(header.h.offset_local_header, header.localHeaderOffset);
+
+        if (extraSize > 4) {
+            writeUShort(extra, 0x0001);
+            writeUShort(extra + 2, (ushort)(extraSize - 4));
+            header.extra_field = ByteArray(extra, extraSize);
+            writeUShort(header.h.version_needed, ZIP64_VERSION);
+        }
+        writeUShort(header.h.extra_field_length, (ushort)header.extra_field.size());
+
+        ok &= writeToDevice((const uint8_t*)&header.h, sizeof(CentralFileHeader));
+        ok &= writeToDevice(header.file_name);
+        ok &= writeToDevice(header.extra_field);
+        ok &= writeToDevice(header.file_comment);
+    }
 
-    start_of_directory = (uint)device->pos();
-    dirtyFileTree = true;
+    const uint64_t dir_size = device->pos() - start_of_directory;
+    const uint64_t num_dir_entries = fileHeaders.size();
+    const bool zip64 = num_dir_entries >= 0xffff || dir_size >= 0xffffffff || start_of_directory >= 0xffffffff;
+
+    if (zip64) {
+        const uint64_t eod64Offset = device->pos();
+
+        Zip64EndOfDirectory eod64;
+        std::memset(&eod64, 0, sizeof(Zip64EndOfDirectory));
+        writeUInt(eod64.signature, 0x06064b50);
+        writeUInt(eod64.record_size, sizeof(Zip64EndOfDirectory) - 12);
+        writeUShort(eod64.version_made, HostUnix << 8 | ZIP64_VERSION);
+        writeUShort(eod64.version_needed, ZIP64_VERSION);
+        for (uint8_t* field : { eod64.num_dir_entries_this_disk, eod64.num_dir_entries }) {
+            writeUInt(field, (uint)num_dir_entries);
+            writeUInt(field + 4, (uint)(num_dir_entries >> 32));
+        }
+        writeUInt(eod64.directory_size, (uint)dir_size);
+        writeUInt(eod64.directory_size + 4, (uint)(dir_size >> 32));
+        writeUInt(eod64.dir_start_offset, (uint)start_of_directory);
+        writeUInt(eod64.dir_start_offset + 4, (uint)(start_of_directory >> 32));
+        ok &= writeToDevice((const uint8_t*)&eod64, sizeof(Zip64EndOfDirectory));
+
+        Zip64EndOfDirectoryLocator locator;
+        std::memset(&locator, 0, sizeof(Zip64EndOfDirectoryLocator));
+        writeUInt(locator.signature, 0x07064b50);
+        writeUInt(locator.end_of_directory_offset, (uint)eod64Offset);
+        writeUInt(locator.end_of_directory_offset + 4, (uint)(eod64Offset >> 32));
+        writeUInt(locator.num_disks, 1);
+        ok &= writeToDevice((const uint8_t*)&locator, sizeof(Zip64EndOfDirectoryLocator));
+    }
+
+    // write end of directory
+    EndOfDirectory eod;
+    memset(&eod, 0, sizeof(EndOfDirectory));
+    writeUInt(eod.signature, 0x06054b50);
+    //uint8_t this_disk[2];
+    //uint8_t start_of_directory_disk[2];
+    writeUShort(eod.num_dir_entries_this_disk, (ushort)std::min<uint64_t>(num_dir_entries, 0xffff));
+    writeUShort(eod.num_dir_entries, (ushort)std::min<uint64_t>(num_dir_entries, 0xffff));
+    writeUInt(eod.directory_size, (uint)std::min<uint64_t>(dir_size, 0xffffffff));
+    writeUInt(eod.dir_start_offset, (uint)std::min<uint64_t>(start_of_directory, 0xffffffff));
+    writeUShort(eod.comment_length, (ushort)comment.size());
+
+    ok &= writeToDevice((const uint8_t*)&eod, sizeof(EndOfDirectory));
+    ok &= writeToDevice(comment);
 
     if (!ok) {
         status = ZipContainer::FileWriteError;
@@ -734,98 +1127,233 @@ int ZipContainer::count() const
 bool ZipContainer::fileExists(const std::string& fileName) const
 {
     p->scanFiles();
+    return p->findFile(fileName) != muse::nidx;
+}
+
+ByteArray ZipContainer::fileData(const std::string& fileName) const
+{
+    std::unique_ptr<FileReader> reader = fileReader(fileName);
+    if (!reader) {
+        return ByteArray();
+    }
+
+    ByteArray data(static_cast<size_t>(reader->size()));
+    size_t size = reader->read(data.data(), data.size());
+
+    // the size in the header may be wrong
+    while (!reader->atEnd() && !reader->hasError()) {
+        if (size == data.size()) {
+            data.resize(std::max(data.size() * 2, size_t(64 * 1024)));
+        }
 
-    for (size_t i = 0; i < p->fileHeaders.size(); ++i) {
-        std::string currentFileName = p->fixFilePath(p->fileHeaders.at(i).file_name.constChar());
-        if (currentFileName == fileName) {
-            return true;
+        const size_t read = reader->read(data.data() + size, data.size() - size);
+        if (read == 0) {
+            break;
         }
+        size += read;
     }
 
-    return false;
+    if (reader->hasError()) {
+        return ByteArray();
+    }
+
+    data.truncate(size);
+    return data;
 }
 
-ByteArray ZipContainer::fileData(const std::string& fileName) const
+// FileReader
+
+struct ZipContainer::FileReader::Impl {
+    const uint8_t* data = nullptr;
+    uint64_t compressedSize = 0;
+    uint64_t uncompressedSize = 0;
+    uint crc = 0;
+    bool deflated = false;
+
+    uint64_t inPos = 0;
+    uint64_t outPos = 0;
+    uLong outCrc = ::crc32(0, 0, 0);
+    bool finished = false;
+    bool error = false;
+    bool crcMismatch = false;
+
+    z_stream stream;
+    bool streamInited = false;
+
+    ~Impl()
+    {
+        if (streamInited) {
+            inflateEnd(&stream);
+        }
+    }
+};
+
+// zlib takes 32-bit lengths
+static constexpr uint64_t ZLIB_CHUNK = 1u << 30;
+
+ZipContainer::FileReader::FileReader(Impl* impl)
+    : p(impl)
 {
-    p->scanFiles();
+}
 
-    size_t i = 0;
-    for (i = 0; i < p->fileHeaders.size(); ++i) {
-        std::string currentFileName = p->fixFilePath(p->fileHeaders.at(i).file_name.constChar());
-        if (currentFileName == fileName) {
-            break;
+ZipContainer::FileReader::~FileReader()
+{
+    delete p;
+}
+
+uint64_t ZipContainer::FileReader::size() const
+{
+    return p->uncompressedSize;
+}
+
+uint64_t ZipContainer::FileReader::pos() const
+{
+    return p->outPos;
+}
+
+bool ZipContainer::FileReader::atEnd() const
+{
+    return p->finished || p->error;
+}
+
+bool ZipContainer::FileReader::hasError() const
+{
+    return p->error;
+}
+
+bool ZipContainer::FileReader::hasCrcMismatch() const
+{
+    return p->crcMismatch;
+}
+
+size_t ZipContainer::FileReader::read(uint8_t* data, size_t len)
+{
+    if (atEnd() || len == 0) {
+        return 0;
+    }
+
+    size_t done = 0;
+    if (!p->deflated) {
+        // no compression
+        const uint64_t available = std::min(p->compressedSize, p->uncompressedSize);
+        done = static_cast<size_t>(std::min<uint64_t>(len, available - p->outPos));
+        std::memcpy(data, p->data + p->outPos, done);
+        p->finished = p->outPos + done == available;
+    } else {
+        z_stream& stream = p->stream;
+        while (done < len) {
+            if (stream.avail_in == 0 && p->inPos < p->compressedSize) {
+                const uInt chunk = static_cast<uInt>(std::min(p->compressedSize - p->inPos, ZLIB_CHUNK));
+                stream.next_in = const_cast<Bytef*>(p->data + p->inPos);
+                stream.avail_in = chunk;
+                p->inPos += chunk;
+            }
+
+            const uInt out = static_cast<uInt>(std::min<uint64_t>(len - done, ZLIB_CHUNK));
+            stream.next_out = data + done;
+            stream.avail_out = out;
+
+            const int res = ::inflate(&stream, Z_NO_FLUSH);
+            done += out - stream.avail_out;
+
+            if (res == Z_STREAM_END) {
+                p->finished = true;
+                break;
+            }
+
+            if (res != Z_OK) {
+                switch (res) {
+                case Z_MEM_ERROR:
+                    LOGW("Zip: Z_MEM_ERROR: Not enough memory");
+                    break;
+                default:
+                    LOGW("Zip: Z_DATA_ERROR: Input data is corrupted");
+                    break;
+                }
+                p->error = true;
+                break;
+            }
         }
     }
 
-    if (i == p->fileHeaders.size()) {
-        return ByteArray();
+    for (size_t i = 0; i < done; i += ZLIB_CHUNK) {
+        p->outCrc = ::crc32(p->outCrc, data + i, static_cast<uInt>(std::min<uint64_t>(done - i, ZLIB_CHUNK)));
+    }
+    p->outPos += done;
+
+    //! NOTE Not an error, as before the check: some writers put wrong checksums, and the data is usually still usable
+    if (p->finished && !p->crcMismatch && p->outCrc != p->crc) {
+        LOGW("Zip: CRC mismatch: Input data may be corrupted");
+        p->crcMismatch = true;
+    }
+
+    return done;
+}
+
+std::unique_ptr<ZipContainer::FileReader> ZipContainer::fileReader(const std::string& fileName) const
+{
+    p->scanFiles();
+
+    const size_t index = p->findFile(fileName);
+    if (index == muse::nidx) {
+        return nullptr;
     }
 
-    FileHeader header = p->fileHeaders.at(i);
+    const FileHeader& header = p->fileHeaders.at(index);
 
     ushort version_needed = readUShort(header.h.version_needed);
-    if (version_needed > ZIP_VERSION) {
+    if (version_needed > ZIP64_VERSION) {
         LOGW("Zip: .ZIP specification version %d implementation is needed to extract the data.", version_needed);
-        return ByteArray();
+        return nullptr;
     }
 
     ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
-    int compressed_size = readUInt(header.h.compressed_size);
-    int uncompressed_size = readUInt(header.h.uncompressed_size);
-    int start = readUInt(header.h.offset_local_header);
+    if ((general_purpose_bits & Encrypted) != 0) {
+        LOGW("Zip: Unsupported encryption method is needed to extract the data.");
+        return nullptr;
+    }
+
+    const uint64_t start = header.localHeaderOffset;
+    if (start > p->archiveSize || p->archiveSize - start < sizeof(LocalFileHeader)) {
+        LOGW("Zip: Local header is out of the archive");
+        return nullptr;
+    }
 
-    p->device->seek(start);
     LocalFileHeader lh;
-    p->device->read((uint8_t*)&lh, sizeof(LocalFileHeader));
-    uint skip = readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
-    p->device->seek(p->device->pos() + skip);
+    std::memcpy(&lh, p->archiveData + start, sizeof(LocalFileHeader));
+    const uint64_t dataPos = start + sizeof(LocalFileHeader) + readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
+    if (dataPos > p->archiveSize || p->archiveSize - dataPos < header.compressedSize) {
+        LOGW("Zip: File data is out of the archive");
+        return nullptr;
+    }
 
     int compression_method = readUShort(lh.compression_method);
-
-    if ((general_purpose_bits & Encrypted) != 0) {
-        LOGW("Zip: Unsupported encryption method is needed to extract the data.");
-        return ByteArray();
+    if (compression_method != CompressionMethodStored && compression_method != CompressionMethodDeflated) {
+        LOGW("Zip: Unsupported compression method %d is needed to extract the data.", compression_method);
+        return nullptr;
     }
 
-    ByteArray compressed = p->device->read(compressed_size);
-    if (compression_method == CompressionMethodStored) {
-        // no compression
-        compressed.truncate(uncompressed_size);
-        return compressed;
-    } else if (compression_method == CompressionMethodDeflated) {
-        // Deflate
-        //qDebug("compressed=%d", compressed.size());
-        compressed.truncate(compressed_size);
-        ByteArray baunzip;
-        ulong len = std::max(uncompressed_size,  1);
-        int res;
-        do {
-            baunzip.resize(len);
-            res = inflate((uint8_t*)baunzip.data(), &len,
-                          (const uint8_t*)compressed.constData(), compressed_size);
-
-            switch (res) {
-            case Z_OK:
-                if ((size_t)len != baunzip.size()) {
-                    baunzip.resize(len);
-                }
-                break;
-            case Z_MEM_ERROR:
-                LOGW("Zip: Z_MEM_ERROR: Not enough memory");
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            case Z_DATA_ERROR:
-                LOGW("Zip: Z_DATA_ERROR: Input data is corrupted");
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-        return baunzip;
+    FileReader::Impl* r = new FileReader::Impl();
+    r->data = p->archiveData + dataPos;
+    r->compressedSize = header.compressedSize;
+    r->uncompressedSize = header.uncompressedSize;
+    r->crc = readUInt(header.h.crc_32);
+    r->deflated = compression_method == CompressionMethodDeflated;
+
+    if (r->deflated) {
+        std::memset(&r->stream, 0, sizeof(z_stream));
+        if (inflateInit2(&r->stream, -MAX_WBITS) != Z_OK) {
+            LOGW("Zip: Failed to init inflate");
+            delete r;
+            return nullptr;
+        }
+        r->streamInited = true;
+    } else if (std::min(r->compressedSize, r->uncompressedSize) == 0) {
+        r->finished = true;
+        r->crcMismatch = r->crc != 0;
     }
 
-    LOGW("Zip: Unsupported compression method %d is needed to extract the data.", compression_method);
-    return ByteArray();
+    return std::unique_ptr<FileReader>(new FileReader(r));
 }
 
 ZipContainer::Status ZipContainer::status() const
@@ -848,6 +1376,41 @@ void ZipContainer::addFile(const std::string& fileName, const ByteArray& data)
     p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data);
 }
 
+void ZipContainer::addFile(const std::string& fileName, IODevice* data)
+{
+    p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data);
+}
+
+void ZipContainer::setThreadCount(size_t count)
+{
+    p->writeChunks(0);
+
+#ifdef MUSE_THREADS_SUPPORT
+    p->threadCount = std::max(count, size_t(1));
+    p->taskScheduler.reset();
+    if (p->threadCount > 1) {
+        p->taskScheduler = std::make_unique<TaskScheduler>(static_cast<thread_pool_size_t>(p->threadCount));
+    }
+#else
+    UNUSED(count);
+#endif
+}
+
+size_t ZipContainer::threadCount() const
+{
+    return p->threadCount;
+}
+
+void ZipContainer::setMemoryLimit(size_t bytes)
+{
+    p->memoryLimit = bytes;
+}
+
+size_t ZipContainer::memoryLimit() const
+{
+    return p->memoryLimit;
+}
+
 void ZipContainer::addDirectory(const std::string& dirName)
 {
     std::string name(Dir::fromNativeSeparators(dirName).toStdString());
@@ -862,40 +1425,20 @@ void ZipContainer::close()
 {
     if (!(p->device->openMode() & IODevice::WriteOnly)) {
         p->device->close();
+
+        // the device data may change when it is opened again
+        if (!p->dirtyFileTree) {
+            p->fileHeaders.clear();
+            p->buildIndex();
+            p->archiveData = nullptr;
+            p->archiveSize = 0;
+            p->dirtyFileTree = true;
+        }
         return;
     }
 
-    bool ok = true;
-
-    //qDebug("Zip::close writing directory, %d entries", p->fileHeaders.size());
-    p->device->seek(p->start_of_directory);
-    // write new directory
-    for (size_t i = 0; i < p->fileHeaders.size(); ++i) {
-        const FileHeader& header = p->fileHeaders.at(i);
-        ok &= p->writeToDevice((const uint8_t*)&header.h, sizeof(CentralFileHeader));
-        ok &= p->writeToDevice(header.file_name);
-        ok &= p->writeToDevice(header.extra_field);
-        ok &= p->writeToDevice(header.file_comment);
-    }
-    int dir_size = (int)p->device->pos() - (int)p->start_of_directory;
-    // write end of directory
-    EndOfDirectory eod;
-    memset(&eod, 0, sizeof(EndOfDirectory));
-    writeUInt(eod.signature, 0x06054b50);
-    //uint8_t this_disk[2];
-    //uint8_t start_of_directory_disk[2];
-    writeUShort(eod.num_dir_entries_this_disk, (ushort)p->fileHeaders.size());
-    writeUShort(eod.num_dir_entries, (ushort)p->fileHeaders.size());
-    writeUInt(eod.directory_size, dir_size);
-    writeUInt(eod.dir_start_offset, p->start_of_directory);
-    writeUShort(eod.comment_length, (ushort)p->comment.size());
-
-    ok &= p->writeToDevice((const uint8_t*)&eod, sizeof(EndOfDirectory));
-    ok &= p->writeToDevice(p->comment);
+    p->writeChunks(0);
+    p->writeDirectory();
     p->device->close();
-
-    if (!ok) {
-        p->status = ZipContainer::FileWriteError;
-    }
 }
 }
@@ -23,6 +23,7 @@
 #define MUSE_GLOBAL_ZIPCONTAINER_H
 
 #include <ctime>
+#include <memory>
 #include <string>
 
 #include "io/iodevice.h"
@@ -66,6 +67,33 @@ public:
     bool fileExists(const std::string& fileName) const;
     ByteArray fileData(const std::string& fileName) const;
 
+    //! NOTE Reads a file by chunks, deflated data is inflated as it is read.
+    //! Refers to the archive data, so must not be used after the container is closed
+    class FileReader
+    {
+    public:
+        ~FileReader();
+
+        uint64_t size() const;
+        uint64_t pos() const;
+        bool atEnd() const;
+        bool hasError() const;
+        //! NOTE The read data doesn't match the checksum from the header (it is logged, but the data is still read)
+        bool hasCrcMismatch() const;
+
+        size_t read(uint8_t* data, size_t len);
+
+    private:
+        friend class ZipContainer;
+
+        struct Impl;
+        FileReader(Impl* impl);
+
+        Impl* p = nullptr;
+    };
+
+    std::unique_ptr<FileReader> fileReader(const std::string& fileName) const;
+
     // Write
     enum CompressionPolicy {
         AlwaysCompress,
@@ -76,7 +104,17 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    //! NOTE Files are compressed by chunks on this number of threads, the output does not depend on it.
+    //! With 1 (by default) they are compressed on the calling thread
+    void setThreadCount(size_t count);
+    size_t threadCount() const;
+
+    //! NOTE Limits the data waiting for compression and writing
+    void setMemoryLimit(size_t bytes);
+    size_t memoryLimit() const;
+
     void addFile(const std::string& fileName, const ByteArray& data);
+    void addFile(const std::string& fileName, io::IODevice* data);
     void addDirectory(const std::string& dirName);
 
 private:
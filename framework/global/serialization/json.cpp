@@ -21,70 +21,427 @@
  */
 #include "json.h"
 
+#include <atomic>
+#include <clocale>
 #include <cmath>
-#include <cassert>
+#include <variant>
 
-#define PICOJSON_USE_LOCALE 1
-#define PICOJSON_ASSERT assert
-#include "../thirdparty/picojson/picojson.h"
+#include "internal/jsontape.h"
 
 #include "log.h"
 
 using namespace muse;
 
+// =======================================
+// Data
+// =======================================
+
+//! NOTE A parsed document is kept as the tape, arrays and objects of it are used in place (JsonTapeRef).
+//! They are converted to own nodes (materialised) only when modified, their children stay in the tape.
+//! Scalars are always own nodes, so the strings can be returned by reference.
+namespace {
+struct JsonNode;
+using JsonNodeArray = std::vector<JsonNode>;
+using JsonNodeObject = std::vector<std::pair<std::string, JsonNode> >; // sorted by key, as picojson::object
+
+struct JsonTapeRef {
+    std::shared_ptr<const JsonTape> tape;
+    size_t pos = 0;
+};
+
+struct JsonNode {
+    std::variant<std::monostate, bool, double, std::string, JsonNodeArray, JsonNodeObject, JsonTapeRef> val;
+
+    JsonNode() = default;
+    template<typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, JsonNode> > >
+    JsonNode(T&& v)
+        : val(std::forward<T>(v)) {}
+};
+
+//! NOTE Children of a parsed array or object, built on the first access by index or by key
+struct JsonChildIndex {
+    std::vector<size_t> items;                                 // array: item positions
+    std::vector<std::pair<std::string_view, size_t> > values;  // object: sorted unique keys (the last wins) and value positions
+};
+
+//! NOTE Objects with up to this size are searched without the index
+constexpr size_t SMALL_OBJECT_SIZE = 8;
+
+JsonTape::Type nodeType(const JsonNode& n)
+{
+    switch (n.val.index()) {
+    case 0: return JsonTape::Type::Null;
+    case 1: return std::get<bool>(n.val) ? JsonTape::Type::True : JsonTape::Type::False;
+    case 2: return JsonTape::Type::Number;
+    case 3: return JsonTape::Type::String;
+    case 4: return JsonTape::Type::Array;
+    case 5: return JsonTape::Type::Object;
+    case 6: {
+        const JsonTapeRef& ref = std::get<JsonTapeRef>(n.val);
+        return ref.tape->type(ref.pos);
+    }
+    }
+    return JsonTape::Type::Null;
+}
+
+JsonNode nodeFromTape(const std::shared_ptr<const JsonTape>& tape, size_t pos)
+{
+    switch (tape->type(pos)) {
+    case JsonTape::Type::Null: return JsonNode();
+    case JsonTape::Type::False: return JsonNode(false);
+    case JsonTape::Type::True: return JsonNode(true);
+    case JsonTape::Type::Number: return JsonNode(tape->number(pos));
+    case JsonTape::Type::String: return JsonNode(std::string(tape->string(pos)));
+    case JsonTape::Type::Array:
+    case JsonTape::Type::Object:
+        break;
+    }
+    return JsonNode(JsonTapeRef { tape, pos });
+}
+
+//! NOTE Keys and value positions of a parsed object, in the picojson order: sorted, the last of the same keys
+void sortedValues(const JsonTape& tape, size_t pos, std::vector<std::pair<std::string_view, size_t> >& out)
+{
+    out.clear();
+    out.reserve(tape.at(pos).size);
+    for (size_t i = pos + 1; i < tape.at(pos).end; i = tape.next(i + 1)) {
+        out.emplace_back(tape.string(i), i + 1);
+    }
+
+    std::stable_sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t count = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (i + 1 < out.size() && out[i + 1].first == out[i].first) {
+            continue;
+        }
+        out[count++] = out[i];
+    }
+    out.resize(count);
+}
+}
+
 struct muse::JsonData
 {
-    picojson::value val;
+    JsonNode node;
+
+    JsonData() = default;
+    JsonData(JsonNode&& n)
+        : node(std::move(n)) {}
+    JsonData(const JsonData& d)
+        : node(d.node) {}
+    ~JsonData() { delete m_index.load(); }
+
+    JsonData& operator=(const JsonData&) = delete;
+
+    const JsonTapeRef* tapeRef() const { return std::get_if<JsonTapeRef>(&node.val); }
+
+    const JsonChildIndex& index() const
+    {
+        const JsonChildIndex* index = m_index.load(std::memory_order_acquire);
+        if (index) {
+            return *index;
+        }
+
+        const JsonTapeRef* ref = tapeRef();
+        JsonChildIndex* newIndex = new JsonChildIndex();
+        if (ref->tape->type(ref->pos) == JsonTape::Type::Array) {
+            const JsonTape& tape = *ref->tape;
+            newIndex->items.reserve(tape.at(ref->pos).size);
+            for (size_t i = ref->pos + 1; i < tape.at(ref->pos).end; i = tape.next(i)) {
+                newIndex->items.push_back(i);
+            }
+        } else {
+            sortedValues(*ref->tape, ref->pos, newIndex->values);
+        }
+
+        //! NOTE Several threads may read the same value
+        const JsonChildIndex* expected = nullptr;
+        if (m_index.compare_exchange_strong(expected, newIndex, std::memory_order_acq_rel)) {
+            return *newIndex;
+        }
+        delete newIndex;
+        return *expected;
+    }
+
+    //! NOTE Called before modification, the data is not shared at this point
+    void resetIndex()
+    {
+        delete m_index.exchange(nullptr);
+    }
+
+private:
+    mutable std::atomic<const JsonChildIndex*> m_index = nullptr;
 };
 
-static inline const picojson::value& val_const(const std::shared_ptr<JsonData>& d)
+static inline JsonTape::Type type_of(const std::shared_ptr<JsonData>& d)
+{
+    return d ? nodeType(d->node) : JsonTape::Type::Null;
+}
+
+static inline std::shared_ptr<JsonData> make_data(JsonNode&& n)
+{
+    return std::make_shared<JsonData>(std::move(n));
+}
+
+// Array
+
+static size_t array_size(const JsonData& d)
+{
+    if (const JsonNodeArray* a = std::get_if<JsonNodeArray>(&d.node.val)) {
+        return a->size();
+    }
+
+    if (const JsonTapeRef* ref = d.tapeRef()) {
+        if (ref->tape->type(ref->pos) == JsonTape::Type::Array) {
+            return ref->tape->at(ref->pos).size;
+        }
+    }
+
+    return 0;
+}
+
+static JsonNode array_at(const JsonData& d, size_t i)
+{
+    if (const JsonNodeArray* a = std::get_if<JsonNodeArray>(&d.node.val)) {
+        return a->at(i);
+    }
+
+    const JsonTapeRef* ref = d.tapeRef();
+    const JsonTape::Entry& e = ref->tape->at(ref->pos);
+    //! NOTE Items of a flat array (only scalars) are one after another
+    if (e.end == ref->pos + 1 + e.size) {
+        return nodeFromTape(ref->tape, ref->pos + 1 + i);
+    }
+    return nodeFromTape(ref->tape, d.index().items.at(i));
+}
+
+//! NOTE Converts the node to an own array, the items are kept in the tape
+static JsonNodeArray& array_mut(JsonData& d)
+{
+    if (JsonNodeArray* a = std::get_if<JsonNodeArray>(&d.node.val)) {
+        return *a;
+    }
+
+    JsonNodeArray arr;
+    if (const JsonTapeRef* ref = d.tapeRef()) {
+        const JsonTape& tape = *ref->tape;
+        if (tape.type(ref->pos) == JsonTape::Type::Array) {
+            arr.reserve(tape.at(ref->pos).size);
+            for (size_t i = ref->pos + 1; i < tape.at(ref->pos).end; i = tape.next(i)) {
+                arr.push_back(nodeFromTape(ref->tape, i));
+            }
+        }
+    }
+
+    d.resetIndex();
+    d.node.val = std::move(arr);
+    return std::get<JsonNodeArray>(d.node.val);
+}
+
+// Object
+
+static const JsonNode* object_find(const JsonNodeObject& o, std::string_view key)
+{
+    auto it = std::lower_bound(o.begin(), o.end(), key, [](const auto& p, std::string_view k) { return p.first < k; });
+    if (it != o.end() && it->first == key) {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+//! NOTE Position of the value in the tape, or muse::nidx
+static size_t object_find_tape(const JsonData& d, std::string_view key)
+{
+    const JsonTapeRef* ref = d.tapeRef();
+    const JsonTape& tape = *ref->tape;
+    const JsonTape::Entry& e = tape.at(ref->pos);
+
+    if (e.size <= SMALL_OBJECT_SIZE) {
+        size_t found = muse::nidx;
+        for (size_t i = ref->pos + 1; i < e.end; i = tape.next(i + 1)) {
+            if (tape.string(i) == key) {
+                found = i + 1;
+            }
+        }
+        return found;
+    }
+
+    const auto& values = d.index().values;
+    auto it = std::lower_bound(values.begin(), values.end(), key, [](const auto& p, std::string_view k) { return p.first < k; });
+    if (it != values.end() && it->first == key) {
+        return it->second;
+    }
+    return muse::nidx;
+}
+
+static bool object_is_tape(const JsonData& d)
+{
+    const JsonTapeRef* ref = d.tapeRef();
+    return ref && ref->tape->type(ref->pos) == JsonTape::Type::Object;
+}
+
+static size_t object_size(const JsonData& d)
+{
+    if (const JsonNodeObject* o = std::get_if<JsonNodeObject>(&d.node.val)) {
+        return o->size();
+    }
+
+    if (!object_is_tape(d)) {
+        return 0;
+    }
+
+    const JsonTapeRef* ref = d.tapeRef();
+    const JsonTape& tape = *ref->tape;
+    const JsonTape::Entry& e = tape.at(ref->pos);
+    if (e.size <= SMALL_OBJECT_SIZE) {
+        // the same keys are counted once
+        size_t count = 0;
+        for (size_t i = ref->pos + 1; i < e.end; i = tape.next(i + 1)) {
+            if (object_find_tape(d, tape.string(i)) == i + 1) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    return d.index().values.size();
+}
+
+//! NOTE Converts the node to an own object, the values are kept in the tape
+static JsonNodeObject& object_mut(JsonData& d)
 {
-    return d->val;
+    if (JsonNodeObject* o = std::get_if<JsonNodeObject>(&d.node.val)) {
+        return *o;
+    }
+
+    JsonNodeObject obj;
+    if (object_is_tape(d)) {
+        const JsonTapeRef* ref = d.tapeRef();
+        std::vector<std::pair<std::string_view, size_t> > values;
+        sortedValues(*ref->tape, ref->pos, values);
+        obj.reserve(values.size());
+        for (const auto& v : values) {
+            obj.emplace_back(std::string(v.first), nodeFromTape(ref->tape, v.second));
+        }
+    }
+
+    d.resetIndex();
+    d.node.val = std::move(obj);
+    return std::get<JsonNodeObject>(d.node.val);
 }
 
-static inline picojson::value& val_mut(std::shared_ptr<JsonData>& d)
+static void object_set(JsonData& d, const std::string& key, JsonNode&& n)
 {
-    return d->val;
+    JsonNodeObject& o = object_mut(d);
+    auto it = std::lower_bound(o.begin(), o.end(), key, [](const auto& p, const std::string& k) { return p.first < k; });
+    if (it != o.end() && it->first == key) {
+        it->second = std::move(n);
+    } else {
+        o.emplace(it, key, std::move(n));
+    }
+}
+
+// Write
+
+static void write_tape(JsonWriter& w, const JsonTape& tape, size_t pos)
+{
+    const JsonTape::Entry& e = tape.at(pos);
+    switch (e.type) {
+    case JsonTape::Type::Null: w.null();
+        break;
+    case JsonTape::Type::False: w.boolean(false);
+        break;
+    case JsonTape::Type::True: w.boolean(true);
+        break;
+    case JsonTape::Type::Number: w.number(e.number);
+        break;
+    case JsonTape::Type::String: w.string(tape.string(pos));
+        break;
+    case JsonTape::Type::Array: {
+        w.beginArray();
+        for (size_t i = pos + 1; i < e.end; i = tape.next(i)) {
+            write_tape(w, tape, i);
+        }
+        w.endArray();
+    } break;
+    case JsonTape::Type::Object: {
+        std::vector<std::pair<std::string_view, size_t> > values;
+        sortedValues(tape, pos, values);
+        w.beginObject();
+        for (const auto& v : values) {
+            w.key(v.first);
+            write_tape(w, tape, v.second);
+        }
+        w.endObject();
+    } break;
+    }
+}
+
+static void write_node(JsonWriter& w, const JsonNode& n)
+{
+    switch (n.val.index()) {
+    case 0: w.null();
+        break;
+    case 1: w.boolean(std::get<bool>(n.val));
+        break;
+    case 2: w.number(std::get<double>(n.val));
+        break;
+    case 3: w.string(std::get<std::string>(n.val));
+        break;
+    case 4: {
+        w.beginArray();
+        for (const JsonNode& item : std::get<JsonNodeArray>(n.val)) {
+            write_node(w, item);
+        }
+        w.endArray();
+    } break;
+    case 5: {
+        w.beginObject();
+        for (const auto& p : std::get<JsonNodeObject>(n.val)) {
+            w.key(p.first);
+            write_node(w, p.second);
+        }
+        w.endObject();
+    } break;
+    case 6: {
+        const JsonTapeRef& ref = std::get<JsonTapeRef>(n.val);
+        write_tape(w, *ref.tape, ref.pos);
+    } break;
+    }
 }
 
 // =======================================
 // JsonValue
 // =======================================
 JsonValue::JsonValue(bool v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(v))
 {
-    val_mut(m_data).set<bool>(v);
 }
 
 JsonValue::JsonValue(int v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(static_cast<double>(v)))
 {
-    double d = static_cast<double>(v);
-    val_mut(m_data).set<double>(d);
 }
 
 JsonValue::JsonValue(double v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(v))
 {
-    val_mut(m_data).set<double>(v);
 }
 
 JsonValue::JsonValue(const String& v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(v.toStdString()))
 {
-    val_mut(m_data).set<std::string>(v.toStdString());
 }
 
 JsonValue::JsonValue(const std::string& v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(v))
 {
-    val_mut(m_data).set<std::string>(v);
 }
 
 JsonValue::JsonValue(const char* v)
-    : m_data(std::make_shared<JsonData>())
+    : m_data(make_data(std::string(v)))
 {
-    val_mut(m_data).set<std::string>(std::string(v));
 }
 
 JsonValue::JsonValue(std::shared_ptr<JsonData> d)
@@ -110,35 +467,49 @@ void JsonValue::detach()
 
 bool JsonValue::isNull() const
 {
-    return val_const(m_data).is<picojson::null>();
+    return type_of(m_data) == JsonTape::Type::Null;
 }
 
 void JsonValue::setNull()
 {
     detach();
-    val_mut(m_data) = picojson::value();
+    m_data->resetIndex();
+    m_data->node = JsonNode();
 }
 
 bool JsonValue::isBool() const
 {
-    return val_const(m_data).is<bool>();
+    const JsonTape::Type t = type_of(m_data);
+    return t == JsonTape::Type::True || t == JsonTape::Type::False;
 }
 
+//! NOTE As picojson::value::evaluate_as_boolean
 bool JsonValue::toBool() const
 {
-    return val_const(m_data).evaluate_as_boolean();
+    switch (type_of(m_data)) {
+    case JsonTape::Type::Null: return false;
+    case JsonTape::Type::False: return false;
+    case JsonTape::Type::True: return true;
+    case JsonTape::Type::Number: return std::get<double>(m_data->node.val) != 0.0;
+    case JsonTape::Type::String: return !std::get<std::string>(m_data->node.val).empty();
+    case JsonTape::Type::Array:
+    case JsonTape::Type::Object:
+        break;
+    }
+    return true;
 }
 
 JsonValue& JsonValue::operator=(bool v)
 {
     detach();
-    val_mut(m_data).set<bool>(v);
+    m_data->resetIndex();
+    m_data->node = v;
     return *this;
 }
 
 bool JsonValue::isNumber() const
 {
-    return val_const(m_data).is<double>();
+    return type_of(m_data) == JsonTape::Type::Number;
 }
 
 int JsonValue::toInt() const
@@ -146,7 +517,7 @@ int JsonValue::toInt() const
     if (!isNumber()) {
         return 0;
     }
-    return static_cast<int>(std::round(val_const(m_data).get<double>()));
+    return static_cast<int>(std::round(std::get<double>(m_data->node.val)));
 }
 
 double JsonValue::toDouble() const
@@ -154,27 +525,28 @@ double JsonValue::toDouble() const
     if (!isNumber()) {
         return 0.0;
     }
-    return val_const(m_data).get<double>();
+    return std::get<double>(m_data->node.val);
 }
 
 JsonValue& JsonValue::operator=(int v)
 {
     detach();
-    double d = static_cast<double>(v);
-    val_mut(m_data).set<double>(d);
+    m_data->resetIndex();
+    m_data->node = static_cast<double>(v);
     return *this;
 }
 
 JsonValue& JsonValue::operator=(double v)
 {
     detach();
-    val_mut(m_data).set<double>(v);
+    m_data->resetIndex();
+    m_data->node = v;
     return *this;
 }
 
 bool JsonValue::isString() const
 {
-    return val_const(m_data).is<std::string>();
+    return type_of(m_data) == JsonTape::Type::String;
 }
 
 String JsonValue::toString() const
@@ -183,7 +555,7 @@ String JsonValue::toString() const
         static String dummy;
         return dummy;
     }
-    return String::fromStdString(val_const(m_data).get<std::string>());
+    return String::fromStdString(std::get<std::string>(m_data->node.val));
 }
 
 const std::string& JsonValue::toStdString() const
@@ -192,33 +564,36 @@ const std::string& JsonValue::toStdString() const
         static std::string dummy;
         return dummy;
     }
-    return val_const(m_data).get<std::string>();
+    return std::get<std::string>(m_data->node.val);
 }
 
 JsonValue& JsonValue::operator=(const String& str)
 {
     detach();
-    val_mut(m_data).set<std::string>(str.toStdString());
+    m_data->resetIndex();
+    m_data->node = str.toStdString();
     return *this;
 }
 
 JsonValue& JsonValue::operator=(const std::string& str)
 {
     detach();
-    val_mut(m_data).set<std::string>(str);
+    m_data->resetIndex();
+    m_data->node = str;
     return *this;
 }
 
 JsonValue& JsonValue::operator=(const char* str)
 {
     detach();
-    val_mut(m_data).set<std::string>(std::string(str));
+    m_data->resetIndex();
+    m_data->node = std::string(str);
     return *this;
 }
 
 bool JsonValue::isArray() const
 {
-    return val_const(m_data).is<picojson::array>();
+    return type_of(m_data) == JsonTape::Type::Array;
 }
 
 JsonArray JsonValue::toArray() const
@@ -228,14 +603,16 @@ JsonArray JsonValue::toArray() const
 
 JsonValue& JsonValue::operator=(const JsonArray& arr)
 {
+    JsonNode n = arr.m_data->node;
     detach();
-    val_mut(m_data) = val_const(arr.m_data);
+    m_data->resetIndex();
+    m_data->node = std::move(n);
     return *this;
 }
 
 bool JsonValue::isObject() const
 {
-    return val_const(m_data).is<picojson::object>();
+    return type_of(m_data) == JsonTape::Type::Object;
 }
 
 JsonObject JsonValue::toObject() const
@@ -245,8 +622,10 @@ JsonObject JsonValue::toObject() const
 
 JsonValue& JsonValue::operator=(const JsonObject& obj)
 {
+    JsonNode n = obj.m_data->node;
     detach();
-    val_mut(m_data) = val_const(obj.m_data);
+    m_data->resetIndex();
+    m_data->node = std::move(n);
     return *this;
 }
 
@@ -358,34 +737,22 @@ JsonValueRef& JsonValueRef::operator=(const JsonObject& v)
 // JsonArray
 // =======================================
 
-static inline const picojson::array& array_const(const std::shared_ptr<JsonData>& d)
-{
-    return d->val.get<picojson::array>();
-}
-
-static inline picojson::array& array_mut(std::shared_ptr<JsonData>& d)
-{
-    return d->val.get<picojson::array>();
-}
-
 JsonArray::JsonArray(std::shared_ptr<JsonData> d)
     : m_data(d)
 {
     if (!m_data) {
-        m_data = std::make_shared<JsonData>();
-        m_data->val = picojson::value(picojson::array());
+        m_data = make_data(JsonNodeArray());
     }
 }
 
 JsonArray::JsonArray(std::initializer_list<JsonValue> args)
 {
-    m_data = std::make_shared<JsonData>();
-    m_data->val = picojson::value(picojson::array());
-
-    array_mut(m_data).reserve(args.size());
+    JsonNodeArray arr;
+    arr.reserve(args.size());
     for (const JsonValue& v : args) {
-        array_mut(m_data).push_back(v.m_data->val);
+        arr.push_back(v.m_data->node);
     }
+    m_data = make_data(std::move(arr));
 }
 
 void JsonArray::detach()
@@ -403,151 +770,138 @@ void JsonArray::detach()
 
 size_t JsonArray::size() const
 {
-    return array_const(m_data).size();
+    return array_size(*m_data);
 }
 
 void JsonArray::resize(size_t i)
 {
     detach();
-    array_mut(m_data).resize(i);
+    array_mut(*m_data).resize(i);
 }
 
 bool JsonArray::empty() const
 {
-    return array_const(m_data).size() == 0;
+    return size() == 0;
 }
 
 JsonValue JsonArray::at(size_t i) const
 {
-    std::shared_ptr<JsonData> d = std::make_shared<JsonData>();
-    d->val = array_const(m_data).at(i);
-    return JsonValue(d);
+    IF_ASSERT_FAILED(i < size()) {
+        return JsonValue();
+    }
+    return JsonValue(make_data(array_at(*m_data, i)));
 }
 
 JsonArray& JsonArray::set(size_t i, bool v)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(v);
-    return *this;
+    return set(i, JsonValue(v));
 }
 
 JsonArray& JsonArray::set(size_t i, int v)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(static_cast<double>(v));
-    return *this;
+    return set(i, JsonValue(v));
 }
 
 JsonArray& JsonArray::set(size_t i, double v)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(v);
-    return *this;
+    return set(i, JsonValue(v));
 }
 
 JsonArray& JsonArray::set(size_t i, const String& str)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(str.toStdString());
-    return *this;
+    return set(i, JsonValue(str));
 }
 
 JsonArray& JsonArray::set(size_t i, const std::string& str)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(str);
-    return *this;
+    return set(i, JsonValue(str));
 }
 
 JsonArray& JsonArray::set(size_t i, const char* str)
 {
-    detach();
-    array_mut(m_data)[i] = picojson::value(std::string(str));
-    return *this;
+    return set(i, JsonValue(str));
 }
 
 JsonArray& JsonArray::set(size_t i, const JsonValue& v)
 {
+    JsonNode n = v.m_data->node;
     detach();
-    array_mut(m_data)[i] = v.m_data->val;
+    JsonNodeArray& arr = array_mut(*m_data);
+    IF_ASSERT_FAILED(i < arr.size()) {
+        return *this;
+    }
+    arr[i] = std::move(n);
     return *this;
 }
 
 JsonArray& JsonArray::set(size_t i, const JsonArray& v)
 {
-    detach();
-    array_mut(m_data)[i] = v.m_data->val;
-    return *this;
+    return set(i, JsonValue(v.m_data));
 }
 
 JsonArray& JsonArray::set(size_t i, const JsonObject& v)
 {
-    detach();
-    array_mut(m_data)[i] = v.m_data->val;
-    return *this;
+    return set(i, JsonValue(v.m_data));
 }
 
 JsonArray& JsonArray::append(bool v)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(v));
+    array_mut(*m_data).emplace_back(v);
     return *this;
 }
 
 JsonArray& JsonArray::append(int v)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(static_cast<double>(v)));
+    array_mut(*m_data).emplace_back(static_cast<double>(v));
     return *this;
 }
 
 JsonArray& JsonArray::append(double v)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(v));
+    array_mut(*m_data).emplace_back(v);
     return *this;
 }
 
 JsonArray& JsonArray::append(const String& str)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(str.toStdString()));
+    array_mut(*m_data).emplace_back(str.toStdString());
     return *this;
 }
 
 JsonArray& JsonArray::append(const std::string& str)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(str));
+    array_mut(*m_data).emplace_back(str);
     return *this;
 }
 
 JsonArray& JsonArray::append(const char* str)
 {
     detach();
-    array_mut(m_data).push_back(picojson::value(std::string(str)));
+    array_mut(*m_data).emplace_back(std::string(str));
     return *this;
 }
 
 JsonArray& JsonArray::append(const JsonValue& v)
 {
+    JsonNode n = v.m_data->node;
     detach();
-    array_mut(m_data).push_back(val_const(v.m_data));
+    array_mut(*m_data).push_back(std::move(n));
     return *this;
 }
 
 JsonArray& JsonArray::append(const JsonArray& v)
 {
-    detach();
-    array_mut(m_data).push_back(val_const(v.m_data));
-    return *this;
+    return append(JsonValue(v.m_data));
 }
 
 JsonArray& JsonArray::append(const JsonObject& v)
 {
-    detach();
-    array_mut(m_data).push_back(val_const(v.m_data));
-    return *this;
+    return append(JsonValue(v.m_data));
 }
 
 JsonValue JsonArray::operator [](size_t i) const
@@ -563,22 +917,12 @@ JsonValueRef JsonArray::operator [](size_t i)
 // =======================================
 // JsonObject
 // =======================================
-static const picojson::object& object_const(const std::shared_ptr<JsonData>& d)
-{
-    return d->val.get<picojson::object>();
-}
-
-static picojson::object& object_mut(std::shared_ptr<JsonData>& d)
-{
-    return d->val.get<picojson::object>();
-}
 
 JsonObject::JsonObject(std::shared_ptr<JsonData> d)
     : m_data(d)
 {
     if (!m_data) {
-        m_data = std::make_shared<JsonData>();
-        m_data->val = picojson::value(picojson::object());
+        m_data = make_data(JsonNodeObject());
     }
 }
 
@@ -597,114 +941,109 @@ void JsonObject::detach()
 
 bool JsonObject::isValid() const
 {
-    return val_const(m_data).is<picojson::object>();
+    return type_of(m_data) == JsonTape::Type::Object;
 }
 
 bool JsonObject::empty() const
 {
-    if (!isValid()) {
-        return true;
-    }
-
-    return object_const(m_data).size() == 0;
+    return size() == 0;
 }
 
 size_t JsonObject::size() const
 {
-    if (!isValid()) {
-        return 0;
-    }
-
-    return object_const(m_data).size();
+    return object_size(*m_data);
 }
 
 bool JsonObject::contains(const std::string& key) const
 {
-    if (!isValid()) {
+    if (const JsonNodeObject* o = std::get_if<JsonNodeObject>(&m_data->node.val)) {
+        return object_find(*o, key) != nullptr;
+    }
+
+    if (!object_is_tape(*m_data)) {
         return false;
     }
 
-    const picojson::object& o = object_const(m_data);
-    return o.find(key) != o.cend();
+    return object_find_tape(*m_data, key) != muse::nidx;
 }
 
 JsonValue JsonObject::value(const std::string& key, JsonValue def) const
 {
-    if (!isValid()) {
+    if (const JsonNodeObject* o = std::get_if<JsonNodeObject>(&m_data->node.val)) {
+        const JsonNode* n = object_find(*o, key);
+        return n ? JsonValue(make_data(JsonNode(*n))) : def;
+    }
+
+    if (!object_is_tape(*m_data)) {
         return def;
     }
 
-    const picojson::object& o = object_const(m_data);
-    auto it = o.find(key);
-    if (it != o.cend()) {
-        std::shared_ptr<JsonData> d = std::make_shared<JsonData>();
-        d->val = it->second;
-        return JsonValue(d);
+    const size_t pos = object_find_tape(*m_data, key);
+    if (pos == muse::nidx) {
+        return def;
     }
-    return def;
+
+    return JsonValue(make_data(nodeFromTape(m_data->tapeRef()->tape, pos)));
 }
 
 JsonObject& JsonObject::set(const std::string& key, bool v)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(v));
+    object_set(*m_data, key, v);
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, int v)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(static_cast<double>(v)));
+    object_set(*m_data, key, static_cast<double>(v));
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, double v)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(v));
+    object_set(*m_data, key, v);
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, const std::string& v)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(v));
+    object_set(*m_data, key, v);
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, const char* str)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(std::string(str)));
+    object_set(*m_data, key, std::string(str));
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, const String& str)
 {
     detach();
-    object_mut(m_data).insert_or_assign(key, picojson::value(str.toStdString()));
+    object_set(*m_data, key, str.toStdString());
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, const JsonValue& v)
 {
+    JsonNode n = v.m_data->node;
     detach();
-    object_mut(m_data).insert_or_assign(key, v.m_data->val);
+    object_set(*m_data, key, std::move(n));
     return *this;
 }
 
 JsonObject& JsonObject::set(const std::string& key, const JsonArray& v)
 {
-    detach();
-    object_mut(m_data).insert_or_assign(key, v.m_data->val);
-    return *this;
+    return set(key, JsonValue(v.m_data));
 }
 
 JsonObject& JsonObject::set(const std::string& key, const JsonObject& v)
 {
-    detach();
-    object_mut(m_data).insert_or_assign(key, v.m_data->val);
-    return *this;
+    return set(key, JsonValue(v.m_data));
 }
 
 JsonValue JsonObject::operator [](const std::string& key) const
@@ -720,9 +1059,17 @@ JsonValueRef JsonObject::operator [](const std::string& key)
 std::vector<std::string> JsonObject::keys() const
 {
     std::vector<std::string> result;
-    const picojson::object& o = object_const(m_data);
-    for (auto&& p : o) {
-        result.push_back(p.first);
+    if (const JsonNodeObject* o = std::get_if<JsonNodeObject>(&m_data->node.val)) {
+        result.reserve(o->size());
+        for (const auto& p : *o) {
+            result.push_back(p.first);
+        }
+    } else if (object_is_tape(*m_data)) {
+        const auto& values = m_data->index().values;
+        result.reserve(values.size());
+        for (const auto& v : values) {
+            result.emplace_back(v.first);
+        }
     }
     return result;
 }
@@ -747,32 +1094,41 @@ JsonDocument::JsonDocument(JsonArray a)
 
 ByteArray JsonDocument::toJson(Format format) const
 {
-    std::string json = m_data->val.serialize(format == Format::Indented);
+    std::string json;
+    JsonWriter writer(json, format == Format::Indented);
+    if (m_data) {
+        write_node(writer, m_data->node);
+    } else {
+        writer.null();
+    }
     return ByteArray(json.c_str(), json.size());
 }
 
 JsonDocument JsonDocument::fromJson(const ByteArray& ba, std::string* err)
 {
-    std::shared_ptr<JsonData> d = std::make_shared<JsonData>();
+    std::shared_ptr<JsonTape> tape = std::make_shared<JsonTape>();
 
     std::string_view json(ba.constChar(), ba.size());
 
     const char* currentLoc = setlocale(LC_NUMERIC, "C");
-    picojson::parse(d->val, json.begin(), json.end(), err);
+    const bool ok = tape->parse(json, err);
     setlocale(LC_NUMERIC, currentLoc);
 
-    JsonDocument doc(d);
-    return doc;
+    if (!ok) {
+        return JsonDocument(std::make_shared<JsonData>());
+    }
+
+    return JsonDocument(make_data(nodeFromTape(tape, 0)));
 }
 
 bool JsonDocument::isObject() const
 {
-    return m_data->val.is<picojson::object>();
+    return type_of(m_data) == JsonTape::Type::Object;
 }
 
 bool JsonDocument::isArray() const
 {
-    return m_data->val.is<picojson::array>();
+    return type_of(m_data) == JsonTape::Type::Array;
 }
 
 JsonObject JsonDocument::rootObject() const
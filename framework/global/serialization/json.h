@@ -201,7 +201,11 @@ public:
     JsonObject rootObject() const;
     JsonArray rootArray() const;
 
+    //! NOTE Integral numbers with the absolute value less than 2^53 are written as integers,
+    //! in full even out of the int range (picojson wrote them through int, that is undefined behavior)
     ByteArray toJson(Format format = Format::Indented) const;
+
+    //! NOTE Arrays and objects can be nested up to 100 levels (as in picojson), deeper is an error
     static JsonDocument fromJson(const ByteArray& ba, std::string* err = nullptr);
 
 private:
@@ -136,9 +136,9 @@ inline void pack_custom(std::vector<uint8_t>& data, const muse::String& value)
 
 inline bool unpack_custom(muse::msgpack::Cursor& cursor, muse::String& value)
 {
-    std::string str;
+    std::string_view str;
     bool ok = muse::msgpack::UnPacker::unpack(cursor, str);
-    value = muse::String::fromStdString(str);
+    value = muse::String::fromUtf8(str);
     return ok;
 }
 
@@ -227,14 +227,28 @@ inline bool unpack_custom(muse::msgpack::Cursor& cursor, muse::Uri& value)
 }
 
 // ByteArray
+//! NOTE Packed with the trailing zero (as the vdata), the raw (and mapped) data doesn't have the vdata
 inline void pack_custom(std::vector<uint8_t>& data, const muse::ByteArray& value)
 {
-    muse::msgpack::Packer::pack(data, value.constVData());
+    if (!kors::msgpack::pack_bin_header(data, value.size() + 1)) {
+        return;
+    }
+
+    data.insert(data.end(), value.constData(), value.constData() + value.size());
+    data.emplace_back(0);
 }
 
 inline bool unpack_custom(muse::msgpack::Cursor& cursor, muse::ByteArray& value)
 {
-    return muse::msgpack::UnPacker::unpack(cursor, value.vdata());
+    muse::msgpack::BinView bin;
+    bool ok = muse::msgpack::UnPacker::unpack(cursor, bin);
+    if (!ok || bin.size == 0) {
+        value = muse::ByteArray();
+        return ok;
+    }
+
+    value = muse::ByteArray(bin.data, bin.size - 1);
+    return ok;
 }
 
 // path_t
@@ -290,6 +304,6 @@ static inline bool unpack(muse::msgpack::Cursor& cursor, Types&... args)
 template<class ... Types>
 static inline bool unpack(const ByteArray& data, Types&... args)
 {
-    return UnPacker::unpack(data.constVData(), args ...);
+    return UnPacker::unpack(data.constData(), data.size(), args ...);
 }
 }
@@ -25,10 +25,12 @@ namespace kors::msgpack {
 class Packer;
 class UnPacker;
 struct Cursor;
+struct BinView;
 }
 
 namespace muse::msgpack {
 using Packer = kors::msgpack::Packer;
 using UnPacker = kors::msgpack::UnPacker;
 using Cursor = kors::msgpack::Cursor;
+using BinView = kors::msgpack::BinView;
 }
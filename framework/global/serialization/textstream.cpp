@@ -27,6 +27,7 @@
 #include "global/io/iodevice.h"
 #include "global/types/bytearray.h"
 #include "global/types/string.h"
+#include "global/types/internal/utf.h"
 
 #include "global/log.h"
 
@@ -177,8 +178,19 @@ TextStream& TextStream::operator<<(const ByteArray& b)
 
 TextStream& TextStream::operator<<(const String& s)
 {
-    ByteArray b = s.toUtf8();
-    write(reinterpret_cast<const char*>(b.constData()), b.size());
+    // transcode straight into the buffer
+    const std::u16string_view str = s.toStdU16StringView();
+    const size_t offset = m_buf.size();
+    m_buf.resize(offset + utf::utf8LengthOfUtf16(str.data(), str.size()));
+    const utf::Result r = utf::utf16to8(str.data(), str.size(), reinterpret_cast<char*>(m_buf.data() + offset));
+    m_buf.resize(offset + r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid UTF-16 at " << r.read;
+    }
+
+    if (m_device && m_buf.size() > TEXTSTREAM_BUFFERSIZE) {
+        flush();
+    }
     return *this;
 }
 
@@ -21,11 +21,14 @@
  */
 #include "xmlstreamreader.h"
 
+#include <charconv>
 #include <cstring>
 #include <sstream>
 
 #include "pugixml.hpp"
 
+#include "internal/xmlpullparser.h"
+
 #include "log.h"
 
 using namespace muse;
@@ -36,18 +39,119 @@ struct XmlStreamReader::Xml {
     pugi::xml_node node{};
     pugi::xml_parse_result result{};
     String customErr;
+    std::string pullText; // readAsciiText result in the incremental mode
 };
 
+using PullToken = XmlPullParser::Token;
+using PullTokenType = XmlPullParser::TokenType;
+
+static const XmlPullParser::Attribute* findPullAttribute(const PullToken& t, const char* name)
+{
+    if (t.type != PullTokenType::StartElement) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < t.attributesCount; ++i) {
+        if (*t.attributes[i].name == name) {
+            return &t.attributes[i];
+        }
+    }
+    return nullptr;
+}
+
+static AsciiStringView toView(const std::string& str)
+{
+    return AsciiStringView(str.c_str(), str.size());
+}
+
+static inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+//! NOTE Skips leading whitespace and '+', like strtol/strtod do
+static const char* numberBegin(const char* b, const char* e)
+{
+    while (b < e && isSpace(*b)) {
+        ++b;
+    }
+
+    if (b + 1 < e && *b == '+' && b[1] != '-' && b[1] != '+') {
+        ++b;
+    }
+    return b;
+}
+
+//! NOTE Same results as AsciiStringView::toInt, but without strlen/setlocale:
+//! the value is parsed as long and truncated to int, like strtol + cast
+static int toInt(const AsciiStringView& str, bool* ok, int base)
+{
+    if (base < 2 || base > 36) {
+        return str.toInt(ok, base);
+    }
+
+    const char* e = str.ascii() + str.size();
+    const char* b = numberBegin(str.ascii(), e);
+    if (base == 16 && e - b > 2 && b[0] == '0' && (b[1] == 'x' || b[1] == 'X')) {
+        b += 2;
+    }
+
+    long v = 0;
+    const std::from_chars_result r = std::from_chars(b, e, v, base);
+    if (r.ec == std::errc::result_out_of_range || (r.ec == std::errc() && r.ptr != e)) {
+        // saturation and the rare forms (like -0x1F) are left to strtol
+        return str.toInt(ok, base);
+    }
+
+    const bool myOk = b < e && r.ec == std::errc();
+    if (ok) {
+        *ok = myOk;
+    }
+    return myOk ? static_cast<int>(v) : 0;
+}
+
+//! NOTE Same results as AsciiStringView::toDouble: trailing characters are allowed
+static double toDouble(const AsciiStringView& str, bool* ok)
+{
+#ifdef __cpp_lib_to_chars
+    const char* e = str.ascii() + str.size();
+    const char* b = numberBegin(str.ascii(), e);
+
+    double v = 0.0;
+    const std::from_chars_result r = std::from_chars(b, e, v);
+    if (r.ec == std::errc::invalid_argument) {
+        if (ok) {
+            *ok = false;
+        }
+        return 0.0;
+    }
+
+    // out of range and hex floats are left to strtod
+    if (r.ec == std::errc() && (r.ptr == e || (*r.ptr != 'x' && *r.ptr != 'X'))) {
+        if (ok) {
+            *ok = true;
+        }
+        return v;
+    }
+#endif
+    return str.toDouble(ok);
+}
+
 XmlStreamReader::XmlStreamReader()
 {
     m_xml = new Xml();
 }
 
-XmlStreamReader::XmlStreamReader(IODevice* device)
+XmlStreamReader::XmlStreamReader(IODevice* device, DeviceMode mode)
 {
     m_xml = new Xml();
-    ByteArray data = device->readAll();
-    setData(data);
+    if (mode == DeviceMode::Incremental) {
+        m_pull = new XmlPullParser(device);
+        initPull();
+    } else {
+        ByteArray data = device->readAll();
+        setData(data);
+    }
 }
 
 XmlStreamReader::XmlStreamReader(const ByteArray& data)
@@ -68,13 +172,37 @@ XmlStreamReader::XmlStreamReader(const QByteArray& data)
 
 XmlStreamReader::~XmlStreamReader()
 {
+    delete m_pull;
     delete m_xml;
 }
 
+void XmlStreamReader::initPull()
+{
+    m_xml->customErr.clear();
+    m_token = TokenType::Invalid;
+
+    switch (m_pull->init()) {
+    case XmlPullParser::Status::Ok:
+        m_token = TokenType::NoToken;
+        break;
+    case XmlPullParser::Status::EmptyDocument:
+        m_xml->customErr = String(u"empty document");
+        LOGE() << m_xml->customErr;
+        break;
+    case XmlPullParser::Status::UnknownEncoding:
+        m_xml->customErr = String(u"unknown encoding");
+        LOGE() << m_xml->customErr;
+        break;
+    }
+}
+
 void XmlStreamReader::setData(const ByteArray& data_)
 {
     TRACEFUNC;
 
+    delete m_pull;
+    m_pull = nullptr;
+
     m_xml->doc.reset();
     m_xml->customErr.clear();
     m_token = TokenType::Invalid;
@@ -205,6 +333,46 @@ XmlStreamReader::TokenType XmlStreamReader::readNext()
         return m_token;
     }
 
+    if (m_pull) {
+        if (m_token == TokenType::EndDocument) {
+            m_token = TokenType::Invalid;
+            return m_token;
+        }
+
+        const PullToken& t = m_pull->next();
+        switch (t.type) {
+        case PullTokenType::Declaration:
+            m_token = TokenType::StartDocument;
+            break;
+        case PullTokenType::Doctype:
+            m_token = TokenType::DTD;
+            tryParseEntity(t.text.c_str());
+            break;
+        case PullTokenType::StartElement:
+            m_token = TokenType::StartElement;
+            break;
+        case PullTokenType::EndElement:
+            m_token = TokenType::EndElement;
+            break;
+        case PullTokenType::Text:
+            m_token = TokenType::Characters;
+            break;
+        case PullTokenType::Comment:
+            m_token = TokenType::Comment;
+            break;
+        case PullTokenType::EndDocument:
+            m_token = TokenType::EndDocument;
+            break;
+        case PullTokenType::Error:
+        case PullTokenType::None:
+            LOGE() << m_pull->errorString() << ", offset: " << t.offset;
+            m_token = TokenType::Invalid;
+            break;
+        }
+
+        return m_token;
+    }
+
     if (m_xml->result.status != pugi::status_ok || m_token == TokenType::EndDocument) {
         m_xml->node = pugi::xml_node();
         m_token = TokenType::Invalid;
@@ -230,16 +398,14 @@ XmlStreamReader::TokenType XmlStreamReader::readNext()
     m_token = p.second;
 
     if (m_token == TokenType::DTD) {
-        tryParseEntity(m_xml);
+        tryParseEntity(m_xml->node.value());
     }
 
     return m_token;
 }
 
-void XmlStreamReader::tryParseEntity(Xml* xml)
+void XmlStreamReader::tryParseEntity(const char* nodeValue)
 {
-    const char* nodeValue = xml->node.value();
-
     if (!nodeValue || *nodeValue == '\0') {
         return;
     }
@@ -326,32 +492,49 @@ void XmlStreamReader::tryParseEntity(Xml* xml)
 }
 
 // emulate tinyxml2::XMLNode::Value
-String XmlStreamReader::nodeValue(Xml* xml) const
+String XmlStreamReader::nodeValue() const
 {
-    const pugi::xml_node n = xml->node;
+    const pugi::xml_node n = m_xml->node;
 
     const char* raw = "";
-    switch (n.type()) {
-    case pugi::node_element:
-    case pugi::node_pi:
-    case pugi::node_declaration:
-    case pugi::node_doctype:
-    case pugi::node_document: // usually empty
-        raw = n.name();
-        break;
+    if (m_pull) {
+        const PullToken& t = m_pull->current();
+        switch (t.type) {
+        case PullTokenType::StartElement:
+        case PullTokenType::EndElement:
+            raw = t.name->c_str();
+            break;
+        case PullTokenType::Text:
+        case PullTokenType::Comment:
+            raw = t.text.c_str();
+            break;
+        default:
+            break;
+        }
+    } else {
+        switch (n.type()) {
+        case pugi::node_element:
+        case pugi::node_pi:
+        case pugi::node_declaration:
+        case pugi::node_doctype:
+        case pugi::node_document: // usually empty
+            raw = n.name();
+            break;
 
-    case pugi::node_pcdata:
-    case pugi::node_cdata:
-    case pugi::node_comment:
-        raw = n.value();
-        break;
+        case pugi::node_pcdata:
+        case pugi::node_cdata:
+        case pugi::node_comment:
+            raw = n.value();
+            break;
 
-    default:
-        break;
+        default:
+            break;
+        }
     }
 
     String str = String::fromUtf8(raw);
-    if (!m_entities.empty()) {
+    // entities are referenced as &name;
+    if (!m_entities.empty() && std::strchr(raw, '&')) {
         for (const auto& p : m_entities) {
             str.replace(p.first, p.second);
         }
@@ -400,114 +583,250 @@ void XmlStreamReader::skipCurrentElement()
 
 AsciiStringView XmlStreamReader::name() const
 {
+    if (m_pull) {
+        const PullToken& t = m_pull->current();
+        return (t.type == PullTokenType::StartElement || t.type == PullTokenType::EndElement)
+               ? toView(*t.name)
+               : AsciiStringView();
+    }
+
     return (m_xml->node && m_xml->node.type() == pugi::node_element)
            ? AsciiStringView(m_xml->node.name())
            : AsciiStringView();
 }
 
-bool XmlStreamReader::hasAttribute(const char* name) const
+bool XmlStreamReader::findAttribute(const char* name, AsciiStringView& value) const
 {
     if (m_token != TokenType::StartElement) {
         return false;
     }
 
-    if (!m_xml->node || m_xml->node.type() != pugi::node_element) {
-        return false;
-    }
-
-    return m_xml->node.attribute(name);
-}
-
-String XmlStreamReader::attribute(const char* name) const
-{
-    if (m_token != TokenType::StartElement) {
-        return String();
+    if (m_pull) {
+        const XmlPullParser::Attribute* a = findPullAttribute(m_pull->current(), name);
+        if (!a) {
+            return false;
+        }
+        value = toView(a->value);
+        return true;
     }
 
     if (!m_xml->node || m_xml->node.type() != pugi::node_element) {
-        return String();
+        return false;
     }
 
     pugi::xml_attribute attr = m_xml->node.attribute(name);
     if (!attr) {
-        return String();
+        return false;
     }
 
-    return String::fromUtf8(attr.value());
+    value = AsciiStringView(attr.value());
+    return true;
 }
 
-String XmlStreamReader::attribute(const char* name, const String& def) const
+bool XmlStreamReader::hasAttribute(const char* name) const
 {
-    return hasAttribute(name) ? attribute(name) : def;
+    AsciiStringView value;
+    return findAttribute(name, value);
 }
 
-AsciiStringView XmlStreamReader::asciiAttribute(const char* name) const
+String XmlStreamReader::attribute(const char* name) const
 {
-    if (m_token != TokenType::StartElement) {
-        return AsciiStringView();
-    }
+    return attribute(name, String());
+}
 
-    if (!m_xml->node || m_xml->node.type() != pugi::node_element) {
-        return AsciiStringView();
-    }
+String XmlStreamReader::attribute(const char* name, const String& def) const
+{
+    AsciiStringView value;
+    return findAttribute(name, value) ? String::fromUtf8(value.ascii()) : def;
+}
 
-    pugi::xml_attribute attr = m_xml->node.attribute(name);
-    return attr ? AsciiStringView(attr.value()) : AsciiStringView();
+AsciiStringView XmlStreamReader::asciiAttribute(const char* name) const
+{
+    return asciiAttribute(name, AsciiStringView());
 }
 
 AsciiStringView XmlStreamReader::asciiAttribute(const char* name, const AsciiStringView& def) const
 {
-    return hasAttribute(name) ? asciiAttribute(name) : def;
+    AsciiStringView value;
+    return findAttribute(name, value) ? value : def;
 }
 
 int XmlStreamReader::intAttribute(const char* name) const
 {
-    return asciiAttribute(name).toInt();
+    return intAttribute(name, 0);
 }
 
 int XmlStreamReader::intAttribute(const char* name, int def) const
 {
-    return hasAttribute(name) ? intAttribute(name) : def;
+    AsciiStringView value;
+    return findAttribute(name, value) ? toInt(value, nullptr, 10) : def;
 }
 
 double XmlStreamReader::doubleAttribute(const char* name) const
 {
-    return asciiAttribute(name).toDouble();
+    return doubleAttribute(name, 0.0);
 }
 
 double XmlStreamReader::doubleAttribute(const char* name, double def) const
 {
-    return hasAttribute(name) ? doubleAttribute(name) : def;
+    AsciiStringView value;
+    return findAttribute(name, value) ? toDouble(value, nullptr) : def;
 }
 
 std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
 {
     std::vector<Attribute> attrs;
+    std::vector<AttributeView> views;
+    attributeViews(views);
+
+    attrs.reserve(views.size());
+    for (const AttributeView& v : views) {
+        Attribute a;
+        a.name = v.name;
+        a.value = String::fromUtf8(v.value.ascii());
+        attrs.push_back(std::move(a));
+    }
+
+    return attrs;
+}
+
+void XmlStreamReader::attributeViews(std::vector<AttributeView>& views) const
+{
+    views.clear();
     if (m_token != TokenType::StartElement) {
-        return attrs;
+        return;
+    }
+
+    if (m_pull) {
+        const PullToken& t = m_pull->current();
+        for (size_t i = 0; i < t.attributesCount; ++i) {
+            views.push_back({ toView(*t.attributes[i].name), toView(t.attributes[i].value) });
+        }
+        return;
     }
 
     if (!m_xml->node || m_xml->node.type() != pugi::node_element) {
-        return attrs;
+        return;
     }
 
     for (pugi::xml_attribute xa = m_xml->node.first_attribute(); xa; xa = xa.next_attribute()) {
-        Attribute a;
-        a.name = xa.name();
-        a.value = String::fromUtf8(xa.value());
-        attrs.push_back(std::move(a));
+        views.push_back({ AsciiStringView(xa.name()), AsciiStringView(xa.value()) });
     }
-
-    return attrs;
 }
 
 bool XmlStreamReader::noChildren() const
 {
+    if (m_pull) {
+        const PullToken& t = m_pull->current();
+        switch (t.type) {
+        case PullTokenType::StartElement:
+            return t.selfClosing || m_pull->peek().type == PullTokenType::EndElement;
+        case PullTokenType::EndElement:
+            return !t.hasChildren;
+        case PullTokenType::None:
+        case PullTokenType::EndDocument:
+        case PullTokenType::Error:
+            return false;
+        default:
+            return true;
+        }
+    }
+
     return m_xml->node ? !m_xml->node.first_child() && !m_xml->node.last_child() : false;
 }
 
+static void writeEscaped(std::string& out, const std::string& str, bool attr)
+{
+    for (char c : str) {
+        switch (c) {
+        case '&':
+            out += "&amp;";
+            break;
+        case '<':
+            out += "&lt;";
+            break;
+        case '>':
+            out += "&gt;";
+            break;
+        case '"':
+            if (attr) {
+                out += "&quot;";
+            } else {
+                out += c;
+            }
+            break;
+        default:
+            out += c;
+        }
+    }
+}
+
 String XmlStreamReader::readBody() const
 {
+    if (m_pull) {
+        //! NOTE Looks ahead up to the end of the current element, the reader position is not changed
+        if (m_pull->current().type != PullTokenType::StartElement || m_pull->current().selfClosing) {
+            return String();
+        }
+
+        std::string out;
+        int depth = 0;
+        for (size_t i = 0;; ++i) {
+            const PullToken& t = m_pull->peek(i);
+            switch (t.type) {
+            case PullTokenType::StartElement: {
+                out += '<';
+                out += *t.name;
+                for (size_t a = 0; a < t.attributesCount; ++a) {
+                    out += ' ';
+                    out += *t.attributes[a].name;
+                    out += "=\"";
+                    writeEscaped(out, t.attributes[a].value, true);
+                    out += '"';
+                }
+
+                const PullToken& n = m_pull->peek(i + 1);
+                if (n.type == PullTokenType::EndElement) {
+                    out += "/>";
+                    ++i;
+                } else {
+                    out += '>';
+                    ++depth;
+                }
+            } break;
+            case PullTokenType::EndElement:
+                if (depth == 0) {
+                    return String::fromStdString(out);
+                }
+                out += "</";
+                out += *t.name;
+                out += '>';
+                --depth;
+                break;
+            case PullTokenType::Text:
+                // text of the element itself is not a part of the body
+                if (depth > 0) {
+                    writeEscaped(out, t.text, false);
+                }
+                break;
+            case PullTokenType::Comment:
+                if (depth > 0) {
+                    out += "<!--";
+                    out += t.text;
+                    out += "-->";
+                }
+                break;
+            case PullTokenType::Declaration:
+            case PullTokenType::Doctype:
+                break;
+            case PullTokenType::None:
+            case PullTokenType::EndDocument:
+            case PullTokenType::Error:
+                return String::fromStdString(out);
+            }
+        }
+    }
+
     if (!m_xml->node) {
         return String();
     }
@@ -528,10 +847,15 @@ String XmlStreamReader::readBody() const
 
 String XmlStreamReader::text() const
 {
+    if (m_pull) {
+        const PullTokenType t = m_pull->current().type;
+        return (t == PullTokenType::Text || t == PullTokenType::Comment) ? nodeValue() : String();
+    }
+
     if (m_xml->node) {
         pugi::xml_node_type t = m_xml->node.type();
         if (t == pugi::node_pcdata || t == pugi::node_cdata || t == pugi::node_comment) {
-            return nodeValue(m_xml);
+            return nodeValue();
         }
     }
     return String();
@@ -539,6 +863,11 @@ String XmlStreamReader::text() const
 
 AsciiStringView XmlStreamReader::asciiText() const
 {
+    if (m_pull) {
+        const PullToken& t = m_pull->current();
+        return (t.type == PullTokenType::Text || t.type == PullTokenType::Comment) ? toView(t.text) : AsciiStringView();
+    }
+
     if (m_xml->node) {
         pugi::xml_node_type t = m_xml->node.type();
         if (t == pugi::node_pcdata || t == pugi::node_cdata || t == pugi::node_comment) {
@@ -555,9 +884,10 @@ String XmlStreamReader::readText()
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = nodeValue(m_xml);
+                result = nodeValue();
                 break;
             case EndElement:
+            case Invalid: // errors in the incremental mode are reached while reading
                 return result;
             case Comment:
                 break;
@@ -578,9 +908,16 @@ AsciiStringView XmlStreamReader::readAsciiText()
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = AsciiStringView(m_xml->node.value());
+                if (m_pull) {
+                    // the token text is reused by the next tokens
+                    m_xml->pullText = m_pull->current().text;
+                    result = toView(m_xml->pullText);
+                } else {
+                    result = AsciiStringView(m_xml->node.value());
+                }
                 break;
             case EndElement:
+            case Invalid: // errors in the incremental mode are reached while reading
                 return result;
             case Comment:
                 break;
@@ -597,17 +934,21 @@ AsciiStringView XmlStreamReader::readAsciiText()
 int XmlStreamReader::readInt(bool* ok, int base)
 {
     AsciiStringView s = readAsciiText();
-    return s.toInt(ok, base);
+    return toInt(s, ok, base);
 }
 
 double XmlStreamReader::readDouble(bool* ok)
 {
     AsciiStringView s = readAsciiText();
-    return s.toDouble(ok);
+    return toDouble(s, ok);
 }
 
 int64_t XmlStreamReader::byteOffset() const
 {
+    if (m_pull) {
+        return m_pull->current().offset;
+    }
+
     if (!m_xml->node) {
         return 0;
     }
@@ -622,6 +963,13 @@ XmlStreamReader::Error XmlStreamReader::error() const
         return CustomError;
     }
 
+    if (m_pull) {
+        if (!m_pull->hasError()) {
+            return NoError;
+        }
+        return m_pull->isPrematureEnd() ? PrematureEndOfDocumentError : NotWellFormedError;
+    }
+
     if (m_xml->result.status == pugi::status_ok) {
         return NoError;
     }
@@ -639,6 +987,11 @@ String XmlStreamReader::errorString() const
     if (!m_xml->customErr.empty()) {
         return m_xml->customErr;
     }
+
+    if (m_pull) {
+        return String::fromStdString(m_pull->errorString());
+    }
+
     return String::fromUtf8(m_xml->result.description());
 }
 
@@ -34,10 +34,23 @@
 #endif
 
 namespace muse {
+class XmlPullParser;
+
 class XmlStreamReader
 {
 public:
 
+    //! NOTE ReadAll reads the whole device and parses the document upfront, like reading from data.
+    //! Incremental tokenizes the document by chunks, so it is not kept in memory, but:
+    //! - the device must stay open while reading;
+    //! - views of asciiAttribute, attributeViews and asciiText are valid until the next token;
+    //! - errors are reported when they are reached, not by the constructor;
+    //! - byteOffset is an offset in UTF-8 for UTF-16 documents, as in ReadAll mode.
+    enum class DeviceMode {
+        ReadAll = 0,
+        Incremental
+    };
+
     enum TokenType {
         NoToken = 0,
         Invalid,
@@ -65,8 +78,15 @@ public:
         String value;
     };
 
+    //! NOTE Views to the parse buffer, the values are UTF-8 with the standard entities decoded
+    struct AttributeView
+    {
+        AsciiStringView name;
+        AsciiStringView value;
+    };
+
     XmlStreamReader();
-    explicit XmlStreamReader(io::IODevice* device);
+    explicit XmlStreamReader(io::IODevice* device, DeviceMode mode = DeviceMode::ReadAll);
     explicit XmlStreamReader(const ByteArray& data);
 #ifndef NO_QT_SUPPORT
     explicit XmlStreamReader(const QByteArray& data);
@@ -104,6 +124,7 @@ public:
     double doubleAttribute(const char* name) const;
     double doubleAttribute(const char* name, double def) const;
     std::vector<Attribute> attributes() const;
+    void attributeViews(std::vector<AttributeView>& views) const;
 
     bool noChildren() const;
 
@@ -125,10 +146,14 @@ public:
 private:
     struct Xml;
 
-    void tryParseEntity(Xml* xml);
-    String nodeValue(Xml* xml) const;
+    bool findAttribute(const char* name, AsciiStringView& value) const;
+
+    void initPull();
+    void tryParseEntity(const char* value);
+    String nodeValue() const;
 
     Xml* m_xml = nullptr;
+    XmlPullParser* m_pull = nullptr;
     TokenType m_token = TokenType::NoToken;
 
     std::map<String, String> m_entities;
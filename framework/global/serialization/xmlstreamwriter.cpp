@@ -21,8 +21,18 @@
  */
 #include "xmlstreamwriter.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
+#if defined(__SSE2__) || (defined(_M_AMD64) || defined(_M_X64))
+#include <emmintrin.h>
+#define XML_ESCAPE_SSE2
+#elif defined(__arm64__) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define XML_ESCAPE_NEON
+#endif
+
 #ifdef SYSTEM_UTFCPP
 #include <utf8cpp/utf8.h>
 #else
@@ -43,9 +53,12 @@ struct XmlStreamWriter::Impl {
 
     void putLevel()
     {
-        size_t level = stack.size();
-        for (size_t i = 0; i < level * 2; ++i) {
-            stream << ' ';
+        static constexpr std::string_view SPACES = "                                                                ";
+        size_t count = stack.size() * 2;
+        while (count > 0) {
+            const size_t n = std::min(count, SPACES.size());
+            stream << SPACES.substr(0, n);
+            count -= n;
         }
     }
 };
@@ -107,18 +120,192 @@ std::string XmlStreamWriter::escapeCodePoint(const char32_t c)
     }
 }
 
+//! NOTE Characters to escape (<>&"), control characters and non-ASCII (to validate)
+static inline bool isSpecial(unsigned char c)
+{
+    return c < 0x20 || c >= 0x80 || c == '<' || c == '>' || c == '&' || c == '"';
+}
+
+static inline bool isAllowedControl(char32_t c)
+{
+    return c == 0x09 || c == 0x0A || c == 0x0D;
+}
+
+//! NOTE Returns the position of the first special character or len
+static size_t findSpecial(const char* str, size_t len)
+{
+    size_t i = 0;
+
+#if defined(XML_ESCAPE_SSE2)
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i lt = _mm_set1_epi8('<');
+    const __m128i gt = _mm_set1_epi8('>');
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i quot = _mm_set1_epi8('"');
+    for (; i + 16 <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        // signed compare: non-ASCII bytes are negative
+        __m128i m = _mm_cmplt_epi8(v, space);
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, lt));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, gt));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, amp));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, quot));
+        if (_mm_movemask_epi8(m) != 0) {
+            break;
+        }
+    }
+#elif defined(XML_ESCAPE_NEON)
+    const uint8x16_t space = vdupq_n_u8(0x20);
+    const uint8x16_t high = vdupq_n_u8(0x80);
+    const uint8x16_t lt = vdupq_n_u8('<');
+    const uint8x16_t gt = vdupq_n_u8('>');
+    const uint8x16_t amp = vdupq_n_u8('&');
+    const uint8x16_t quot = vdupq_n_u8('"');
+    for (; i + 16 <= len; i += 16) {
+        const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(str + i));
+        uint8x16_t m = vcltq_u8(v, space);
+        m = vorrq_u8(m, vcgeq_u8(v, high));
+        m = vorrq_u8(m, vceqq_u8(v, lt));
+        m = vorrq_u8(m, vceqq_u8(v, gt));
+        m = vorrq_u8(m, vceqq_u8(v, amp));
+        m = vorrq_u8(m, vceqq_u8(v, quot));
+        if (vmaxvq_u8(m) != 0) {
+            break;
+        }
+    }
+#endif
+
+    // the tail and the block with the special character
+    for (; i < len; ++i) {
+        if (isSpecial(static_cast<unsigned char>(str[i]))) {
+            return i;
+        }
+    }
+    return len;
+}
+
+//! NOTE Copies runs without special characters as is, the output is the same as escapeCodePoint for each code point
+template<typename Sink>
+static void escapeUtf8(std::string_view str, const Sink& sink)
+{
+    const char* p = str.data();
+    const char* end = p + str.size();
+    while (p < end) {
+        const size_t run = findSpecial(p, static_cast<size_t>(end - p));
+        if (run > 0) {
+            sink(p, run);
+            p += run;
+            if (p == end) {
+                break;
+            }
+        }
+
+        const unsigned char c = static_cast<unsigned char>(*p);
+        if (c >= 0x80) {
+            // validate, throws on invalid sequence
+            const char* begin = p;
+            utf8::next(p, end);
+            sink(begin, static_cast<size_t>(p - begin));
+            continue;
+        }
+
+        switch (c) {
+        case '<': sink("&lt;", 4);
+            break;
+        case '>': sink("&gt;", 4);
+            break;
+        case '&': sink("&amp;", 5);
+            break;
+        case '"': sink("&quot;", 6);
+            break;
+        default:
+            // ignore invalid characters in xml 1.0
+            if (isAllowedControl(c)) {
+                sink(p, 1);
+            }
+            break;
+        }
+        ++p;
+    }
+}
+
+//! NOTE Transcodes to UTF-8 and escapes in one pass, without a temporary UTF-8 string
+static void escapeUtf16(std::u16string_view str, TextStream& stream)
+{
+    char buf[512];
+    size_t n = 0;
+
+    auto put = [&buf, &n](const char* s, size_t len) {
+        std::memcpy(buf + n, s, len);
+        n += len;
+    };
+
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (n > sizeof(buf) - 8) {
+            stream << std::string_view(buf, n);
+            n = 0;
+        }
+
+        const char16_t c = str[i];
+        if (c < 0x80) {
+            switch (c) {
+            case u'<': put("&lt;", 4);
+                break;
+            case u'>': put("&gt;", 4);
+                break;
+            case u'&': put("&amp;", 5);
+                break;
+            case u'"': put("&quot;", 6);
+                break;
+            default:
+                if (c >= 0x20 || isAllowedControl(c)) {
+                    buf[n++] = static_cast<char>(c);
+                }
+                break;
+            }
+        } else if (c < 0x800) {
+            buf[n++] = static_cast<char>(0xC0 | (c >> 6));
+            buf[n++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0xD800 || c > 0xDFFF) {
+            buf[n++] = static_cast<char>(0xE0 | (c >> 12));
+            buf[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            buf[n++] = static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c <= 0xDBFF && i + 1 < str.size() && str[i + 1] >= 0xDC00 && str[i + 1] <= 0xDFFF) {
+            const char32_t cp = 0x10000 + ((static_cast<char32_t>(c) - 0xD800) << 10) + (str[i + 1] - 0xDC00);
+            buf[n++] = static_cast<char>(0xF0 | (cp >> 18));
+            buf[n++] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            buf[n++] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            buf[n++] = static_cast<char>(0x80 | (cp & 0x3F));
+            ++i;
+        } else {
+            // as String::toStdString, the rest of the string is dropped
+            LOGE() << "invalid utf-16";
+            break;
+        }
+    }
+
+    stream << std::string_view(buf, n);
+}
+
 std::string XmlStreamWriter::escapeString(const std::string_view str)
 {
     std::string escaped{};
-    auto it = str.begin();
-    while (it != str.end()) {
-        const char32_t c = utf8::next(it, str.end());
-        escaped += escapeCodePoint(c);
-    }
+    escaped.reserve(str.size());
+    escapeUtf8(str, [&escaped](const char* s, size_t len) {
+        escaped.append(s, len);
+    });
 
     return escaped;
 }
 
+void XmlStreamWriter::writeEscaped(std::string_view str)
+{
+    TextStream& stream = m_impl->stream;
+    escapeUtf8(str, [&stream](const char* s, size_t len) {
+        stream << std::string_view(s, len);
+    });
+}
+
 void XmlStreamWriter::writeValue(const Value& v)
 {
     // std::monostate, int, unsigned int, signed long int, unsigned long int, signed long long, unsigned long long,
@@ -140,11 +327,11 @@ void XmlStreamWriter::writeValue(const Value& v)
         break;
     case 7: m_impl->stream << std::get<double>(v);
         break;
-    case 8: m_impl->stream << escapeString(AsciiStringView(std::get<const char*>(v)));
+    case 8: writeEscaped(AsciiStringView(std::get<const char*>(v)));
         break;
-    case 9: m_impl->stream << escapeString(std::get<std::string_view>(v));
+    case 9: writeEscaped(std::get<std::string_view>(v));
         break;
-    case 10: m_impl->stream << escapeString(std::get<String>(v).toStdString());
+    case 10: escapeUtf16(std::get<String>(v).toStdU16StringView(), m_impl->stream);
         break;
     default:
         LOGI() << "index: " << v.index();
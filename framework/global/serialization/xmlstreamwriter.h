@@ -73,6 +73,7 @@ protected:
 private:
 
     void writeValue(const Value& v);
+    void writeEscaped(std::string_view str);
 
     struct Impl;
     Impl* m_impl = nullptr;
@@ -111,6 +111,61 @@ ByteArray ZipReader::fileData(const std::string& fileName) const
     return m_impl->zip->fileData(fileName);
 }
 
+struct ZipReader::FileReader::Impl
+{
+    std::unique_ptr<ZipContainer::FileReader> reader;
+};
+
+ZipReader::FileReader::FileReader(Impl* impl)
+    : m_impl(impl)
+{
+}
+
+ZipReader::FileReader::~FileReader()
+{
+    delete m_impl;
+}
+
+uint64_t ZipReader::FileReader::size() const
+{
+    return m_impl->reader->size();
+}
+
+uint64_t ZipReader::FileReader::pos() const
+{
+    return m_impl->reader->pos();
+}
+
+bool ZipReader::FileReader::atEnd() const
+{
+    return m_impl->reader->atEnd();
+}
+
+bool ZipReader::FileReader::hasError() const
+{
+    return m_impl->reader->hasError();
+}
+
+bool ZipReader::FileReader::hasCrcMismatch() const
+{
+    return m_impl->reader->hasCrcMismatch();
+}
+
+size_t ZipReader::FileReader::read(uint8_t* data, size_t len)
+{
+    return m_impl->reader->read(data, len);
+}
+
+std::unique_ptr<ZipReader::FileReader> ZipReader::fileReader(const std::string& fileName) const
+{
+    std::unique_ptr<ZipContainer::FileReader> reader = m_impl->zip->fileReader(fileName);
+    if (!reader) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<FileReader>(new FileReader(new FileReader::Impl { std::move(reader) }));
+}
+
 // ===========================
 // ZipUnpack
 // ===========================
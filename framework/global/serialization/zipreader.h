@@ -22,6 +22,7 @@
 #ifndef MUSE_GLOBAL_ZIPREADER_H
 #define MUSE_GLOBAL_ZIPREADER_H
 
+#include <memory>
 #include <vector>
 
 #include "global/types/ret.h"
@@ -56,6 +57,34 @@ public:
     bool fileExists(const std::string& fileName) const;
     ByteArray fileData(const std::string& fileName) const;
 
+    //! NOTE Reads a file of the archive by chunks, deflated data is inflated as it is read.
+    //! Must not be used after the reader is closed
+    class FileReader
+    {
+    public:
+        ~FileReader();
+
+        uint64_t size() const;
+        uint64_t pos() const;
+        bool atEnd() const;
+        bool hasError() const;
+        //! NOTE The read data doesn't match the checksum from the header (it is logged, but the data is still read)
+        bool hasCrcMismatch() const;
+
+        size_t read(uint8_t* data, size_t len);
+
+    private:
+        friend class ZipReader;
+
+        struct Impl;
+        FileReader(Impl* impl);
+
+        Impl* m_impl = nullptr;
+    };
+
+    //! NOTE Returns nullptr if there is no such file or it can't be extracted
+    std::unique_ptr<FileReader> fileReader(const std::string& fileName) const;
+
 private:
     struct Impl;
     Impl* m_impl = nullptr;
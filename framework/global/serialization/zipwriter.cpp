@@ -72,8 +72,24 @@ bool ZipWriter::hasError() const
     return m_impl->zip->status() != ZipContainer::NoError;
 }
 
+void ZipWriter::setThreadCount(size_t count)
+{
+    m_impl->zip->setThreadCount(count);
+}
+
+void ZipWriter::setMemoryLimit(size_t bytes)
+{
+    m_impl->zip->setMemoryLimit(bytes);
+}
+
 void ZipWriter::addFile(const std::string& fileName, const ByteArray& data)
 {
     m_impl->zip->addFile(fileName, data);
     flush();
 }
+
+void ZipWriter::addFile(const std::string& fileName, io::IODevice* data)
+{
+    m_impl->zip->addFile(fileName, data);
+    flush();
+}
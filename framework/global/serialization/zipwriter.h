@@ -40,7 +40,15 @@ public:
     void close();
     bool hasError() const;
 
+    //! NOTE Files are compressed by chunks on this number of threads, the output does not depend on it.
+    //! With 1 (by default) they are compressed on the calling thread
+    void setThreadCount(size_t count);
+    //! NOTE Limits the data waiting for compression and writing
+    void setMemoryLimit(size_t bytes);
+
     void addFile(const std::string& fileName, const ByteArray& data);
+    //! NOTE The data is read by chunks from the current position to the end
+    void addFile(const std::string& fileName, io::IODevice* data);
 
 private:
 
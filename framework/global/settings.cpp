@@ -31,6 +31,8 @@
 #include "multiwindows/resourcelockguard.h"
 #endif
 
+#include "internal/settingswriter.h"
+
 #include "muse_framework_config.h"
 
 #include "log.h"
@@ -58,13 +60,22 @@ Settings::Settings()
 #endif
 
     m_settings = new QSettings();
+    m_writer = std::make_unique<SettingsWriter>([this](const SettingsWriter::Values& values) {
+        writeValues(values);
+    });
 }
 
 Settings::~Settings()
 {
+    m_writer.reset();
     delete m_settings;
 }
 
+void Settings::flush()
+{
+    m_writer->flush();
+}
+
 io::path_t Settings::filePath() const
 {
     return m_settings->fileName();
@@ -80,11 +91,16 @@ const Settings::Items& Settings::items() const
  */
 void Settings::reload()
 {
+    //! NOTE Otherwise the not yet written values will be replaced by the old ones
+    m_writer->flush();
+
     Items items = readItems();
 
+    beginBatch();
     for (auto it = items.cbegin(); it != items.cend(); ++it) {
         setSharedValue(it->first, it->second.value);
     }
+    endBatch();
 }
 
 void Settings::load()
@@ -94,8 +110,10 @@ void Settings::load()
 
 void Settings::reset(bool keepDefaultSettings, bool notifyAboutChanges, bool notifyOtherInstances)
 {
+    m_writer->discard();
     m_settings->clear();
 
+    const bool wasTransactionStarted = m_isTransactionStarted;
     m_isTransactionStarted = false;
 
     std::vector<Settings::Key> locallyAddedKeys;
@@ -111,6 +129,10 @@ void Settings::reset(bool keepDefaultSettings, bool notifyAboutChanges, bool not
 
     m_localSettings.clear();
 
+    if (wasTransactionStarted) {
+        endBatch();
+    }
+
     if (!keepDefaultSettings) {
         QDir(dataPath()).removeRecursively();
         QDir().mkpath(dataPath());
@@ -120,6 +142,8 @@ void Settings::reset(bool keepDefaultSettings, bool notifyAboutChanges, bool not
         return;
     }
 
+    beginBatch();
+
     for (auto it = m_items.begin(); it != m_items.end(); ++it) {
         if (it->second.value == it->second.defaultValue) {
             continue;
@@ -127,15 +151,15 @@ void Settings::reset(bool keepDefaultSettings, bool notifyAboutChanges, bool not
 
         it->second.value = it->second.defaultValue;
 
-        Channel<Val>& channel = findChannel(it->first);
-        channel.send(it->second.value);
+        notifyChanged(it->first, it->second.value);
     }
 
     for (auto it = locallyAddedKeys.cbegin(); it != locallyAddedKeys.cend(); ++it) {
-        Channel<Val>& channel = findChannel(*it);
-        channel.send(Val());
+        notifyChanged(*it, Val());
     }
 
+    endBatch();
+
     UNUSED(notifyOtherInstances);
 #ifdef MUSE_MODULE_MULTIWINDOWS
     if (notifyOtherInstances && multiwindowsProvider()) {
@@ -223,6 +247,16 @@ void Settings::setLocalValue(const Key& key, const Val& value)
         item.value = value;
     }
 
+    notifyChanged(key, value);
+}
+
+void Settings::notifyChanged(const Key& key, const Val& value)
+{
+    if (m_batchDepth > 0) {
+        m_batchChanges[key] = value;
+        return;
+    }
+
     auto it = m_channels.find(key);
     if (it != m_channels.end()) {
         async::Channel<Val> channel = it->second;
@@ -230,13 +264,53 @@ void Settings::setLocalValue(const Key& key, const Val& value)
     }
 }
 
+void Settings::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void Settings::endBatch()
+{
+    IF_ASSERT_FAILED(m_batchDepth > 0) {
+        return;
+    }
+
+    if (--m_batchDepth > 0) {
+        return;
+    }
+
+    std::map<Key, Val> changes;
+    changes.swap(m_batchChanges);
+
+    for (auto it = changes.cbegin(); it != changes.cend(); ++it) {
+        notifyChanged(it->first, it->second);
+    }
+}
+
 void Settings::writeValue(const Key& key, const Val& value)
 {
+    // TODO: implement writing/reading first part of key (module name)
+    m_writer->setValue(key.key, value);
+}
+
+void Settings::writeValues(const std::map<std::string, Val>& values)
+{
+    //! NOTE Called on the writer thread, so a separate QSettings object is used
+    //! (QSettings objects of the same location in one process share the data).
+    //! The resource lock is held for the whole batch, so other instances don't read a half written file
 #ifdef MUSE_MODULE_MULTIWINDOWS
-    muse::mi::WriteResourceLockGuard resource_lock(multiwindowsProvider.get(), SETTINGS_RESOURCE_NAME);
+    muse::mi::WriteResourceLockGuard resource_lock(writerMultiwindowsProvider.get(), SETTINGS_RESOURCE_NAME);
 #endif
-    // TODO: implement writing/reading first part of key (module name)
-    m_settings->setValue(QString::fromStdString(key.key), value.toQVariant());
+
+    QSettings settings;
+    for (auto it = values.cbegin(); it != values.cend(); ++it) {
+        settings.setValue(QString::fromStdString(it->first), it->second.toQVariant());
+    }
+
+    settings.sync();
+    if (settings.status() != QSettings::NoError) {
+        LOGE() << "failed write settings, status: " << static_cast<int>(settings.status());
+    }
 }
 
 QString Settings::dataPath() const
@@ -303,6 +377,8 @@ void Settings::beginTransaction(bool notifyToOtherInstances)
     m_localSettings = m_items;
     m_isTransactionStarted = true;
 
+    beginBatch();
+
     UNUSED(notifyToOtherInstances)
 #ifdef MUSE_MODULE_MULTIWINDOWS
     if (notifyToOtherInstances && multiwindowsProvider()) {
@@ -313,6 +389,11 @@ void Settings::beginTransaction(bool notifyToOtherInstances)
 
 void Settings::commitTransaction(bool notifyToOtherInstances)
 {
+    if (!m_isTransactionStarted) {
+        LOGW() << "Transaction is not started";
+        return;
+    }
+
     m_isTransactionStarted = false;
 
     for (auto it = m_localSettings.begin(); it != m_localSettings.end(); ++it) {
@@ -332,6 +413,8 @@ void Settings::commitTransaction(bool notifyToOtherInstances)
 
     m_localSettings.clear();
 
+    endBatch();
+
     UNUSED(notifyToOtherInstances)
 #ifdef MUSE_MODULE_MULTIWINDOWS
     if (notifyToOtherInstances && multiwindowsProvider()) {
@@ -342,20 +425,32 @@ void Settings::commitTransaction(bool notifyToOtherInstances)
 
 void Settings::rollbackTransaction(bool notifyToOtherInstances)
 {
+    if (!m_isTransactionStarted) {
+        LOGW() << "Transaction is not started";
+        return;
+    }
+
     m_isTransactionStarted = false;
 
-    for (auto it = m_localSettings.begin(); it != m_localSettings.end(); ++it) {
-        Item item = findItem(it->first);
-        if (item.value == it->second.value) {
-            continue;
+    if (m_batchDepth == 1) {
+        //! NOTE Only the transaction changes are coalesced, nobody has seen them
+        m_batchChanges.clear();
+    } else {
+        //! NOTE Inside an outer batch, replace the coalesced values with the committed ones
+        for (auto it = m_localSettings.begin(); it != m_localSettings.end(); ++it) {
+            Item item = findItem(it->first);
+            if (item.value == it->second.value) {
+                continue;
+            }
+
+            notifyChanged(it->first, item.value);
         }
-
-        Channel<Val>& channel = findChannel(it->first);
-        channel.send(item.value);
     }
 
     m_localSettings.clear();
 
+    endBatch();
+
     UNUSED(notifyToOtherInstances)
 #ifdef MUSE_MODULE_MULTIWINDOWS
     if (notifyToOtherInstances && multiwindowsProvider()) {
@@ -378,18 +473,6 @@ Settings::Item& Settings::findItem(const Key& key) const
     return it->second;
 }
 
-async::Channel<Val>& Settings::findChannel(const Settings::Key& key) const
-{
-    auto it = m_channels.find(key);
-
-    if (it == m_channels.end()) {
-        static async::Channel<Val> null;
-        return null;
-    }
-
-    return it->second;
-}
-
 async::Channel<Val> Settings::valueChanged(const Key& key) const
 {
     return m_channels[key];
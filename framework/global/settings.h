@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "types/val.h"
@@ -42,10 +44,13 @@
 class QSettings;
 
 namespace muse {
+class SettingsWriter;
 class Settings
 {
 #ifdef MUSE_MODULE_MULTIWINDOWS
     GlobalInject<muse::mi::IMultiWindowsProvider> multiwindowsProvider;
+    //! NOTE Used on the writer thread
+    GlobalThreadSafeInject<muse::mi::IMultiWindowsProvider> writerMultiwindowsProvider;
 #endif
 public:
     static Settings* instance();
@@ -102,6 +107,17 @@ public:
     void setCanBeManuallyEdited(const Settings::Key& key, bool canBeManuallyEdited, const Val& minValue = Val(),
                                 const Val& maxValue = Val());
 
+    //! NOTE The values are written to the file in the background (coalesced, with a delay),
+    //! flush writes the not yet written values immediately (should be called on shutdown)
+    void flush();
+
+    //! NOTE Between begin and end batch, the change notifications are coalesced by key
+    //! and sent on end batch (only the last value of each key)
+    void beginBatch();
+    void endBatch();
+
+    //! NOTE The change notifications inside a transaction are coalesced by key
+    //! and sent on commit or rollback (as in a batch)
     void beginTransaction(bool notifyToOtherInstances = true);
     void commitTransaction(bool notifyToOtherInstances = true);
     void rollbackTransaction(bool notifyToOtherInstances = true);
@@ -115,12 +131,13 @@ private:
     ~Settings();
 
     Item& findItem(const Key& key) const;
-    async::Channel<Val>& findChannel(const Key& key) const;
 
     void insertNewItem(const Key& key, const Val& value);
+    void notifyChanged(const Key& key, const Val& value);
 
     Items readItems() const;
     void writeValue(const Key& key, const Val& value);
+    void writeValues(const std::map<std::string, Val>& values);
 
     QString dataPath() const;
 
@@ -129,6 +146,9 @@ private:
     mutable Items m_localSettings;
     mutable bool m_isTransactionStarted = false;
     mutable std::map<Key, async::Channel<Val> > m_channels;
+    std::unique_ptr<SettingsWriter> m_writer;
+    int m_batchDepth = 0;
+    std::map<Key, Val> m_batchChanges;
 };
 
 inline Settings* settings()
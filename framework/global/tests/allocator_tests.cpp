@@ -21,8 +21,11 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <cstdint>
+#include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "allocator.h"
@@ -78,6 +81,30 @@ DECLARE_ITEM(3)
 DECLARE_ITEM(8)
 DECLARE_ITEM(13)
 DECLARE_ITEM(131)
+
+#define DECLARE_NODE(name) \
+    class name { \
+        OBJECT_ALLOCATOR(test, name) \
+    public: \
+        name(int v) \
+            : value(v) {} \
+        int value = 0; \
+        uint8_t data[40]; \
+    };
+
+DECLARE_NODE(CrossNode)
+DECLARE_NODE(ExitNode)
+DECLARE_NODE(StatNode)
+DECLARE_NODE(BenchNode)
+
+class PlainNode
+{
+public:
+    PlainNode(int v)
+        : value(v) {}
+    int value = 0;
+    uint8_t data[40];
+};
 }
 
 class Global_AllocatorTests : public ::testing::Test
@@ -88,6 +115,12 @@ public:
     {
         ObjectAllocator::s_used++;
     }
+
+    void TearDown() override
+    {
+        ObjectAllocator::s_used--;
+        ObjectAllocator::DEFAULT_BLOCK_SIZE = 1024 * 256;
+    }
 };
 
 TEST_F(Global_AllocatorTests, Single_NewDelete)
@@ -200,3 +233,150 @@ TEST_F(Global_AllocatorTests, Many_NewCleanup)
     EXPECT_EQ(info.totalChunks, 12); // DEFAULT_BLOCK_SIZE * 3
     EXPECT_EQ(info.freeChunks, 12);
 }
+
+TEST_F(Global_AllocatorTests, CrossThread_Free)
+{
+    //! GIVEN Objects allocated on one thread and freed on another
+    const int rounds = 20;
+    const int count = 1000;
+    size_t blockCountAfterFirstRound = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+        std::vector<CrossNode*> nodes;
+        std::thread producer([&nodes]() {
+            for (int i = 0; i < count; ++i) {
+                nodes.push_back(new CrossNode(i));
+            }
+        });
+        producer.join();
+
+        std::thread consumer([&nodes]() {
+            int sum = 0;
+            for (CrossNode* n : nodes) {
+                sum += n->value;
+                delete n;
+            }
+            EXPECT_EQ(sum, count * (count - 1) / 2);
+        });
+        consumer.join();
+
+        if (r == 0) {
+            blockCountAfterFirstRound = CrossNode::allocator().stateInfo().blockCount;
+        }
+    }
+
+    //! CHECK All chunks are returned and reused (no new blocks after the first round)
+    ObjectAllocator::Info info = CrossNode::allocator().stateInfo();
+    EXPECT_EQ(info.liveCount, 0);
+    EXPECT_EQ(info.freeChunks, info.totalChunks);
+    EXPECT_EQ(info.totalAllocatedCount, rounds * count);
+    EXPECT_EQ(info.totalFreeCount, rounds * count);
+    EXPECT_EQ(info.blockCount, blockCountAfterFirstRound);
+}
+
+TEST_F(Global_AllocatorTests, ThreadExit_Reclaim)
+{
+    //! GIVEN Thread that allocates and frees, so its cache holds free chunks
+    std::thread th([]() {
+        std::vector<ExitNode*> nodes;
+        for (int i = 0; i < 10; ++i) {
+            nodes.push_back(new ExitNode(i));
+        }
+        for (ExitNode* n : nodes) {
+            delete n;
+        }
+    });
+    th.join();
+
+    //! CHECK On exit the thread cache is returned to the depot
+    ObjectAllocator::Info info = ExitNode::allocator().stateInfo();
+    EXPECT_EQ(info.blockCount, 1);
+    EXPECT_EQ(info.freeChunks, info.totalChunks);
+
+    //! DO Allocate on another thread
+    ExitNode* node = new ExitNode(1);
+
+    //! CHECK Reused the chunks and the cache of the exited thread
+    info = ExitNode::allocator().stateInfo();
+    EXPECT_EQ(info.blockCount, 1);
+    EXPECT_EQ(info.threadCaches, 1);
+    EXPECT_EQ(info.liveCount, 1);
+
+    delete node;
+}
+
+TEST_F(Global_AllocatorTests, Stats_LivePeak)
+{
+    //! GIVEN Small blocks, so the peak is updated often
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = sizeof(StatNode) * 16;
+
+    //! DO Allocate 100 objects, free 70
+    std::vector<StatNode*> nodes;
+    for (int i = 0; i < 100; ++i) {
+        nodes.push_back(new StatNode(i));
+    }
+    for (int i = 0; i < 70; ++i) {
+        delete nodes.at(i);
+    }
+
+    //! CHECK
+    ObjectAllocator::Info info = StatNode::allocator().stateInfo();
+    EXPECT_EQ(info.liveCount, 30);
+    EXPECT_GE(info.peakLiveCount, 100 - ObjectAllocator::CACHE_BATCH_SIZE);
+    EXPECT_LE(info.peakLiveCount, 100);
+    EXPECT_EQ(info.totalAllocatedCount, 100);
+    EXPECT_EQ(info.totalFreeCount, 70);
+
+    //! CHECK Queried from the register
+    bool found = false;
+    for (const ObjectAllocator::Info& i : AllocatorsRegister::instance()->stateInfos()) {
+        if (i.name == "StatNode") {
+            found = true;
+            EXPECT_EQ(i.liveCount, 30);
+        }
+    }
+    EXPECT_TRUE(found);
+
+    for (int i = 70; i < 100; ++i) {
+        delete nodes.at(i);
+    }
+}
+
+TEST_F(Global_AllocatorTests, DISABLED_Benchmark_AllocFree)
+{
+    const size_t threadsCount = 4;
+    const int rounds = 200;
+    const int count = 5000;
+
+    auto run = [&](auto create, auto destroy) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&]() {
+                std::vector<void*> nodes(count);
+                for (int r = 0; r < rounds; ++r) {
+                    for (int i = 0; i < count; ++i) {
+                        nodes[i] = create(i);
+                    }
+                    for (int i = 0; i < count; ++i) {
+                        destroy(nodes[i]);
+                    }
+                }
+            });
+        }
+        for (std::thread& th : threads) {
+            th.join();
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    auto allocatorMs = run([](int i) -> void* { return new BenchNode(i); },
+                           [](void* p) { delete static_cast<BenchNode*>(p); });
+    auto plainMs = run([](int i) -> void* { return new PlainNode(i); },
+                       [](void* p) { delete static_cast<PlainNode*>(p); });
+
+    ObjectAllocator::Info info = BenchNode::allocator().stateInfo();
+    std::cout << threadsCount * rounds * count << " alloc/free from " << threadsCount << " threads"
+              << ", allocator: " << allocatorMs << " ms, new/delete: " << plainMs << " ms"
+              << ", peak: " << info.peakLiveCount << ", blocks: " << info.blockCount << std::endl;
+}
@@ -212,3 +212,65 @@ TEST_F(Global_IO_FileTests, FileTests_Exists_Append)
         EXPECT_EQ(refba, data);
     }
 }
+
+TEST_F(Global_IO_FileTests, FileTests_Large_ReadAll_WriteBack)
+{
+    //! GIVEN Large file
+    path_t filePath("FileTests_Large.bin");
+    std::string content(1024 * 1024, 'a');
+    for (size_t i = 0; i < content.size(); i += 1000) {
+        content[i] = static_cast<char>('0' + i % 10);
+    }
+    createFile(filePath, content);
+    ByteArray ref(reinterpret_cast<const uint8_t*>(content.c_str()), content.size());
+
+    {
+        File f(filePath);
+        EXPECT_TRUE(f.open(IODevice::ReadOnly));
+
+        //! DO Read all twice
+        ByteArray data1 = f.readAll();
+        f.seek(0);
+        ByteArray data2 = f.readAll();
+
+        //! CHECK The data is shared, not copied
+        EXPECT_EQ(data1, ref);
+        EXPECT_EQ(data1.constData(), data2.constData());
+    }
+
+    {
+        //! DO Write back the read data to the same file
+        ByteArray data;
+        EXPECT_TRUE(File::readFile(filePath, data));
+        EXPECT_TRUE(File::writeFile(filePath, data));
+
+        //! CHECK
+        ByteArray written;
+        EXPECT_TRUE(File::readFile(filePath, written));
+        EXPECT_EQ(written, ref);
+    }
+
+    File::remove(filePath);
+}
+
+TEST_F(Global_IO_FileTests, FileTests_Large_ReadFile_IsCopy)
+{
+    //! GIVEN Large file
+    path_t filePath("FileTests_Large_Copy.bin");
+    std::string content(1024 * 1024, 'a');
+    createFile(filePath, content);
+
+    //! DO Read it, then rewrite the file with a shorter content
+    ByteArray data;
+    EXPECT_TRUE(File::readFile(filePath, data));
+    EXPECT_TRUE(File::writeFile(filePath, ByteArray("b")));
+
+    //! CHECK The read data is a copy, it isn't affected by the changes of the file
+    EXPECT_FALSE(data.isMapped());
+    ASSERT_EQ(data.size(), content.size());
+    EXPECT_EQ(data.at(data.size() - 1), 'a');
+    EXPECT_EQ(data.constVData().size(), content.size() + 1);
+    EXPECT_EQ(data.constChar()[data.size()], '\0');
+
+    File::remove(filePath);
+}
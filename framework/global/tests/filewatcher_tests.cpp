@@ -0,0 +1,283 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "muse_framework_config.h"
+
+#if defined(__linux__) && defined(MUSE_THREADS_SUPPORT)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "io/internal/inotifywatcher.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_IO_FileWatcherTests : public ::testing::Test
+{
+public:
+
+    void SetUp() override
+    {
+        //! NOTE /dev/shm is tmpfs
+        std::string tmpl = (access("/dev/shm", W_OK) == 0 ? "/dev/shm" : "/tmp") + std::string("/filewatcher_XXXXXX");
+        ASSERT_NE(mkdtemp(tmpl.data()), nullptr);
+        m_dir = tmpl;
+    }
+
+    void TearDown() override
+    {
+        std::string cmd = "rm -rf '" + m_dir + "'";
+        EXPECT_EQ(std::system(cmd.c_str()), 0);
+    }
+
+    struct Changes {
+        std::mutex mutex;
+        std::vector<std::string> paths;
+
+        InotifyWatcher::Callback callback()
+        {
+            return [this](const std::string& path) {
+                std::lock_guard<std::mutex> lock(mutex);
+                paths.push_back(path);
+            };
+        }
+
+        size_t count()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return paths.size();
+        }
+
+        std::vector<std::string> take()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::vector<std::string> result;
+            result.swap(paths);
+            return result;
+        }
+    };
+
+    static bool waitFor(const std::function<bool()>& cond, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!cond()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    static void sleep(int ms)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    static void writeFile(const std::string& path, const std::string& content)
+    {
+        std::ofstream f(path, std::ios::trunc);
+        f << content;
+    }
+
+    std::string m_dir;
+};
+
+TEST_F(Global_IO_FileWatcherTests, Burst_Coalesced)
+{
+    //! GIVEN Watched directory
+    Changes changes;
+    InotifyWatcher watcher(changes.callback(), std::chrono::milliseconds(100), false);
+    ASSERT_TRUE(watcher.isValid());
+    ASSERT_TRUE(watcher.addPath(m_dir));
+
+    //! DO Burst of file operations
+    for (int i = 0; i < 200; ++i) {
+        writeFile(m_dir + "/file" + std::to_string(i) + ".txt", "data");
+    }
+    for (int i = 0; i < 100; ++i) {
+        std::rename((m_dir + "/file" + std::to_string(i) + ".txt").c_str(), (m_dir + "/moved" + std::to_string(i) + ".txt").c_str());
+    }
+    for (int i = 100; i < 200; ++i) {
+        std::remove((m_dir + "/file" + std::to_string(i) + ".txt").c_str());
+    }
+
+    //! CHECK One coalesced notification
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    sleep(300);
+    std::vector<std::string> paths = changes.take();
+    ASSERT_EQ(paths.size(), 1);
+    EXPECT_EQ(paths.at(0), m_dir);
+}
+
+TEST_F(Global_IO_FileWatcherTests, File_AtomicReplace)
+{
+    //! GIVEN Watched file and other file in the same directory
+    const std::string filePath = m_dir + "/watched.cfg";
+    writeFile(filePath, "v1");
+    writeFile(m_dir + "/other.cfg", "v1");
+
+    Changes changes;
+    InotifyWatcher watcher(changes.callback(), std::chrono::milliseconds(20), false);
+    ASSERT_TRUE(watcher.addPath(filePath));
+
+    //! DO Change other file
+    writeFile(m_dir + "/other.cfg", "v2");
+    sleep(100);
+
+    //! CHECK No notifications
+    EXPECT_EQ(changes.count(), 0);
+
+    //! DO Replace the watched file (like editors do)
+    writeFile(filePath + ".tmp", "v2");
+    std::rename((filePath + ".tmp").c_str(), filePath.c_str());
+
+    //! CHECK
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    std::vector<std::string> paths = changes.take();
+    ASSERT_EQ(paths.size(), 1);
+    EXPECT_EQ(paths.at(0), filePath);
+
+    //! DO Change again (still watched after replace)
+    writeFile(filePath, "v3");
+
+    //! CHECK
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+}
+
+TEST_F(Global_IO_FileWatcherTests, Recursive)
+{
+    //! GIVEN Recursively watched directory with subdirectory
+    ASSERT_EQ(mkdir((m_dir + "/a").c_str(), 0700), 0);
+
+    Changes changes;
+    InotifyWatcher watcher(changes.callback(), std::chrono::milliseconds(20), true);
+    ASSERT_TRUE(watcher.addPath(m_dir));
+    EXPECT_EQ(watcher.watchesCount(), 2);
+
+    //! DO Change in subdirectory
+    writeFile(m_dir + "/a/file.txt", "data");
+
+    //! CHECK
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    EXPECT_EQ(changes.take().at(0), m_dir);
+
+    //! DO Create nested subdirectories
+    ASSERT_EQ(mkdir((m_dir + "/a/b").c_str(), 0700), 0);
+    ASSERT_EQ(mkdir((m_dir + "/a/b/c").c_str(), 0700), 0);
+
+    //! CHECK New subdirectories are watched
+    EXPECT_TRUE(waitFor([&watcher]() { return watcher.watchesCount() == 4; }));
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    changes.take();
+
+    //! DO Change in new subdirectory
+    writeFile(m_dir + "/a/b/c/file.txt", "data");
+
+    //! CHECK
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    EXPECT_EQ(changes.take().at(0), m_dir);
+}
+
+TEST_F(Global_IO_FileWatcherTests, Recursive_Rename)
+{
+    //! GIVEN Recursively watched directory with subdirectories
+    ASSERT_EQ(mkdir((m_dir + "/a").c_str(), 0700), 0);
+    ASSERT_EQ(mkdir((m_dir + "/a/b").c_str(), 0700), 0);
+
+    const std::string outDir = m_dir + "_out";
+    ASSERT_EQ(mkdir(outDir.c_str(), 0700), 0);
+
+    Changes changes;
+    InotifyWatcher watcher(changes.callback(), std::chrono::milliseconds(20), true);
+    ASSERT_TRUE(watcher.addPath(m_dir));
+    EXPECT_EQ(watcher.watchesCount(), 3);
+
+    //! DO Rename subdirectory inside the tree
+    ASSERT_EQ(std::rename((m_dir + "/a").c_str(), (m_dir + "/renamed").c_str()), 0);
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    changes.take();
+
+    //! CHECK The watches are kept and followed the rename
+    EXPECT_EQ(watcher.watchesCount(), 3);
+
+    //! DO Create subdirectory in renamed (checks the paths of the watches)
+    ASSERT_EQ(mkdir((m_dir + "/renamed/b/c").c_str(), 0700), 0);
+
+    //! CHECK
+    EXPECT_TRUE(waitFor([&watcher]() { return watcher.watchesCount() == 4; }));
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    changes.take();
+
+    //! DO Move subdirectory out of the tree
+    ASSERT_EQ(std::rename((m_dir + "/renamed").c_str(), (outDir + "/renamed").c_str()), 0);
+
+    //! CHECK The watches are removed, changes outside are not reported
+    EXPECT_TRUE(waitFor([&watcher]() { return watcher.watchesCount() == 1; }));
+    EXPECT_TRUE(waitFor([&changes]() { return changes.count() > 0; }));
+    sleep(100);
+    changes.take();
+
+    writeFile(outDir + "/renamed/b/file.txt", "data");
+    sleep(100);
+    EXPECT_EQ(changes.count(), 0);
+
+    std::string cmd = "rm -rf '" + outDir + "'";
+    EXPECT_EQ(std::system(cmd.c_str()), 0);
+}
+
+TEST_F(Global_IO_FileWatcherTests, RemovePath)
+{
+    //! GIVEN Watched directory
+    Changes changes;
+    InotifyWatcher watcher(changes.callback(), std::chrono::milliseconds(20), true);
+    ASSERT_TRUE(watcher.addPath(m_dir));
+    EXPECT_EQ(watcher.paths().size(), 1);
+
+    //! DO
+    watcher.removePath(m_dir);
+
+    //! CHECK
+    EXPECT_EQ(watcher.paths().size(), 0);
+    EXPECT_EQ(watcher.watchesCount(), 0);
+
+    writeFile(m_dir + "/file.txt", "data");
+    sleep(100);
+    EXPECT_EQ(changes.count(), 0);
+
+    //! CHECK Not existing path
+    EXPECT_FALSE(watcher.addPath(m_dir + "/not_existing/file.txt"));
+}
+
+#endif
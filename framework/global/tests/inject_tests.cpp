@@ -0,0 +1,318 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "modularity/ioc.h"
+
+using namespace muse;
+using namespace muse::modularity;
+
+namespace muse::tests {
+class IInjectTestService : MODULE_GLOBAL_INTERFACE
+{
+    INTERFACE_ID(IInjectTestService)
+
+public:
+    virtual ~IInjectTestService() = default;
+
+    virtual int value() const = 0;
+};
+
+class IInjectTestContextService : MODULE_CONTEXT_INTERFACE
+{
+    INTERFACE_ID(IInjectTestContextService)
+
+public:
+    virtual ~IInjectTestContextService() = default;
+
+    virtual int value() const = 0;
+};
+
+template<class I>
+class InjectTestService : public I
+{
+public:
+    explicit InjectTestService(int v)
+        : m_value(v) {}
+
+    int value() const override { return m_value; }
+
+private:
+    int m_value = 0;
+};
+
+//! NOTE The previous implementation of ThreadSafeInject (shared lock on each access), for comparison
+template<class I>
+class LockingInject : public kors::modularity::InjectBase<I>
+{
+public:
+    LockingInject()
+        : kors::modularity::InjectBase<I>(kors::modularity::globalCtx) {}
+
+    const std::shared_ptr<I>& get() const
+    {
+        {
+            std::shared_lock lock(m_mutex);
+            if (kors::modularity::InjectBase<I>::m_i) {
+                return kors::modularity::InjectBase<I>::m_i;
+            }
+        }
+
+        std::unique_lock lock(m_mutex);
+        return kors::modularity::InjectBase<I>::get();
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+};
+}
+
+using namespace muse::tests;
+
+class Global_InjectTests : public ::testing::Test
+{
+public:
+
+    void TearDown() override
+    {
+        globalIoc()->unregister<IInjectTestService>("tests");
+    }
+
+    template<class Inject>
+    static double benchmark(const Inject& inj, size_t threadsCount, size_t callsCount)
+    {
+        std::vector<std::thread> threads;
+        std::vector<int64_t> sums(threadsCount, 0);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([&inj, &sums, t, threadsCount, callsCount]() {
+                int64_t sum = 0;
+                for (size_t i = 0; i < callsCount / threadsCount; ++i) {
+                    sum += inj.get()->value();
+                }
+                sums[t] = sum;
+            });
+        }
+
+        for (std::thread& th : threads) {
+            th.join();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        int64_t total = 0;
+        for (int64_t s : sums) {
+            total += s;
+        }
+        EXPECT_EQ(total, static_cast<int64_t>(callsCount / threadsCount * threadsCount));
+
+        return static_cast<double>(elapsed.count()) / 1000.0;
+    }
+};
+
+TEST_F(Global_InjectTests, ThreadSafeInject_Resolve)
+{
+    //! GIVEN Registered service
+    globalIoc()->registerExport<IInjectTestService>("tests", std::make_shared<InjectTestService<IInjectTestService> >(1));
+
+    //! DO Resolve from several threads
+    GlobalThreadSafeInject<IInjectTestService> inj;
+    std::vector<std::thread> threads;
+    std::vector<int> values(4, 0);
+    for (size_t t = 0; t < values.size(); ++t) {
+        threads.emplace_back([&inj, &values, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                values[t] += inj.get()->value();
+            }
+        });
+    }
+
+    for (std::thread& th : threads) {
+        th.join();
+    }
+
+    //! CHECK
+    for (int v : values) {
+        EXPECT_EQ(v, 1000);
+    }
+}
+
+TEST_F(Global_InjectTests, ThreadSafeInject_Republish)
+{
+    //! GIVEN Resolved service
+    globalIoc()->registerExport<IInjectTestService>("tests", std::make_shared<InjectTestService<IInjectTestService> >(1));
+    GlobalThreadSafeInject<IInjectTestService> inj;
+    const std::shared_ptr<IInjectTestService> first = inj.get();
+    ASSERT_TRUE(first);
+    EXPECT_EQ(first->value(), 1);
+
+    //! DO Unregister
+    globalIoc()->unregister<IInjectTestService>("tests");
+
+    //! CHECK Invalidated, the returned service stays alive
+    EXPECT_FALSE(inj.get());
+    EXPECT_EQ(first->value(), 1);
+
+    //! DO Register another implementation
+    globalIoc()->registerExport<IInjectTestService>("tests", std::make_shared<InjectTestService<IInjectTestService> >(2));
+
+    //! CHECK
+    ASSERT_TRUE(inj.get());
+    EXPECT_EQ(inj.get()->value(), 2);
+
+    //! DO Set for testing
+    inj.set(std::make_shared<InjectTestService<IInjectTestService> >(3));
+
+    //! CHECK
+    EXPECT_EQ(inj.get()->value(), 3);
+}
+
+TEST_F(Global_InjectTests, ThreadSafeInject_ReleasesOld)
+{
+    //! GIVEN Resolved service, not held by anyone else
+    std::weak_ptr<IInjectTestService> firstWeak;
+    GlobalThreadSafeInject<IInjectTestService> inj;
+    {
+        auto first = std::make_shared<InjectTestService<IInjectTestService> >(1);
+        firstWeak = first;
+        inj.set(first);
+    }
+
+    {
+        std::shared_ptr<IInjectTestService> first = inj.get();
+        ASSERT_TRUE(first);
+
+        //! DO Change the service several times
+        inj.set(std::make_shared<InjectTestService<IInjectTestService> >(2));
+        inj.set(std::make_shared<InjectTestService<IInjectTestService> >(3));
+
+        //! CHECK The returned service stays alive while it's held
+        EXPECT_EQ(first->value(), 1);
+        EXPECT_FALSE(firstWeak.expired());
+        EXPECT_EQ(inj.get()->value(), 3);
+    }
+
+    //! CHECK The inject doesn't hold the old service
+    EXPECT_TRUE(firstWeak.expired());
+}
+
+TEST_F(Global_InjectTests, ThreadSafeInject_ChangeWhileReading)
+{
+    //! GIVEN Resolved service, read from several threads
+    GlobalThreadSafeInject<IInjectTestService> inj;
+    inj.set(std::make_shared<InjectTestService<IInjectTestService> >(1));
+
+    std::atomic<bool> done = false;
+    std::atomic<size_t> started = 0;
+    std::vector<std::thread> readers;
+    std::vector<int64_t> sums(4, 0);
+    std::vector<int64_t> nulls(4, 0);
+    for (size_t t = 0; t < sums.size(); ++t) {
+        readers.emplace_back([&inj, &done, &started, &sums, &nulls, t]() {
+            bool first = true;
+            while (!done.load()) {
+                std::shared_ptr<IInjectTestService> s = inj.get();
+                std::this_thread::yield();
+                if (s) {
+                    sums[t] += s->value();
+                } else {
+                    ++nulls[t];
+                }
+
+                if (first) {
+                    first = false;
+                    ++started;
+                }
+            }
+        });
+    }
+
+    while (started.load() < readers.size()) {
+        std::this_thread::yield();
+    }
+
+    //! DO Change the service many times while it's read
+    for (int i = 0; i < 1000; ++i) {
+        inj.set(std::make_shared<InjectTestService<IInjectTestService> >(1));
+        std::this_thread::yield();
+    }
+    done = true;
+
+    for (std::thread& th : readers) {
+        th.join();
+    }
+
+    //! CHECK Every read service was alive (checked by the sanitizers), and never null
+    for (size_t t = 0; t < sums.size(); ++t) {
+        EXPECT_GT(sums[t], 0);
+        EXPECT_EQ(nulls[t], 0);
+    }
+}
+
+TEST_F(Global_InjectTests, ThreadSafeInject_ContextTeardown)
+{
+    //! GIVEN Service in a context
+    ContextPtr ctx = std::make_shared<Context>(1000);
+    modularity::ioc(ctx)->registerExport<IInjectTestContextService>("tests",
+                                                         std::make_shared<InjectTestService<IInjectTestContextService> >(5));
+
+    {
+        ContextThreadSafeInject<IInjectTestContextService> inj(ctx);
+        ASSERT_TRUE(inj.get());
+        EXPECT_EQ(inj.get()->value(), 5);
+
+        //! DO Tear down the context
+        modularity::removeIoC(ctx);
+
+        //! CHECK Invalidated
+        EXPECT_FALSE(inj.get());
+
+        //! CHECK The inject is destroyed after the ioc (must not unsubscribe from the destroyed ioc)
+    }
+
+    modularity::removeIoC(ctx);
+}
+
+TEST_F(Global_InjectTests, DISABLED_ThreadSafeInject_Benchmark)
+{
+    globalIoc()->registerExport<IInjectTestService>("tests", std::make_shared<InjectTestService<IInjectTestService> >(1));
+
+    const size_t threadsCount = 8;
+    const size_t callsCount = 10000000;
+
+    LockingInject<IInjectTestService> locking;
+    GlobalThreadSafeInject<IInjectTestService> cached;
+
+    double lockingMs = benchmark(locking, threadsCount, callsCount);
+    double cachedMs = benchmark(cached, threadsCount, callsCount);
+
+    std::cout << callsCount << " calls from " << threadsCount << " threads, shared lock: " << lockingMs
+              << " ms, atomic publication: " << cachedMs << " ms" << std::endl;
+}
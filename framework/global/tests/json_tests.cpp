@@ -21,6 +21,7 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -28,11 +29,48 @@
 #include "serialization/json.h"
 #include "types/bytearray.h"
 
+#include "thirdparty/picojson/picojson.h"
+
 using namespace muse;
 
 class Global_Ser_Json : public ::testing::Test
 {
 public:
+
+    //! NOTE Like the known audio plugins registry
+    static std::string makeRegistry(size_t count)
+    {
+        std::string json = "[";
+        for (size_t i = 0; i < count; ++i) {
+            if (i > 0) {
+                json += ",";
+            }
+            const std::string n = std::to_string(i);
+            json += "{\"meta\":{\"id\":\"plugin" + n + "\",\"type\":\"VstPlugin\",\"attributes\":{\"categories\":\"Fx|Reverb\","
+                    "\"playbackSetupData\":\"Strings\"},\"hasNativeEditorSupport\":true},"
+                    "\"path\":\"/Library/Audio/Plug-Ins/VST3/Plugin " + n + ".vst3\",\"enabled\":" + (i % 3 ? "true" : "false") + ","
+                    "\"errorCode\":" + std::to_string(int(i % 5) - 2) + ",\"version\":" + std::to_string(1.25 * double(i)) + ","
+                    "\"tags\":[\"a\",\"b\\u00e9\",null,1e3,-0.5]}";
+        }
+        json += "]";
+        return json;
+    }
+
+    static std::string picojsonSerialize(const std::string& json, bool indented)
+    {
+        picojson::value v;
+        std::string err = picojson::parse(v, json);
+        EXPECT_TRUE(err.empty()) << err;
+        return v.serialize(indented);
+    }
+
+    static std::string toJson(const std::string& json, JsonDocument::Format format)
+    {
+        std::string err;
+        JsonDocument doc = JsonDocument::fromJson(ByteArray(json.c_str(), json.size()), &err);
+        EXPECT_TRUE(err.empty()) << err;
+        return doc.toJson(format).constChar();
+    }
 };
 
 TEST_F(Global_Ser_Json, WriteRead)
@@ -117,3 +155,184 @@ TEST_F(Global_Ser_Json, WriteRead)
         EXPECT_EQ(keys.at(1), "key2");
     }
 }
+
+TEST_F(Global_Ser_Json, Serialize_AsPicojson)
+{
+    //! GIVEN Document with all types, escapes, not sorted and duplicated keys
+    std::string json = "{\"z\":[1,2.5,-3,1e20,0.1,-0,[],{}],\"a\":{\"y\":null,\"x\":\"\\\"q\\\"\\\\/\\n\\t\\u0001\\u007f\\ud83c\\udfb5\"},"
+                       "\"m\":true,\"m\":false,\"e\":\"\",\"n\":[[[\"deep\"]],{\"k\":[{\"k\":1}]}]}";
+
+    //! CHECK Output is the same as picojson's
+    EXPECT_EQ(toJson(json, JsonDocument::Format::Indented), picojsonSerialize(json, true));
+    EXPECT_EQ(toJson(json, JsonDocument::Format::Compact), picojsonSerialize(json, false));
+
+    std::string registry = makeRegistry(20);
+    EXPECT_EQ(toJson(registry, JsonDocument::Format::Indented), picojsonSerialize(registry, true));
+    EXPECT_EQ(toJson(registry, JsonDocument::Format::Compact), picojsonSerialize(registry, false));
+}
+
+TEST_F(Global_Ser_Json, Serialize_LargeIntegers)
+{
+    //! GIVEN Integers out of the int range, but less than 2^53
+    std::string json = "[2147483648,-2147483649,123456789012,-9007199254740991]";
+
+    //! CHECK They are written in full (picojson writes them through int, that is undefined behavior)
+    EXPECT_EQ(toJson(json, JsonDocument::Format::Compact), json);
+
+    //! GIVEN Integers from 2^53
+    //! CHECK They are written as doubles, as picojson does
+    EXPECT_EQ(toJson("[9007199254740992]", JsonDocument::Format::Compact), picojsonSerialize("[9007199254740992]", false));
+
+    //! CHECK Values set from the API too
+    JsonArray arr;
+    arr.append(4294967296.0);
+    EXPECT_EQ(JsonDocument(arr).toJson(JsonDocument::Format::Compact), ByteArray("[4294967296]"));
+}
+
+TEST_F(Global_Ser_Json, Read_MaxDepth)
+{
+    auto nested = [](size_t depth) {
+        return std::string(depth, '[') + std::string(depth, ']');
+    };
+
+    auto isParsed = [](const std::string& json) {
+        std::string err;
+        JsonDocument doc = JsonDocument::fromJson(ByteArray(json.c_str(), json.size()), &err);
+        return err.empty() && doc.isArray();
+    };
+
+    auto isParsedByPicojson = [](const std::string& json) {
+        picojson::value v;
+        return picojson::parse(v, json).empty();
+    };
+
+    //! CHECK Up to 100 levels are parsed, deeper is an error, as in picojson
+    EXPECT_TRUE(isParsed(nested(1)));
+    EXPECT_TRUE(isParsed(nested(100)));
+    EXPECT_FALSE(isParsed(nested(101)));
+
+    for (size_t depth : { 1, 99, 100, 101, 512 }) {
+        EXPECT_EQ(isParsed(nested(depth)), isParsedByPicojson(nested(depth))) << depth;
+    }
+
+    //! CHECK Objects are counted too
+    std::string objects;
+    for (size_t i = 0; i < 100; ++i) {
+        objects += "{\"k\":";
+    }
+    objects += "1" + std::string(100, '}');
+    EXPECT_FALSE(isParsed("[" + objects + "]"));
+    EXPECT_EQ(toJson(objects, JsonDocument::Format::Compact), picojsonSerialize(objects, false));
+}
+
+TEST_F(Global_Ser_Json, Read_Values)
+{
+    //! GIVEN Document with duplicated keys and escaped strings
+    std::string json = "{\"k\":1,\"s\":\"\\u00e9\\ud83c\\udfb5\",\"k\":2,\"a\":[1,[2,3],{\"b\":4},5]}";
+
+    //! DO
+    JsonDocument doc = JsonDocument::fromJson(ByteArray(json.c_str(), json.size()));
+
+    //! CHECK The last of the same keys wins
+    JsonObject root = doc.rootObject();
+    EXPECT_EQ(root.size(), 3);
+    EXPECT_EQ(root.value("k").toInt(), 2);
+    EXPECT_EQ(root.keys(), std::vector<std::string>({ "a", "k", "s" }));
+
+    //! CHECK Strings are unescaped to UTF-8
+    EXPECT_EQ(root.value("s").toString(), String(u"\u00e9\U0001F3B5"));
+
+    //! CHECK Nested values
+    JsonArray a = root.value("a").toArray();
+    ASSERT_EQ(a.size(), 4);
+    EXPECT_EQ(a.at(1).toArray().at(1).toInt(), 3);
+    EXPECT_EQ(a.at(2).toObject().value("b").toInt(), 4);
+    EXPECT_EQ(a.at(3).toInt(), 5);
+    EXPECT_TRUE(root.value("notexists", JsonValue("def")).isString());
+}
+
+TEST_F(Global_Ser_Json, Read_Errors)
+{
+    for (const std::string& json : std::vector<std::string> { "", "{", "[1,]", "{\"a\" 1}", "\"\x01\"", "[1.2.3]", "tru", std::string(1000, '[') }) {
+        //! DO
+        std::string err;
+        JsonDocument doc = JsonDocument::fromJson(ByteArray(json.c_str(), json.size()), &err);
+
+        //! CHECK
+        EXPECT_FALSE(err.empty()) << json;
+        EXPECT_FALSE(doc.isObject());
+        EXPECT_FALSE(doc.isArray());
+    }
+}
+
+TEST_F(Global_Ser_Json, Modify_Parsed)
+{
+    //! GIVEN Parsed document
+    std::string json = "{\"o\":{\"a\":1,\"b\":[1,2,3]},\"c\":\"x\"}";
+    JsonDocument doc = JsonDocument::fromJson(ByteArray(json.c_str(), json.size()));
+    JsonObject root = doc.rootObject();
+
+    //! DO Modify copies of the nested values
+    JsonObject o = root.value("o").toObject();
+    o["a"] = 10;
+    JsonArray b = o.value("b").toArray();
+    b.append("d");
+    b[0] = false;
+    o["b"] = b;
+    root["o"] = o;
+    root["c"] = JsonValue();
+
+    //! CHECK
+    EXPECT_EQ(JsonDocument(root).toJson(JsonDocument::Format::Compact), ByteArray("{\"c\":null,\"o\":{\"a\":10,\"b\":[false,2,3,\"d\"]}}"));
+
+    //! CHECK The parsed document is not changed
+    EXPECT_EQ(doc.toJson(JsonDocument::Format::Compact), ByteArray("{\"c\":\"x\",\"o\":{\"a\":1,\"b\":[1,2,3]}}"));
+}
+
+TEST_F(Global_Ser_Json, DISABLED_Benchmark)
+{
+    const std::string json = makeRegistry(20000);
+    const ByteArray data(json.c_str(), json.size());
+    const int iterations = 10;
+
+    auto measure = [iterations](const auto& func) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            func();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / iterations;
+    };
+
+    size_t count = 0;
+    auto parseRead = measure([&]() {
+        JsonDocument doc = JsonDocument::fromJson(data);
+        JsonArray arr = doc.rootArray();
+        for (size_t i = 0; i < arr.size(); ++i) {
+            JsonObject o = arr.at(i).toObject();
+            count += o.value("meta").toObject().value("id").toStdString().size() + o.value("path").toStdString().size();
+        }
+    });
+
+    size_t picoCount = 0;
+    auto picoParseRead = measure([&]() {
+        picojson::value v;
+        picojson::parse(v, json);
+        for (const picojson::value& item : v.get<picojson::array>()) {
+            const picojson::object& o = item.get<picojson::object>();
+            picoCount += o.at("meta").get<picojson::object>().at("id").get<std::string>().size() + o.at("path").get<std::string>().size();
+        }
+    });
+
+    const JsonDocument doc = JsonDocument::fromJson(data);
+    auto serialize = measure([&]() { doc.toJson(JsonDocument::Format::Indented); });
+
+    picojson::value v;
+    picojson::parse(v, json);
+    auto picoSerialize = measure([&]() { v.serialize(true); });
+
+    EXPECT_EQ(count, picoCount);
+
+    std::cout << "size: " << json.size() / 1024 << " KB" << std::endl;
+    std::cout << "parse and read: " << parseRead << " us, picojson: " << picoParseRead << " us" << std::endl;
+    std::cout << "serialize: " << serialize << " us, picojson: " << picoSerialize << " us" << std::endl;
+}
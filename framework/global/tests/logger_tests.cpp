@@ -0,0 +1,466 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <unistd.h>
+#endif
+
+#include "logger.h"
+#include "logasync.h"
+#include "log.h"
+
+using namespace muse;
+using namespace muse::logger;
+using kors::logger::LogAsyncWriter;
+
+class Global_LoggerTests : public ::testing::Test
+{
+public:
+
+    class TestLogDest : public LogDest
+    {
+    public:
+        TestLogDest()
+            : LogDest(LogLayout("${message}")) {}
+
+        std::string name() const override { return "TestLogDest"; }
+
+        void write(const LogMsg& logMsg) override
+        {
+            if (delay.count() > 0) {
+                std::this_thread::sleep_for(delay);
+            }
+            messages.push_back(logMsg.message);
+            tags.emplace_back(logMsg.tag);
+        }
+
+        std::vector<std::string> messages;
+        std::vector<std::string> tags;
+        std::chrono::microseconds delay { 0 };
+    };
+
+    void SetUp() override
+    {
+        Logger* logger = Logger::instance();
+        m_wasAsync = logger->isAsync();
+        logger->flush();
+
+        //! NOTE Keep the destinations of the environment, but don't write to them
+        m_prevDests = logger->dests();
+        for (LogDest* d : m_prevDests) {
+            logger->removeDest(d);
+        }
+    }
+
+    void TearDown() override
+    {
+        Logger* logger = Logger::instance();
+        logger->setAsync(false);
+        for (LogDest* d : logger->dests()) {
+            logger->removeDest(d);
+            delete d;
+        }
+
+        for (LogDest* d : m_prevDests) {
+            logger->addDest(d);
+        }
+        logger->setAsync(m_wasAsync);
+    }
+
+    static void writeMessages(int thread, int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            Logger::instance()->write(LogMsg(Logger::INFO, "test", Color::None,
+                                             std::to_string(thread) + " " + std::to_string(i)));
+        }
+    }
+
+    static void writeFromThreads(int threads, int count)
+    {
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; ++t) {
+            ths.emplace_back(writeMessages, t, count);
+        }
+
+        for (std::thread& th : ths) {
+            th.join();
+        }
+    }
+
+    //! NOTE The order of the messages of each thread must be preserved
+    static void checkOrder(const std::vector<std::string>& messages, int threads)
+    {
+        std::vector<int> next(threads, 0);
+        for (const std::string& m : messages) {
+            int thread = -1;
+            int val = -1;
+            if (std::sscanf(m.c_str(), "%d %d", &thread, &val) != 2) {
+                continue;
+            }
+
+            ASSERT_TRUE(thread >= 0 && thread < threads);
+            EXPECT_GT(val, next[thread] - 1);
+            next[thread] = val + 1;
+        }
+    }
+
+private:
+    bool m_wasAsync = false;
+    std::vector<LogDest*> m_prevDests;
+};
+
+TEST_F(Global_LoggerTests, Async_WriteFromThreads)
+{
+    //! GIVEN Async logger
+    Logger* logger = Logger::instance();
+    TestLogDest* dest = new TestLogDest();
+    logger->addDest(dest);
+    logger->setAsync(true, 1024, OverflowPolicy::Block);
+
+    //! DO Write from several threads
+    writeFromThreads(4, 1000);
+    logger->flush();
+
+    //! CHECK All messages are written in order
+    EXPECT_EQ(dest->messages.size(), 4000);
+    EXPECT_EQ(logger->droppedCount(), 0);
+    checkOrder(dest->messages, 4);
+}
+
+TEST_F(Global_LoggerTests, Async_TemporaryTag)
+{
+    //! GIVEN Async logger
+    Logger* logger = Logger::instance();
+    TestLogDest* dest = new TestLogDest();
+    logger->addDest(dest);
+    logger->setAsync(true, 1024, OverflowPolicy::Block);
+
+    //! DO Write messages with tags, that are destroyed right after the call
+    for (int i = 0; i < 100; ++i) {
+        std::string tag = "temporary_tag_longer_than_small_string_" + std::to_string(i);
+        logger->write(LogMsg(Logger::INFO, tag, Color::None, std::to_string(i)));
+        tag.assign(tag.size(), 'x');
+    }
+    logger->flush();
+
+    //! CHECK The tags are written as they were
+    ASSERT_EQ(dest->tags.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(dest->tags.at(i), "temporary_tag_longer_than_small_string_" + std::to_string(i));
+    }
+}
+
+TEST_F(Global_LoggerTests, Async_Overflow_CountAndReport)
+{
+    //! GIVEN Async logger with a small queue and a slow destination
+    Logger* logger = Logger::instance();
+    TestLogDest* dest = new TestLogDest();
+    dest->delay = std::chrono::microseconds(200);
+    logger->addDest(dest);
+    logger->setAsync(true, 16, OverflowPolicy::CountAndReport);
+
+    //! DO
+    writeMessages(0, 1000);
+    logger->flush();
+
+    //! CHECK Some messages are dropped, and it is reported
+    auto isReport = [](const std::string& m) {
+        return m.find("dropped messages") != std::string::npos;
+    };
+
+    const uint64_t dropped = logger->droppedCount();
+    const size_t reports = std::count_if(dest->messages.begin(), dest->messages.end(), isReport);
+    EXPECT_GT(dropped, 0);
+    EXPECT_GT(reports, 0);
+    EXPECT_EQ(dest->messages.size() - reports + dropped, 1000);
+}
+
+TEST_F(Global_LoggerTests, Async_Overflow_Block)
+{
+    //! GIVEN Async logger with a small queue and a slow destination
+    Logger* logger = Logger::instance();
+    TestLogDest* dest = new TestLogDest();
+    dest->delay = std::chrono::microseconds(50);
+    logger->addDest(dest);
+    logger->setAsync(true, 16, OverflowPolicy::Block);
+
+    //! DO
+    writeFromThreads(2, 500);
+    logger->flush();
+
+    //! CHECK Nothing is lost
+    EXPECT_EQ(dest->messages.size(), 1000);
+    EXPECT_EQ(logger->droppedCount(), 0);
+    checkOrder(dest->messages, 2);
+}
+
+TEST_F(Global_LoggerTests, Async_Disable_WritesQueued)
+{
+    //! GIVEN Async logger with queued messages
+    Logger* logger = Logger::instance();
+    TestLogDest* dest = new TestLogDest();
+    logger->addDest(dest);
+    logger->setAsync(true);
+    writeMessages(0, 100);
+
+    //! DO Switch to sync
+    logger->setAsync(false);
+
+    //! CHECK The queued messages are written
+    EXPECT_EQ(dest->messages.size(), 100);
+
+    //! CHECK Sync write
+    writeMessages(0, 1);
+    EXPECT_EQ(dest->messages.size(), 101);
+}
+
+static std::vector<std::string> readLines(std::FILE* file)
+{
+    std::vector<std::string> lines;
+    std::rewind(file);
+    char buf[256];
+    while (std::fgets(buf, sizeof(buf), file)) {
+        std::string line(buf);
+        if (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+        }
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+TEST_F(Global_LoggerTests, Async_CrashWrite_WritesQueued)
+{
+    //! GIVEN Async writer with records pushed from two threads, the drain thread is stuck in writing
+    std::atomic<bool> writing = false;
+    std::atomic<bool> release = false;
+    std::atomic<size_t> written = 0;
+    LogAsyncWriter writer(1024, OverflowPolicy::Block, [&](const std::vector<LogMsg>& batch) {
+        writing = true;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        written += batch.size();
+    });
+    writer.start();
+
+    writer.push(LogMsg(Logger::INFO, "test", Color::None, "first"));
+    while (!writing.load()) {
+        std::this_thread::yield();
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        std::string tag = "tag" + std::to_string(i % 2);
+        auto push = [&]() { EXPECT_TRUE(writer.push(LogMsg(Logger::INFO, tag, Color::None, std::to_string(i)))); };
+        if (i % 2) {
+            std::thread(push).join();
+        } else {
+            push();
+        }
+    }
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_TRUE(file);
+
+    //! DO
+    const size_t crashWritten = writer.crashWrite(fileno(file));
+
+    //! CHECK The queued records are written in the order of the calls, without the destinations
+    EXPECT_EQ(crashWritten, 100);
+    EXPECT_EQ(written.load(), 0);
+
+    std::vector<std::string> lines = readLines(file);
+    ASSERT_EQ(lines.size(), 100);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(lines[i], "INFO | tag" + std::to_string(i % 2) + " | " + std::to_string(i));
+    }
+
+    //! CHECK After the crash write, the messages are not queued anymore (written synchronously)
+    EXPECT_FALSE(writer.push(LogMsg(Logger::INFO, "test", Color::None, "after")));
+
+    //! CHECK Only once
+    EXPECT_EQ(writer.crashWrite(fileno(file)), 0);
+
+    release = true;
+    writer.stop();
+    EXPECT_EQ(written.load(), 1);
+
+    std::fclose(file);
+}
+
+TEST_F(Global_LoggerTests, Async_CrashWrite_DoesNotWaitForWriter)
+{
+    //! GIVEN Async writer, its drain thread is stuck in writing (for example, the crashed thread holds a destination lock)
+    std::atomic<bool> writing = false;
+    std::atomic<bool> release = false;
+    LogAsyncWriter writer(1024, OverflowPolicy::Block, [&](const std::vector<LogMsg>&) {
+        writing = true;
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    writer.start();
+
+    writer.push(LogMsg(Logger::INFO, "test", Color::None, "first"));
+    while (!writing.load()) {
+        std::this_thread::yield();
+    }
+    writer.push(LogMsg(Logger::INFO, "test", Color::None, "second"));
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_TRUE(file);
+
+    //! DO
+    const size_t crashWritten = writer.crashWrite(fileno(file));
+
+    //! CHECK It doesn't wait for the drain thread, the queued record is written
+    EXPECT_EQ(crashWritten, 1);
+    EXPECT_EQ(readLines(file).size(), 1);
+
+    release = true;
+    writer.stop();
+    std::fclose(file);
+}
+
+#ifndef _WIN32
+static void prevCrashAction(int sig, siginfo_t* info, void*)
+{
+    _exit(info && info->si_signo == sig ? 3 : 4);
+}
+
+TEST_F(Global_LoggerTests, Async_FlushOnCrash_ChainsPrevAction)
+{
+    auto crash = []() {
+        //! GIVEN A crash reporter with the SA_SIGINFO handler, and the flush on crash installed after it
+        struct sigaction action = {};
+        action.sa_sigaction = prevCrashAction;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGSEGV, &action, nullptr);
+
+        Logger* logger = Logger::instance();
+        TestLogDest* dest = new TestLogDest();
+        dest->delay = std::chrono::seconds(10);
+        logger->addDest(dest);
+        logger->setAsync(true, 1024, OverflowPolicy::Block);
+        Logger::setIsFlushOnCrash(true);
+
+        //! GIVEN The drain thread is stuck in writing, the next message is queued
+        logger->write(LogMsg(Logger::INFO, "test", Color::None, "first"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        logger->write(LogMsg(Logger::INFO, "test", Color::None, "queued"));
+
+        //! DO
+        raise(SIGSEGV);
+    };
+
+    //! CHECK The queued message is written to stderr, then the previous handler is called with the siginfo
+    EXPECT_EXIT(crash(), ::testing::ExitedWithCode(3), "INFO \\| test \\| queued");
+}
+
+#endif
+
+TEST_F(Global_LoggerTests, DISABLED_Async_Benchmark)
+{
+    using clock = std::chrono::steady_clock;
+    const int threads = 16;
+    const int count = 2000;
+    const std::string filePath = "logger_benchmark.log";
+
+    for (bool async : { false, true }) {
+        std::remove(filePath.c_str());
+
+        Logger* logger = Logger::instance();
+        logger->addDest(new FileLogDest(filePath, LogLayout("${datetime} | ${type|5} | ${thread|15} | ${tag|15} | ${message}")));
+        logger->setAsync(async, 4096, OverflowPolicy::Block);
+
+        std::vector<std::vector<int64_t> > latencies(threads);
+        std::atomic<bool> start = false;
+
+        std::vector<std::thread> ths;
+        for (int t = 0; t < threads; ++t) {
+            ths.emplace_back([&, t]() {
+                std::vector<int64_t>& lat = latencies[t];
+                lat.reserve(count);
+                while (!start.load()) {
+                    std::this_thread::yield();
+                }
+
+                for (int i = 0; i < count; ++i) {
+                    clock::time_point begin = clock::now();
+                    LOGI() << "benchmark message " << t << " " << i << ", some value: " << 42.5;
+                    lat.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin).count());
+                }
+            });
+        }
+
+        clock::time_point begin = clock::now();
+        start = true;
+        for (std::thread& th : ths) {
+            th.join();
+        }
+        const int64_t callsMs = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - begin).count();
+
+        logger->flush();
+        const int64_t writtenMs = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - begin).count();
+
+        std::vector<int64_t> all;
+        for (const std::vector<int64_t>& lat : latencies) {
+            all.insert(all.end(), lat.begin(), lat.end());
+        }
+        std::sort(all.begin(), all.end());
+
+        auto percentileUs = [&all](double p) {
+            size_t idx = std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())));
+            return static_cast<double>(all.at(idx)) / 1000.0;
+        };
+
+        const int total = threads * count;
+        std::cout << (async ? "async" : "sync ")
+                  << ", threads: " << threads << ", messages: " << total
+                  << ", calls: " << callsMs << " ms (" << (callsMs > 0 ? total * 1000 / callsMs : total) << " msg/s)"
+                  << ", written: " << writtenMs << " ms"
+                  << ", call latency p50: " << percentileUs(0.5) << " us"
+                  << ", p99: " << percentileUs(0.99) << " us"
+                  << ", max: " << percentileUs(1.0) << " us" << std::endl;
+
+        logger->setAsync(false);
+        for (LogDest* d : logger->dests()) {
+            logger->removeDest(d);
+            delete d;
+        }
+    }
+
+    std::remove(filePath.c_str());
+}
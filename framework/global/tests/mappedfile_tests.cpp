@@ -0,0 +1,311 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "global/io/chunkedfilereader.h"
+#include "global/io/mappedfile.h"
+#include "global/types/bytearray.h"
+#include "global/serialization/msgpack.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_IO_MappedFileTests : public ::testing::Test
+{
+public:
+
+    static ByteArray makeData(size_t size)
+    {
+        ByteArray data(size);
+        uint8_t* d = data.data();
+        uint32_t v = 1;
+        for (size_t i = 0; i < size; ++i) {
+            v = v * 1103515245 + 12345;
+            d[i] = static_cast<uint8_t>(v >> 16);
+        }
+        return data;
+    }
+
+    static void writeFile(const std::string& path, const ByteArray& data)
+    {
+        FILE* f = std::fopen(path.c_str(), "wb");
+        ASSERT_TRUE(f);
+        std::fwrite(data.constData(), 1, data.size(), f);
+        std::fclose(f);
+    }
+
+    static uint64_t checksum(const uint8_t* data, size_t size)
+    {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    //! NOTE Private (heap) and file backed resident memory, KB
+    static std::pair<long, long> rss()
+    {
+#ifdef __linux__
+        long anon = 0;
+        long file = 0;
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind("RssAnon:", 0) == 0) {
+                anon = std::stol(line.substr(8));
+            } else if (line.rfind("RssFile:", 0) == 0) {
+                file = std::stol(line.substr(8));
+            }
+        }
+        return { anon, file };
+#else
+        return { 0, 0 };
+#endif
+    }
+};
+
+TEST_F(Global_IO_MappedFileTests, FromMappedFile_Read)
+{
+    //! GIVEN File
+    const std::string path = "MappedFileTests_Read.bin";
+    ByteArray ref = makeData(1024 * 1024 + 123);
+    writeFile(path, ref);
+
+    {
+        //! DO
+        bool ok = false;
+        ByteArray data = ByteArray::fromMappedFile(path, &ok);
+
+        //! CHECK
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(data, ref);
+
+#ifndef __EMSCRIPTEN__
+        //! CHECK Copies share the mapping
+        EXPECT_TRUE(data.isMapped());
+        ByteArray copy = data;
+        EXPECT_EQ(copy.constData(), data.constData());
+#endif
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Global_IO_MappedFileTests, FromMappedFile_Detach)
+{
+    //! GIVEN Mapped file and its copy
+    const std::string path = "MappedFileTests_Detach.bin";
+    ByteArray ref = makeData(10000);
+    writeFile(path, ref);
+
+    {
+        ByteArray data = ByteArray::fromMappedFile(path);
+        ByteArray copy = data;
+
+        //! DO Modify the copy
+        copy[0] = static_cast<uint8_t>(ref[0] + 1);
+        copy.push_back(uint8_t(42));
+
+        //! CHECK The copy is detached, the original and the file aren't changed
+        EXPECT_FALSE(copy.isMapped());
+        EXPECT_EQ(copy.size(), ref.size() + 1);
+        EXPECT_EQ(copy[0], static_cast<uint8_t>(ref[0] + 1));
+        EXPECT_EQ(copy[1], ref[1]);
+        EXPECT_EQ(data, ref);
+        EXPECT_EQ(ByteArray::fromMappedFile(path), ref);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Global_IO_MappedFileTests, FromMappedFile_Msgpack)
+{
+    //! GIVEN Mapped file
+    const std::string path = "MappedFileTests_Msgpack.bin";
+    ByteArray ref = makeData(10000);
+    writeFile(path, ref);
+
+    {
+        ByteArray data = ByteArray::fromMappedFile(path);
+        EXPECT_TRUE(data.isMapped());
+
+        //! DO Pack the mapped array (it doesn't have the vdata)
+        ByteArray packed = msgpack::pack(data);
+
+        //! CHECK It is packed as the data itself
+        ByteArray unpacked;
+        EXPECT_TRUE(msgpack::unpack(packed, unpacked));
+        EXPECT_EQ(unpacked, ref);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Global_IO_MappedFileTests, FromMappedFile_EmptyAndNotExists)
+{
+    //! GIVEN Empty file
+    const std::string path = "MappedFileTests_Empty.bin";
+    writeFile(path, ByteArray());
+
+    //! DO
+    bool ok = false;
+    ByteArray data = ByteArray::fromMappedFile(path, &ok);
+
+    //! CHECK
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(data.empty());
+
+    //! DO Not existing file
+    std::remove(path.c_str());
+    data = ByteArray::fromMappedFile(path, &ok);
+
+    //! CHECK
+    EXPECT_FALSE(ok);
+    EXPECT_TRUE(data.empty());
+}
+
+TEST_F(Global_IO_MappedFileTests, ChunkedFileReader_Read)
+{
+    //! GIVEN File bigger than a few chunks
+    const std::string path = "MappedFileTests_Chunked.bin";
+    ByteArray ref = makeData(100000);
+    writeFile(path, ref);
+
+    for (AccessHint hint : { AccessHint::Sequential, AccessHint::Normal, AccessHint::Random }) {
+        ChunkedFileReader reader(path, 4096, hint);
+        ASSERT_TRUE(reader.open());
+        EXPECT_EQ(reader.size(), ref.size());
+
+        //! DO Read by small pieces, crossing the chunks
+        ByteArray data;
+        uint8_t buf[1000];
+        while (data.size() < 50000) {
+            size_t read = reader.read(buf, sizeof(buf));
+            ASSERT_EQ(read, sizeof(buf));
+            data.push_back(buf, read);
+        }
+
+        //! DO Read the rest, bigger than a chunk
+        data.push_back(reader.read(30000));
+        data.push_back(reader.readAll());
+
+        //! CHECK
+        EXPECT_EQ(data, ref);
+        EXPECT_EQ(reader.read(buf, sizeof(buf)), 0);
+
+        //! DO Seek back
+        ASSERT_TRUE(reader.seek(4000));
+        ByteArray part = reader.read(200);
+
+        //! CHECK
+        EXPECT_EQ(part, ByteArray(ref.constData() + 4000, 200));
+
+        //! CHECK The whole data is available too
+        EXPECT_EQ(ByteArray::fromRawData(reader.readData(), reader.size()), ref);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Global_IO_MappedFileTests, ChunkedFileReader_Errors)
+{
+    const std::string path = "MappedFileTests_Chunked_Errors.bin";
+
+    //! CHECK Not existing file
+    ChunkedFileReader notExists(path);
+    EXPECT_FALSE(notExists.open());
+    EXPECT_TRUE(notExists.hasError());
+
+    //! CHECK Only reading is supported
+    writeFile(path, makeData(10));
+    ChunkedFileReader writer(path);
+    EXPECT_FALSE(writer.open(IODevice::WriteOnly));
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Global_IO_MappedFileTests, DISABLED_Benchmark)
+{
+    const std::string path = "MappedFileTests_Benchmark.bin";
+    const size_t size = 64 * 1024 * 1024;
+    writeFile(path, makeData(size));
+
+    using clock = std::chrono::steady_clock;
+    auto ms = [](clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start).count();
+    };
+
+    uint64_t refSum = 0;
+
+    {
+        //! NOTE As it was: the whole file is read to the heap, then readAll copies it
+        std::pair<long, long> before = rss();
+        auto start = clock::now();
+        ByteArray data(size);
+        FILE* f = std::fopen(path.c_str(), "rb");
+        ASSERT_TRUE(f);
+        EXPECT_EQ(std::fread(data.data(), 1, size, f), size);
+        std::fclose(f);
+        ByteArray all(data.constData(), data.size());
+        refSum = checksum(all.constData(), all.size());
+        std::pair<long, long> after = rss();
+        std::cout << "read + copy: " << ms(start) << " ms, heap: +" << (after.first - before.first) / 1024
+                  << " MB, file: +" << (after.second - before.second) / 1024 << " MB" << std::endl;
+    }
+
+    {
+        std::pair<long, long> before = rss();
+        auto start = clock::now();
+        ByteArray data = ByteArray::fromMappedFile(path);
+        ByteArray all = data;
+        EXPECT_EQ(checksum(all.constData(), all.size()), refSum);
+        std::pair<long, long> after = rss();
+        std::cout << "mapped: " << ms(start) << " ms, heap: +" << (after.first - before.first) / 1024
+                  << " MB, file: +" << (after.second - before.second) / 1024 << " MB" << std::endl;
+    }
+
+    {
+        std::pair<long, long> before = rss();
+        auto start = clock::now();
+        ChunkedFileReader reader(path);
+        ASSERT_TRUE(reader.open());
+        uint64_t sum = 0;
+        uint8_t buf[64 * 1024];
+        size_t read = 0;
+        while ((read = reader.read(buf, sizeof(buf))) > 0) {
+            sum += checksum(buf, read);
+        }
+        EXPECT_EQ(sum, refSum);
+        std::pair<long, long> after = rss();
+        std::cout << "chunked: " << ms(start) << " ms, heap: +" << (after.first - before.first) / 1024
+                  << " MB, file: +" << (after.second - before.second) / 1024 << " MB" << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
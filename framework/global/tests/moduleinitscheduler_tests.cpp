@@ -0,0 +1,233 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "modularity/moduleinitscheduler.h"
+
+using namespace muse;
+using namespace muse::modularity;
+
+class Global_ModuleInitSchedulerTests : public ::testing::Test
+{
+public:
+
+    struct Record {
+        std::string module;
+        std::thread::id thread;
+        std::chrono::steady_clock::time_point begin;
+        std::chrono::steady_clock::time_point end;
+    };
+
+    struct Journal {
+        std::mutex mutex;
+        std::vector<Record> records;
+
+        const Record* find(const std::string& module) const
+        {
+            for (const Record& r : records) {
+                if (r.module == module) {
+                    return &r;
+                }
+            }
+            return nullptr;
+        }
+
+        std::vector<std::string> order() const
+        {
+            std::vector<std::string> names;
+            for (const Record& r : records) {
+                names.push_back(r.module);
+            }
+            return names;
+        }
+    };
+
+    class SleepModule : public IModuleSetup
+    {
+    public:
+        SleepModule(Journal* journal, const std::string& name, int sleepMs, InitPolicy policy = InitPolicy::MainThread,
+                    const std::vector<std::string>& deps = {})
+            : m_journal(journal), m_name(name), m_sleepMs(sleepMs), m_policy(policy), m_deps(deps) {}
+
+        std::string moduleName() const override { return m_name; }
+        std::vector<std::string> dependencies() const override { return m_deps; }
+        InitPolicy initPolicy() const override { return m_policy; }
+
+        void onInit(const IApplication::RunMode&) override
+        {
+            Record r;
+            r.module = m_name;
+            r.thread = std::this_thread::get_id();
+            r.begin = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(m_sleepMs));
+            r.end = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(m_journal->mutex);
+            m_journal->records.push_back(r);
+        }
+
+    private:
+        Journal* m_journal = nullptr;
+        std::string m_name;
+        int m_sleepMs = 0;
+        InitPolicy m_policy = InitPolicy::MainThread;
+        std::vector<std::string> m_deps;
+    };
+
+    void TearDown() override
+    {
+        for (IModuleSetup* m : m_modules) {
+            delete m;
+        }
+        m_modules.clear();
+    }
+
+    void runOnInit(ModuleInitScheduler& scheduler)
+    {
+        scheduler.runScheduled("onInit", [](IModuleSetup* m) {
+            m->onInit(IApplication::RunMode::ConsoleApp);
+        });
+    }
+
+    std::vector<IModuleSetup*> m_modules;
+};
+
+TEST_F(Global_ModuleInitSchedulerTests, MainThread_KeepsOrder)
+{
+    //! GIVEN Modules without dependencies on the main thread
+    Journal journal;
+    m_modules = {
+        new SleepModule(&journal, "a", 1),
+        new SleepModule(&journal, "b", 0),
+        new SleepModule(&journal, "c", 1),
+    };
+
+    ModuleInitScheduler scheduler;
+    EXPECT_TRUE(scheduler.setModules(m_modules));
+
+    //! DO
+    runOnInit(scheduler);
+
+    //! CHECK Registration order and the calling thread
+    EXPECT_EQ(journal.order(), std::vector<std::string>({ "a", "b", "c" }));
+    for (const Record& r : journal.records) {
+        EXPECT_EQ(r.thread, std::this_thread::get_id());
+    }
+}
+
+TEST_F(Global_ModuleInitSchedulerTests, Dependencies_Respected)
+{
+    //! GIVEN Main module depends on a concurrent module, which depends on a later registered main module
+    using Policy = IModuleSetup::InitPolicy;
+    Journal journal;
+    m_modules = {
+        new SleepModule(&journal, "main_a", 5, Policy::MainThread, { "conc_c" }),
+        new SleepModule(&journal, "conc_c", 20, Policy::Concurrent, { "main_b" }),
+        new SleepModule(&journal, "main_b", 10, Policy::MainThread),
+        new SleepModule(&journal, "conc_d", 30, Policy::Concurrent),
+        new SleepModule(&journal, "main_e", 5, Policy::MainThread, { "conc_d", "unknown" }),
+    };
+
+    ModuleInitScheduler scheduler;
+    EXPECT_TRUE(scheduler.setModules(m_modules));
+
+    //! DO
+    runOnInit(scheduler);
+
+    //! CHECK All modules are inited
+    ASSERT_EQ(journal.records.size(), m_modules.size());
+
+    //! CHECK Each module begins after its dependencies end
+    auto after = [&journal](const std::string& module, const std::string& dep) {
+        return journal.find(module)->begin >= journal.find(dep)->end;
+    };
+
+    EXPECT_TRUE(after("conc_c", "main_b"));
+    EXPECT_TRUE(after("main_a", "conc_c"));
+    EXPECT_TRUE(after("main_e", "conc_d"));
+
+    //! CHECK Threads
+    EXPECT_EQ(journal.find("main_a")->thread, std::this_thread::get_id());
+    EXPECT_EQ(journal.find("main_b")->thread, std::this_thread::get_id());
+    EXPECT_NE(journal.find("conc_c")->thread, std::this_thread::get_id());
+    EXPECT_NE(journal.find("conc_d")->thread, std::this_thread::get_id());
+}
+
+TEST_F(Global_ModuleInitSchedulerTests, Concurrent_WallClockGain)
+{
+    //! GIVEN Independent slow modules
+    using Policy = IModuleSetup::InitPolicy;
+    Journal journal;
+    m_modules = {
+        new SleepModule(&journal, "fonts", 50, Policy::Concurrent),
+        new SleepModule(&journal, "soundfonts", 50, Policy::Concurrent),
+        new SleepModule(&journal, "languages", 50, Policy::Concurrent),
+        new SleepModule(&journal, "workspace", 50, Policy::MainThread),
+    };
+
+    ModuleInitScheduler scheduler(4);
+    scheduler.setModules(m_modules);
+
+    //! DO
+    runOnInit(scheduler);
+
+    //! CHECK The stage takes about one module time instead of the sum
+    ASSERT_EQ(scheduler.stageTimings().size(), 1);
+    const ModuleInitScheduler::StageTiming& st = scheduler.stageTimings().front();
+    EXPECT_GE(st.sumMs, 200.0);
+    EXPECT_LT(st.wallMs, 150.0);
+
+    //! CHECK The report
+    std::string report = scheduler.timingReport();
+    EXPECT_NE(report.find("stage: onInit"), std::string::npos);
+    EXPECT_NE(report.find("soundfonts"), std::string::npos);
+    EXPECT_NE(report.find("concurrent"), std::string::npos);
+}
+
+TEST_F(Global_ModuleInitSchedulerTests, Cycle_Sequential)
+{
+    //! GIVEN Modules with cyclic dependencies
+    using Policy = IModuleSetup::InitPolicy;
+    Journal journal;
+    m_modules = {
+        new SleepModule(&journal, "a", 0, Policy::Concurrent, { "c" }),
+        new SleepModule(&journal, "b", 0, Policy::MainThread, { "a" }),
+        new SleepModule(&journal, "c", 0, Policy::Concurrent, { "b" }),
+    };
+
+    ModuleInitScheduler scheduler;
+
+    //! DO
+    EXPECT_FALSE(scheduler.setModules(m_modules));
+    runOnInit(scheduler);
+
+    //! CHECK The dependencies are ignored, all modules are inited in registration order on the calling thread
+    EXPECT_EQ(journal.order(), std::vector<std::string>({ "a", "b", "c" }));
+    for (const Record& r : journal.records) {
+        EXPECT_EQ(r.thread, std::this_thread::get_id());
+    }
+}
@@ -174,3 +174,69 @@ TEST_F(Global_Ser_Msgpack, ObjectCustom)
         EXPECT_EQ(obj.str, "ha ha ha");
     }
 }
+
+TEST_F(Global_Ser_Msgpack, Views)
+{
+    //! GIVEN Packed strings and bytes (long enough to use the 16-bit lengths)
+    std::string str(300, 'a');
+    std::vector<uint8_t> bytes(70000, 0x7f);
+
+    std::vector<uint8_t> data;
+    msgpack::pack(data, str, std::string(), bytes);
+
+    //! DO Unpack as views
+    std::string_view strView;
+    std::string_view emptyView;
+    msgpack::BinView bin;
+    msgpack::Cursor cursor(data.data(), data.size());
+    bool ok = msgpack::unpack(cursor, strView, emptyView, bin);
+
+    //! CHECK The views point into the packed data
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(strView, str);
+    EXPECT_TRUE(emptyView.empty());
+    ASSERT_EQ(bin.size, bytes.size());
+    EXPECT_GE(bin.data, data.data());
+    EXPECT_LE(bin.data + bin.size, data.data() + data.size());
+    EXPECT_EQ(std::vector<uint8_t>(bin.data, bin.data + bin.size), bytes);
+}
+
+TEST_F(Global_Ser_Msgpack, Truncated)
+{
+    //! GIVEN Truncated data
+    std::vector<uint8_t> data;
+    msgpack::pack(data, std::string(100, 'a'), std::vector<int> { 1, 2, 3 });
+    data.resize(50);
+
+    //! DO
+    std::string str;
+    std::vector<int> vi;
+    msgpack::Cursor cursor(data.data(), data.size());
+    bool ok = msgpack::unpack(cursor, str, vi);
+
+    //! CHECK
+    EXPECT_FALSE(ok);
+}
+
+TEST_F(Global_Ser_Msgpack, ByteArray_Raw)
+{
+    //! GIVEN Raw byte array (not owns data)
+    const uint8_t bytes[] = { 1, 2, 3, 4, 5 };
+    ByteArray raw = ByteArray::fromRawData(bytes, sizeof(bytes));
+
+    //! DO
+    ByteArray data = msgpack::pack(raw);
+
+    ByteArray ba;
+    bool ok = msgpack::unpack(data, ba);
+
+    //! CHECK
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(ba, ByteArray(bytes, sizeof(bytes)));
+
+    //! CHECK Unpack from the raw packed data
+    ByteArray rawData = ByteArray::fromRawData(data.constData(), data.size());
+    ByteArray ba2;
+    EXPECT_TRUE(msgpack::unpack(rawData, ba2));
+    EXPECT_EQ(ba2, ba);
+}
@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "internal/settingswriter.h"
+
+using namespace muse;
+
+class Global_SettingsWriterTests : public ::testing::Test
+{
+public:
+
+    struct Written {
+        std::mutex mutex;
+        SettingsWriter::Values values;
+        size_t batches = 0;
+        size_t valuesCount = 0;
+
+        SettingsWriter::WriteFunc func()
+        {
+            return [this](const SettingsWriter::Values& batch) {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++batches;
+                valuesCount += batch.size();
+                for (const auto& p : batch) {
+                    values[p.first] = p.second;
+                }
+            };
+        }
+    };
+
+    static bool waitFor(const std::function<bool()>& cond, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000))
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!cond()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return true;
+    }
+
+    //! NOTE Like QSettings::sync - the whole file is rewritten and replaced
+    static void writeIni(const std::string& path, const SettingsWriter::Values& values)
+    {
+        const std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream f(tmpPath, std::ios::trunc);
+            f << "[General]\n";
+            for (const auto& p : values) {
+                f << p.first << "=" << p.second.toString() << "\n";
+            }
+        }
+        std::rename(tmpPath.c_str(), path.c_str());
+    }
+};
+
+TEST_F(Global_SettingsWriterTests, Coalesce)
+{
+    //! GIVEN Writer with a small delay
+    Written written;
+    SettingsWriter writer(written.func(), std::chrono::milliseconds(50), std::chrono::milliseconds(5000));
+
+    //! DO Many changes of a few keys
+    for (int i = 0; i < 1000; ++i) {
+        writer.setValue("key" + std::to_string(i % 10), Val(i));
+    }
+
+    //! CHECK Written in the background, by one batch with the last values
+    EXPECT_TRUE(waitFor([&writer]() { return writer.writesCount() > 0; }));
+
+    std::lock_guard<std::mutex> lock(written.mutex);
+    EXPECT_EQ(written.batches, 1);
+    EXPECT_EQ(written.valuesCount, 10);
+    EXPECT_EQ(written.values["key0"].toInt(), 990);
+    EXPECT_EQ(written.values["key9"].toInt(), 999);
+    EXPECT_EQ(writer.pendingCount(), 0);
+}
+
+TEST_F(Global_SettingsWriterTests, Flush)
+{
+    //! GIVEN Writer with a big delay
+    Written written;
+    SettingsWriter writer(written.func(), std::chrono::milliseconds(60000), std::chrono::milliseconds(60000));
+
+    writer.setValue("a", Val(1));
+    writer.setValue("b", Val(std::string("str")));
+    EXPECT_EQ(writer.pendingCount(), 2);
+
+    //! DO
+    writer.flush();
+
+    //! CHECK Written immediately
+    EXPECT_EQ(writer.pendingCount(), 0);
+    EXPECT_EQ(writer.writesCount(), 1);
+    EXPECT_EQ(written.values["a"].toInt(), 1);
+    EXPECT_EQ(written.values["b"].toString(), "str");
+
+    //! CHECK Nothing to flush
+    writer.flush();
+    EXPECT_EQ(writer.writesCount(), 1);
+}
+
+TEST_F(Global_SettingsWriterTests, Destroy_Flush)
+{
+    Written written;
+    {
+        //! GIVEN Writer with pending values
+        SettingsWriter writer(written.func(), std::chrono::milliseconds(60000), std::chrono::milliseconds(60000));
+        writer.setValue("a", Val(1));
+    }
+
+    //! CHECK Written on destroy
+    EXPECT_EQ(written.batches, 1);
+    EXPECT_EQ(written.values["a"].toInt(), 1);
+}
+
+TEST_F(Global_SettingsWriterTests, Discard)
+{
+    Written written;
+    {
+        //! GIVEN Writer with pending values
+        SettingsWriter writer(written.func(), std::chrono::milliseconds(60000), std::chrono::milliseconds(60000));
+        writer.setValue("a", Val(1));
+
+        //! DO
+        writer.discard();
+
+        //! CHECK
+        EXPECT_EQ(writer.pendingCount(), 0);
+    }
+
+    //! CHECK Nothing written
+    EXPECT_EQ(written.batches, 0);
+}
+
+TEST_F(Global_SettingsWriterTests, MaxDelay)
+{
+    //! GIVEN Writer with max delay
+    Written written;
+    SettingsWriter writer(written.func(), std::chrono::milliseconds(100), std::chrono::milliseconds(200));
+
+    //! DO Changes more often than the delay, longer than the max delay
+    auto start = std::chrono::steady_clock::now();
+    int i = 0;
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(700)) {
+        writer.setValue("key", Val(++i));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    //! CHECK Written during the changes
+    EXPECT_GE(writer.writesCount(), 2);
+
+    writer.flush();
+    EXPECT_EQ(written.values["key"].toInt(), i);
+}
+
+TEST_F(Global_SettingsWriterTests, DISABLED_Benchmark_SetValues)
+{
+    const int count = 10000;
+    const std::string path = "SettingsWriter_Benchmark.ini";
+
+    //! NOTE Write-through: the file is written on each change
+    {
+        SettingsWriter::Values values;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            values["key" + std::to_string(i)] = Val(i);
+            writeIni(path, values);
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << "write-through, " << count << " keys: " << elapsed.count() << " ms, file writes: " << count << std::endl;
+    }
+
+    //! NOTE Write-behind
+    {
+        SettingsWriter::Values values;
+        SettingsWriter writer([&values, &path](const SettingsWriter::Values& batch) {
+            for (const auto& p : batch) {
+                values[p.first] = p.second;
+            }
+            writeIni(path, values);
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            writer.setValue("key" + std::to_string(i), Val(i));
+        }
+        auto setElapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        writer.flush();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << "write-behind, " << count << " keys: set " << setElapsed.count() << " us, with flush " << elapsed.count()
+                  << " ms, file writes: " << writer.writesCount() << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
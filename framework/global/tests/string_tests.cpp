@@ -21,9 +21,13 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <cstring>
+#include <functional>
+#include <iostream>
 #include <regex>
 #include <string>
+#include <thread>
 
 #include <QString>
 
@@ -976,3 +980,224 @@ TEST_F(Global_Types_StringTests, String_FromUtf16LE)
         EXPECT_EQ(str, u"< xml");
     }
 }
+
+TEST_F(Global_Types_StringTests, String_ShortAndLong)
+{
+    //! NOTE Short strings are stored inline, long ones are shared, the behaviour must be the same
+    const String shortStr = u"note";
+    const String longStr = u"score-partwise-part-list";
+
+    {
+        //! GIVEN Copies of a short and a long string
+        String s1 = shortStr;
+        String s2 = longStr;
+        //! DO Modify the copies
+        s1 += u"-head";
+        s2[0] = u'S';
+        //! CHECK Originals are not changed
+        EXPECT_EQ(shortStr, u"note");
+        EXPECT_EQ(longStr, u"score-partwise-part-list");
+        EXPECT_EQ(s1, u"note-head");
+        EXPECT_EQ(s2, u"Score-partwise-part-list");
+    }
+
+    {
+        //! GIVEN Short string
+        String str = u"abc";
+        //! DO Grow it past the inline capacity, by appending itself
+        for (int i = 0; i < 4; ++i) {
+            str += str;
+        }
+        //! CHECK
+        EXPECT_EQ(str.size(), 48);
+        EXPECT_EQ(str.left(6), u"abcabc");
+        EXPECT_EQ(str.right(3), u"abc");
+
+        //! DO Shrink it back
+        str.truncate(4);
+        //! CHECK
+        EXPECT_EQ(str, u"abca");
+    }
+
+    {
+        //! GIVEN Short string
+        String str = u"0123456789";
+        //! DO Insert and remove inline
+        str.insert(2, String(u"ab"));
+        str.remove(0, 1);
+        str.prepend(u'x');
+        str.remove(u'9');
+        //! CHECK
+        EXPECT_EQ(str, u"x1ab2345678");
+
+        //! DO Insert itself
+        str.insert(1, str);
+        //! CHECK
+        EXPECT_EQ(str, u"xx1ab23456781ab2345678");
+    }
+
+    {
+        //! GIVEN Moved string
+        String s1 = longStr;
+        String s2 = std::move(s1);
+        String s3 = shortStr;
+        String s4 = std::move(s3);
+        //! CHECK Moved from strings are empty and usable
+        EXPECT_EQ(s2, longStr);
+        EXPECT_EQ(s4, shortStr);
+        EXPECT_TRUE(s1.empty());
+        EXPECT_TRUE(s3.empty());
+        s1 = u"a";
+        EXPECT_EQ(s1, u"a");
+    }
+
+    {
+        //! GIVEN Strings with the same content in different storages
+        String s1 = String::fromAscii("score-partwise");
+        String s2 = String(u"score-partwise-part").left(14);
+        String s3 = String(u"x") + s1;
+        //! CHECK
+        EXPECT_EQ(s1, s2);
+        EXPECT_EQ(s1.hash(), s2.hash());
+        EXPECT_EQ(s3.mid(1), s1);
+        EXPECT_EQ(s1.trimmed(), s1);
+        EXPECT_EQ(String(u"  score-partwise \n").trimmed(), s1);
+    }
+}
+
+TEST_F(Global_Types_StringTests, String_Interned)
+{
+    {
+        //! GIVEN Equal strings, constructed separately
+        String s1 = String::fromAscii("measure");
+        String s2 = String::fromUtf8("measure");
+        //! DO
+        String i1 = s1.interned();
+        String i2 = s2.interned();
+        //! CHECK Interned strings share the storage
+        EXPECT_EQ(i1, s1);
+        EXPECT_EQ(i1, i2);
+        EXPECT_EQ(i1.toStdU16StringView().data(), i2.toStdU16StringView().data());
+        EXPECT_NE(i1.toStdU16StringView().data(), String(u"measures").interned().toStdU16StringView().data());
+
+        //! DO Modify an interned string
+        i2 += u"s";
+        //! CHECK Others are not changed
+        EXPECT_EQ(i2, u"measures");
+        EXPECT_EQ(i1, u"measure");
+        EXPECT_EQ(String(u"measure").interned(), u"measure");
+    }
+
+    {
+        //! GIVEN Threads interning the same strings
+        const size_t threadsCount = 8;
+        std::vector<std::vector<String> > results(threadsCount);
+
+        //! DO
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadsCount; ++t) {
+            threads.emplace_back([t, &results]() {
+                for (int i = 0; i < 1000; ++i) {
+                    String s = String::number(i) + u"-interned";
+                    results[t].push_back(s.interned());
+                }
+            });
+        }
+
+        for (std::thread& th : threads) {
+            th.join();
+        }
+
+        //! CHECK Every thread got the same storage
+        for (size_t t = 1; t < threadsCount; ++t) {
+            ASSERT_EQ(results[t].size(), results[0].size());
+            for (size_t i = 0; i < results[0].size(); ++i) {
+                EXPECT_EQ(results[t][i].toStdU16StringView().data(), results[0][i].toStdU16StringView().data());
+            }
+        }
+    }
+
+    {
+        //! GIVEN A held interned string
+        String held = String(u"held-interned").interned();
+
+        //! DO Intern many strings that are not held, so the table drops the unused ones
+        for (int i = 0; i < 200000; ++i) {
+            (String::number(i) + u"-temporary").interned();
+        }
+
+        //! CHECK The held string still shares the storage with new interned copies
+        EXPECT_EQ(String(u"held-interned").interned().toStdU16StringView().data(), held.toStdU16StringView().data());
+        EXPECT_EQ(held, u"held-interned");
+    }
+}
+
+TEST_F(Global_Types_StringTests, DISABLED_String_Benchmark)
+{
+    //! NOTE Typical identifiers: tag names, action codes, setting keys
+    const std::vector<std::string> names = {
+        "note", "pitch", "step", "octave", "duration", "voice", "type", "stem", "measure", "attributes",
+        "file-open", "note-input", "pad-note-8", "toggle-mixer", "ui/theme", "application/language"
+    };
+
+    const size_t count = 2000000;
+
+    auto measure = [](const char* title, const std::function<size_t()>& func) {
+        auto start = std::chrono::steady_clock::now();
+        size_t result = func();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        std::cout << title << ": " << elapsed.count() << " ms, result: " << result << std::endl;
+    };
+
+    measure("construct", [&]() {
+        size_t result = 0;
+        for (size_t i = 0; i < count; ++i) {
+            String s = String::fromUtf8(names[i % names.size()]);
+            result += s.size();
+        }
+        return result;
+    });
+
+    std::vector<String> strings;
+    for (const std::string& n : names) {
+        strings.push_back(String::fromUtf8(n));
+    }
+
+    measure("copy", [&]() {
+        size_t result = 0;
+        for (size_t i = 0; i < count; ++i) {
+            String s = strings[i % strings.size()];
+            result += s.size();
+        }
+        return result;
+    });
+
+    //! NOTE Equal strings with different storages
+    std::vector<String> others;
+    for (const std::string& n : names) {
+        others.push_back(String::fromUtf8(n));
+    }
+
+    measure("compare", [&]() {
+        size_t result = 0;
+        for (size_t i = 0; i < count; ++i) {
+            result += strings[i % strings.size()] == others[i % others.size()] ? 1 : 0;
+        }
+        return result;
+    });
+
+    std::vector<String> interned;
+    std::vector<String> othersInterned;
+    for (size_t i = 0; i < strings.size(); ++i) {
+        interned.push_back(strings[i].interned());
+        othersInterned.push_back(others[i].interned());
+    }
+
+    measure("compare interned", [&]() {
+        size_t result = 0;
+        for (size_t i = 0; i < count; ++i) {
+            result += interned[i % interned.size()] == othersInterned[i % othersInterned.size()] ? 1 : 0;
+        }
+        return result;
+    });
+}
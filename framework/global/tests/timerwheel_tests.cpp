@@ -0,0 +1,362 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "global/timerwheel.h"
+#include "global/concurrency/threadtickerprovider.h"
+
+using namespace muse;
+
+class Global_TimerWheelTests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_TimerWheelTests, Single)
+{
+    //! GIVEN Single timer
+    TimerWheel wheel;
+    int calls = 0;
+    uint32_t id = wheel.add(5, 0, [&calls]() { ++calls; });
+    EXPECT_TRUE(wheel.contains(id));
+    EXPECT_EQ(wheel.nextExpiry(), 5);
+
+    //! DO
+    wheel.advance(4);
+
+    //! CHECK
+    EXPECT_EQ(calls, 0);
+
+    //! DO
+    wheel.advance(1);
+
+    //! CHECK Called once and removed
+    EXPECT_EQ(calls, 1);
+    EXPECT_FALSE(wheel.contains(id));
+    EXPECT_EQ(wheel.size(), 0);
+    EXPECT_EQ(wheel.nextExpiry(), TimerWheel::NO_EXPIRY);
+
+    wheel.advance(100);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(Global_TimerWheelTests, Periodic)
+{
+    //! GIVEN Periodic timer
+    TimerWheel wheel;
+    std::vector<TimerWheel::Tick> ticks;
+    wheel.add(3, 3, [&wheel, &ticks]() { ticks.push_back(wheel.now() - 1); });
+
+    //! DO
+    wheel.advance(30);
+
+    //! CHECK
+    std::vector<TimerWheel::Tick> expected = { 2, 5, 8, 11, 14, 17, 20, 23, 26, 29 };
+    EXPECT_EQ(ticks, expected);
+    EXPECT_EQ(wheel.size(), 1);
+}
+
+TEST_F(Global_TimerWheelTests, Deadlines)
+{
+    //! GIVEN Timers with deadlines on all levels (and beyond the range)
+    TimerWheel wheel;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<TimerWheel::Tick> dist(1, 300000);
+
+    std::vector<TimerWheel::Tick> delays;
+    for (int i = 0; i < 10000; ++i) {
+        delays.push_back(dist(gen));
+    }
+    delays.push_back(64);
+    delays.push_back(65);
+    delays.push_back(4096);
+    delays.push_back(4097);
+    delays.push_back((1 << 24) + 100);
+
+    //! DO Advance a bit, so that the wheel is not aligned
+    wheel.advance(37);
+
+    std::map<uint32_t, TimerWheel::Tick> expected;
+    std::map<uint32_t, TimerWheel::Tick> fired;
+    for (TimerWheel::Tick delay : delays) {
+        uint32_t* idPtr = new uint32_t(0);
+        uint32_t id = wheel.add(delay, 0, [&wheel, &fired, idPtr]() {
+            fired[*idPtr] = wheel.now() - 1;
+            delete idPtr;
+        });
+        *idPtr = id;
+        expected[id] = 37 + delay - 1;
+    }
+
+    //! DO
+    wheel.advance((1 << 24) + 200);
+
+    //! CHECK Each fired exactly on the deadline
+    EXPECT_EQ(fired, expected);
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST_F(Global_TimerWheelTests, Cancel)
+{
+    //! GIVEN Timers
+    TimerWheel wheel;
+    std::vector<int> calls(100, 0);
+    std::vector<uint32_t> ids;
+    for (int i = 0; i < 100; ++i) {
+        ids.push_back(wheel.add(i * 100 + 1, 0, [&calls, i]() { ++calls[i]; }));
+    }
+
+    //! DO Cancel the odd
+    for (int i = 1; i < 100; i += 2) {
+        EXPECT_TRUE(wheel.cancel(ids[i]));
+    }
+    EXPECT_FALSE(wheel.cancel(ids[1]));
+    EXPECT_FALSE(wheel.cancel(100000));
+
+    wheel.advance(10000);
+
+    //! CHECK
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(calls[i], i % 2 == 0 ? 1 : 0);
+    }
+}
+
+TEST_F(Global_TimerWheelTests, ChangesFromCallbacks)
+{
+    TimerWheel wheel;
+    int selfCalls = 0;
+    int otherCalls = 0;
+    int addedCalls = 0;
+
+    //! GIVEN Periodic timer that cancels itself on the third call
+    uint32_t selfId = 0;
+    selfId = wheel.add(1, 1, [&]() {
+        if (++selfCalls == 3) {
+            wheel.cancel(selfId);
+        }
+    });
+
+    //! GIVEN Timer that cancels other timer with the same deadline and adds a new one
+    uint32_t otherId = 0;
+    wheel.add(2, 0, [&]() {
+        wheel.cancel(otherId);
+        wheel.add(1, 0, [&]() { ++addedCalls; });
+    });
+    otherId = wheel.add(2, 0, [&]() { ++otherCalls; });
+
+    //! DO
+    wheel.advance(2);
+
+    //! CHECK Other is cancelled (it was added after the canceller), the new one is not called yet
+    EXPECT_EQ(addedCalls, 0);
+
+    wheel.advance(10);
+
+    //! CHECK
+    EXPECT_EQ(selfCalls, 3);
+    EXPECT_EQ(otherCalls, 0);
+    EXPECT_EQ(addedCalls, 1);
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST_F(Global_TimerWheelTests, RecursiveAdvance)
+{
+    //! GIVEN Timer that advances the wheel from the callback
+    TimerWheel wheel;
+    std::vector<int> order;
+    wheel.add(1, 0, [&]() {
+        order.push_back(1);
+        wheel.advance(2);
+        order.push_back(3);
+    });
+    wheel.add(2, 0, [&]() { order.push_back(2); });
+
+    //! DO
+    wheel.advance(1);
+
+    //! CHECK
+    EXPECT_EQ(order, std::vector<int>({ 1, 2, 3 }));
+    EXPECT_EQ(wheel.now(), 3);
+    EXPECT_EQ(wheel.size(), 0);
+}
+
+TEST_F(Global_TimerWheelTests, NextExpiry_FewWakeups)
+{
+    //! GIVEN Far timer
+    TimerWheel wheel;
+    int calls = 0;
+    wheel.add(1000, 0, [&calls]() { ++calls; });
+
+    //! DO Advance by the next expiry
+    int wakeups = 0;
+    while (calls == 0) {
+        TimerWheel::Tick next = wheel.nextExpiry();
+        ASSERT_NE(next, TimerWheel::NO_EXPIRY);
+        wheel.advance(next);
+        ++wakeups;
+    }
+
+    //! CHECK
+    EXPECT_EQ(wheel.now(), 1000);
+    EXPECT_LE(wakeups, 1000 / 64 + 2);
+}
+
+TEST_F(Global_TimerWheelTests, ThreadTickerProvider)
+{
+    //! GIVEN Ticker with 1 ms tick
+    ThreadTickerProvider ticker(std::chrono::milliseconds(1));
+    ticker.start();
+
+    std::atomic<int> repeatCalls = 0;
+    std::atomic<int> singleCalls = 0;
+    std::thread::id callThread;
+
+    //! DO
+    uint32_t repeatId = ticker.addTask({ 5, true, [&]() { ++repeatCalls; } });
+    ticker.addTask({ 20, false, [&]() {
+            ++singleCalls;
+            callThread = std::this_thread::get_id();
+        } });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ticker.removeTask(repeatId);
+    const int repeatCallsAfterRemove = repeatCalls;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    //! CHECK
+    EXPECT_GE(repeatCalls, 30);
+    EXPECT_LE(repeatCalls, 41);
+    EXPECT_EQ(repeatCalls, repeatCallsAfterRemove);
+    EXPECT_EQ(singleCalls, 1);
+    EXPECT_NE(callThread, std::this_thread::get_id());
+
+    ticker.stop();
+}
+
+TEST_F(Global_TimerWheelTests, DISABLED_Benchmark_PeriodicTasks)
+{
+    const size_t tasksCount = 100000;
+    const uint32_t tickMs = 16;
+    const auto duration = std::chrono::seconds(3);
+
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        uint32_t interval = 0;
+        Clock::time_point last;
+        double jitterSumMs = 0.0;
+        double jitterMaxMs = 0.0;
+        size_t calls = 0;
+    };
+
+    //! NOTE From 16 ms to 16 s, about 750 tasks are due on each tick
+
+    auto makeStates = [&]() {
+        std::vector<State> states(tasksCount);
+        for (size_t i = 0; i < tasksCount; ++i) {
+            states[i].interval = 1 + static_cast<uint32_t>(i % 1000);
+        }
+        return states;
+    };
+
+    auto onCall = [tickMs](State& s) {
+        Clock::time_point now = Clock::now();
+        if (s.calls > 0) {
+            double elapsedMs = std::chrono::duration<double, std::milli>(now - s.last).count();
+            double jitterMs = std::abs(elapsedMs - s.interval * tickMs);
+            s.jitterSumMs += jitterMs;
+            s.jitterMaxMs = std::max(s.jitterMaxMs, jitterMs);
+        }
+        s.last = now;
+        ++s.calls;
+    };
+
+    auto report = [](const std::string& name, const std::vector<State>& states, double cpuMs, double wallMs, size_t wakeups) {
+        double sum = 0.0;
+        double max = 0.0;
+        size_t calls = 0;
+        size_t samples = 0;
+        for (const State& s : states) {
+            sum += s.jitterSumMs;
+            max = std::max(max, s.jitterMaxMs);
+            calls += s.calls;
+            samples += s.calls > 0 ? s.calls - 1 : 0;
+        }
+        std::cout << name << ": calls: " << calls << ", wakeups: " << wakeups
+                  << ", cpu: " << cpuMs << " ms (" << (100.0 * cpuMs / wallMs) << "%)"
+                  << ", jitter mean: " << (sum / samples) << " ms, max: " << max << " ms" << std::endl;
+    };
+
+    //! NOTE The previous implementation: walks all tasks on each tick
+    {
+        std::vector<State> states = makeStates();
+        std::map<uint32_t, std::function<void()> > tasks;
+        for (size_t i = 0; i < tasksCount; ++i) {
+            tasks[static_cast<uint32_t>(i + 1)] = [&states, &onCall, i]() { onCall(states[i]); };
+        }
+
+        const std::clock_t cpuStart = std::clock();
+        const Clock::time_point start = Clock::now();
+        size_t ticks = 0;
+        while (Clock::now() - start < duration) {
+            for (auto& p : tasks) {
+                const uint32_t interval = states[p.first - 1].interval;
+                if (ticks % interval == 0) {
+                    p.second();
+                }
+            }
+            ++ticks;
+            std::this_thread::sleep_for(std::chrono::milliseconds(tickMs));
+        }
+        const double cpuMs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("walk all", states, cpuMs, wallMs, ticks);
+    }
+
+    //! NOTE Timer wheel
+    {
+        std::vector<State> states = makeStates();
+        ThreadTickerProvider ticker { std::chrono::milliseconds(tickMs) };
+        for (size_t i = 0; i < tasksCount; ++i) {
+            ticker.addTask({ states[i].interval, true, [&states, &onCall, i]() { onCall(states[i]); } });
+        }
+
+        const std::clock_t cpuStart = std::clock();
+        const Clock::time_point start = Clock::now();
+        ticker.start();
+        std::this_thread::sleep_for(duration);
+        ticker.stop();
+        const double cpuMs = 1000.0 * (std::clock() - cpuStart) / CLOCKS_PER_SEC;
+        const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        report("timer wheel", states, cpuMs, wallMs, ticker.wakeupsCount());
+    }
+}
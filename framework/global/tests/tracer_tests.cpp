@@ -0,0 +1,263 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+
+#include "thirdparty/picojson/picojson.h"
+
+using namespace muse;
+using namespace muse::profiler;
+
+class Global_TracerTests : public ::testing::Test
+{
+public:
+
+    void TearDown() override
+    {
+        Tracer::instance()->stop();
+        Tracer::instance()->clear();
+    }
+
+    static size_t eventsCount(const std::vector<Tracer::ThreadEvents>& threads)
+    {
+        size_t count = 0;
+        for (const Tracer::ThreadEvents& th : threads) {
+            count += th.events.size();
+        }
+        return count;
+    }
+
+    static const Tracer::ThreadEvents* findThread(const std::vector<Tracer::ThreadEvents>& threads, const std::string& name)
+    {
+        for (const Tracer::ThreadEvents& th : threads) {
+            if (th.name == name) {
+                return &th;
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(Global_TracerTests, Disabled_NoEvents)
+{
+    //! GIVEN Tracer is stopped
+    Tracer::instance()->stop();
+    Tracer::instance()->clear();
+
+    //! DO
+    for (int i = 0; i < 100; ++i) {
+        TRACE_ZONE("zone");
+        TRACE_INSTANT("instant");
+        TRACE_COUNTER("counter", i);
+    }
+
+    //! CHECK
+    EXPECT_FALSE(Tracer::isEnabled());
+    EXPECT_EQ(eventsCount(Tracer::instance()->snapshot()), 0);
+}
+
+TEST_F(Global_TracerTests, Export_ChromeTrace)
+{
+    //! GIVEN Tracer is started
+    Tracer* tracer = Tracer::instance();
+    tracer->start();
+
+    //! DO
+    std::thread th([]() {
+        Tracer::instance()->setThreadName("tracer_worker");
+        TRACE_ZONE("worker \"quoted\"");
+        TRACE_FLOW_END("msg", 42);
+    });
+
+    {
+        TRACE_ZONE("outer");
+        TRACE_FLOW_BEGIN("msg", 42);
+        {
+            TRACE_FUNC_ZONE;
+            TRACE_INSTANT("instant");
+            TRACE_COUNTER("counter", 7);
+        }
+        th.join();
+    }
+
+    tracer->stop();
+    std::string json = tracer->exportChromeTrace();
+
+    //! CHECK The JSON is valid
+    picojson::value root;
+    std::string err = picojson::parse(root, json);
+    ASSERT_TRUE(err.empty()) << err;
+    ASSERT_TRUE(root.get("traceEvents").is<picojson::array>());
+
+    //! CHECK The events
+    std::map<std::string, int> phases;
+    std::map<std::string, int> names;
+    bool hasWorkerName = false;
+    for (const picojson::value& e : root.get("traceEvents").get<picojson::array>()) {
+        const std::string ph = e.get("ph").get<std::string>();
+        phases[ph]++;
+        names[e.get("name").get<std::string>()]++;
+        if (ph == "M" && e.get("args").get("name").get<std::string>() == "tracer_worker") {
+            hasWorkerName = true;
+        }
+        if (ph == "C") {
+            EXPECT_EQ(e.get("args").get("value").get<double>(), 7.0);
+        }
+        if (ph == "s" || ph == "f") {
+            EXPECT_EQ(e.get("id").get<double>(), 42.0);
+        }
+    }
+
+    EXPECT_TRUE(hasWorkerName);
+    EXPECT_EQ(phases["B"], 3);
+    EXPECT_EQ(phases["E"], 3);
+    EXPECT_EQ(phases["i"], 1);
+    EXPECT_EQ(phases["C"], 1);
+    EXPECT_EQ(phases["s"], 1);
+    EXPECT_EQ(phases["f"], 1);
+    EXPECT_EQ(names["worker \"quoted\""], 2);
+    EXPECT_EQ(names["Global_TracerTests_Export_ChromeTrace_Test::TestBody"], 2);
+}
+
+TEST_F(Global_TracerTests, MultiThread_LiveSnapshot)
+{
+    //! GIVEN Tracer is started
+    Tracer* tracer = Tracer::instance();
+    tracer->start();
+
+    //! DO Write from several threads and export at the same time
+    const int threadsCount = 4;
+    const int zonesCount = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([t]() {
+            Tracer::instance()->setThreadName("tracer_mt_" + std::to_string(t));
+            for (int i = 0; i < zonesCount; ++i) {
+                TRACE_ZONE("zone");
+            }
+        });
+    }
+
+    for (int i = 0; i < 5; ++i) {
+        std::string json = tracer->exportChromeTrace();
+        picojson::value root;
+        EXPECT_TRUE(picojson::parse(root, json).empty());
+    }
+
+    for (std::thread& th : threads) {
+        th.join();
+    }
+
+    //! CHECK All events are in order
+    std::vector<Tracer::ThreadEvents> snapshot = tracer->snapshot();
+    for (int t = 0; t < threadsCount; ++t) {
+        const Tracer::ThreadEvents* th = findThread(snapshot, "tracer_mt_" + std::to_string(t));
+        ASSERT_TRUE(th);
+        ASSERT_EQ(th->events.size(), zonesCount * 2);
+        EXPECT_EQ(th->lost, 0);
+        for (size_t i = 0; i < th->events.size(); ++i) {
+            EXPECT_EQ(th->events[i].phase, i % 2 == 0 ? Tracer::Phase::Begin : Tracer::Phase::End);
+            if (i > 0) {
+                EXPECT_GE(th->events[i].timeNs, th->events[i - 1].timeNs);
+            }
+        }
+    }
+}
+
+TEST_F(Global_TracerTests, Ring_Overwrite)
+{
+    //! GIVEN Small rings (applied to new threads)
+    Tracer* tracer = Tracer::instance();
+    Tracer::Options defaultOpt = tracer->options();
+    Tracer::Options opt;
+    opt.eventsPerThread = 1000;
+    tracer->setup(opt);
+    tracer->start();
+
+    //! DO Write more than the capacity, the first event is an end
+    std::thread th([]() {
+        Tracer::instance()->setThreadName("tracer_ring");
+        TRACE_ZONE("outer");
+        for (int i = 0; i < 5000; ++i) {
+            TRACE_ZONE("zone");
+        }
+    });
+    th.join();
+
+    tracer->stop();
+    tracer->setup(defaultOpt);
+
+    //! CHECK Only the last events are kept
+    std::vector<Tracer::ThreadEvents> snapshot = tracer->snapshot();
+    const Tracer::ThreadEvents* ring = findThread(snapshot, "tracer_ring");
+    ASSERT_TRUE(ring);
+    EXPECT_GE(ring->events.size(), 1000);
+    EXPECT_LE(ring->events.size(), 1024);
+    EXPECT_EQ(ring->events.size() + ring->lost, 10002);
+
+    //! CHECK Ends without begins are skipped on export
+    picojson::value root;
+    ASSERT_TRUE(picojson::parse(root, tracer->exportChromeTrace()).empty());
+    int depth = 0;
+    for (const picojson::value& e : root.get("traceEvents").get<picojson::array>()) {
+        const std::string ph = e.get("ph").get<std::string>();
+        if (ph == "B") {
+            ++depth;
+        } else if (ph == "E") {
+            --depth;
+        }
+        EXPECT_GE(depth, 0);
+    }
+    EXPECT_EQ(depth, 0);
+}
+
+TEST_F(Global_TracerTests, DISABLED_Benchmark_Zone)
+{
+    Tracer* tracer = Tracer::instance();
+    const int count = 10000000;
+
+    auto measure = [count]() {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; ++i) {
+            TRACE_ZONE("zone");
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        return static_cast<double>(elapsed.count()) / count;
+    };
+
+    tracer->stop();
+    double disabledNs = measure();
+
+    tracer->start();
+    double enabledNs = measure();
+    tracer->stop();
+
+    std::cout << "zone disabled: " << disabledNs << " ns, enabled: " << enabledNs << " ns" << std::endl;
+}
@@ -0,0 +1,251 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#ifdef SYSTEM_UTFCPP
+#include <utf8cpp/utf8.h>
+#else
+#include "global/thirdparty/utfcpp/utf8.h"
+#endif
+
+#include "types/string.h"
+#include "types/internal/utf.h"
+
+using namespace muse;
+
+class Global_Types_UtfTests : public ::testing::Test
+{
+public:
+
+    //! NOTE utfcpp conversion, the result is truncated at the first error
+    template<typename Dst, typename Src, typename Func>
+    static Dst reference(const Src& src, Func func)
+    {
+        Dst dst;
+        try {
+            func(src.begin(), src.end(), std::back_inserter(dst));
+        } catch (const std::exception&) {
+        }
+        return dst;
+    }
+
+    //! NOTE Mostly valid text with random damages
+    static std::string randomUtf8(std::mt19937& rnd, size_t len)
+    {
+        static const std::vector<std::string> pieces = {
+            "a", "Hello, world ", "0123456789abcdef", "<tag/>", "\xC3\xA9", "\xC3\xBC", "\xD0\x96", "\xE2\x82\xAC", "\xE4\xB8\xAD",
+            "\xE6\x96\x87", "\xF0\x9F\x8E\xB5", "\xF0\x9F\x98\x80",
+        };
+
+        std::string str;
+        while (str.size() < len) {
+            str += pieces[rnd() % pieces.size()];
+        }
+
+        // damages: random bytes, truncated sequences, overlongs, surrogates, out of range
+        static const std::vector<std::string> damages = {
+            "\x80", "\xBF", "\xC0\xAF", "\xC1\xBF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", "\xC3",
+            "\xE2\x82", "\xF0\x9F\x8E",
+        };
+
+        if (rnd() % 2) {
+            size_t pos = rnd() % (str.size() + 1);
+            if (str.empty() || rnd() % 2) {
+                str.insert(pos, damages[rnd() % damages.size()]);
+            } else {
+                str[pos % str.size()] = static_cast<char>(rnd() % 256);
+            }
+        }
+        return str;
+    }
+
+    static std::u16string randomUtf16(std::mt19937& rnd, size_t len)
+    {
+        std::u16string str;
+        for (size_t i = 0; i < len; ++i) {
+            switch (rnd() % 6) {
+            case 0:
+            case 1:
+            case 2: str += static_cast<char16_t>(0x20 + rnd() % 0x5F);
+                break;
+            case 3: str += static_cast<char16_t>(0x80 + rnd() % 0x780);
+                break;
+            case 4: str += static_cast<char16_t>(0x4E00 + rnd() % 0x5000);
+                break;
+            case 5: str += u"\U0001F3B5";
+                break;
+            }
+        }
+
+        if (rnd() % 2) {
+            // lone surrogates
+            str.insert(rnd() % (str.size() + 1), 1, static_cast<char16_t>(0xD800 + rnd() % 0x800));
+        }
+        return str;
+    }
+
+    static std::string corpus(const char* piece, size_t size)
+    {
+        std::string str;
+        while (str.size() < size) {
+            str += piece;
+        }
+        return str;
+    }
+};
+
+TEST_F(Global_Types_UtfTests, Utf8to16_SameAsUtfcpp)
+{
+    std::mt19937 rnd(42);
+    for (int i = 0; i < 20000; ++i) {
+        //! GIVEN
+        const std::string src = randomUtf8(rnd, rnd() % 100);
+
+        //! DO
+        std::u16string dst;
+        UtfCodec::utf8to16(src, dst);
+
+        //! CHECK
+        std::u16string expected = reference<std::u16string>(src, [](auto b, auto e, auto out) { utf8::utf8to16(b, e, out); });
+        ASSERT_EQ(dst, expected) << src;
+        EXPECT_EQ(UtfCodec::isValidUtf8(src), utf8::is_valid(src.begin(), src.end())) << src;
+    }
+}
+
+TEST_F(Global_Types_UtfTests, Utf16to8_SameAsUtfcpp)
+{
+    std::mt19937 rnd(43);
+    for (int i = 0; i < 20000; ++i) {
+        //! GIVEN
+        const std::u16string src = randomUtf16(rnd, rnd() % 100);
+
+        //! DO
+        std::string dst;
+        UtfCodec::utf16to8(src, dst);
+
+        //! CHECK
+        std::string expected = reference<std::string>(src, [](auto b, auto e, auto out) { utf8::utf16to8(b, e, out); });
+        ASSERT_EQ(dst, expected);
+    }
+}
+
+TEST_F(Global_Types_UtfTests, Utf32_SameAsUtfcpp)
+{
+    std::mt19937 rnd(44);
+    for (int i = 0; i < 20000; ++i) {
+        //! GIVEN
+        const std::string src = randomUtf8(rnd, rnd() % 100);
+
+        //! DO
+        std::u32string dst32;
+        UtfCodec::utf8to32(src, dst32);
+
+        //! CHECK
+        std::u32string expected32 = reference<std::u32string>(src, [](auto b, auto e, auto out) { utf8::utf8to32(b, e, out); });
+        ASSERT_EQ(dst32, expected32) << src;
+
+        //! GIVEN Code points with invalid ones
+        std::u32string src32 = dst32;
+        if (rnd() % 2) {
+            const char32_t invalid[] = { 0xD800, 0xDFFF, 0x110000, 0xFFFFFFFF };
+            src32.insert(rnd() % (src32.size() + 1), 1, invalid[rnd() % 4]);
+        }
+
+        //! DO
+        std::string dst8;
+        UtfCodec::utf32to8(src32, dst8);
+
+        //! CHECK
+        std::string expected8 = reference<std::string>(src32, [](auto b, auto e, auto out) { utf8::utf32to8(b, e, out); });
+        ASSERT_EQ(dst8, expected8);
+    }
+}
+
+TEST_F(Global_Types_UtfTests, Length_Exact)
+{
+    const std::string src = "abc \xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8E\xB5";
+    const std::u16string u16 = u"abc \u00E9 \u20AC \U0001F3B5";
+    const std::u32string u32 = U"abc \u00E9 \u20AC \U0001F3B5";
+
+    EXPECT_EQ(utf::utf16LengthOfUtf8(src.data(), src.size()), u16.size());
+    EXPECT_EQ(utf::utf8LengthOfUtf16(u16.data(), u16.size()), src.size());
+    EXPECT_EQ(utf::utf8LengthOfUtf32(u32.data(), u32.size()), src.size());
+
+    //! CHECK Conversion appends
+    std::u16string dst = u"x";
+    UtfCodec::utf8to16(src, dst);
+    EXPECT_EQ(dst, u"x" + u16);
+}
+
+TEST_F(Global_Types_UtfTests, DISABLED_Utf_Benchmark)
+{
+    struct Corpus {
+        const char* name;
+        std::string text;
+    };
+
+    const size_t size = 16 * 1024 * 1024;
+    const std::vector<Corpus> corpora = {
+        { "ASCII", corpus("The quick brown fox jumps over the lazy dog. <note pitch=\"60\"/> ", size) },
+        { "Latin", corpus("D\xC3\xA9j\xC3\xA0 vu, na\xC3\xAFve caf\xC3\xA9 \xC3\xBC" "ber Stra\xC3\x9F" "e, ma\xC3\xB1" "ana. ", size) },
+        { "CJK", corpus("\xE9\x9F\xB3\xE6\xA5\xBD\xE3\x81\xAE\xE6\xA5\xBD\xE8\xAD\x9C\xE3\x82\x92\xE6\x9B\xB8\xE3\x81\x8F\xE3\x80\x82", size) },
+        { "emoji", corpus("\xF0\x9F\x8E\xB5\xF0\x9F\x8E\xB6 \xF0\x9F\x98\x80 la ", size) },
+    };
+
+    auto ms = [](auto start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    };
+
+    for (const Corpus& c : corpora) {
+        const double mb = static_cast<double>(c.text.size()) / (1024.0 * 1024.0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::u16string ref16 = reference<std::u16string>(c.text, [](auto b, auto e, auto out) { utf8::utf8to16(b, e, out); });
+        double utfcpp8to16 = ms(start);
+
+        start = std::chrono::steady_clock::now();
+        std::u16string u16;
+        UtfCodec::utf8to16(c.text, u16);
+        double codec8to16 = ms(start);
+
+        start = std::chrono::steady_clock::now();
+        std::string ref8 = reference<std::string>(u16, [](auto b, auto e, auto out) { utf8::utf16to8(b, e, out); });
+        double utfcpp16to8 = ms(start);
+
+        start = std::chrono::steady_clock::now();
+        std::string u8;
+        UtfCodec::utf16to8(u16, u8);
+        double codec16to8 = ms(start);
+
+        EXPECT_EQ(u16, ref16);
+        EXPECT_EQ(u8, c.text);
+
+        std::cout << c.name << ": utf8to16 " << mb * 1000.0 / utfcpp8to16 << " -> " << mb * 1000.0 / codec8to16 << " MB/s"
+                  << ", utf16to8 " << mb * 1000.0 / utfcpp16to8 << " -> " << mb * 1000.0 / codec16to8 << " MB/s" << std::endl;
+    }
+}
@@ -21,15 +21,48 @@
  */
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
 
 #include "types/bytearray.h"
 #include "types/string.h"
+#include "io/buffer.h"
 #include "serialization/xmlstreamreader.h"
+#include "serialization/internal/xmlpullparser.h"
+
+#include "testing/heapcounter.h"
 
 using namespace muse;
 
+//! NOTE pugixml allocates with malloc, so the peak of the whole process memory is measured too
+static long long procStatusKb(const char* key)
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind(key, 0) == 0) {
+            return std::atoll(line.c_str() + std::strlen(key));
+        }
+    }
+#else
+    (void)key;
+#endif
+    return 0;
+}
+
+static void resetPeakRss()
+{
+#ifdef __linux__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
 namespace {
 static ByteArray BA(const char* s)
 {
@@ -46,6 +79,109 @@ static XmlStreamReader::TokenType advanceTo(XmlStreamReader& r, XmlStreamReader:
         }
     }
 }
+
+// Helper: all tokens with their content, to compare the readers
+static std::string dumpTokens(XmlStreamReader& r)
+{
+    std::string out;
+    while (r.readNext() != XmlStreamReader::TokenType::Invalid) {
+        out += r.tokenString().ascii();
+        switch (r.tokenType()) {
+        case XmlStreamReader::TokenType::StartElement:
+            out += " " + std::string(r.name().ascii(), r.name().size());
+            for (const XmlStreamReader::Attribute& a : r.attributes()) {
+                out += " " + std::string(a.name.ascii(), a.name.size()) + "=" + a.value.toStdString();
+            }
+            out += r.noChildren() ? " empty" : "";
+            break;
+        case XmlStreamReader::TokenType::EndElement:
+            out += " " + std::string(r.name().ascii(), r.name().size());
+            break;
+        case XmlStreamReader::TokenType::Characters:
+        case XmlStreamReader::TokenType::Comment:
+            out += " " + r.text().toStdString();
+            break;
+        default:
+            break;
+        }
+        out += "\n";
+
+        if (r.isEndDocument()) {
+            break;
+        }
+    }
+    return out;
+}
+
+static std::string dumpTokens(const char* xml)
+{
+    XmlStreamReader r;
+    r.setData(BA(xml));
+    return dumpTokens(r);
+}
+
+static std::string dumpStreamTokens(const ByteArray& data)
+{
+    ByteArray ba = data;
+    io::Buffer buf(&ba);
+    buf.open(io::IODevice::ReadOnly);
+    XmlStreamReader r(&buf, XmlStreamReader::DeviceMode::Incremental);
+    return dumpTokens(r);
+}
+
+//! NOTE MusicXML-like document
+static ByteArray makeScore(int measures)
+{
+    std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<score-partwise version=\"4.0\">\n<part id=\"P1\">\n";
+    for (int m = 0; m < measures; ++m) {
+        xml += "<measure number=\"" + std::to_string(m + 1) + "\" width=\"312.5\">\n";
+        for (int n = 0; n < 4; ++n) {
+            xml += "  <note default-x=\"" + std::to_string(20 + n * 70) + ".25\" default-y=\"-35\">\n"
+                   "    <pitch><step>C</step><octave>5</octave></pitch>\n"
+                   "    <duration>1</duration>\n"
+                   "    <voice>1</voice>\n"
+                   "    <type>quarter</type>\n"
+                   "    <stem>down</stem>\n"
+                   "  </note>\n";
+        }
+        xml += "</measure>\n";
+    }
+    xml += "</part>\n</score-partwise>\n";
+
+    return ByteArray(reinterpret_cast<const uint8_t*>(xml.data()), xml.size());
+}
+
+// Helper: runs the check for the reader of the whole data and the incremental reader
+static void forEachReader(const char* xml, const std::function<void(XmlStreamReader&)>& check)
+{
+    XmlStreamReader dataReader;
+    dataReader.setData(BA(xml));
+    check(dataReader);
+
+    ByteArray ba = BA(xml);
+    io::Buffer buf(&ba);
+    buf.open(io::IODevice::ReadOnly);
+    XmlStreamReader streamReader(&buf, XmlStreamReader::DeviceMode::Incremental);
+    check(streamReader);
+}
+
+static const char* STREAM_DOCS[] = {
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<!DOCTYPE score-partwise PUBLIC \"-//Recordare//DTD MusicXML 4.0 Partwise//EN\" \"http://www.musicxml.org/dtds/partwise.dtd\">\n"
+    "<!-- top -->\n"
+    "<root a=\"1\" b='two &amp; three'>\n"
+    "  <child x=\"&lt;&#65;&#x42;&gt;\"/>\n"
+    "  <text>Hello &quot;world&quot; &unknown; \xC3\xA9</text>\n"
+    "  <cdata><![CDATA[<raw> & ]]></cdata>\n"
+    "  <mixed>a<b/>c<!--in-->d</mixed>\n"
+    "  <empty></empty>\n"
+    "  <?pi data?>\n"
+    "</root>\n",
+
+    "<root>\r\n<t>line1\r\nline2\rline3</t><a v=\"x\ty\nz\"/></root>",
+
+    "<?xml version=\"1.0\"?><!DOCTYPE r [ <!ENTITY ent \"value\"> ]><r><t>&ent;</t></r>",
+};
 } // namespace
 
 class Serialization_XmlStreamReaderTests : public ::testing::Test
@@ -258,3 +394,379 @@ TEST_F(Serialization_XmlStreamReaderTests, ProcessingInstructionsIgnored)
     EXPECT_EQ(advanceTo(xr, XmlStreamReader::TokenType::EndElement), XmlStreamReader::TokenType::EndElement);
     EXPECT_EQ(advanceTo(xr, XmlStreamReader::TokenType::EndDocument), XmlStreamReader::TokenType::EndDocument);
 }
+
+// ---------- Incremental reading from a device ----------
+TEST_F(Serialization_XmlStreamReaderTests, Stream_SameTokensAsData)
+{
+    for (const char* xml : STREAM_DOCS) {
+        std::string expected = dumpTokens(xml);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(dumpStreamTokens(BA(xml)), expected) << xml;
+    }
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, Stream_SmallChunks)
+{
+    auto dumpPull = [](const char* xml, size_t chunkSize) {
+        ByteArray ba = BA(xml);
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+
+        XmlPullParser parser(&buf, chunkSize);
+        EXPECT_EQ(parser.init(), XmlPullParser::Status::Ok);
+
+        std::string out;
+        for (;;) {
+            const XmlPullParser::Token& t = parser.next();
+            out += std::to_string(static_cast<int>(t.type)) + " " + std::to_string(t.offset);
+            if (t.name) {
+                out += " " + *t.name;
+            }
+            for (size_t i = 0; i < t.attributesCount; ++i) {
+                out += " " + *t.attributes[i].name + "=" + t.attributes[i].value;
+            }
+            out += " " + t.text + "\n";
+
+            if (t.type == XmlPullParser::TokenType::EndDocument || t.type == XmlPullParser::TokenType::Error) {
+                break;
+            }
+        }
+        return out;
+    };
+
+    for (const char* xml : STREAM_DOCS) {
+        std::string expected = dumpPull(xml, XmlPullParser::DEFAULT_CHUNK_SIZE);
+        for (size_t chunkSize : { 1, 2, 3, 7, 16 }) {
+            EXPECT_EQ(dumpPull(xml, chunkSize), expected) << "chunk: " << chunkSize;
+        }
+    }
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, Stream_Utf16)
+{
+    const char* xml = STREAM_DOCS[0];
+    String str = String::fromUtf8(xml);
+
+    // UTF-16LE with BOM
+    ByteArray data;
+    data.push_back(0xFF);
+    data.push_back(0xFE);
+    for (size_t i = 0; i < str.size(); ++i) {
+        char16_t u = str.at(i).unicode();
+        data.push_back(static_cast<uint8_t>(u & 0xFF));
+        data.push_back(static_cast<uint8_t>(u >> 8));
+    }
+
+    EXPECT_EQ(dumpStreamTokens(data), dumpTokens(xml));
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, Stream_ErrorIsReached)
+{
+    {
+        ByteArray ba = BA("<a><b>text</a>");
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+        XmlStreamReader xr(&buf, XmlStreamReader::DeviceMode::Incremental);
+
+        EXPECT_EQ(xr.readNext(), XmlStreamReader::TokenType::StartElement);
+        EXPECT_EQ(xr.readNext(), XmlStreamReader::TokenType::StartElement);
+        EXPECT_EQ(xr.readText(), u"text");
+        EXPECT_TRUE(xr.atEnd());
+        EXPECT_EQ(xr.error(), XmlStreamReader::Error::NotWellFormedError);
+        EXPECT_FALSE(xr.errorString().empty());
+    }
+
+    {
+        ByteArray ba = BA("<a><b>text</b>");
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+        XmlStreamReader xr(&buf, XmlStreamReader::DeviceMode::Incremental);
+
+        xr.skipCurrentElement();
+        EXPECT_EQ(xr.tokenType(), XmlStreamReader::TokenType::Invalid);
+        EXPECT_EQ(xr.error(), XmlStreamReader::Error::PrematureEndOfDocumentError);
+    }
+
+    {
+        ByteArray ba = BA("<a");
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+        XmlStreamReader xr(&buf, XmlStreamReader::DeviceMode::Incremental);
+
+        EXPECT_EQ(xr.error(), XmlStreamReader::Error::CustomError);
+        EXPECT_EQ(xr.readNext(), XmlStreamReader::TokenType::Invalid);
+    }
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, Device_ReadAllByDefault)
+{
+    //! GIVEN Malformed document in a device
+    ByteArray ba = BA("<a><b>text</a>");
+    io::Buffer buf(&ba);
+    buf.open(io::IODevice::ReadOnly);
+
+    //! DO Read with the default mode and close the device
+    XmlStreamReader xr(&buf);
+    buf.close();
+
+    //! CHECK The error is reported upfront, like reading from data
+    EXPECT_EQ(xr.error(), XmlStreamReader::Error::NotWellFormedError);
+    EXPECT_EQ(xr.readNext(), XmlStreamReader::TokenType::Invalid);
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, Stream_ReadBody)
+{
+    const char* xml = "<root><html><p a=\"1 &amp; 2\">x &lt; y<br/></p><!--c--></html></root>";
+
+    XmlStreamReader dataReader;
+    dataReader.setData(BA(xml));
+    dataReader.readNextStartElement();
+    dataReader.readNextStartElement();
+
+    ByteArray ba = BA(xml);
+    io::Buffer buf(&ba);
+    buf.open(io::IODevice::ReadOnly);
+    XmlStreamReader streamReader(&buf, XmlStreamReader::DeviceMode::Incremental);
+    streamReader.readNextStartElement();
+    streamReader.readNextStartElement();
+
+    EXPECT_EQ(streamReader.readBody(), dataReader.readBody());
+
+    //! CHECK The position is not changed
+    EXPECT_EQ(streamReader.name(), AsciiStringView("html"));
+    EXPECT_TRUE(streamReader.readNextStartElement());
+    EXPECT_EQ(streamReader.name(), AsciiStringView("p"));
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, DISABLED_Stream_Benchmark)
+{
+    if (!muse::testing::HeapCounter::isAvailable()) {
+        std::cout << "the heap counter is not available" << std::endl;
+    }
+
+    const ByteArray data = makeScore(40000);
+
+    auto walk = [](XmlStreamReader& r) {
+        size_t elements = 0;
+        double sum = 0.0;
+        while (r.readNext() != XmlStreamReader::TokenType::Invalid && !r.isEndDocument()) {
+            if (r.isStartElement()) {
+                ++elements;
+                sum += r.doubleAttribute("default-x", 0.0);
+            }
+        }
+        return elements + static_cast<size_t>(sum);
+    };
+
+    auto measure = [&](const char* title, const std::function<size_t()>& func) {
+        resetPeakRss();
+        long long rss = procStatusKb("VmRSS:");
+        muse::testing::HeapCounter::start();
+
+        auto start = std::chrono::steady_clock::now();
+        size_t result = func();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        muse::testing::HeapCounter::Stats heap = muse::testing::HeapCounter::stop();
+        long long peakRss = procStatusKb("VmHWM:") - rss;
+
+        double mb = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+        std::cout << title << ": " << elapsed.count() / 1000 << " ms, "
+                  << mb / (static_cast<double>(elapsed.count()) / 1e6) << " MB/s, "
+                  << "peak heap: " << heap.peakBytes / 1024 << " KB, "
+                  << "peak rss: +" << peakRss << " KB, "
+                  << "allocations: " << heap.allocs << ", result: " << result << std::endl;
+        return result;
+    };
+
+    std::cout << "document: " << data.size() / 1024 << " KB" << std::endl;
+
+    size_t whole = measure("whole document", [&]() {
+        XmlStreamReader r;
+        r.setData(data);
+        return walk(r);
+    });
+
+    size_t stream = measure("incremental", [&]() {
+        ByteArray ba = data; // shared, not copied
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+        XmlStreamReader r(&buf, XmlStreamReader::DeviceMode::Incremental);
+        return walk(r);
+    });
+
+    EXPECT_EQ(whole, stream);
+}
+
+// ---------- Views and numbers ----------
+TEST_F(Serialization_XmlStreamReaderTests, AttributeViews)
+{
+    const char* xml = "<root a=\"1\" b=\"x &amp; y\" c=\"\xC3\xA9\"/>";
+
+    forEachReader(xml, [](XmlStreamReader& xr) {
+        ASSERT_TRUE(xr.readNextStartElement());
+
+        std::vector<XmlStreamReader::AttributeView> views;
+        xr.attributeViews(views);
+        ASSERT_EQ(views.size(), 3);
+        EXPECT_EQ(views[0].name, AsciiStringView("a"));
+        EXPECT_EQ(views[0].value, AsciiStringView("1"));
+        EXPECT_EQ(views[1].value, AsciiStringView("x & y"));
+        EXPECT_EQ(String::fromUtf8(views[2].value.ascii()), String(u"\u00E9"));
+
+        EXPECT_EQ(xr.asciiAttribute("b"), AsciiStringView("x & y"));
+        EXPECT_EQ(xr.asciiAttribute("none", "def"), AsciiStringView("def"));
+        EXPECT_EQ(xr.attribute("c"), String(u"\u00E9"));
+        EXPECT_EQ(xr.attribute("none", u"def"), u"def");
+
+        std::vector<XmlStreamReader::Attribute> attrs = xr.attributes();
+        ASSERT_EQ(attrs.size(), 3);
+        EXPECT_EQ(attrs[1].name, AsciiStringView("b"));
+        EXPECT_EQ(attrs[1].value, u"x & y");
+
+        //! CHECK Not a start element
+        xr.readNext();
+        xr.attributeViews(views);
+        EXPECT_TRUE(views.empty());
+        EXPECT_FALSE(xr.hasAttribute("a"));
+    });
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, NumericAccessors)
+{
+    const char* xml
+        ="<root i=\"42\" n=\"-7\" p=\"+5\" s=\" 3\" bad=\"4x\" d=\"1.5\" e=\"-2.5e2\" dt=\"2.5mm\" dbad=\"abc\" big=\"4294967298\" huge=\"-99999999999999999999\">"
+         "<int>123</int><hex>0x1F</hex><neg>-8</neg><badint>12a</badint>"
+         "<double>0.125</double><hexdouble>0x1p3</hexdouble><baddouble>-</baddouble><empty></empty>"
+         "</root>";
+
+    forEachReader(xml, [](XmlStreamReader& xr) {
+        ASSERT_TRUE(xr.readNextStartElement());
+
+        EXPECT_EQ(xr.intAttribute("i"), 42);
+        EXPECT_EQ(xr.intAttribute("n"), -7);
+        EXPECT_EQ(xr.intAttribute("p"), 5);
+        EXPECT_EQ(xr.intAttribute("s"), 3);
+        EXPECT_EQ(xr.intAttribute("bad", 9), 0);
+        EXPECT_EQ(xr.intAttribute("none", 9), 9);
+        EXPECT_EQ(xr.intAttribute("big"), AsciiStringView("4294967298").toInt());
+        EXPECT_EQ(xr.intAttribute("huge"), AsciiStringView("-99999999999999999999").toInt());
+
+        EXPECT_DOUBLE_EQ(xr.doubleAttribute("d"), 1.5);
+        EXPECT_DOUBLE_EQ(xr.doubleAttribute("e"), -250.0);
+        EXPECT_DOUBLE_EQ(xr.doubleAttribute("dt"), 2.5);
+        EXPECT_DOUBLE_EQ(xr.doubleAttribute("dbad", 1.0), 0.0);
+        EXPECT_DOUBLE_EQ(xr.doubleAttribute("none", 1.0), 1.0);
+
+        bool ok = false;
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_EQ(xr.readInt(&ok), 123);
+        EXPECT_TRUE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_EQ(xr.readInt(&ok, 16), 31);
+        EXPECT_TRUE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_EQ(xr.readInt(&ok), -8);
+        EXPECT_TRUE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_EQ(xr.readInt(&ok), 0);
+        EXPECT_FALSE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_DOUBLE_EQ(xr.readDouble(&ok), 0.125);
+        EXPECT_TRUE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_DOUBLE_EQ(xr.readDouble(&ok), 8.0);
+        EXPECT_TRUE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_DOUBLE_EQ(xr.readDouble(&ok), 0.0);
+        EXPECT_FALSE(ok);
+
+        ASSERT_TRUE(xr.readNextStartElement());
+        EXPECT_EQ(xr.readInt(&ok), 0);
+        EXPECT_FALSE(ok);
+    });
+}
+
+TEST_F(Serialization_XmlStreamReaderTests, DISABLED_Access_AllocationsBenchmark)
+{
+    if (!muse::testing::HeapCounter::isAvailable()) {
+        std::cout << "the heap counter is not available" << std::endl;
+    }
+
+    const ByteArray data = makeScore(20000);
+
+    //! NOTE Typical reading code, values are converted to String
+    auto readStrings = [](XmlStreamReader& r) {
+        double sum = 0.0;
+        while (r.readNext() != XmlStreamReader::TokenType::Invalid && !r.isEndDocument()) {
+            if (!r.isStartElement()) {
+                continue;
+            }
+
+            if (r.name() == "note") {
+                sum += r.attribute("default-x").toDouble() + r.attribute("default-y").toDouble();
+            } else if (r.name() == "duration" || r.name() == "voice" || r.name() == "octave") {
+                sum += r.readText().toInt();
+            } else if (r.name() == "type" || r.name() == "step" || r.name() == "stem") {
+                sum += r.readText() == u"quarter" ? 1.0 : 0.0;
+            } else if (r.name() == "measure") {
+                sum += r.attributes().size();
+            }
+        }
+        return sum;
+    };
+
+    //! NOTE The same with views and numeric accessors
+    auto readViews = [](XmlStreamReader& r) {
+        double sum = 0.0;
+        std::vector<XmlStreamReader::AttributeView> views;
+        while (r.readNext() != XmlStreamReader::TokenType::Invalid && !r.isEndDocument()) {
+            if (!r.isStartElement()) {
+                continue;
+            }
+
+            if (r.name() == "note") {
+                sum += r.doubleAttribute("default-x") + r.doubleAttribute("default-y");
+            } else if (r.name() == "duration" || r.name() == "voice" || r.name() == "octave") {
+                sum += r.readInt();
+            } else if (r.name() == "type" || r.name() == "step" || r.name() == "stem") {
+                sum += r.readAsciiText() == "quarter" ? 1.0 : 0.0;
+            } else if (r.name() == "measure") {
+                r.attributeViews(views);
+                sum += views.size();
+            }
+        }
+        return sum;
+    };
+
+    auto measure = [&](const char* title, const std::function<double(XmlStreamReader&)>& func) {
+        ByteArray ba = data;
+        io::Buffer buf(&ba);
+        buf.open(io::IODevice::ReadOnly);
+        XmlStreamReader r(&buf, XmlStreamReader::DeviceMode::Incremental);
+
+        muse::testing::HeapCounter::start();
+
+        auto start = std::chrono::steady_clock::now();
+        double result = func(r);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        muse::testing::HeapCounter::Stats heap = muse::testing::HeapCounter::stop();
+
+        std::cout << title << ": " << elapsed.count() << " ms, allocations: " << heap.allocs << ", result: " << result << std::endl;
+        return result;
+    };
+
+    std::cout << "document: " << data.size() / 1024 << " KB" << std::endl;
+
+    double strings = measure("String values", readStrings);
+    double views = measure("views and numbers", readViews);
+
+    EXPECT_DOUBLE_EQ(strings, views);
+}
@@ -21,6 +21,10 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <functional>
+#include <iostream>
+
 #include "serialization/xmlstreamreader.h"
 #include "serialization/xmlstreamwriter.h"
 #include "types/bytearray.h"
@@ -32,6 +36,29 @@ using namespace muse::io;
 class Global_Ser_XML : public ::testing::Test
 {
 public:
+
+    //! NOTE Escaping by code points
+    static std::string escapeReference(const std::string& str)
+    {
+        std::string escaped;
+        for (char32_t c : String::fromUtf8(str.c_str()).toStdU32String()) {
+            escaped += XmlStreamWriter::escapeCodePoint(c);
+        }
+        return escaped;
+    }
+
+    template<typename Func>
+    static std::string write(const Func& func)
+    {
+        ByteArray data;
+        {
+            auto buf = Buffer::opened(IODevice::WriteOnly, &data);
+            XmlStreamWriter xml(&buf);
+            func(xml);
+            xml.flush();
+        }
+        return std::string(data.constChar(), data.size());
+    }
 };
 
 TEST_F(Global_Ser_XML, WriteRead)
@@ -86,3 +113,107 @@ TEST_F(Global_Ser_XML, WriteRead)
         EXPECT_EQ(xml.name(), "anotherTag");
     }
 }
+
+TEST_F(Global_Ser_XML, Escape_SameAsCodePoints)
+{
+    //! GIVEN Strings with special characters at all positions (and so in all vector blocks)
+    const std::vector<std::string> specials = { "<", ">", "&", "\"", "\x01", "\t", "\n", "\r", "\x1F", "'", "\xC3\xA9", "\xE2\x82\xAC",
+                                                "\xF0\x9F\x8E\xB5" };
+    for (const std::string& special : specials) {
+        for (size_t pos = 0; pos < 40; ++pos) {
+            std::string str(40, 'a');
+            str.insert(pos, special);
+            str += special;
+
+            //! CHECK
+            EXPECT_EQ(XmlStreamWriter::escapeString(str), escapeReference(str)) << str;
+        }
+    }
+
+    EXPECT_EQ(XmlStreamWriter::escapeString("a<b>&\"c\"\x02"), "a&lt;b&gt;&amp;&quot;c&quot;");
+    EXPECT_EQ(XmlStreamWriter::escapeString(""), "");
+}
+
+TEST_F(Global_Ser_XML, Escape_InvalidUtf8Throws)
+{
+    EXPECT_ANY_THROW(XmlStreamWriter::escapeString("abc\xFF"));
+    EXPECT_ANY_THROW(XmlStreamWriter::escapeString("0123456789abcdef\xC3"));
+}
+
+TEST_F(Global_Ser_XML, Write_StringValue)
+{
+    //! GIVEN The same text as String and as UTF-8
+    const char* utf8 = "a<b & \"c\" \xC3\xA9 \xE2\x82\xAC \xF0\x9F\x8E\xB5 \x01 end";
+    std::string longUtf8;
+    for (int i = 0; i < 100; ++i) {
+        longUtf8 += utf8;
+    }
+
+    for (const std::string& str : { std::string(utf8), longUtf8 }) {
+        //! DO
+        std::string fromString = write([&str](XmlStreamWriter& xml) {
+            xml.element("t", { { "a", String::fromUtf8(str.c_str()) } }, String::fromUtf8(str.c_str()));
+        });
+
+        std::string fromUtf8 = write([&str](XmlStreamWriter& xml) {
+            xml.element("t", { { "a", std::string_view(str) } }, std::string_view(str));
+        });
+
+        //! CHECK
+        EXPECT_EQ(fromString, fromUtf8);
+        EXPECT_EQ(fromString, "<t a=\"" + escapeReference(str) + "\">" + escapeReference(str) + "</t>\n");
+    }
+
+    //! CHECK Not escaped text is written as is
+    std::string comment = write([utf8](XmlStreamWriter& xml) {
+        xml.comment(String::fromUtf8(utf8));
+    });
+    EXPECT_EQ(comment, std::string("<!-- ") + utf8 + " -->\n");
+}
+
+TEST_F(Global_Ser_XML, DISABLED_Write_Benchmark)
+{
+    const String text = String::fromUtf8("Allegro ma non troppo, \"dolce\" & espressivo \xE2\x80\x94 ritardando poco a poco");
+    const std::string_view utf8Text = "Allegro ma non troppo, \"dolce\" & espressivo \xE2\x80\x94 ritardando poco a poco";
+
+    auto measure = [](const char* title, const std::function<void(XmlStreamWriter&)>& func) {
+        ByteArray data;
+        auto start = std::chrono::steady_clock::now();
+        {
+            auto buf = Buffer::opened(IODevice::WriteOnly, &data);
+            XmlStreamWriter xml(&buf);
+            func(xml);
+            xml.flush();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        double mb = static_cast<double>(data.size()) / (1024.0 * 1024.0);
+        std::cout << title << ": " << elapsed.count() / 1000 << " ms, " << mb / (static_cast<double>(elapsed.count()) / 1e6) << " MB/s"
+                  << std::endl;
+    };
+
+    measure("attributes", [](XmlStreamWriter& xml) {
+        xml.startElement("score");
+        for (int i = 0; i < 500000; ++i) {
+            xml.element("note", { { "pitch", 60 + i % 12 }, { "tpc", 14 }, { "head", "normal" }, { "x", 12.5 * (i % 40) },
+                            { "color", std::string_view("#000000") } });
+        }
+        xml.endElement();
+    });
+
+    measure("String text", [&text](XmlStreamWriter& xml) {
+        xml.startElement("score");
+        for (int i = 0; i < 500000; ++i) {
+            xml.element("text", text);
+        }
+        xml.endElement();
+    });
+
+    measure("UTF-8 text", [utf8Text](XmlStreamWriter& xml) {
+        xml.startElement("score");
+        for (int i = 0; i < 500000; ++i) {
+            xml.element("text", utf8Text);
+        }
+        xml.endElement();
+    });
+}
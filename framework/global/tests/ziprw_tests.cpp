@@ -21,15 +21,204 @@
  */
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
 #include "global/io/buffer.h"
 #include "global/serialization/zipwriter.h"
 #include "global/serialization/zipreader.h"
+#include "global/serialization/internal/zipcontainer.h"
 
 using namespace muse;
 
 class Zip_RW_Tests : public ::testing::Test
 {
 public:
+
+    static std::string fileName(size_t i)
+    {
+        return "dir" + std::to_string(i % 10) + "/file" + std::to_string(i) + ".txt";
+    }
+
+    static ByteArray fileContent(size_t i)
+    {
+        std::string content;
+        for (size_t n = 0; n < i % 50 + 1; ++n) {
+            content += "Content of the file " + std::to_string(i) + ", line " + std::to_string(n) + "\n";
+        }
+        return ByteArray(content.c_str(), content.size());
+    }
+
+    static ByteArray makeZip(size_t count, ZipContainer::CompressionPolicy policy = ZipContainer::AlwaysCompress)
+    {
+        ByteArray data;
+        io::Buffer buf(&data);
+        ZipContainer zip(&buf);
+        zip.setCompressionPolicy(policy);
+        for (size_t i = 0; i < count; ++i) {
+            zip.addFile(fileName(i), fileContent(i));
+        }
+        zip.close();
+        return data;
+    }
+
+    static uint32_t crc32(const ByteArray& data)
+    {
+        uint32_t crc = 0xffffffff;
+        for (size_t i = 0; i < data.size(); ++i) {
+            crc ^= data[i];
+            for (int b = 0; b < 8; ++b) {
+                crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    static void put(ByteArray& out, uint64_t v, size_t bytes)
+    {
+        for (size_t i = 0; i < bytes; ++i) {
+            out.push_back(uint8_t(v >> (8 * i)));
+        }
+    }
+
+    //! NOTE Stored files with all sizes and offsets in the Zip64 records
+    static ByteArray makeZip64(const std::vector<std::pair<std::string, ByteArray> >& files)
+    {
+        ByteArray zip;
+        std::vector<uint64_t> offsets;
+        for (const auto& f : files) {
+            offsets.push_back(zip.size());
+            put(zip, 0x04034b50, 4);
+            put(zip, 45, 2);                // version needed
+            put(zip, 0, 2);                 // flags
+            put(zip, 0, 2);                 // stored
+            put(zip, 0, 4);                 // time
+            put(zip, crc32(f.second), 4);
+            put(zip, 0xffffffff, 4);
+            put(zip, 0xffffffff, 4);
+            put(zip, f.first.size(), 2);
+            put(zip, 20, 2);                // extra
+            zip.push_back(reinterpret_cast<const uint8_t*>(f.first.c_str()), f.first.size());
+            put(zip, 0x0001, 2);
+            put(zip, 16, 2);
+            put(zip, f.second.size(), 8);
+            put(zip, f.second.size(), 8);
+            zip.push_back(f.second);
+        }
+
+        const uint64_t dirOffset = zip.size();
+        for (size_t i = 0; i < files.size(); ++i) {
+            const auto& f = files.at(i);
+            put(zip, 0x02014b50, 4);
+            put(zip, 3 << 8 | 45, 2);       // made by unix
+            put(zip, 45, 2);
+            put(zip, 0, 2);
+            put(zip, 0, 2);
+            put(zip, 0, 4);
+            put(zip, crc32(f.second), 4);
+            put(zip, 0xffffffff, 4);
+            put(zip, 0xffffffff, 4);
+            put(zip, f.first.size(), 2);
+            put(zip, 28, 2);                // extra
+            put(zip, 0, 2);                 // comment
+            put(zip, 0, 2);                 // disk
+            put(zip, 0, 2);
+            put(zip, uint64_t(0100644) << 16, 4);
+            put(zip, 0xffffffff, 4);
+            zip.push_back(reinterpret_cast<const uint8_t*>(f.first.c_str()), f.first.size());
+            put(zip, 0x0001, 2);
+            put(zip, 24, 2);
+            put(zip, f.second.size(), 8);
+            put(zip, f.second.size(), 8);
+            put(zip, offsets.at(i), 8);
+        }
+
+        const uint64_t dirSize = zip.size() - dirOffset;
+        const uint64_t eod64Offset = zip.size();
+        put(zip, 0x06064b50, 4);
+        put(zip, 44, 8);
+        put(zip, 45, 2);
+        put(zip, 45, 2);
+        put(zip, 0, 4);
+        put(zip, 0, 4);
+        put(zip, files.size(), 8);
+        put(zip, files.size(), 8);
+        put(zip, dirSize, 8);
+        put(zip, dirOffset, 8);
+
+        put(zip, 0x07064b50, 4);
+        put(zip, 0, 4);
+        put(zip, eod64Offset, 8);
+        put(zip, 1, 4);
+
+        put(zip, 0x06054b50, 4);
+        put(zip, 0, 4);
+        put(zip, 0xffff, 2);
+        put(zip, 0xffff, 2);
+        put(zip, 0xffffffff, 4);
+        put(zip, 0xffffffff, 4);
+        put(zip, 0, 2);
+
+        return zip;
+    }
+
+    //! NOTE Compressible text of the given size
+    static ByteArray makeText(size_t size, unsigned seed)
+    {
+        static const char* words[] = { "note", "chord", "rest", "staff", "measure", "beam", "slur", "tie", "clef", "key" };
+        std::mt19937 rnd(seed);
+        std::string text;
+        text.reserve(size + 16);
+        while (text.size() < size) {
+            text += words[rnd() % 10];
+            text += std::to_string(rnd() % 100);
+            text += (rnd() % 8) ? ' ' : '\n';
+        }
+        text.resize(size);
+        return ByteArray(text.c_str(), text.size());
+    }
+
+    //! NOTE Archive with the modification times cleared, they depend on the moment of writing
+    static ByteArray withoutTimes(const ByteArray& zip)
+    {
+        auto read16 = [&zip](size_t pos) { return size_t(zip[pos]) | size_t(zip[pos + 1]) << 8; };
+        auto read32 = [&zip, &read16](size_t pos) { return read16(pos) | read16(pos + 2) << 16; };
+
+        ByteArray result = zip;
+        const size_t eod = zip.size() - 22;
+        size_t pos = read32(eod + 16);
+        for (size_t i = 0; i < read16(eod + 10); ++i) {
+            const size_t local = read32(pos + 42);
+            for (size_t b = 0; b < 4; ++b) {
+                result[pos + 12 + b] = 0;
+                result[local + 10 + b] = 0;
+            }
+            pos += 46 + read16(pos + 28) + read16(pos + 30) + read16(pos + 32);
+        }
+        return result;
+    }
+
+    static std::vector<std::pair<std::string, ByteArray> > makeFiles()
+    {
+        std::vector<std::pair<std::string, ByteArray> > files;
+        for (size_t size : { 0, 10, 1000, 300 * 1024, 2 * 1024 * 1024 + 17, 5000 }) {
+            files.push_back({ "file" + std::to_string(files.size()) + ".txt", makeText(size, unsigned(size)) });
+        }
+        return files;
+    }
+
+    static ByteArray readByChunks(ZipReader::FileReader& reader, size_t chunk)
+    {
+        ByteArray result;
+        std::vector<uint8_t> buf(chunk);
+        while (!reader.atEnd()) {
+            const size_t read = reader.read(buf.data(), buf.size());
+            result.push_back(buf.data(), read);
+        }
+        return result;
+    }
 };
 
 TEST_F(Zip_RW_Tests, Write_And_Read)
@@ -54,3 +243,298 @@ TEST_F(Zip_RW_Tests, Write_And_Read)
 
     reader.close();
 }
+
+TEST_F(Zip_RW_Tests, Read_Index)
+{
+    //! GIVEN Archive with many files
+    ByteArray data = makeZip(1000);
+    io::Buffer buf(&data);
+
+    //! DO
+    ZipReader reader(&buf);
+
+    //! CHECK
+    std::vector<ZipReader::FileInfo> infos = reader.fileInfoList();
+    ASSERT_EQ(infos.size(), 1000);
+    for (size_t i = 0; i < infos.size(); ++i) {
+        EXPECT_EQ(infos.at(i).filePath, io::path_t(fileName(i)));
+        EXPECT_EQ(infos.at(i).size, fileContent(i).size());
+    }
+
+    for (size_t i = 0; i < 1000; i += 7) {
+        EXPECT_TRUE(reader.fileExists(fileName(i)));
+        EXPECT_EQ(reader.fileData(fileName(i)), fileContent(i));
+    }
+
+    EXPECT_FALSE(reader.fileExists("file1.txt"));
+    EXPECT_TRUE(reader.fileData("file1.txt").empty());
+    EXPECT_FALSE(reader.fileReader("file1.txt"));
+    EXPECT_FALSE(reader.hasError());
+}
+
+TEST_F(Zip_RW_Tests, Read_Stream)
+{
+    for (ZipContainer::CompressionPolicy policy : { ZipContainer::AlwaysCompress, ZipContainer::NeverCompress }) {
+        //! GIVEN Archive with compressed or stored files
+        ByteArray data = makeZip(100, policy);
+        io::Buffer buf(&data);
+        ZipReader reader(&buf);
+
+        for (size_t i : { 0, 49, 99 }) {
+            //! DO Read by small chunks
+            std::unique_ptr<ZipReader::FileReader> file = reader.fileReader(fileName(i));
+            ASSERT_TRUE(file);
+            EXPECT_EQ(file->size(), fileContent(i).size());
+
+            ByteArray content = readByChunks(*file, 7);
+
+            //! CHECK
+            EXPECT_EQ(content, fileContent(i));
+            EXPECT_EQ(file->pos(), content.size());
+            EXPECT_TRUE(file->atEnd());
+            EXPECT_FALSE(file->hasError());
+            EXPECT_FALSE(file->hasCrcMismatch());
+        }
+    }
+}
+
+TEST_F(Zip_RW_Tests, Read_Corrupted)
+{
+    //! GIVEN Archive with a damaged stored file
+    ByteArray data = makeZip(10, ZipContainer::NeverCompress);
+    const std::string content = fileContent(3).constChar();
+    std::string zip(data.constChar(), data.size());
+    zip[zip.find(content) + 5] ^= 1;
+    data = ByteArray(zip.c_str(), zip.size());
+    io::Buffer buf(&data);
+    ZipReader reader(&buf);
+
+    //! CHECK Not matched checksum is reported, but the data is still read
+    std::unique_ptr<ZipReader::FileReader> file = reader.fileReader(fileName(3));
+    ASSERT_TRUE(file);
+    const ByteArray read = readByChunks(*file, 1024);
+    EXPECT_TRUE(file->hasCrcMismatch());
+    EXPECT_FALSE(file->hasError());
+    EXPECT_EQ(read.size(), fileContent(3).size());
+    EXPECT_EQ(reader.fileData(fileName(3)), read);
+
+    //! CHECK Other files are read
+    EXPECT_EQ(reader.fileData(fileName(4)), fileContent(4));
+}
+
+TEST_F(Zip_RW_Tests, Read_Zip64)
+{
+    //! GIVEN Archive with Zip64 records
+    ByteArray data = makeZip64({ { "a.txt", ByteArray("Hello World!") }, { "b/c.txt", fileContent(10) } });
+    io::Buffer buf(&data);
+
+    //! DO
+    ZipReader reader(&buf);
+
+    //! CHECK
+    std::vector<ZipReader::FileInfo> infos = reader.fileInfoList();
+    ASSERT_EQ(infos.size(), 2);
+    EXPECT_EQ(infos.at(1).filePath, io::path_t("b/c.txt"));
+    EXPECT_EQ(infos.at(1).size, fileContent(10).size());
+    EXPECT_EQ(reader.fileData("a.txt"), ByteArray("Hello World!"));
+    EXPECT_EQ(reader.fileData("b/c.txt"), fileContent(10));
+}
+
+TEST_F(Zip_RW_Tests, Read_File)
+{
+    //! GIVEN Archive file
+    const std::string path = "Zip_RW_Tests_Read_File.zip";
+    ByteArray data = makeZip(100);
+    FILE* f = std::fopen(path.c_str(), "wb");
+    ASSERT_TRUE(f);
+    std::fwrite(data.constData(), 1, data.size(), f);
+    std::fclose(f);
+
+    {
+        //! DO
+        ZipReader reader(path);
+
+        //! CHECK
+        EXPECT_EQ(reader.fileInfoList().size(), 100);
+        EXPECT_EQ(reader.fileData(fileName(42)), fileContent(42));
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_F(Zip_RW_Tests, DISABLED_Read_Benchmark)
+{
+    const size_t count = 10000;
+    ByteArray data = makeZip(count);
+    std::cout << "archive: " << data.size() / 1024 << " KB, " << count << " files" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        io::Buffer buf(&data);
+        ZipReader reader(&buf);
+        size_t found = 0;
+        for (size_t i = 0; i < count; ++i) {
+            found += reader.fileExists(fileName(i)) ? 1 : 0;
+        }
+        EXPECT_EQ(found, count);
+    }
+    auto exists = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    {
+        io::Buffer buf(&data);
+        ZipReader reader(&buf);
+        for (size_t i = 0; i < count; ++i) {
+            total += reader.fileData(fileName(i)).size();
+        }
+    }
+    auto read = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    size_t streamed = 0;
+    {
+        io::Buffer buf(&data);
+        ZipReader reader(&buf);
+        std::vector<uint8_t> chunk(4096);
+        for (size_t i = 0; i < count; ++i) {
+            std::unique_ptr<ZipReader::FileReader> file = reader.fileReader(fileName(i));
+            while (!file->atEnd()) {
+                streamed += file->read(chunk.data(), chunk.size());
+            }
+        }
+    }
+    auto stream = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(total, streamed);
+    std::cout << "open and check all files: " << exists.count() << " ms" << std::endl;
+    std::cout << "open and read all files: " << read.count() << " ms" << std::endl;
+    std::cout << "open and stream all files: " << stream.count() << " ms" << std::endl;
+}
+
+TEST_F(Zip_RW_Tests, Write_Parallel)
+{
+    //! GIVEN Small and big files
+    std::vector<std::pair<std::string, ByteArray> > files = makeFiles();
+
+    ByteArray serial;
+    for (size_t threads : { 1, 2, 4 }) {
+        //! DO Write on the threads with a small memory limit
+        ByteArray data;
+        {
+            io::Buffer buf(&data);
+            ZipWriter writer(&buf);
+            writer.setThreadCount(threads);
+            writer.setMemoryLimit(512 * 1024);
+            for (const auto& f : files) {
+                writer.addFile(f.first, f.second);
+            }
+            writer.close();
+            EXPECT_FALSE(writer.hasError());
+        }
+
+        //! CHECK The output does not depend on the threads
+        if (threads == 1) {
+            serial = withoutTimes(data);
+        } else {
+            EXPECT_EQ(withoutTimes(data), serial) << threads;
+        }
+
+        //! CHECK
+        io::Buffer buf(&data);
+        ZipReader reader(&buf);
+        ASSERT_EQ(reader.fileInfoList().size(), files.size());
+        for (const auto& f : files) {
+            EXPECT_EQ(reader.fileData(f.first), f.second) << f.first;
+        }
+    }
+}
+
+TEST_F(Zip_RW_Tests, Write_Stream)
+{
+    //! GIVEN Big file
+    std::vector<std::pair<std::string, ByteArray> > files = makeFiles();
+
+    //! DO Write from the data and from a device
+    ByteArray fromData;
+    ByteArray fromDevice;
+    {
+        io::Buffer buf(&fromData);
+        ZipWriter writer(&buf);
+        for (const auto& f : files) {
+            writer.addFile(f.first, f.second);
+        }
+    }
+    {
+        io::Buffer buf(&fromDevice);
+        ZipWriter writer(&buf);
+        writer.setThreadCount(2);
+        for (const auto& f : files) {
+            io::Buffer source(f.second.constData(), f.second.size());
+            writer.addFile(f.first, &source);
+        }
+    }
+
+    //! CHECK
+    EXPECT_EQ(withoutTimes(fromDevice), withoutTimes(fromData));
+}
+
+TEST_F(Zip_RW_Tests, Write_Zip64)
+{
+    //! GIVEN More files than fit in the end of directory record
+    const size_t count = 70000;
+
+    //! DO
+    ByteArray data;
+    {
+        io::Buffer buf(&data);
+        ZipContainer zip(&buf);
+        zip.setCompressionPolicy(ZipContainer::NeverCompress);
+        for (size_t i = 0; i < count; ++i) {
+            zip.addFile(std::to_string(i), ByteArray(std::to_string(i * 2).c_str()));
+        }
+        zip.close();
+    }
+
+    //! CHECK Zip64 records are read back
+    io::Buffer buf(&data);
+    ZipReader reader(&buf);
+    EXPECT_EQ(reader.fileInfoList().size(), count);
+    EXPECT_EQ(reader.fileData("69999"), ByteArray("139998"));
+}
+
+TEST_F(Zip_RW_Tests, DISABLED_Write_Benchmark)
+{
+    //! NOTE Big files like embedded audio and many small ones
+    std::vector<ByteArray> files;
+    for (unsigned i = 0; i < 4; ++i) {
+        files.push_back(makeText(16 * 1024 * 1024, i));
+    }
+    for (unsigned i = 0; i < 1000; ++i) {
+        files.push_back(makeText(16 * 1024, i));
+    }
+
+    size_t total = 0;
+    for (const ByteArray& f : files) {
+        total += f.size();
+    }
+
+    for (size_t threads : { 1, 2, 4, 8 }) {
+        ByteArray data;
+        auto start = std::chrono::steady_clock::now();
+        {
+            io::Buffer buf(&data);
+            ZipWriter writer(&buf);
+            writer.setThreadCount(threads);
+            for (size_t i = 0; i < files.size(); ++i) {
+                writer.addFile("file" + std::to_string(i), files.at(i));
+            }
+            writer.close();
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::cout << "threads: " << threads << ", " << total / 1024 / 1024 << " MB -> " << data.size() / 1024 / 1024 << " MB, "
+                  << elapsed.count() << " ms, " << (total / 1024 / 1024) * 1000 / std::max<int64_t>(elapsed.count(), 1) << " MB/s"
+                  << std::endl;
+    }
+}
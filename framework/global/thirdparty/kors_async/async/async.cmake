@@ -9,6 +9,7 @@ set (KORS_ASYNC_SRC
     ${CMAKE_CURRENT_LIST_DIR}/promise.h
     ${CMAKE_CURRENT_LIST_DIR}/internal/conf.cpp
     ${CMAKE_CURRENT_LIST_DIR}/internal/ringqueue.h
+    ${CMAKE_CURRENT_LIST_DIR}/internal/mpscqueue.h
     ${CMAKE_CURRENT_LIST_DIR}/internal/rpcqueue.h
     ${CMAKE_CURRENT_LIST_DIR}/internal/channelimpl.h
     ${CMAKE_CURRENT_LIST_DIR}/internal/queuepool.cpp
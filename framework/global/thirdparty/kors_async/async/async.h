@@ -86,8 +86,7 @@ private:
     ~Async()
     {
         for (QueueData* d : m_queues) {
-            QueuePool::instance()->unregPort(d->sendTh, d->queue.port1());           // send
-            QueuePool::instance()->unregPort(d->receiveTh, d->queue.port2());        // receive
+            QueuePool::instance()->unregQueue(d->sendTh, d->receiveTh, d->queue);
 
             for (Asyncable* a : d->callers) {
                 a->async_disconnect(d);
@@ -121,8 +120,7 @@ private:
             }
         });
 
-        QueuePool::instance()->regPort(sendTh, d->queue.port1());           // send
-        QueuePool::instance()->regPort(receiveTh, d->queue.port2());        // receive
+        QueuePool::instance()->regQueue(sendTh, receiveTh, d->queue);
 
         return d;
     }
@@ -160,7 +158,7 @@ private:
         }
 
         qdata->connect(caller);
-        qdata->queue.port1()->send(m);
+        QueuePool::instance()->send(sendTh, qdata->queue, m);
     }
 
     static inline void do_call(const Asyncable* caller, const Call& func, const std::thread::id& th = std::this_thread::get_id())
@@ -42,6 +42,12 @@ struct conf {
     //! they will not be lost, but will be sent to the next process
     static size_t QUEUE_CAPACITY;
 
+    //! NOTE Each thread has a mailbox (lock-free multi producer queue) of ports
+    //! that have messages, so only these ports are processed instead of all ports of the thread.
+    //! If it is full, all ports are processed.
+    static bool DO_USE_MAILBOX;
+    static size_t MAILBOX_CAPACITY;
+
     //! NOTE Should be wait send pending messages on send
     static bool DO_WAIT_PENDINGS_ON_SEND;
     //! NOTE Should be warning on send pending messages timeout
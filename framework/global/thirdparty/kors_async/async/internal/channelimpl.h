@@ -32,6 +32,7 @@ SOFTWARE.
 #include <atomic>
 #include <iostream>
 #include <sstream>
+#include <mutex>
 
 #include "../conf.h"
 #include "../asyncable.h"
@@ -50,12 +51,16 @@ struct ChannelOpt {
     size_t queueCapacity = conf::QUEUE_CAPACITY;
     bool isWaitPendingsOnSend = conf::DO_WAIT_PENDINGS_ON_SEND;
     bool isWarnOnPendingsSendTimeout = conf::DO_WARN_ON_PENDINGSSEND_TIMEOUT;
+    bool isCoalesce = false;
 
     ChannelOpt& name(const std::string& name) { chname = name; return *this; }
     ChannelOpt& threads(size_t v) { maxThreads = v; return *this; }
     ChannelOpt& capacity(size_t v) { queueCapacity = v; return *this; }
     ChannelOpt& disableWaitPendingsOnSend() { isWaitPendingsOnSend = false; return *this; }
     ChannelOpt& disableWarnOnPendingsSendTimeout() { isWarnOnPendingsSendTimeout = false; return *this; }
+    //! NOTE Only the latest value is delivered to another thread,
+    //! if the previous one has not been received yet (for example, a position or a level meter)
+    ChannelOpt& coalesce() { isCoalesce = true; return *this; }
 };
 
 template<typename ... T>
@@ -72,9 +77,60 @@ private:
         Callback callback;
     };
 
+    //! NOTE One per queue, it is sent again only after the receiver has taken the value
+    struct CoalescedCall : public ICallable
+    {
+        std::mutex mutex;
+        std::tuple<std::decay_t<T>...> latest;
+        bool hasLatest = false;
+        std::tuple<std::decay_t<T>...> args;
+        bool hasArgs = false;
+        std::atomic<bool> queued = false;
+
+        // returns true if the message needs to be sent,
+        // otherwise the already queued one will deliver the value
+        bool setArgs(const T&... a)
+        {
+            {
+                std::scoped_lock lock(mutex);
+                latest = std::make_tuple(a ...);
+                hasLatest = true;
+            }
+            return !queued.exchange(true);
+        }
+
+        void prepare() override
+        {
+            // reset before taking, so a value set after this will be sent again
+            queued.store(false);
+
+            std::scoped_lock lock(mutex);
+            hasArgs = hasLatest;
+            if (hasLatest) {
+                args = std::move(latest);
+                latest = {};
+                hasLatest = false;
+            }
+        }
+
+        void unlock() override
+        {
+            args = {};
+            hasArgs = false;
+        }
+
+        void call(const void* r) override
+        {
+            if (hasArgs) {
+                std::apply(reinterpret_cast<const Receiver*>(r)->callback, args);
+            }
+        }
+    };
+
     struct QueueData {
         std::thread::id receiveTh;
         Queue queue;
+        std::shared_ptr<CoalescedCall> coalesced;
         QueueData(size_t queue_capacity)
             : queue(queue_capacity) {}
     };
@@ -232,9 +288,7 @@ private:
             qdata->receiveTh = receiveTh;
             qdata->queue.port2()->onMessage(handler);
 
-            QueuePool* pool = QueuePool::instance();
-            pool->regPort(threadId, qdata->queue.port1());     // send
-            pool->regPort(receiveTh, qdata->queue.port2());    // receive
+            QueuePool::instance()->regQueue(threadId, receiveTh, qdata->queue);
 
             queues.push_back(qdata);
 
@@ -251,8 +305,7 @@ private:
             QueuePool* pool = QueuePool::instance();
             for (QueueData* qdata : queues) {
                 qdata->queue.port2()->onMessage(nullptr);
-                pool->unregPort(threadId, qdata->queue.port1());             // send
-                pool->unregPort(qdata->receiveTh, qdata->queue.port2());     // receive
+                pool->unregQueue(threadId, qdata->receiveTh, qdata->queue);
 
                 delete qdata;
             }
@@ -451,7 +504,7 @@ private:
         disconnect(a, connectThId);
     }
 
-    void sendToQueue(ThreadData& sendThdata, const std::thread::id& receiveTh, const CallMsg& msg)
+    QueueData* queueData(ThreadData& sendThdata, const std::thread::id& receiveTh)
     {
         assert(sendThdata.threadId == std::this_thread::get_id());
 
@@ -469,12 +522,47 @@ private:
             qdata = sendThdata.addQueue(m_opt.queueCapacity, receiveTh, [this](const CallMsg& m) {
                 const std::thread::id threadId = std::this_thread::get_id();
                 ThreadData& thdata = threadData(threadId);
+                m.func->prepare();
                 thdata.receiversCall(m);
                 m.func->unlock();
             });
         }
 
-        qdata->queue.port1()->send(msg);
+        return qdata;
+    }
+
+    void sendToQueue(ThreadData& sendThdata, QueueData* qdata, const CallMsg& msg)
+    {
+        QueuePool::instance()->send(sendThdata.threadId, qdata->queue, msg);
+    }
+
+    void sendToQueue(ThreadData& sendThdata, const std::thread::id& receiveTh, const CallMsg& msg)
+    {
+        sendToQueue(sendThdata, queueData(sendThdata, receiveTh), msg);
+    }
+
+    void sendToThread(ThreadData& sendThdata, const std::thread::id& receiveTh, const T&... args)
+    {
+        if (m_opt.isCoalesce) {
+            QueueData* qdata = queueData(sendThdata, receiveTh);
+            if (!qdata->coalesced) {
+                qdata->coalesced = std::make_shared<CoalescedCall>();
+            }
+
+            if (qdata->coalesced->setArgs(args ...)) {
+                CallMsg msg;
+                msg.func = qdata->coalesced;
+                sendToQueue(sendThdata, qdata, msg);
+            }
+            return;
+        }
+
+        auto rcall = lockedReceiverCall();
+        rcall->setArgs(args ...);
+
+        CallMsg msg;
+        msg.func = rcall;
+        sendToQueue(sendThdata, receiveTh, msg);
     }
 
     void sendAuto(const T&... args)
@@ -504,12 +592,7 @@ private:
                 continue;
             }
 
-            auto rcall = lockedReceiverCall();
-            rcall->setArgs(args ...);
-
-            CallMsg msg;
-            msg.func = rcall;
-            sendToQueue(sendThdata, receiveThdata->threadId, msg);
+            sendToThread(sendThdata, receiveThdata->threadId, args ...);
         }
     }
 
@@ -531,12 +614,7 @@ private:
                 continue;
             }
 
-            auto rcall = lockedReceiverCall();
-            rcall->setArgs(args ...);
-
-            CallMsg msg;
-            msg.func = rcall;
-            sendToQueue(sendThdata, receiveThdata->threadId, msg);
+            sendToThread(sendThdata, receiveThdata->threadId, args ...);
         }
     }
 
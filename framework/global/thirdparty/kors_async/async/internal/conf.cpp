@@ -28,6 +28,8 @@ namespace kors::async {
 size_t conf::MAX_THREADS = 100;
 size_t conf::MAX_THREADS_PER_CHANNEL = 10;
 size_t conf::QUEUE_CAPACITY = 128;
+bool conf::DO_USE_MAILBOX = true;
+size_t conf::MAILBOX_CAPACITY = 1024;
 bool conf::DO_WAIT_PENDINGS_ON_SEND = true;
 bool conf::DO_WARN_ON_PENDINGSSEND_TIMEOUT = true;
 size_t conf::WAIT_PENDINGS_MS = 4;
@@ -0,0 +1,182 @@
+/*
+MIT License
+
+Copyright (c) Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+
+#ifndef KORS_CACHE_LINE_SIZE
+#define KORS_CACHE_LINE_SIZE 64
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <atomic>
+
+namespace kors::async {
+//! NOTE Multi Producer/Single Consumer
+//! Bounded ring, like RingQueue, but each cell has its own sequence number,
+//! so producers reserve a cell with CAS on the write position and publish it
+//! by the cell sequence, without locks (D. Vyukov bounded queue)
+template<typename T>
+class MpscQueue
+{
+private:
+
+    struct Cell {
+        std::atomic<size_t> seq = 0;
+        T data;
+    };
+
+    struct ProducerSide {
+        alignas(KORS_CACHE_LINE_SIZE) std::atomic<size_t> write_pos = 0;
+        char padding[KORS_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    };
+
+    struct ConsumerSide {
+        alignas(KORS_CACHE_LINE_SIZE) std::atomic<size_t> read_pos = 0;
+        char padding[KORS_CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    };
+
+    size_t m_capacity = 0;
+    size_t m_mask = 0;
+    std::unique_ptr<Cell[]> m_cells;
+
+    ProducerSide m_producer;
+    ConsumerSide m_consumer;
+
+public:
+    explicit MpscQueue(size_t initialCapacity)
+        : m_capacity(nextPowerOfTwo(std::max<size_t>(initialCapacity, 2))) // with one cell, "published" and "free" are indistinguishable
+        , m_mask(m_capacity - 1)
+        , m_cells(new Cell[m_capacity])
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() = default;
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Producers (any thread)
+    bool tryPush(const T& item)
+    {
+        return tryPush_impl(item);
+    }
+
+    bool tryPush(T&& item)
+    {
+        return tryPush_impl(std::move(item));
+    }
+
+    // Consumer (one thread)
+    bool tryPop(T& item)
+    {
+        const size_t read_idx = m_consumer.read_pos.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[read_idx & m_mask];
+        const size_t seq = cell.seq.load(std::memory_order_acquire);
+
+        // the cell is not published yet (empty or the producer is still writing)
+        if (seq != read_idx + 1) {
+            return false;
+        }
+
+        item = std::move(cell.data);
+        cell.data = T();
+
+        // make the cell available for the producers on the next lap
+        cell.seq.store(read_idx + m_capacity, std::memory_order_release);
+        m_consumer.read_pos.store(read_idx + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    size_t tryPopAll(std::vector<T>& out)
+    {
+        size_t count = 0;
+        T item;
+        while (tryPop(item)) {
+            out.push_back(std::move(item));
+            ++count;
+        }
+        return count;
+    }
+
+    // Service
+    //! NOTE Approximate, if producers are pushing right now
+    bool empty() const
+    {
+        const size_t read_idx = m_consumer.read_pos.load(std::memory_order_relaxed);
+        return m_cells[read_idx & m_mask].seq.load(std::memory_order_acquire) != read_idx + 1;
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    template<typename U>
+    bool tryPush_impl(U&& item)
+    {
+        size_t write_idx = m_producer.write_pos.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &m_cells[write_idx & m_mask];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(write_idx);
+            if (diff == 0) {
+                // the cell is free, let's try to reserve it
+                if (m_producer.write_pos.compare_exchange_weak(write_idx, write_idx + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // the consumer hasn't read the cell yet on the previous lap - full
+                return false;
+            } else {
+                // another producer has taken the cell
+                write_idx = m_producer.write_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::forward<U>(item);
+        cell->seq.store(write_idx + 1, std::memory_order_release);
+        return true;
+    }
+
+    static size_t nextPowerOfTwo(size_t n)
+    {
+        if (n == 0) {
+            return 1;
+        }
+        n--;
+        n |= n >> 1;
+        n |= n >> 2;
+        n |= n >> 4;
+        n |= n >> 8;
+        n |= n >> 16;
+        n |= n >> 32;
+        return n + 1;
+    }
+};
+}
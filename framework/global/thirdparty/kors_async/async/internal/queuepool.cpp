@@ -76,7 +76,7 @@ QueuePool::ThreadData* QueuePool::threadData(const std::thread::id& threadId, bo
         std::scoped_lock lock(m_mutex);
         count = m_count.load();
         if (count < m_threads.size()) {
-            ThreadData* thdata = new ThreadData();
+            ThreadData* thdata = new ThreadData(conf::MAILBOX_CAPACITY);
             thdata->threadId = threadId;
             m_threads[count] = thdata;
             ++m_count;
@@ -159,6 +159,78 @@ void QueuePool::unregPort(const std::thread::id& th, const std::shared_ptr<Port>
     ports.erase(std::remove(ports.begin(), ports.end(), port), ports.end());
 }
 
+void QueuePool::regQueue(const std::thread::id& sendTh, const std::thread::id& receiveTh, const Queue& queue)
+{
+    regPort(sendTh, queue.port1());
+    regPort(receiveTh, queue.port2());
+
+    // put the receiving port to the mailbox of the receiver thread
+    std::weak_ptr<Port> receivePort = queue.port2();
+    queue.port1()->onSent([this, receiveTh, receivePort]() {
+        if (std::shared_ptr<Port> port = receivePort.lock()) {
+            notify(receiveTh, port);
+        }
+    });
+}
+
+void QueuePool::unregQueue(const std::thread::id& sendTh, const std::thread::id& receiveTh, const Queue& queue)
+{
+    queue.port1()->onSent(nullptr);
+    unregPort(sendTh, queue.port1());
+    unregPort(receiveTh, queue.port2());
+}
+
+void QueuePool::send(const std::thread::id& sendTh, const Queue& queue, const CallMsg& msg)
+{
+    const std::shared_ptr<Port>& port = queue.port1();
+    port->send(msg);
+
+    if (port->hasPending()) {
+        notify(sendTh, port);
+    }
+}
+
+void QueuePool::notify(const std::thread::id& th, const std::shared_ptr<Port>& port)
+{
+    if (!conf::DO_USE_MAILBOX || conf::terminated) {
+        return;
+    }
+
+    // already in the mailbox and not processed yet
+    if (!port->tryMarkNotified()) {
+        return;
+    }
+
+    ThreadData* thdata = threadData(th, false);
+    if (!thdata) {
+        port->resetNotified();
+        return;
+    }
+
+    if (!thdata->mailbox.tryPush(port)) {
+        // the mailbox is full, the thread will process all ports
+        thdata->mailboxOverflow.store(true, std::memory_order_release);
+    }
+
+    // one wakeup per batch
+    if (!thdata->wakeupRequested.exchange(true, std::memory_order_acq_rel)) {
+        std::shared_ptr<const Wakeup> wakeup = std::atomic_load(&thdata->wakeup);
+        if (wakeup && *wakeup) {
+            (*wakeup)();
+        }
+    }
+}
+
+void QueuePool::setWakeup(const std::thread::id& th, const Wakeup& wakeup)
+{
+    ThreadData* thdata = threadData(th, true);
+    if (!thdata) {
+        return;
+    }
+
+    std::atomic_store(&thdata->wakeup, wakeup ? std::make_shared<const Wakeup>(wakeup) : std::shared_ptr<const Wakeup>());
+}
+
 void QueuePool::processMessages()
 {
     std::thread::id threadId = std::this_thread::get_id();
@@ -181,9 +253,74 @@ void QueuePool::processMessages(const std::thread::id& th)
         return;
     }
 
+    // notifications after this point will request a new wakeup
+    // (read-modify-write, so that it is not reordered after reading the mailbox, see `resetNotified`)
+    thdata->wakeupRequested.exchange(false, std::memory_order_acq_rel);
+
+    if (!conf::DO_USE_MAILBOX || thdata->mailboxOverflow.exchange(false, std::memory_order_acq_rel)) {
+        processAllPorts(thdata);
+    } else {
+        processReadyPorts(thdata);
+    }
+}
+
+void QueuePool::processAllPorts(ThreadData* thdata)
+{
+    // the notifications are not needed, we'll process everything
+    std::shared_ptr<Port> port;
+    while (thdata->mailbox.tryPop(port)) {
+        port->resetNotified();
+    }
+
+    for (size_t i = 0; i < thdata->ports.size(); ++i) {
+        thdata->ports.at(i)->resetNotified();
+    }
+
     for (size_t i = 0; i < thdata->ports.size(); ++i) {
         std::shared_ptr<Port>& port = thdata->ports.at(i);
         port->process();
+        if (port->hasPending()) {
+            notify(thdata->threadId, port);
+        }
     }
 }
+
+void QueuePool::processReadyPorts(ThreadData* thdata)
+{
+    //! NOTE Can be called recursively (from a message handler),
+    //! so we take the buffer and return it back after use
+    std::vector<std::shared_ptr<Port> > ready;
+    ready.swap(thdata->readyBuffer);
+
+    thdata->mailbox.tryPopAll(ready);
+
+    for (const std::shared_ptr<Port>& port : ready) {
+        // reset before processing, so messages sent during processing will notify again
+        port->resetNotified();
+
+        // the port could have been unregistered after notification,
+        // then the queue may be already destroyed
+        if (!isRegistered(thdata, port)) {
+            continue;
+        }
+
+        port->process();
+
+        // couldn't send all (the receiver's queue is full), we'll try again next time
+        if (port->hasPending()) {
+            notify(thdata->threadId, port);
+        }
+    }
+
+    ready.clear();
+    if (thdata->readyBuffer.empty()) {
+        ready.swap(thdata->readyBuffer);
+    }
+}
+
+bool QueuePool::isRegistered(const ThreadData* thdata, const std::shared_ptr<Port>& port) const
+{
+    const auto& ports = thdata->ports;
+    return std::find(ports.begin(), ports.end(), port) != ports.end();
+}
 } // kors::async
@@ -27,8 +27,11 @@ SOFTWARE.
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <functional>
 
 #include "rpcqueue.h"
+#include "mpscqueue.h"
 
 #include "../asyncable.h"
 
@@ -36,6 +39,8 @@ namespace kors::async {
 struct ICallable {
     virtual ~ICallable() = default;
     virtual void call(const void*) = 0;
+    //! NOTE Called once per message, before calling for each receiver
+    virtual void prepare() {}
     virtual bool tryLock() { return false; }
     virtual void unlock() {}
 };
@@ -57,6 +62,26 @@ public:
     void regPort(const std::thread::id& th, const std::shared_ptr<Port>& port);
     void unregPort(const std::thread::id& th, const std::shared_ptr<Port>& port);
 
+    //! NOTE Registers both ports of the queue,
+    //! the receiver thread will be notified about messages sent to the queue
+    void regQueue(const std::thread::id& sendTh, const std::thread::id& receiveTh, const Queue& queue);
+    void unregQueue(const std::thread::id& sendTh, const std::thread::id& receiveTh, const Queue& queue);
+
+    //! NOTE Sends from the sender thread; if the receiver's queue is full,
+    //! the pending messages will be sent on the processing of the sender thread
+    void send(const std::thread::id& sendTh, const Queue& queue, const CallMsg& msg);
+
+    //! NOTE Puts the port to the mailbox of the thread (can be called from any thread),
+    //! on the next `processMessages` only the notified ports will be processed.
+    //! Repeated notifications of a not yet processed port are coalesced.
+    void notify(const std::thread::id& th, const std::shared_ptr<Port>& port);
+
+    //! NOTE Called (in the notifying thread) when the mailbox of the thread becomes non-empty,
+    //! once per batch, until the next `processMessages` of that thread.
+    //! For example, it can post an event to the event loop of the thread.
+    using Wakeup = std::function<void ()>;
+    void setWakeup(const std::thread::id& th, const Wakeup& wakeup);
+
     void processMessages();
     void processMessages(const std::thread::id& th);
 
@@ -69,10 +94,23 @@ private:
         std::thread::id threadId;
         std::vector<std::shared_ptr<Port> > ports;
         std::recursive_mutex mutex;
+
+        MpscQueue<std::shared_ptr<Port> > mailbox;
+        std::vector<std::shared_ptr<Port> > readyBuffer;
+        std::atomic<bool> mailboxOverflow = false;
+        std::atomic<bool> wakeupRequested = false;
+        std::shared_ptr<const Wakeup> wakeup;
+
+        ThreadData(size_t mailboxCapacity)
+            : mailbox(mailboxCapacity) {}
     };
 
     ThreadData* threadData(const std::thread::id& threadId, bool create);
 
+    void processAllPorts(ThreadData* thdata);
+    void processReadyPorts(ThreadData* thdata);
+    bool isRegistered(const ThreadData* thdata, const std::shared_ptr<Port>& port) const;
+
     std::mutex m_mutex;
     std::vector<ThreadData*> m_threads;
     std::atomic<size_t> m_count = 0;
@@ -23,6 +23,7 @@ SOFTWARE.
 */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <functional>
@@ -74,6 +75,8 @@ private:
     std::vector<T> m_buffer;
     std::queue<T> m_pending;
     std::function<void(const T&)> m_handler;
+    std::function<void()> m_sentHandler;
+    std::atomic<bool> m_notified = false;
     bool m_isProcessing = false;
 
 public:
@@ -130,37 +133,78 @@ public:
 
     bool sendPending()
     {
-        while (!m_pending.empty()) {
-            const T& item = m_pending.front();
-            bool ok = m_queue.tryPush(item);
-            if (ok) {
-                m_pending.pop();
-            } else {
-                return false;
-            }
+        bool sent = false;
+        bool ok = sendPending_impl(sent);
+        if (sent && m_sentHandler) {
+            m_sentHandler();
         }
-        return true;
+        return ok;
     }
 
     void send(const T& item)
     {
         // try send pending first
-        bool ok = sendPending();
+        bool sent = false;
+        bool ok = sendPending_impl(sent);
 
         // if there are no more pending ones, we send them to the queue
         if (ok) {
             ok = m_queue.tryPush(item);
+            sent = sent || ok;
         }
 
         // If the queue is full, add to the pending
         if (!ok) {
             m_pending.push(item);
         }
+
+        // one notification for everything pushed by this call
+        if (sent && m_sentHandler) {
+            m_sentHandler();
+        }
     }
 
     void onMessage(const std::function<void(const T&)>& handler)
     {
         m_handler = handler;
     }
+
+    //! NOTE Called in the sender thread after messages have been pushed to the queue,
+    //! so the receiver side can be notified that there is something to process
+    void onSent(const std::function<void()>& handler)
+    {
+        m_sentHandler = handler;
+    }
+
+    //! NOTE Coalescing of notifications: returns true only for the first one
+    //! since the last `resetNotified`, so the port is queued for processing once per batch
+    bool tryMarkNotified()
+    {
+        return !m_notified.exchange(true, std::memory_order_acq_rel);
+    }
+
+    //! NOTE A read-modify-write, not a store: the store could be reordered after the following reading
+    //! of the queue (StoreLoad), then a sender could see the flag still set, and its message would be left unprocessed
+    void resetNotified()
+    {
+        m_notified.exchange(false, std::memory_order_acq_rel);
+    }
+
+private:
+
+    bool sendPending_impl(bool& sent)
+    {
+        while (!m_pending.empty()) {
+            const T& item = m_pending.front();
+            bool ok = m_queue.tryPush(item);
+            if (ok) {
+                m_pending.pop();
+                sent = true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
 };
 }
@@ -37,6 +37,13 @@ inline void processMessages(const std::thread::id& th)
     QueuePool::instance()->processMessages(th);
 }
 
+//! NOTE Called (in the sending thread) when there are new messages for the thread,
+//! once until the next `processMessages` of that thread
+inline void setWakeup(const std::thread::id& th, const std::function<void()>& wakeup)
+{
+    QueuePool::instance()->setWakeup(th, wakeup);
+}
+
 inline void terminate()
 {
     conf::terminated = true;
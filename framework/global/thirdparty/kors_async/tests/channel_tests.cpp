@@ -23,6 +23,12 @@ SOFTWARE.
 */
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <iostream>
 
 #include <gtest/gtest.h>
 
@@ -455,3 +461,361 @@ TEST(Channel_Tests, SingleThread_ArgTypes)
     //     ch.send(obj);
     // }
 }
+
+TEST(Channel_Tests, MultiThread_ManySenders)
+{
+    Channel<int, int> ch(ChannelOpt().threads(8));
+
+    const int sendersCount = 4;
+    const int count = 1000;
+
+    std::vector<int> next(sendersCount, 0);
+    int received = 0;
+    ch.onReceive(nullptr, [&next, &received](const int& sender, const int& val) {
+        // main thread, the order of each sender is preserved
+        EXPECT_EQ(val, next[sender]);
+        next[sender] = val + 1;
+        ++received;
+    });
+
+    std::vector<std::thread> senders;
+    for (int i = 0; i < sendersCount; ++i) {
+        senders.emplace_back([](Channel<int, int> ch, int sender) {
+            for (int v = 0; v < count; ++v) {
+                ch.send(sender, v);
+            }
+        }, ch, i);
+    }
+
+    // emulate an event loop in the main thread
+    const std::thread::id thisThId = std::this_thread::get_id();
+    int iteration = 0;
+    while (received < sendersCount * count && iteration < 5000) { // anti freeze
+        ++iteration;
+        async::processMessages(thisThId);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (std::thread& t : senders) {
+        t.join();
+    }
+
+    EXPECT_EQ(received, sendersCount * count);
+}
+
+TEST(Channel_Tests, MultiThread_Coalesce)
+{
+    Channel<int> ch(ChannelOpt().coalesce());
+
+    std::vector<int> received;
+    ch.onReceive(nullptr, [&received](const int& val) {
+        // main thread
+        received.push_back(val);
+    });
+
+    //! DO Send several values before the receiver processes messages
+    auto t1 = std::thread([](Channel<int> ch) {
+        for (int i = 1; i <= 100; ++i) {
+            ch.send(i);
+        }
+    }, ch);
+    t1.join();
+
+    const std::thread::id thisThId = std::this_thread::get_id();
+    async::processMessages(thisThId);
+
+    //! CHECK Only the latest value is received
+    ASSERT_EQ(received.size(), 1);
+    EXPECT_EQ(received.at(0), 100);
+
+    //! DO Send again
+    auto t2 = std::thread([](Channel<int> ch) {
+        ch.send(101);
+    }, ch);
+    t2.join();
+
+    async::processMessages(thisThId);
+
+    //! CHECK
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_EQ(received.at(1), 101);
+
+    //! CHECK Nothing more
+    async::processMessages(thisThId);
+    EXPECT_EQ(received.size(), 2);
+}
+
+TEST(Channel_Tests, MultiThread_WakeupPerBatch)
+{
+    Channel<int> ch;
+
+    int received = 0;
+    ch.onReceive(nullptr, [&received](const int&) {
+        // main thread
+        ++received;
+    });
+
+    const std::thread::id thisThId = std::this_thread::get_id();
+    std::atomic<int> wakeups = 0;
+    async::setWakeup(thisThId, [&wakeups]() {
+        ++wakeups;
+    });
+
+    // reset the state left by the previous messages
+    async::processMessages(thisThId);
+
+    auto sendAll = [](Channel<int> ch) {
+        for (int i = 0; i < 100; ++i) {
+            ch.send(i);
+        }
+    };
+
+    //! DO Send a batch
+    std::thread(sendAll, ch).join();
+
+    //! CHECK One wakeup for the batch
+    EXPECT_EQ(wakeups.load(), 1);
+
+    async::processMessages(thisThId);
+    EXPECT_EQ(received, 100);
+
+    //! DO Send the next batch
+    std::thread(sendAll, ch).join();
+    async::processMessages(thisThId);
+
+    //! CHECK
+    EXPECT_EQ(wakeups.load(), 2);
+    EXPECT_EQ(received, 200);
+
+    async::setWakeup(thisThId, nullptr);
+}
+
+TEST(Channel_Tests, MultiThread_Wakeup_NotLost)
+{
+    //! NOTE Stress test: the receiver processes messages only when it is woken up,
+    //! so a notification lost between resetting the flags and reading the queue stalls it
+    const int sendersCount = 4;
+    const int count = 20000; // per sender
+
+    std::vector<Channel<int> > channels(sendersCount);
+    std::vector<std::atomic<int> > received(sendersCount);
+    for (int i = 0; i < sendersCount; ++i) {
+        channels[i].onReceive(nullptr, [&received, i](const int&) {
+            // main thread
+            ++received[i];
+        });
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool woken = false;
+
+    const std::thread::id thisThId = std::this_thread::get_id();
+    async::setWakeup(thisThId, [&]() {
+        {
+            std::lock_guard lock(mutex);
+            woken = true;
+        }
+        cv.notify_one();
+    });
+
+    // reset the state left by the previous messages
+    async::processMessages(thisThId);
+
+    //! DO Each sender sends the next message as soon as the previous one is received,
+    //! that is, right while the receiver is still processing
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> senders;
+    for (int s = 0; s < sendersCount; ++s) {
+        senders.emplace_back([&received, &stop, s](Channel<int> ch) {
+            for (int i = 0; i < count && !stop.load(); ++i) {
+                ch.send(i);
+                while (received[s].load() <= i && !stop.load()) {
+                    std::this_thread::yield();
+                }
+            }
+        }, channels[s]);
+    }
+
+    auto receivedTotal = [&received]() {
+        int total = 0;
+        for (const std::atomic<int>& r : received) {
+            total += r.load();
+        }
+        return total;
+    };
+
+    bool lost = false;
+    while (receivedTotal() < sendersCount * count) {
+        std::unique_lock lock(mutex);
+        if (!cv.wait_for(lock, std::chrono::seconds(2), [&woken]() { return woken; })) {
+            lost = true;
+            break;
+        }
+        woken = false;
+        lock.unlock();
+
+        async::processMessages(thisThId);
+    }
+
+    stop = true;
+    for (std::thread& t : senders) {
+        t.join();
+    }
+    async::setWakeup(thisThId, nullptr);
+
+    //! CHECK Every message was delivered by a wakeup
+    EXPECT_FALSE(lost) << "received: " << receivedTotal();
+    EXPECT_EQ(receivedTotal(), sendersCount * count);
+}
+
+static void channelBenchmark(size_t producersCount, size_t receiversCount, size_t idleChannelsCount)
+{
+    using clock = std::chrono::steady_clock;
+    const size_t count = 10000; // per producer
+    const size_t burst = 50;
+    const size_t threads = producersCount + receiversCount;
+
+    Channel<int64_t> ch(ChannelOpt().threads(threads).disableWaitPendingsOnSend());
+
+    //! NOTE Other channels, that have subscribers in the receiver threads,
+    //! but don't send anything while measuring (like most channels in an application)
+    std::vector<Channel<int64_t> > idle;
+    for (size_t i = 0; i < idleChannelsCount; ++i) {
+        idle.emplace_back(ChannelOpt().threads(threads));
+    }
+
+    std::atomic<size_t> ready = 0;
+    std::atomic<size_t> receiversDone = 0;
+    std::atomic<bool> start = false;
+    std::vector<std::vector<int64_t> > latencies(receiversCount);
+    std::atomic<int64_t> idleProcessNs = 0;
+
+    std::vector<std::thread> receivers;
+    for (size_t r = 0; r < receiversCount; ++r) {
+        receivers.emplace_back([&, r]() {
+            std::vector<int64_t>& lat = latencies[r];
+            lat.reserve(producersCount * count);
+
+            Asyncable asyncable;
+            ch.onReceive(&asyncable, [&lat](const int64_t& sent) {
+                lat.push_back(clock::now().time_since_epoch().count() - sent);
+            });
+            for (Channel<int64_t>& c : idle) {
+                c.onReceive(&asyncable, [](const int64_t&) {});
+            }
+            ++ready;
+
+            const std::thread::id thisThId = std::this_thread::get_id();
+            const clock::time_point deadline = clock::now() + std::chrono::seconds(30);
+            while (lat.size() < producersCount * count && clock::now() < deadline) {
+                async::processMessages(thisThId);
+                std::this_thread::yield();
+            }
+
+            // the cost of the processing, when there is nothing to process
+            async::processMessages(thisThId);
+            const size_t idleCalls = 10000;
+            clock::time_point idleBegin = clock::now();
+            for (size_t i = 0; i < idleCalls; ++i) {
+                async::processMessages(thisThId);
+            }
+            idleProcessNs += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - idleBegin).count()
+                             / static_cast<int64_t>(idleCalls * receiversCount);
+            ch.disconnect(&asyncable);
+            for (Channel<int64_t>& c : idle) {
+                c.disconnect(&asyncable);
+            }
+            ++receiversDone;
+        });
+    }
+
+    while (ready.load() < receiversCount) {
+        std::this_thread::yield();
+    }
+
+    std::atomic<int64_t> sendNs = 0;
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < producersCount; ++p) {
+        producers.emplace_back([&]() {
+            // create queues (ports) of idle channels
+            for (Channel<int64_t>& c : idle) {
+                c.send(0);
+            }
+
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+
+            // bursts of messages, like an event loop does
+            for (size_t i = 0; i < count; i += burst) {
+                clock::time_point begin = clock::now();
+                for (size_t j = 0; j < burst; ++j) {
+                    ch.send(clock::now().time_since_epoch().count());
+                }
+                sendNs += std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin).count();
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+
+            // sending the pending messages, until the receivers have taken everything
+            const std::thread::id thisThId = std::this_thread::get_id();
+            while (receiversDone.load() < receiversCount) {
+                async::processMessages(thisThId);
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    start = true;
+
+    for (std::thread& t : producers) {
+        t.join();
+    }
+
+    for (std::thread& t : receivers) {
+        t.join();
+    }
+
+    std::vector<int64_t> all;
+    for (const std::vector<int64_t>& lat : latencies) {
+        all.insert(all.end(), lat.begin(), lat.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    EXPECT_EQ(all.size(), producersCount * receiversCount * count);
+    if (all.empty()) {
+        return;
+    }
+
+    auto percentileUs = [&all](double p) {
+        size_t idx = std::min(all.size() - 1, static_cast<size_t>(p * static_cast<double>(all.size())));
+        return std::chrono::duration_cast<std::chrono::microseconds>(clock::duration(all.at(idx))).count();
+    };
+
+    const double sendsPerSec = static_cast<double>(producersCount * count) / (static_cast<double>(sendNs.load()) / producersCount / 1e9);
+
+    std::cout << (conf::DO_USE_MAILBOX ? "mailbox" : "all ports")
+              << ", producers: " << producersCount << ", receivers: " << receiversCount
+              << ", idle channels: " << idleChannelsCount
+              << ", sends/sec: " << static_cast<int64_t>(sendsPerSec)
+              << ", latency p50: " << percentileUs(0.5) << " us"
+              << ", p99: " << percentileUs(0.99) << " us"
+              << ", max: " << percentileUs(1.0) << " us"
+              << ", idle processMessages: " << idleProcessNs.load() << " ns" << std::endl;
+}
+
+TEST(Channel_Tests, DISABLED_Benchmark_ProducersReceivers)
+{
+    const bool useMailbox = conf::DO_USE_MAILBOX;
+
+    for (bool mailbox : { false, true }) {
+        conf::DO_USE_MAILBOX = mailbox;
+        for (size_t producers : { 1, 4 }) {
+            for (size_t receivers : { 1, 2 }) {
+                channelBenchmark(producers, receivers, 200);
+            }
+        }
+    }
+
+    conf::DO_USE_MAILBOX = useMailbox;
+}
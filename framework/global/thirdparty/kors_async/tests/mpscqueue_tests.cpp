@@ -0,0 +1,135 @@
+/*
+MIT License
+
+Copyright (c) 2025 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <thread>
+#include <vector>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "../async/internal/mpscqueue.h"
+
+using namespace kors::async;
+
+struct ProducerMsg {
+    int producer = 0;
+    int val = 0;
+};
+
+TEST(MpscQueue_Tests, MultiProducers)
+{
+    MpscQueue<ProducerMsg> q(100);
+
+    // next power of two
+    EXPECT_EQ(q.capacity(), 128);
+
+    const int producersCount = 4;
+    const int count = 10000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producersCount; ++p) {
+        producers.emplace_back([&q, p]() {
+            for (int i = 0; i < count; ++i) {
+                ProducerMsg m { p, i };
+                while (!q.tryPush(m)) { // full, waiting for the consumer
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // the order of each producer is preserved
+    std::vector<int> next(producersCount, 0);
+    int received = 0;
+    int iteration = 0;
+    while (received < producersCount * count && iteration < 10000000) { // anti freeze
+        ++iteration;
+        ProducerMsg m;
+        if (q.tryPop(m)) {
+            EXPECT_EQ(m.val, next[m.producer]);
+            next[m.producer] = m.val + 1;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    for (std::thread& t : producers) {
+        t.join();
+    }
+
+    EXPECT_EQ(received, producersCount * count);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(MpscQueue_Tests, Full)
+{
+    MpscQueue<ProducerMsg> q(10);
+
+    // next power of two
+    EXPECT_EQ(q.capacity(), 16);
+
+    for (int i = 0; i < 17; ++i) {
+        bool ok = q.tryPush(ProducerMsg { 0, i });
+        if (i < 16) {
+            EXPECT_TRUE(ok);
+        } else {
+            EXPECT_FALSE(ok);
+        }
+    }
+
+    // after read, the cells can be reused
+    ProducerMsg m;
+    EXPECT_TRUE(q.tryPop(m));
+    EXPECT_EQ(m.val, 0);
+    EXPECT_TRUE(q.tryPush(ProducerMsg { 0, 16 }));
+    EXPECT_FALSE(q.tryPush(ProducerMsg { 0, 17 }));
+
+    std::vector<ProducerMsg> out;
+    EXPECT_EQ(q.tryPopAll(out), 16);
+    for (size_t i = 0; i < out.size(); ++i) {
+        EXPECT_EQ(out.at(i).val, i + 1);
+    }
+
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.tryPop(m));
+}
+
+TEST(MpscQueue_Tests, MinCapacity)
+{
+    MpscQueue<ProducerMsg> q(1);
+    EXPECT_EQ(q.capacity(), 2);
+
+    for (int lap = 0; lap < 10; ++lap) {
+        EXPECT_TRUE(q.tryPush(ProducerMsg { 0, lap }));
+        EXPECT_TRUE(q.tryPush(ProducerMsg { 0, lap + 1 }));
+        EXPECT_FALSE(q.tryPush(ProducerMsg { 0, lap + 2 }));
+
+        ProducerMsg m;
+        EXPECT_TRUE(q.tryPop(m));
+        EXPECT_EQ(m.val, lap);
+        EXPECT_TRUE(q.tryPop(m));
+        EXPECT_EQ(m.val, lap + 1);
+        EXPECT_FALSE(q.tryPop(m));
+    }
+}
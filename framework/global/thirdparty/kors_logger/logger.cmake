@@ -6,6 +6,8 @@ set(KORS_LOGGER_SRC
     ${CMAKE_CURRENT_LIST_DIR}/src/logger.h
     ${CMAKE_CURRENT_LIST_DIR}/src/logdefdest.cpp
     ${CMAKE_CURRENT_LIST_DIR}/src/logdefdest.h
+    ${CMAKE_CURRENT_LIST_DIR}/src/logasync.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/src/logasync.h
     ${CMAKE_CURRENT_LIST_DIR}/src/funcinfo.h
 )
 
@@ -0,0 +1,499 @@
+/*
+MIT License
+
+Copyright (c) 2026 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*/
+#include "logasync.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace kors::logger;
+
+static constexpr std::chrono::milliseconds DRAIN_INTERVAL(10);
+static constexpr int CRASH_WAIT_ATTEMPTS = 100; // ms
+static constexpr size_t CRASH_MAX_RINGS = 64;
+
+static size_t nextPowerOfTwo(size_t n)
+{
+    size_t p = 2;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Ring ---------------------------------
+
+struct LogAsyncWriter::Ring
+{
+    std::vector<Record> records;
+    const size_t mask;
+
+    alignas(64) std::atomic<size_t> writePos = 0;
+    alignas(64) std::atomic<size_t> readPos = 0;
+
+    std::atomic<bool> closed = false;
+
+    explicit Ring(size_t capacity)
+        : records(nextPowerOfTwo(capacity)), mask(records.size() - 1) {}
+
+    // producer
+    bool tryPush(Record& r)
+    {
+        const size_t w = writePos.load(std::memory_order_relaxed);
+        const size_t rd = readPos.load(std::memory_order_acquire);
+        if (w - rd >= records.size()) {
+            return false;
+        }
+
+        records[w & mask] = std::move(r);
+        writePos.store(w + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_acquire);
+    }
+
+    // consumer
+    size_t popAll(std::vector<Record>& out, size_t limit = SIZE_MAX)
+    {
+        const size_t rd = readPos.load(std::memory_order_relaxed);
+        const size_t w = rd + std::min(writePos.load(std::memory_order_acquire) - rd, limit);
+        for (size_t i = rd; i < w; ++i) {
+            out.push_back(std::move(records[i & mask]));
+        }
+        readPos.store(w, std::memory_order_release);
+        return w - rd;
+    }
+};
+
+// trivially destructible, so it is valid until the very end of the thread
+static thread_local bool s_threadRingDestroyed = false;
+
+//! NOTE The ring of the current thread, it is closed on the thread exit
+//! and removed by the drain thread after the last records are written
+struct LogAsyncWriter::ThreadRing
+{
+    std::shared_ptr<Ring> ring;
+    uint64_t writerId = 0;
+
+    ~ThreadRing()
+    {
+        s_threadRingDestroyed = true;
+        if (ring) {
+            ring->closed.store(true, std::memory_order_release);
+        }
+    }
+};
+
+// LogAsyncWriter ---------------------------------
+
+static uint64_t nextWriterId()
+{
+    static std::atomic<uint64_t> lastId = 0;
+    return ++lastId;
+}
+
+LogAsyncWriter::LogAsyncWriter(size_t capacity, OverflowPolicy policy, const Writer& writer)
+    : m_capacity(nextPowerOfTwo(capacity)), m_policy(policy), m_id(nextWriterId()), m_writer(writer)
+{
+}
+
+LogAsyncWriter::~LogAsyncWriter()
+{
+    stop();
+}
+
+void LogAsyncWriter::start()
+{
+    if (m_running.load()) {
+        return;
+    }
+
+    m_running.store(true);
+    m_thread = std::thread([this]() { run(); });
+    m_threadId = m_thread.get_id();
+}
+
+void LogAsyncWriter::stop()
+{
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_threadId = std::thread::id();
+
+    // records pushed while stopping
+    drain();
+}
+
+bool LogAsyncWriter::isRunning() const
+{
+    return m_running.load();
+}
+
+size_t LogAsyncWriter::capacity() const
+{
+    return m_capacity;
+}
+
+OverflowPolicy LogAsyncWriter::overflowPolicy() const
+{
+    return m_policy;
+}
+
+LogAsyncWriter::Ring* LogAsyncWriter::threadRing()
+{
+    // logging from destructors of other thread local or static objects
+    if (s_threadRingDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadRing th;
+    if (th.writerId != m_id || !th.ring) {
+        if (th.ring) {
+            th.ring->closed.store(true, std::memory_order_release);
+        }
+
+        if (!enterRings()) {
+            return nullptr;
+        }
+
+        th.ring = std::make_shared<Ring>(m_capacity);
+        th.writerId = m_id;
+
+        {
+            std::lock_guard lock(m_ringsMutex);
+            m_rings.push_back(th.ring);
+        }
+
+        leaveRings();
+    }
+    return th.ring.get();
+}
+
+bool LogAsyncWriter::push(LogMsg&& msg)
+{
+    if (!m_running.load(std::memory_order_acquire) || m_crashing.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // a destination is logging
+    if (std::this_thread::get_id() == m_threadId) {
+        return false;
+    }
+
+    Ring* ring = threadRing();
+    if (!ring) {
+        return false;
+    }
+
+    Record r;
+    r.seq = m_seq.fetch_add(1, std::memory_order_relaxed);
+    r.tag.assign(msg.tag);
+    r.msg = std::move(msg);
+
+    if (ring->tryPush(r)) {
+        // don't wait for the interval, if the ring is filling up
+        if (ring->size() == m_capacity / 2) {
+            wake();
+        }
+        return true;
+    }
+
+    switch (m_policy) {
+    case OverflowPolicy::Block: {
+        while (!ring->tryPush(r)) {
+            if (!m_running.load(std::memory_order_acquire)) {
+                // `seq` is taken, so let's count it as done for the flush
+                ++m_done;
+                msg = std::move(r.msg);
+                return false;
+            }
+            wake();
+            std::this_thread::yield();
+        }
+    } break;
+    case OverflowPolicy::CountAndReport:
+        ++m_unreported;
+        [[fallthrough]];
+    case OverflowPolicy::Drop:
+        ++m_dropped;
+        ++m_done;
+        break;
+    }
+
+    return true;
+}
+
+void LogAsyncWriter::wake()
+{
+    {
+        std::lock_guard lock(m_wakeMutex);
+        m_wakeRequested = true;
+    }
+    m_wakeCv.notify_one();
+}
+
+void LogAsyncWriter::run()
+{
+    while (m_running.load()) {
+        {
+            std::unique_lock lock(m_wakeMutex);
+            m_wakeCv.wait_for(lock, DRAIN_INTERVAL, [this]() { return m_wakeRequested || !m_running.load(); });
+            m_wakeRequested = false;
+        }
+
+        drain();
+    }
+
+    drain();
+}
+
+void LogAsyncWriter::drain()
+{
+    std::lock_guard lock(m_drainMutex);
+    drainLocked();
+}
+
+bool LogAsyncWriter::enterRings()
+{
+    //! NOTE Both are seq_cst: either the crash path sees the counter, or this one sees the flag
+    m_ringsBusy.fetch_add(1);
+    if (m_crashing.load()) {
+        m_ringsBusy.fetch_sub(1);
+        return false;
+    }
+    return true;
+}
+
+void LogAsyncWriter::leaveRings()
+{
+    m_ringsBusy.fetch_sub(1);
+}
+
+void LogAsyncWriter::drainLocked()
+{
+    m_records.clear();
+
+    if (!enterRings()) {
+        return;
+    }
+
+    {
+        std::lock_guard lock(m_ringsMutex);
+        for (auto it = m_rings.begin(); it != m_rings.end();) {
+            Ring* ring = it->get();
+
+            // check before reading, the thread could push its last records right before closing
+            const bool closed = ring->closed.load(std::memory_order_acquire);
+            ring->popAll(m_records);
+            if (closed) {
+                it = m_rings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    leaveRings();
+
+    const uint64_t unreported = m_unreported.exchange(0);
+
+    if (m_records.empty() && unreported == 0) {
+        return;
+    }
+
+    // the rings are filled concurrently, let's restore the order of the calls
+    std::sort(m_records.begin(), m_records.end(), [](const Record& r1, const Record& r2) {
+        return r1.seq < r2.seq;
+    });
+
+    m_batch.clear();
+    m_batch.reserve(m_records.size() + 1);
+    for (Record& r : m_records) {
+        // `m_records` is kept until the batch is written
+        r.msg.tag = r.tag;
+        m_batch.push_back(std::move(r.msg));
+    }
+
+    if (unreported > 0) {
+        LogMsg report(Logger::WARN, "Logger", Color::Yellow,
+                      "log queue overflow, dropped messages: " + std::to_string(unreported));
+        m_batch.push_back(std::move(report));
+    }
+
+    if (m_writer) {
+        m_writer(m_batch);
+    }
+
+    const size_t written = m_records.size();
+    m_records.clear();
+    m_batch.clear();
+
+    {
+        std::lock_guard lock(m_flushMutex);
+        m_done += written;
+    }
+    m_flushCv.notify_all();
+}
+
+void LogAsyncWriter::flush()
+{
+    const uint64_t target = m_seq.load();
+    if (m_done.load() >= target) {
+        return;
+    }
+
+    if (!m_running.load() || std::this_thread::get_id() == m_threadId) {
+        drain();
+        return;
+    }
+
+    wake();
+
+    std::unique_lock lock(m_flushMutex);
+    while (m_done.load() < target && m_running.load() && !m_crashing.load()) {
+        // the interval, just in case, if the wakeup is missed
+        m_flushCv.wait_for(lock, DRAIN_INTERVAL);
+    }
+}
+
+static void crashSleep()
+{
+#ifdef _WIN32
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+#else
+    timespec ts { 0, 1000000 };
+    nanosleep(&ts, nullptr);
+#endif
+}
+
+static bool crashWriteAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+#ifdef _WIN32
+        const int n = _write(fd, data, static_cast<unsigned int>(size));
+#else
+        const ssize_t n = ::write(fd, data, size);
+#endif
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+size_t LogAsyncWriter::crashWrite(int fd)
+{
+    //! NOTE Only atomics, nanosleep and write(2) here. After the flag is set, the drains and the ring registrations
+    //! don't touch the rings, so they are read in place: the producers don't overwrite the unread records.
+    //! The records already taken by the drain thread are left to it.
+    if (m_crashing.exchange(true)) {
+        return 0;
+    }
+
+    int attempts = 0;
+    while (m_ringsBusy.load() != 0) {
+        if (++attempts > CRASH_WAIT_ATTEMPTS) {
+            return 0;
+        }
+        crashSleep();
+    }
+
+    Ring* rings[CRASH_MAX_RINGS];
+    size_t pos[CRASH_MAX_RINGS];
+    size_t end[CRASH_MAX_RINGS];
+    size_t count = 0;
+    for (const std::shared_ptr<Ring>& ring : m_rings) {
+        if (count == CRASH_MAX_RINGS) {
+            break;
+        }
+        rings[count] = ring.get();
+        pos[count] = ring->readPos.load(std::memory_order_relaxed);
+        end[count] = ring->writePos.load(std::memory_order_acquire);
+        ++count;
+    }
+
+    static constexpr char SEPARATOR[] = " | ";
+    static constexpr char NEWLINE[] = "\n";
+
+    // the rings are filled concurrently, let's restore the order of the calls
+    size_t written = 0;
+    while (true) {
+        const Record* next = nullptr;
+        size_t nextRing = 0;
+        for (size_t i = 0; i < count; ++i) {
+            if (pos[i] == end[i]) {
+                continue;
+            }
+            const Record& r = rings[i]->records[pos[i] & rings[i]->mask];
+            if (!next || r.seq < next->seq) {
+                next = &r;
+                nextRing = i;
+            }
+        }
+
+        if (!next) {
+            break;
+        }
+        ++pos[nextRing];
+
+        const bool ok = crashWriteAll(fd, next->msg.type.data(), next->msg.type.size())
+                        && crashWriteAll(fd, SEPARATOR, sizeof(SEPARATOR) - 1)
+                        && crashWriteAll(fd, next->tag.data(), next->tag.size())
+                        && crashWriteAll(fd, SEPARATOR, sizeof(SEPARATOR) - 1)
+                        && crashWriteAll(fd, next->msg.message.data(), next->msg.message.size())
+                        && crashWriteAll(fd, NEWLINE, sizeof(NEWLINE) - 1);
+        if (!ok) {
+            break;
+        }
+        ++written;
+    }
+
+    return written;
+}
+
+uint64_t LogAsyncWriter::droppedCount() const
+{
+    return m_dropped.load();
+}
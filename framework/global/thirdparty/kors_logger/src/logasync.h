@@ -0,0 +1,131 @@
+#ifndef KORS_LOGASYNC_H
+/*
+MIT License
+
+Copyright (c) 2026 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+*/
+#define KORS_LOGASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+
+namespace kors::logger {
+//! NOTE Each logging thread pushes records to its own ring (single producer/single consumer, without locks),
+//! a background thread drains all rings, orders records by sequence number and passes them to the writer
+//! (formatting and destinations)
+class LogAsyncWriter
+{
+public:
+    using Writer = std::function<void (const std::vector<LogMsg>& batch)>;
+
+    LogAsyncWriter(size_t capacity, OverflowPolicy policy, const Writer& writer);
+    ~LogAsyncWriter();
+
+    LogAsyncWriter(const LogAsyncWriter&) = delete;
+    LogAsyncWriter& operator=(const LogAsyncWriter&) = delete;
+
+    void start();
+    //! NOTE Writes all pushed records and stops the thread
+    void stop();
+    bool isRunning() const;
+
+    size_t capacity() const;
+    OverflowPolicy overflowPolicy() const;
+
+    //! NOTE Returns false if the record must be written synchronously
+    //! (not running, or called from the drain thread itself)
+    bool push(LogMsg&& msg);
+
+    //! NOTE Blocks until all records pushed before the call are written
+    void flush();
+
+    //! NOTE For a fatal signal handler, async-signal-safe: stops the drains and writes the queued records
+    //! (type, tag and message) to the file descriptor with write(2), without the destinations, allocations and locks.
+    //! Gives up if the rings are busy (drained or registered) for a long time, for example, by the crashed thread.
+    //! Returns the number of written records
+    size_t crashWrite(int fd);
+
+    uint64_t droppedCount() const;
+
+private:
+    //! NOTE The tag of the message is a view, it may point to a temporary string (for example, LOGE_T(tag.toStdString())),
+    //! so the record owns a copy, and the tag of the message is pointed to it just before writing
+    struct Record {
+        uint64_t seq = 0;
+        std::string tag;
+        LogMsg msg;
+    };
+
+    struct Ring;
+    struct ThreadRing;
+
+    Ring* threadRing();
+    void wake();
+    void run();
+    void drain();
+    void drainLocked();
+    bool enterRings();
+    void leaveRings();
+
+    const size_t m_capacity;
+    const OverflowPolicy m_policy;
+    const uint64_t m_id;
+    Writer m_writer;
+
+    std::mutex m_ringsMutex;
+    std::vector<std::shared_ptr<Ring> > m_rings;
+
+    std::atomic<bool> m_running = false;
+    std::thread m_thread;
+    std::thread::id m_threadId;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    bool m_wakeRequested = false;
+
+    std::mutex m_drainMutex;
+    std::vector<Record> m_records;
+    std::vector<LogMsg> m_batch;
+
+    std::atomic<uint64_t> m_seq = 0;
+    std::atomic<uint64_t> m_done = 0;     // written or dropped
+    std::atomic<uint64_t> m_dropped = 0;
+    std::atomic<uint64_t> m_unreported = 0;
+
+    //! NOTE The rings are read and registered only while `m_ringsBusy` is not zero,
+    //! and not at all after `m_crashing` is set
+    std::atomic<int> m_ringsBusy = 0;
+    std::atomic<bool> m_crashing = false;
+
+    std::mutex m_flushMutex;
+    std::condition_variable m_flushCv;
+};
+}
+
+#endif // KORS_LOGASYNC_H
@@ -28,8 +28,12 @@ SOFTWARE.
 #include <algorithm>
 #include <cassert>
 #include <cstdarg>
+#include <cerrno>
+#include <csignal>
+#include <iterator>
 
 #include "logdefdest.h"
+#include "logasync.h"
 #include "funcinfo.h"
 
 using namespace kors::logger;
@@ -335,6 +339,11 @@ Logger::~Logger()
 #ifdef KORS_LOGGER_QT_SUPPORT
     setIsCatchQtMsg(false);
 #endif
+    setIsFlushOnCrash(false);
+
+    // write the queued messages
+    setAsync(false);
+
     clearDests();
 }
 
@@ -363,6 +372,32 @@ void Logger::setupDefault()
 }
 
 void Logger::write(const LogMsg& logMsg)
+{
+    if (m_isAsync.load(std::memory_order_acquire)) {
+        write(LogMsg(logMsg));
+        return;
+    }
+
+    writeSync(logMsg);
+}
+
+void Logger::write(LogMsg&& logMsg)
+{
+    if (m_isAsync.load(std::memory_order_acquire)) {
+        if (!isAsseptMsg(logMsg.type)) {
+            return;
+        }
+
+        // the message is moved only if it was queued
+        if (m_async->push(std::move(logMsg))) {
+            return;
+        }
+    }
+
+    writeSync(logMsg);
+}
+
+void Logger::writeSync(const LogMsg& logMsg)
 {
     std::lock_guard locker(m_mutex);
     if (isAsseptMsg(logMsg.type)) {
@@ -372,6 +407,188 @@ void Logger::write(const LogMsg& logMsg)
     }
 }
 
+void Logger::writeBatch(const std::vector<LogMsg>& batch)
+{
+    std::lock_guard locker(m_mutex);
+    for (const LogMsg& logMsg : batch) {
+        for (LogDest* dest : m_dests) {
+            dest->write(logMsg);
+        }
+    }
+}
+
+void Logger::setAsync(bool arg, size_t queueCapacity, OverflowPolicy policy)
+{
+    //! NOTE Should be called on setup, not concurrently with the logging threads
+    if (m_async) {
+        m_isAsync.store(false, std::memory_order_release);
+        m_async->stop();
+    }
+
+    if (!arg) {
+        return;
+    }
+
+    if (!m_async || m_async->capacity() < queueCapacity || m_async->overflowPolicy() != policy) {
+        m_async = std::make_unique<LogAsyncWriter>(queueCapacity, policy, [this](const std::vector<LogMsg>& batch) {
+            writeBatch(batch);
+        });
+    }
+
+    m_async->start();
+    m_isAsync.store(true, std::memory_order_release);
+}
+
+bool Logger::isAsync() const
+{
+    return m_isAsync.load();
+}
+
+uint64_t Logger::droppedCount() const
+{
+    return m_async ? m_async->droppedCount() : 0;
+}
+
+void Logger::flush()
+{
+    if (m_async) {
+        m_async->flush();
+    }
+}
+
+static const int CRASH_SIGNALS[] = {
+    SIGSEGV,
+    SIGABRT,
+    SIGFPE,
+    SIGILL,
+#ifdef SIGBUS
+    SIGBUS,
+#endif
+};
+
+static std::atomic<Logger*> s_crashLogger = nullptr;
+static std::atomic<int> s_crashFd = 2;
+static std::atomic<bool> s_isCrashing = false;
+
+void Logger::crashWrite(int fd)
+{
+    if (m_async) {
+        m_async->crashWrite(fd);
+    }
+}
+
+static void crashWriteOnce()
+{
+    Logger* logger = s_crashLogger.load();
+    if (logger && !s_isCrashing.exchange(true)) {
+        logger->crashWrite(s_crashFd.load());
+    }
+}
+
+#ifdef _WIN32
+using SignalHandler = void (*)(int);
+static SignalHandler s_prevCrashHandlers[std::size(CRASH_SIGNALS)] = {};
+
+static void crashHandler(int sig)
+{
+    crashWriteOnce();
+
+    SignalHandler prev = SIG_DFL;
+    for (size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        if (CRASH_SIGNALS[i] == sig) {
+            prev = s_prevCrashHandlers[i];
+            break;
+        }
+    }
+
+    if (prev && prev != SIG_DFL && prev != SIG_IGN && prev != SIG_ERR) {
+        prev(sig);
+        return;
+    }
+
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+
+static void setCrashHandlers(bool arg)
+{
+    for (size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        if (arg) {
+            s_prevCrashHandlers[i] = std::signal(CRASH_SIGNALS[i], crashHandler);
+        } else {
+            SignalHandler prev = s_prevCrashHandlers[i];
+            std::signal(CRASH_SIGNALS[i], (prev && prev != SIG_ERR) ? prev : SIG_DFL);
+        }
+    }
+}
+
+#else
+static struct sigaction s_prevCrashActions[std::size(CRASH_SIGNALS)] = {};
+
+static void crashHandler(int sig, siginfo_t* info, void* context)
+{
+    const int savedErrno = errno;
+    crashWriteOnce();
+    errno = savedErrno;
+
+    const struct sigaction* prev = nullptr;
+    for (size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        if (CRASH_SIGNALS[i] == sig) {
+            prev = &s_prevCrashActions[i];
+            break;
+        }
+    }
+
+    //! NOTE The previous handler is called as it was installed, for example, crash reporters need the siginfo and the context
+    if (prev && (prev->sa_flags & SA_SIGINFO) && prev->sa_sigaction) {
+        prev->sa_sigaction(sig, info, context);
+        return;
+    }
+
+    if (prev && !(prev->sa_flags & SA_SIGINFO) && prev->sa_handler != SIG_DFL && prev->sa_handler != SIG_IGN) {
+        prev->sa_handler(sig);
+        return;
+    }
+
+    // the default action, the signal is delivered after returning from the handler
+    struct sigaction dfl = {};
+    dfl.sa_handler = SIG_DFL;
+    sigemptyset(&dfl.sa_mask);
+    sigaction(sig, &dfl, nullptr);
+    raise(sig);
+}
+
+static void setCrashHandlers(bool arg)
+{
+    for (size_t i = 0; i < std::size(CRASH_SIGNALS); ++i) {
+        if (arg) {
+            struct sigaction action = {};
+            action.sa_sigaction = crashHandler;
+            action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+            sigemptyset(&action.sa_mask);
+            sigaction(CRASH_SIGNALS[i], &action, &s_prevCrashActions[i]);
+        } else {
+            sigaction(CRASH_SIGNALS[i], &s_prevCrashActions[i], nullptr);
+        }
+    }
+}
+
+#endif
+
+static bool s_isFlushOnCrash = false;
+
+void Logger::setIsFlushOnCrash(bool arg, int fd)
+{
+    s_crashFd.store(fd);
+    if (s_isFlushOnCrash == arg) {
+        return;
+    }
+    s_isFlushOnCrash = arg;
+
+    s_crashLogger.store(arg ? Logger::instance() : nullptr);
+    setCrashHandlers(arg);
+}
+
 bool Logger::isAsseptMsg(const Type& type) const
 {
     return m_level == Level::Full || m_level == Level::Normal || isType(type);
@@ -388,21 +605,30 @@ bool Logger::isType(const Type& type) const
 void Logger::addDest(LogDest* dest)
 {
     assert(dest);
+    std::lock_guard locker(m_mutex);
     m_dests.push_back(dest);
 }
 
 void Logger::removeDest(LogDest* dest)
 {
+    // the queued messages are for this destination too
+    flush();
+
+    std::lock_guard locker(m_mutex);
     m_dests.erase(std::remove(m_dests.begin(), m_dests.end(), dest), m_dests.end());
 }
 
 std::vector<LogDest*> Logger::dests() const
 {
+    std::lock_guard locker(m_mutex);
     return m_dests;
 }
 
 void Logger::clearDests()
 {
+    flush();
+
+    std::lock_guard locker(m_mutex);
     for (LogDest* d : m_dests) {
         delete d;
     }
@@ -29,6 +29,9 @@ SOFTWARE.
 #include <thread>
 #include <vector>
 #include <mutex>
+#include <memory>
+#include <atomic>
+#include <cstdint>
 
 #include "logstream.h"
 
@@ -186,6 +189,15 @@ protected:
 };
 
 //! Logger ---------------------------------
+class LogAsyncWriter;
+
+//! What to do, if the queue of the thread is full in the async mode
+enum class OverflowPolicy {
+    Drop,           // drop the message
+    Block,          // wait for the space in the queue
+    CountAndReport  // drop, and write a warning with the count of dropped messages
+};
+
 class Logger
 {
 public:
@@ -215,6 +227,24 @@ public:
 #endif
 
     void write(const LogMsg& logMsg);
+    void write(LogMsg&& logMsg);
+
+    //! NOTE In the async mode, messages are written to the destinations in a background thread,
+    //! the calling thread only puts the message to its own queue
+    void setAsync(bool arg, size_t queueCapacity = 4096, OverflowPolicy policy = OverflowPolicy::CountAndReport);
+    bool isAsync() const;
+    uint64_t droppedCount() const;
+
+    //! NOTE Waits until all messages are written (in the async mode)
+    void flush();
+
+    //! NOTE Opt-in. On a fatal signal (SIGSEGV, SIGABRT...) writes the queued messages to the file descriptor
+    //! (see crashWrite), then the previous handler is called with its own signature (SA_SIGINFO or not)
+    static void setIsFlushOnCrash(bool arg, int fd = 2);
+
+    //! NOTE Async-signal-safe, for fatal signal handlers: writes the queued messages (type, tag and message)
+    //! to the file descriptor with write(2), without formatting, allocations and locks
+    void crashWrite(int fd);
 
     void addDest(LogDest* dest);
     void removeDest(LogDest* dest);
@@ -229,10 +259,16 @@ private:
     static void logMsgHandler(QtMsgType, const QMessageLogContext&, const QString&);
 #endif
 
+    void writeSync(const LogMsg& logMsg);
+    void writeBatch(const std::vector<LogMsg>& batch);
+
     Level m_level = Level::Normal;
     std::vector<LogDest*> m_dests;
     std::vector<Type> m_types;
-    std::mutex m_mutex;
+    mutable std::mutex m_mutex;
+
+    std::unique_ptr<LogAsyncWriter> m_async;
+    std::atomic<bool> m_isAsync = false;
 };
 
 //! LogInput ---------------------------------
@@ -245,7 +281,7 @@ public:
     ~LogInput()
     {
         m_msg.message = m_stream.str();
-        Logger::instance()->write(m_msg);
+        Logger::instance()->write(std::move(m_msg));
     }
 
     inline Stream& stream() { return m_stream; }
@@ -24,10 +24,11 @@ SOFTWARE.
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <shared_mutex>
 #include <string_view>
+#include <vector>
 
 #include "context.h"
 #include "modulesioc.h"
@@ -138,33 +139,92 @@ class ThreadSafeInjectBase : public InjectBase<I>
 public:
     using InjectBase<I>::InjectBase;
 
-    const std::shared_ptr<I>& get() const
+    //! NOTE After the first resolve, access is an acquire load and a copy of the shared_ptr, without locks.
+    //! The resolved pointer is published atomically and republished when the service changes
+    //! (register, unregister, reset or context teardown).
+    //! Returned by value: the service stays alive while the caller holds it, whatever changes happen.
+    std::shared_ptr<I> get() const
     {
-        {
-            std::shared_lock lock(m_mutex);
-            if (InjectBase<I>::m_i) {
-                return InjectBase<I>::m_i;
+        const Resolved* r = m_resolved.load(std::memory_order_acquire);
+        while (r) {
+            std::shared_ptr<I> p = r->p.lock();
+            if (p) {
+                return p;
+            }
+
+            // the service is being changed
+            const Resolved* next = m_resolved.load(std::memory_order_acquire);
+            if (next == r) {
+                break;
             }
+            r = next;
         }
 
-        std::unique_lock lock(m_mutex);
-        return InjectBase<I>::get();
+        return resolve();
     }
 
     /// For testing purposes.
     void set(std::shared_ptr<I> impl)
     {
-        std::unique_lock lock(m_mutex);
+        std::lock_guard lock(m_mutex);
         InjectBase<I>::set(impl);
+        publish(impl);
     }
 
-    const std::shared_ptr<I>& operator()() const
+    std::shared_ptr<I> operator()() const
     {
         return get();
     }
 
 private:
-    mutable std::shared_mutex m_mutex;
+
+    //! NOTE Immutable and not deleted until the inject is destroyed, so a reader can always dereference a loaded node.
+    //! It doesn't own the service (the current one is owned by `m_i`), so the old services are released on change,
+    //! only the small nodes remain (the service changes are rare)
+    struct Resolved {
+        std::weak_ptr<I> p;
+    };
+
+    std::shared_ptr<I> resolve() const
+    {
+        std::lock_guard lock(m_mutex);
+
+        const Resolved* r = m_resolved.load(std::memory_order_relaxed);
+        if (r) {
+            return InjectBase<I>::m_i;
+        }
+
+        const std::shared_ptr<I>& p = InjectBase<I>::get();
+        if (!p) {
+            return p;
+        }
+
+        //! NOTE Changes come from the ioc, route them through the publication
+        InjectBase<I>::m_subscriber.onChanged = [this](const std::shared_ptr<I>& changed) {
+            std::lock_guard lock(m_mutex);
+            InjectBase<I>::m_i = changed;
+            publish(changed);
+        };
+
+        publish(p);
+        return p;
+    }
+
+    //! NOTE Must be called with locked mutex
+    void publish(const std::shared_ptr<I>& p) const
+    {
+        if (!p) {
+            m_resolved.store(nullptr, std::memory_order_release);
+            return;
+        }
+
+        m_nodes.push_back(std::make_unique<const Resolved>(Resolved { p }));
+        m_resolved.store(m_nodes.back().get(), std::memory_order_release);
+    }
+
+    mutable std::mutex m_mutex;
+    mutable std::atomic<const Resolved*> m_resolved = nullptr;
+    mutable std::vector<std::unique_ptr<const Resolved> > m_nodes;
 };
 
 //! NOTE Global Inject
@@ -76,6 +76,14 @@ public:
 
     virtual ~ModulesIoCBase()
     {
+        //! NOTE Subscribers can outlive the ioc (context teardown),
+        //! they must not unsubscribe from the destroyed ioc
+        for (auto& s : m_map) {
+            for (const auto& d : s.second.onDetaches) {
+                d.second();
+            }
+        }
+
         reset();
     }
 
@@ -127,6 +135,8 @@ public:
     {
         int key = doSubscribe(I::modularity_interfaceInfo(), [s](const std::shared_ptr<IModuleInterface>& p) {
             s->changed(pointer_cast<I>(p));
+        }, [s]() {
+            s->onUnSubscribe = nullptr;
         });
 
         s->onUnSubscribe = [this, key, s]() {
@@ -214,7 +224,8 @@ protected:
     }
 
     using OnChangedInternal = std::function<void (const std::shared_ptr<IModuleInterface>&)>;
-    int doSubscribe(const InterfaceInfo& info, const OnChangedInternal& onChanged)
+    using OnDetachInternal = std::function<void ()>;
+    int doSubscribe(const InterfaceInfo& info, const OnChangedInternal& onChanged, const OnDetachInternal& onDetach)
     {
         auto it = m_map.find(info.id);
         if (it == m_map.end()) {
@@ -224,6 +235,7 @@ protected:
         Service& inj = it->second;
         int key = ++inj.lastKey;
         inj.onChanges.insert({ key, onChanged });
+        inj.onDetaches.insert({ key, onDetach });
 
         return key;
     }
@@ -237,6 +249,7 @@ protected:
 
         Service& inj = it->second;
         inj.onChanges.erase(key);
+        inj.onDetaches.erase(key);
     }
 
     template<class I>
@@ -254,6 +267,7 @@ protected:
         std::shared_ptr<IModuleInterface> p;
         int lastKey = 0;
         std::map<int, OnChangedInternal> onChanges;
+        std::map<int, OnDetachInternal> onDetaches;
     };
 
     std::map<std::string_view, Service > m_map;
@@ -317,6 +331,8 @@ public:
         static_assert(I::modularity_isGlobalInterface(), "The interface must be global.");
         int key = doSubscribe(I::modularity_interfaceInfo(), [s](const std::shared_ptr<IModuleInterface>& p) {
             s->changed(pointer_cast<I>(p));
+        }, [s]() {
+            s->onUnSubscribe = nullptr;
         });
 
         s->onUnSubscribe = [this, key]() {
@@ -383,6 +399,8 @@ public:
         static_assert(!I::modularity_isGlobalInterface(), "The interface must be contextual.");
         int key = doSubscribe(I::modularity_interfaceInfo(), [s](const std::shared_ptr<IModuleInterface>& p) {
             s->changed(pointer_cast<I>(p));
+        }, [s]() {
+            s->onUnSubscribe = nullptr;
         });
 
         s->onUnSubscribe = [this, key]() {
@@ -30,6 +30,8 @@ SOFTWARE.
 #include <limits>
 #include <cmath>
 #include <string>
+#include <string_view>
+#include <algorithm>
 #include <utility>
 #include <type_traits>
 
@@ -147,7 +149,7 @@ struct has_reserve : std::false_type {};
 
 template <typename T>
 struct has_reserve<T, std::void_t<
-        decltype(std::declval<T>().reserve())
+        decltype(std::declval<T&>().reserve(std::declval<size_t>()))
 >> : std::true_type {};
 
 template <typename T, typename = void>
@@ -255,6 +257,38 @@ inline bool unpack_type(Cursor& cursor, bool& value) {
     return true;
 }
 
+// Big-endian helpers
+template<typename T>
+inline void pack_be(std::vector<uint8_t>& data, uint8_t marker, T value) {
+    static_assert(std::is_unsigned<T>::value, "Expected unsigned type");
+
+    uint8_t buf[sizeof(T) + 1];
+    buf[0] = marker;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        buf[sizeof(T) - i] = static_cast<uint8_t>((value >> (i * 8)) & 0xFF);
+    }
+
+    data.insert(data.end(), buf, buf + sizeof(buf));
+}
+
+template<typename T>
+inline T unpack_be(Cursor& cursor) {
+    static_assert(std::is_unsigned<T>::value, "Expected unsigned type");
+
+    if (cursor.remain() < sizeof(T)) {
+        cursor.error = true;
+        return 0;
+    }
+
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((static_cast<uint64_t>(value) << 8) | cursor.current[i]);
+    }
+
+    cursor.current += sizeof(T);
+    return value;
+}
+
 // Int family
 template<typename T>
 inline bool pack_fixint(std::vector<uint8_t>& data, const T& value) {
@@ -300,8 +334,7 @@ inline void pack_type(std::vector<uint8_t>& data, const int8_t& value) {
         return;
     }
 
-    data.emplace_back(int8);
-    data.emplace_back(static_cast<uint8_t>(value));
+    pack_be(data, int8, static_cast<uint8_t>(value));
 }
 
 inline bool unpack_type(Cursor& cursor, int8_t& value) {
@@ -309,7 +342,7 @@ inline bool unpack_type(Cursor& cursor, int8_t& value) {
         return true;
     } else if (cursor.data() == int8) {
         cursor.next();
-        value = static_cast<int8_t>(cursor.read());
+        value = static_cast<int8_t>(unpack_be<uint8_t>(cursor));
         return true;
     }
     return false;
@@ -320,8 +353,7 @@ inline void pack_type(std::vector<uint8_t>& data, const uint8_t& value) {
         return;
     }
 
-    data.emplace_back(uint8);
-    data.emplace_back(value);
+    pack_be(data, uint8, value);
 }
 
 inline bool unpack_type(Cursor& cursor, uint8_t& value) {
@@ -329,7 +361,7 @@ inline bool unpack_type(Cursor& cursor, uint8_t& value) {
         return true;
     } else if (cursor.data() == uint8) {
         cursor.next();
-        value = cursor.read();
+        value = unpack_be<uint8_t>(cursor);
         return true;
     }
     return false;
@@ -345,10 +377,7 @@ inline void pack_type(std::vector<uint8_t>& data, const int16_t& value) {
     if (is_fit_in_type<int8_t>(value)) {
         pack_type(data, static_cast<int8_t>(value));
     } else {
-        data.emplace_back(int16);
-        uint16_t uvalue = static_cast<uint16_t>(value);
-        data.emplace_back(static_cast<uint8_t>((uvalue >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(uvalue & 0xFF));
+        pack_be(data, int16, static_cast<uint16_t>(value));
     }
 }
 
@@ -359,10 +388,7 @@ inline bool unpack_type(Cursor& cursor, int16_t& value) {
         return true;
     } else if (cursor.data() == int16) {
         cursor.next();
-        uint8_t high = cursor.read();
-        uint8_t low = cursor.read();
-        uint16_t uvalue = (static_cast<uint16_t>(high) << 8) | low;
-        value = static_cast<int16_t>(uvalue);
+        value = static_cast<int16_t>(unpack_be<uint16_t>(cursor));
         return true;
     }
 
@@ -373,9 +399,7 @@ inline void pack_type(std::vector<uint8_t>& data, const uint16_t& value) {
     if (is_fit_in_type<uint8_t>(value)) {
         pack_type(data, static_cast<uint8_t>(value));
     } else {
-        data.emplace_back(uint16);
-        data.emplace_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(value & 0xFF));
+        pack_be(data, uint16, value);
     }
 }
 
@@ -386,9 +410,7 @@ inline bool unpack_type(Cursor& cursor, uint16_t& value) {
         return true;
     } else if (cursor.data() == uint16) {
         cursor.next();
-        uint8_t high = cursor.read();
-        uint8_t low = cursor.read();
-        value = (static_cast<uint16_t>(high) << 8) | low;
+        value = unpack_be<uint16_t>(cursor);
         return true;
     }
 
@@ -399,12 +421,7 @@ inline void pack_type(std::vector<uint8_t>& data, const int32_t& value) {
     if (is_fit_in_type<int16_t>(value)) {
         pack_type(data, static_cast<int16_t>(value));
     } else {
-        data.emplace_back(int32);
-        uint32_t uvalue = static_cast<uint32_t>(value);
-        data.emplace_back(static_cast<uint8_t>((uvalue >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((uvalue >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((uvalue >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(uvalue & 0xFF));
+        pack_be(data, int32, static_cast<uint32_t>(value));
     }
 }
 
@@ -415,12 +432,7 @@ inline bool unpack_type(Cursor& cursor, int32_t& value) {
         return true;
     } else if (cursor.data() == int32) {
         cursor.next();
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        value = static_cast<int32_t>(ui32);
+        value = static_cast<int32_t>(unpack_be<uint32_t>(cursor));
         return true;
     }
 
@@ -431,11 +443,7 @@ inline void pack_type(std::vector<uint8_t>& data, const uint32_t& value) {
     if (is_fit_in_type<uint16_t>(value)) {
         pack_type(data, static_cast<uint16_t>(value));
     } else {
-        data.emplace_back(uint32);
-        data.emplace_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(value & 0xFF));
+        pack_be(data, uint32, value);
     }
 }
 
@@ -446,12 +454,7 @@ inline bool unpack_type(Cursor& cursor, uint32_t& value) {
         return true;
     } else if (cursor.data() == uint32) {
         cursor.next();
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        value = ui32;
+        value = unpack_be<uint32_t>(cursor);
         return true;
     }
 
@@ -462,11 +465,7 @@ inline void pack_type(std::vector<uint8_t>& data, const int64_t& value) {
     if (is_fit_in_type<int32_t>(value)) {
         pack_type(data, static_cast<int32_t>(value));
     } else {
-        data.emplace_back(int64);
-        uint64_t uvalue = static_cast<uint64_t>(value);
-        for (int i = 7; i >= 0; --i) {
-            data.emplace_back(static_cast<uint8_t>((uvalue >> (i * 8)) & 0xFF));
-        }
+        pack_be(data, int64, static_cast<uint64_t>(value));
     }
 }
 
@@ -477,12 +476,7 @@ inline bool unpack_type(Cursor& cursor, int64_t& value) {
         return true;
     } else if (cursor.data() == int64) {
         cursor.next();
-        uint64_t ui64 = 0;
-        for (int i = 0; i < 8; ++i) {
-            uint8_t byte = cursor.read();
-            ui64 = (ui64 << 8) | byte;
-        }
-        value = static_cast<int64_t>(ui64);
+        value = static_cast<int64_t>(unpack_be<uint64_t>(cursor));
         return true;
     }
 
@@ -493,10 +487,7 @@ inline void pack_type(std::vector<uint8_t>& data, const uint64_t& value) {
     if (is_fit_in_type<uint32_t>(value)) {
         pack_type(data, static_cast<uint32_t>(value));
     } else {
-        data.emplace_back(uint64);
-        for (int i = 7; i >= 0; --i) {
-            data.emplace_back(static_cast<uint8_t>((value >> (i * 8)) & 0xFF));
-        }
+        pack_be(data, uint64, value);
     }
 }
 
@@ -507,12 +498,7 @@ inline bool unpack_type(Cursor& cursor, uint64_t& value) {
         return true;
     } else if (cursor.data() == uint64) {
         cursor.next();
-        uint64_t ui64 = 0;
-        for (int i = 0; i < 8; ++i) {
-            uint8_t byte = cursor.read();
-            ui64 = (ui64 << 8) | byte;
-        }
-        value = ui64;
+        value = unpack_be<uint64_t>(cursor);
         return true;
     }
 
@@ -522,16 +508,11 @@ inline bool unpack_type(Cursor& cursor, uint64_t& value) {
 // Float/Double
 inline void pack_type(std::vector<uint8_t>& data, const float& value) {
 
-    data.emplace_back(float32);
-
     uint32_t bin = 0;
     static_assert(sizeof(float) == sizeof(uint32_t), "Float size mismatch");
     std::memcpy(&bin, &value, sizeof(float));
 
-    data.emplace_back(static_cast<uint8_t>((bin >> 24) & 0xFF));
-    data.emplace_back(static_cast<uint8_t>((bin >> 16) & 0xFF));
-    data.emplace_back(static_cast<uint8_t>((bin >> 8) & 0xFF));
-    data.emplace_back(static_cast<uint8_t>(bin & 0xFF));
+    pack_be(data, float32, bin);
 }
 
 inline bool unpack_type(Cursor& cursor, float& value) {
@@ -539,11 +520,7 @@ inline bool unpack_type(Cursor& cursor, float& value) {
     if (cursor.data() == float32) {
         cursor.next();
 
-        uint32_t bin = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            bin = (bin << 8) | byte;
-        }
+        uint32_t bin = unpack_be<uint32_t>(cursor);
 
         static_assert(sizeof(float) == sizeof(uint32_t), "Float size mismatch");
         std::memcpy(&value, &bin, sizeof(float));
@@ -556,14 +533,11 @@ inline bool unpack_type(Cursor& cursor, float& value) {
 
 inline void pack_type(std::vector<uint8_t>& data, const double& value) {
 
-    data.emplace_back(float64);
     uint64_t bin = 0;
     static_assert(sizeof(double) == sizeof(uint64_t), "Double size mismatch");
     std::memcpy(&bin, &value, sizeof(double));
 
-    for (int i = 7; i >= 0; --i) {
-        data.emplace_back(static_cast<uint8_t>((bin >> (i * 8)) & 0xFF));
-    }
+    pack_be(data, float64, bin);
 }
 
 inline bool unpack_type(Cursor& cursor, double& value) {
@@ -574,11 +548,7 @@ inline bool unpack_type(Cursor& cursor, double& value) {
     } else if (cursor.data() == float64) {
         cursor.next();
 
-        uint64_t bin = 0;
-        for (int i = 0; i < 8; ++i) {
-            uint8_t byte = cursor.read();
-            bin = (bin << 8) | byte;
-        }
+        uint64_t bin = unpack_be<uint64_t>(cursor);
 
         static_assert(sizeof(double) == sizeof(uint64_t), "Double size mismatch");
         std::memcpy(&value, &bin, sizeof(double));
@@ -589,61 +559,33 @@ inline bool unpack_type(Cursor& cursor, double& value) {
     return false;
 }
 
-// string
-inline void pack_type(std::vector<uint8_t>& data, const std::string& value) {
-
-    const size_t len = value.size();
-
+// Length headers (str, bin, array, map)
+inline bool pack_str_header(std::vector<uint8_t>& data, size_t len) {
     if (len <= 31) {
         data.emplace_back(static_cast<uint8_t>(fixstr | len));
     } else if (len <= 0xFF) {
-        data.emplace_back(str8);
-        data.emplace_back(static_cast<uint8_t>(len));
-    }
-    else if (len <= 0xFFFF) {
-        data.emplace_back(str16);
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
-    }
-    else if (len <= 0xFFFFFFFF) {
-        data.emplace_back(str32);
-        data.emplace_back(static_cast<uint8_t>((len >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
+        pack_be(data, str8, static_cast<uint8_t>(len));
+    } else if (len <= 0xFFFF) {
+        pack_be(data, str16, static_cast<uint16_t>(len));
+    } else if (len <= 0xFFFFFFFF) {
+        pack_be(data, str32, static_cast<uint32_t>(len));
     } else {
         // too long for MessagePack
-        return;
-    }
-
-    data.reserve(data.size() + len + 5);
-    for (char i : value) {
-        data.emplace_back(static_cast<uint8_t>(i));
+        return false;
     }
+    return true;
 }
 
-inline bool unpack_type(Cursor& cursor, std::string& value) {
-
-    size_t len = 0;
+inline bool unpack_str_header(Cursor& cursor, size_t& len) {
     uint8_t marker = cursor.read();
     if ((marker & 0xE0) == fixstr) {
         len = marker & 0x1F;
     } else if (marker == str8) {
-        len = cursor.read();;
+        len = unpack_be<uint8_t>(cursor);
     } else if (marker == str16) {
-        uint16_t ui16 = 0;
-        for (int i = 0; i < 2; ++i) {
-            uint8_t byte = cursor.read();
-            ui16 = (ui16 << 8) | byte;
-        }
-        len = ui16;
+        len = unpack_be<uint16_t>(cursor);
     } else if (marker == str32) {
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        len = ui32;
+        len = unpack_be<uint32_t>(cursor);
     } else {
         // invalid string marker
         return false;
@@ -654,63 +596,31 @@ inline bool unpack_type(Cursor& cursor, std::string& value) {
         return false;
     }
 
-    value = std::string(cursor.pdata(), cursor.pdata() + len);
-    cursor.next(len);
-
-    return true;
+    return !cursor.error;
 }
 
-// bin
-inline void pack_type(std::vector<uint8_t>& data, const std::vector<uint8_t>& value) {
-
-    const size_t len = value.size();
-
+inline bool pack_bin_header(std::vector<uint8_t>& data, size_t len) {
     if (len <= 0xFF) {
-        data.emplace_back(bin8);
-        data.emplace_back(static_cast<uint8_t>(len));
-    }
-    else if (len <= 0xFFFF) {
-        data.emplace_back(bin16);
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
-    }
-    else if (len <= 0xFFFFFFFF) {
-        data.emplace_back(bin32);
-        data.emplace_back(static_cast<uint8_t>((len >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
+        pack_be(data, bin8, static_cast<uint8_t>(len));
+    } else if (len <= 0xFFFF) {
+        pack_be(data, bin16, static_cast<uint16_t>(len));
+    } else if (len <= 0xFFFFFFFF) {
+        pack_be(data, bin32, static_cast<uint32_t>(len));
     } else {
         // too long for MessagePack
-        return;
-    }
-
-    data.reserve(data.size() + len + 5);
-    for (uint8_t i : value) {
-        data.emplace_back(i);
+        return false;
     }
+    return true;
 }
 
-inline bool unpack_type(Cursor& cursor, std::vector<uint8_t>& value) {
-
-    size_t len = 0;
+inline bool unpack_bin_header(Cursor& cursor, size_t& len) {
     uint8_t marker = cursor.read();
     if (marker == bin8) {
-        len = cursor.read();;
+        len = unpack_be<uint8_t>(cursor);
     } else if (marker == bin16) {
-        uint16_t ui16 = 0;
-        for (int i = 0; i < 2; ++i) {
-            uint8_t byte = cursor.read();
-            ui16 = (ui16 << 8) | byte;
-        }
-        len = ui16;
+        len = unpack_be<uint16_t>(cursor);
     } else if (marker == bin32) {
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        len = ui32;
+        len = unpack_be<uint32_t>(cursor);
     } else {
         // invalid bin marker
         return false;
@@ -721,32 +631,158 @@ inline bool unpack_type(Cursor& cursor, std::vector<uint8_t>& value) {
         return false;
     }
 
-    value = std::vector<uint8_t>(cursor.pdata(), cursor.pdata() + len);
-    cursor.next(len);
+    return !cursor.error;
+}
 
+inline bool pack_array_header(std::vector<uint8_t>& data, size_t len) {
+    if (len < 16) {
+        data.emplace_back(uint8_t(fixarray | len));
+    } else if (len <= 0xFFFF) {
+        pack_be(data, array16, static_cast<uint16_t>(len));
+    } else if (len <= 0xFFFFFFFF) {
+        pack_be(data, array32, static_cast<uint32_t>(len));
+    } else {
+        // too long for MessagePack
+        return false;
+    }
     return true;
 }
 
-// array
-template<class T>
-void pack_array(std::vector<uint8_t>& data, const T& array) {
-
-    const size_t len = array.size();
+inline bool unpack_array_header(Cursor& cursor, size_t& len) {
+    uint8_t marker = cursor.read();
+    if ((marker & 0xF0) == fixarray) {
+        len = marker & 0xF;
+    } else if (marker == array16) {
+        len = unpack_be<uint16_t>(cursor);
+    } else if (marker == array32) {
+        len = unpack_be<uint32_t>(cursor);
+    } else {
+        // invalid marker
+        return false;
+    }
+    return !cursor.error;
+}
 
+inline bool pack_map_header(std::vector<uint8_t>& data, size_t len) {
     if (len < 16) {
-        data.emplace_back(uint8_t(fixarray | len));
+        data.emplace_back(uint8_t(fixmap | len));
     } else if (len <= 0xFFFF) {
-        data.emplace_back(array16);
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
+        pack_be(data, map16, static_cast<uint16_t>(len));
     } else if (len <= 0xFFFFFFFF) {
-        data.emplace_back(array32);
-        data.emplace_back(static_cast<uint8_t>((len >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
+        pack_be(data, map32, static_cast<uint32_t>(len));
     } else {
         // too long for MessagePack
+        return false;
+    }
+    return true;
+}
+
+inline bool unpack_map_header(Cursor& cursor, size_t& len) {
+    uint8_t marker = cursor.read();
+    if ((marker & 0xF0) == fixmap) {
+        len = marker & 0xF;
+    } else if (marker == map16) {
+        len = unpack_be<uint16_t>(cursor);
+    } else if (marker == map32) {
+        len = unpack_be<uint32_t>(cursor);
+    } else {
+        // invalid marker
+        return false;
+    }
+    return !cursor.error;
+}
+
+// string
+inline void pack_type(std::vector<uint8_t>& data, const std::string_view& value) {
+
+    if (!pack_str_header(data, value.size())) {
+        return;
+    }
+
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(value.data());
+    data.insert(data.end(), begin, begin + value.size());
+}
+
+inline void pack_type(std::vector<uint8_t>& data, const std::string& value) {
+    pack_type(data, std::string_view(value));
+}
+
+// borrows from the source buffer, valid while the buffer is alive
+inline bool unpack_type(Cursor& cursor, std::string_view& value) {
+
+    size_t len = 0;
+    if (!unpack_str_header(cursor, len)) {
+        return false;
+    }
+
+    value = std::string_view(reinterpret_cast<const char*>(cursor.current), len);
+    cursor.next(len);
+
+    return true;
+}
+
+inline bool unpack_type(Cursor& cursor, std::string& value) {
+
+    std::string_view view;
+    if (!unpack_type(cursor, view)) {
+        return false;
+    }
+
+    value.assign(view.data(), view.size());
+    return true;
+}
+
+// bin
+// the view of bytes, on unpacking borrows from the source buffer, valid while the buffer is alive
+struct BinView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+inline void pack_type(std::vector<uint8_t>& data, const BinView& value) {
+
+    if (!pack_bin_header(data, value.size)) {
+        return;
+    }
+
+    if (value.size > 0) {
+        data.insert(data.end(), value.data, value.data + value.size);
+    }
+}
+
+inline void pack_type(std::vector<uint8_t>& data, const std::vector<uint8_t>& value) {
+    pack_type(data, BinView { value.data(), value.size() });
+}
+
+inline bool unpack_type(Cursor& cursor, BinView& value) {
+
+    size_t len = 0;
+    if (!unpack_bin_header(cursor, len)) {
+        return false;
+    }
+
+    value = BinView { cursor.current, len };
+    cursor.next(len);
+
+    return true;
+}
+
+inline bool unpack_type(Cursor& cursor, std::vector<uint8_t>& value) {
+
+    BinView view;
+    if (!unpack_type(cursor, view)) {
+        return false;
+    }
+
+    value.assign(view.data, view.data + view.size);
+    return true;
+}
+
+// array
+template<class T>
+void pack_array(std::vector<uint8_t>& data, const T& array) {
+
+    if (!pack_array_header(data, array.size())) {
         return;
     }
 
@@ -759,45 +795,37 @@ template<class T>
 inline bool unpack_array(Cursor& cursor, T& array) {
 
     size_t len = 0;
-    uint8_t marker = cursor.read();
-    if ((marker & 0xF0) == fixarray) {
-        len = marker & 0xF;
-    } else if (marker == array16) {
-        uint16_t ui16 = 0;
-        for (int i = 0; i < 2; ++i) {
-            uint8_t byte = cursor.read();
-            ui16 = (ui16 << 8) | byte;
-        }
-        len = ui16;
-    } else if (marker == array32) {
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        len = ui32;
-    } else {
-        // invalid marker
+    if (!unpack_array_header(cursor, len)) {
         return false;
     }
 
     using ValueType = typename T::value_type;
 
     if constexpr (has_reserve<T>::value) {
-        array.reserve(len);
+        // each element takes at least one byte, so a broken length can't reserve more than the data
+        array.reserve(array.size() + std::min(len, cursor.remain()));
     }
 
     for (size_t i = 0; i < len; ++i) {
-        ValueType val{};
-        bool ok = unpack_type(cursor, val);
-        if (!ok) {
-            return false;
-        }
-
-        if constexpr (has_emplace_back<T>::value) {
-            array.emplace_back(std::move(val));
+        if constexpr (has_emplace_back<T>::value && !std::is_same<ValueType, bool>::value) {
+            ValueType& val = array.emplace_back();
+            bool ok = unpack_type(cursor, val);
+            if (!ok) {
+                array.pop_back();
+                return false;
+            }
         } else {
-            array.emplace(std::move(val));
+            ValueType val{};
+            bool ok = unpack_type(cursor, val);
+            if (!ok) {
+                return false;
+            }
+
+            if constexpr (has_emplace_back<T>::value) {
+                array.emplace_back(std::move(val));
+            } else {
+                array.emplace(std::move(val));
+            }
         }
     }
 
@@ -808,22 +836,7 @@ inline bool unpack_array(Cursor& cursor, T& array) {
 template <typename T>
 void pack_map(std::vector<uint8_t>& data, const T& map) {
 
-    const size_t len = map.size();
-
-    if (len < 16) {
-        data.emplace_back(uint8_t(fixmap | len));
-    } else if (len <= 0xFFFF) {
-        data.emplace_back(map16);
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
-    } else if (len <= 0xFFFFFFFF) {
-        data.emplace_back(map32);
-        data.emplace_back(static_cast<uint8_t>((len >> 24) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 16) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>((len >> 8) & 0xFF));
-        data.emplace_back(static_cast<uint8_t>(len & 0xFF));
-    } else {
-        // too long for MessagePack
+    if (!pack_map_header(data, map.size())) {
         return;
     }
 
@@ -837,31 +850,18 @@ template<class T>
 inline bool unpack_map(Cursor& cursor, T& map) {
 
     size_t len = 0;
-    uint8_t marker = cursor.read();
-    if ((marker & 0xF0) == fixmap) {
-        len = marker & 0xF;
-    } else if (marker == map16) {
-        uint16_t ui16 = 0;
-        for (int i = 0; i < 2; ++i) {
-            uint8_t byte = cursor.read();
-            ui16 = (ui16 << 8) | byte;
-        }
-        len = ui16;
-    } else if (marker == map32) {
-        uint32_t ui32 = 0;
-        for (int i = 0; i < 4; ++i) {
-            uint8_t byte = cursor.read();
-            ui32 = (ui32 << 8) | byte;
-        }
-        len = ui32;
-    } else {
-        // invalid marker
+    if (!unpack_map_header(cursor, len)) {
         return false;
     }
 
     using KeyType = typename T::key_type;
     using MappedType = typename T::mapped_type;
 
+    if constexpr (has_reserve<T>::value) {
+        // each pair takes at least two bytes
+        map.reserve(map.size() + std::min(len, cursor.remain() / 2));
+    }
+
     for (size_t i = 0; i < len; ++i) {
         KeyType key{};
         MappedType value{};
@@ -875,7 +875,7 @@ inline bool unpack_map(Cursor& cursor, T& map) {
             return false;
         }
 
-        map.insert_or_assign(key, value);
+        map.insert_or_assign(std::move(key), std::move(value));
     }
 
     return true;
@@ -1074,6 +1074,7 @@ inline bool pack_unpacker(Cursor& cursor, T& value)
 {
     UnPacker u(cursor);
     value.pack(u);
+    cursor = u.cursor();
     return u.success();
 }
 
@@ -1082,6 +1083,7 @@ inline bool unpack_unpacker(Cursor& cursor, T& value)
 {
     UnPacker u(cursor);
     value.unpack(u);
+    cursor = u.cursor();
     return u.success();
 }
 
@@ -2,4 +2,6 @@
 set(KORS_PROFILER_SRC
     ${CMAKE_CURRENT_LIST_DIR}/profiler.cpp
     ${CMAKE_CURRENT_LIST_DIR}/profiler.h
+    ${CMAKE_CURRENT_LIST_DIR}/tracer.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/tracer.h
 )
@@ -0,0 +1,347 @@
+/*
+MIT License
+
+Copyright (c) 2026 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include "tracer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+
+using namespace kors::profiler;
+
+static thread_local std::string s_threadName;
+
+static uint64_t nowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static size_t roundUpPow2(size_t v)
+{
+    size_t p = 2;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+Tracer::Ring::Ring(size_t capacity, uint64_t tid)
+    : mask(roundUpPow2(capacity) - 1), tid(tid), slots(new Slot[mask + 1])
+{
+}
+
+void Tracer::Ring::push(Phase phase, const char* name, int64_t value)
+{
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    Slot& s = slots[h & mask];
+
+    //! NOTE Orders the previous head store before the slot overwrite (see snapshot)
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.name.store(name, std::memory_order_relaxed);
+    s.timeNs.store(nowNs(), std::memory_order_relaxed);
+    s.value.store(value, std::memory_order_relaxed);
+    s.phase.store(static_cast<uint8_t>(phase), std::memory_order_relaxed);
+
+    head.store(h + 1, std::memory_order_release);
+}
+
+Tracer* Tracer::instance()
+{
+    static Tracer t;
+    return &t;
+}
+
+void Tracer::setup(const Options& opt)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_options = opt;
+    m_options.eventsPerThread = std::max<size_t>(m_options.eventsPerThread, 2);
+}
+
+const Tracer::Options& Tracer::options() const
+{
+    return m_options;
+}
+
+void Tracer::start()
+{
+    clear();
+    m_startTimeNs.store(nowNs());
+    s_enabled.store(true);
+}
+
+void Tracer::stop()
+{
+    s_enabled.store(false);
+}
+
+void Tracer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const std::unique_ptr<Ring>& r : m_rings) {
+        r->tail.store(r->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void Tracer::setThreadName(const std::string& name)
+{
+    s_threadName = name;
+
+    Ring* ring = threadRing(false);
+    if (ring) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ring->name = name;
+    }
+}
+
+Tracer::Ring* Tracer::threadRing(bool create)
+{
+    static thread_local Ring* ring = nullptr;
+    if (ring || !create) {
+        return ring;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_rings.push_back(std::make_unique<Ring>(m_options.eventsPerThread, m_rings.size() + 1));
+    ring = m_rings.back().get();
+    ring->name = s_threadName;
+    return ring;
+}
+
+void Tracer::push(Phase phase, const char* name, int64_t value)
+{
+    threadRing(true)->push(phase, name, value);
+}
+
+void Tracer::begin(const char* name)
+{
+    push(Phase::Begin, name, 0);
+}
+
+void Tracer::end(const char* name)
+{
+    push(Phase::End, name, 0);
+}
+
+void Tracer::instant(const char* name)
+{
+    push(Phase::Instant, name, 0);
+}
+
+void Tracer::counter(const char* name, int64_t value)
+{
+    push(Phase::Counter, name, value);
+}
+
+void Tracer::flowBegin(const char* name, uint64_t id)
+{
+    push(Phase::FlowBegin, name, static_cast<int64_t>(id));
+}
+
+void Tracer::flowEnd(const char* name, uint64_t id)
+{
+    push(Phase::FlowEnd, name, static_cast<int64_t>(id));
+}
+
+std::vector<Tracer::ThreadEvents> Tracer::snapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<ThreadEvents> result;
+    result.reserve(m_rings.size());
+
+    for (const std::unique_ptr<Ring>& r : m_rings) {
+        const uint64_t capacity = r->mask + 1;
+        const uint64_t tail = r->tail.load(std::memory_order_relaxed);
+        const uint64_t head = r->head.load(std::memory_order_acquire);
+
+        //! NOTE The slot of the next event (head - capacity) can be being overwritten right now
+        uint64_t from = std::max(tail, head >= capacity ? head - capacity + 1 : 0);
+
+        ThreadEvents te;
+        te.tid = r->tid;
+        te.name = r->name;
+        te.events.reserve(static_cast<size_t>(head - from));
+
+        for (uint64_t i = from; i < head; ++i) {
+            const Slot& s = r->slots[i & r->mask];
+            Event e;
+            e.name = s.name.load(std::memory_order_relaxed);
+            e.timeNs = s.timeNs.load(std::memory_order_relaxed);
+            e.value = s.value.load(std::memory_order_relaxed);
+            e.phase = static_cast<Phase>(s.phase.load(std::memory_order_relaxed));
+            te.events.push_back(e);
+        }
+
+        //! NOTE The owner thread can overwrite the oldest slots while we were copying them,
+        //! the slot with index N is overwritten by the event N + capacity,
+        //! so everything below (current head - capacity + 1) is not reliable
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t headAfter = r->head.load(std::memory_order_relaxed);
+        const uint64_t reliable = headAfter >= capacity ? headAfter - capacity + 1 : 0;
+        if (reliable > from) {
+            const uint64_t torn = std::min(reliable, head) - from;
+            te.events.erase(te.events.begin(), te.events.begin() + static_cast<ptrdiff_t>(torn));
+            from += torn;
+        }
+
+        te.lost = from - tail;
+        result.push_back(std::move(te));
+    }
+
+    return result;
+}
+
+static void writeJsonString(std::stringstream& ss, const char* str)
+{
+    ss << '"';
+    for (const char* p = str ? str : ""; *p; ++p) {
+        const char c = *p;
+        switch (c) {
+        case '"': ss << "\\\"";
+            break;
+        case '\\': ss << "\\\\";
+            break;
+        case '\n': ss << "\\n";
+            break;
+        case '\t': ss << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+                ss << buf;
+            } else {
+                ss << c;
+            }
+        }
+    }
+    ss << '"';
+}
+
+static void writeTimeUs(std::stringstream& ss, uint64_t ns)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%llu.%03u",
+                  static_cast<unsigned long long>(ns / 1000), static_cast<unsigned>(ns % 1000));
+    ss << buf;
+}
+
+std::string Tracer::exportChromeTrace() const
+{
+    const uint64_t startTimeNs = m_startTimeNs.load();
+    const std::vector<ThreadEvents> threads = snapshot();
+
+    std::stringstream ss;
+    ss << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    auto next = [&ss, &first]() {
+        if (!first) {
+            ss << ",\n";
+        }
+        first = false;
+    };
+
+    for (const ThreadEvents& th : threads) {
+        next();
+        ss << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << th.tid << ",\"args\":{\"name\":";
+        std::string name = th.name.empty() ? ("thread " + std::to_string(th.tid)) : th.name;
+        writeJsonString(ss, name.c_str());
+        ss << "}}";
+
+        //! NOTE The beginning of the ring may be overwritten,
+        //! so ends without begins are skipped
+        size_t depth = 0;
+        for (const Event& e : th.events) {
+            if (e.timeNs < startTimeNs) {
+                continue;
+            }
+
+            const char* ph = nullptr;
+            switch (e.phase) {
+            case Phase::Begin: ph = "B";
+                ++depth;
+                break;
+            case Phase::End:
+                if (depth == 0) {
+                    continue;
+                }
+                ph = "E";
+                --depth;
+                break;
+            case Phase::Instant: ph = "i";
+                break;
+            case Phase::Counter: ph = "C";
+                break;
+            case Phase::FlowBegin: ph = "s";
+                break;
+            case Phase::FlowEnd: ph = "f";
+                break;
+            }
+
+            next();
+            ss << "{\"name\":";
+            writeJsonString(ss, e.name);
+            ss << ",\"ph\":\"" << ph << "\",\"ts\":";
+            writeTimeUs(ss, e.timeNs - startTimeNs);
+            ss << ",\"pid\":1,\"tid\":" << th.tid;
+
+            switch (e.phase) {
+            case Phase::Instant: ss << ",\"s\":\"t\"";
+                break;
+            case Phase::Counter: ss << ",\"args\":{\"value\":" << e.value << "}";
+                break;
+            case Phase::FlowBegin: ss << ",\"cat\":\"flow\",\"id\":" << static_cast<uint64_t>(e.value);
+                break;
+            case Phase::FlowEnd: ss << ",\"cat\":\"flow\",\"bp\":\"e\",\"id\":" << static_cast<uint64_t>(e.value);
+                break;
+            default:
+                break;
+            }
+
+            ss << "}";
+        }
+    }
+
+    ss << "]}\n";
+    return ss.str();
+}
+
+bool Tracer::save(const std::string& filePath) const
+{
+    std::string content = exportChromeTrace();
+
+    FILE* pFile = fopen(filePath.c_str(), "w");
+    if (!pFile) {
+        return false;
+    }
+
+    size_t count = fwrite(content.c_str(), sizeof(char), content.size(), pFile);
+    fclose(pFile);
+
+    return count == content.size();
+}
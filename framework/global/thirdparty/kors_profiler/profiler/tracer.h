@@ -0,0 +1,209 @@
+/*
+MIT License
+
+Copyright (c) 2026 Igor Korsukov
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#ifndef KORS_TRACER_H
+#define KORS_TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "funcinfo.h"
+
+//! NOTE The tracer is compiled in by default and is enabled at runtime (Tracer::start),
+//! when it is disabled, a trace point costs one relaxed atomic load.
+//! Names must be static strings (literals or strings that live until the export),
+//! only the pointers are stored.
+// #define KORS_TRACER_DISABLED
+
+#ifndef KORS_TRACER_DISABLED
+
+#ifndef TRACE_ZONE
+#define TRACE_ZONE(name) \
+    kors::profiler::TraceZone __traceZone(name);
+#endif
+
+#ifndef TRACE_FUNC_ZONE
+#define TRACE_FUNC_ZONE \
+    static const std::string __trace_func_info(CLASSFUNC); \
+    kors::profiler::TraceZone __traceFuncZone(__trace_func_info.c_str());
+#endif
+
+#ifndef TRACE_INSTANT
+#define TRACE_INSTANT(name) \
+    if (kors::profiler::Tracer::isEnabled()) \
+    { kors::profiler::Tracer::instance()->instant(name); }
+#endif
+
+#ifndef TRACE_COUNTER
+#define TRACE_COUNTER(name, value) \
+    if (kors::profiler::Tracer::isEnabled()) \
+    { kors::profiler::Tracer::instance()->counter(name, static_cast<int64_t>(value)); }
+#endif
+
+#ifndef TRACE_FLOW_BEGIN
+#define TRACE_FLOW_BEGIN(name, id) \
+    if (kors::profiler::Tracer::isEnabled()) \
+    { kors::profiler::Tracer::instance()->flowBegin(name, static_cast<uint64_t>(id)); }
+#endif
+
+#ifndef TRACE_FLOW_END
+#define TRACE_FLOW_END(name, id) \
+    if (kors::profiler::Tracer::isEnabled()) \
+    { kors::profiler::Tracer::instance()->flowEnd(name, static_cast<uint64_t>(id)); }
+#endif
+
+#else
+
+#define TRACE_ZONE(name)
+#define TRACE_FUNC_ZONE
+#define TRACE_INSTANT(name)
+#define TRACE_COUNTER(name, value)
+#define TRACE_FLOW_BEGIN(name, id)
+#define TRACE_FLOW_END(name, id)
+
+#endif
+
+namespace kors::profiler {
+class Tracer
+{
+public:
+
+    static Tracer* instance();
+
+    enum class Phase : uint8_t {
+        Begin = 0,
+        End,
+        Instant,
+        Counter,
+        FlowBegin,
+        FlowEnd
+    };
+
+    struct Event {
+        const char* name = nullptr;
+        uint64_t timeNs = 0;   // steady clock
+        int64_t value = 0;     // counter value or flow id
+        Phase phase = Phase::Begin;
+    };
+
+    struct Options {
+        size_t eventsPerThread = 1 << 16; // ring capacity (rounded up to a power of two), old events are overwritten
+    };
+
+    void setup(const Options& opt);
+    const Options& options() const;
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    void start(); // clears previous events
+    void stop();
+    void clear();
+
+    void setThreadName(const std::string& name);
+
+    void begin(const char* name);
+    void end(const char* name);
+    void instant(const char* name);
+    void counter(const char* name, int64_t value);
+    void flowBegin(const char* name, uint64_t id);
+    void flowEnd(const char* name, uint64_t id);
+
+    struct ThreadEvents {
+        uint64_t tid = 0;
+        std::string name;
+        std::vector<Event> events;
+        uint64_t lost = 0; // overwritten events
+    };
+
+    //! NOTE Can be called while tracing, the rings are not stopped
+    std::vector<ThreadEvents> snapshot() const;
+
+    //! NOTE Chrome Trace Event Format (JSON), can be opened in chrome://tracing or ui.perfetto.dev
+    std::string exportChromeTrace() const;
+    bool save(const std::string& filePath) const;
+
+private:
+    Tracer() = default;
+    ~Tracer() = default;
+
+    //! NOTE Single writer (owner thread), lock-free.
+    //! Slots are atomics with relaxed access, so reading a live ring is not a data race,
+    //! torn slots are detected by rechecking the head (like a seqlock)
+    struct Slot {
+        std::atomic<const char*> name = nullptr;
+        std::atomic<uint64_t> timeNs = 0;
+        std::atomic<int64_t> value = 0;
+        std::atomic<uint8_t> phase = 0;
+    };
+
+    struct Ring {
+        Ring(size_t capacity, uint64_t tid);
+
+        void push(Phase phase, const char* name, int64_t value);
+
+        const size_t mask;
+        const uint64_t tid;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head = 0;
+        std::atomic<uint64_t> tail = 0; // first not cleared event
+        std::string name; // guarded by Tracer::m_mutex
+    };
+
+    Ring* threadRing(bool create);
+    void push(Phase phase, const char* name, int64_t value);
+
+    static inline std::atomic<bool> s_enabled = false;
+
+    Options m_options;
+    std::atomic<uint64_t> m_startTimeNs = 0;
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Ring> > m_rings;
+};
+
+struct TraceZone
+{
+    explicit TraceZone(const char* n)
+        : name(Tracer::isEnabled() ? n : nullptr)
+    {
+        if (name) {
+            Tracer::instance()->begin(name);
+        }
+    }
+
+    ~TraceZone()
+    {
+        if (name) {
+            Tracer::instance()->end(name);
+        }
+    }
+
+    const char* name = nullptr;
+};
+}
+
+#endif // KORS_TRACER_H
@@ -0,0 +1,287 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "timerwheel.h"
+
+#include <algorithm>
+
+#include "log.h"
+
+using namespace muse;
+
+uint32_t TimerWheel::add(Tick delay, Tick period, const Call& call)
+{
+    uint32_t id = ++m_lastId;
+    while (id == 0 || m_ids.find(id) != m_ids.end()) {
+        id = ++m_lastId;
+    }
+
+    const int32_t idx = allocNode();
+    Node& n = m_nodes[idx];
+    n.id = id;
+    n.state = State::Scheduled;
+    n.deadline = m_now + std::max(delay, Tick(1)) - 1;
+    n.period = period;
+    n.call = call;
+
+    m_ids[id] = idx;
+    schedule(idx);
+
+    return id;
+}
+
+bool TimerWheel::cancel(uint32_t id)
+{
+    auto it = m_ids.find(id);
+    if (it == m_ids.end()) {
+        return false;
+    }
+
+    const int32_t idx = it->second;
+    m_ids.erase(it);
+
+    Node& n = m_nodes[idx];
+    if (n.state == State::Running) {
+        //! NOTE Will be freed after the call
+        n.state = State::Cancelled;
+        return true;
+    }
+
+    unlink(idx);
+    freeNode(idx);
+    return true;
+}
+
+bool TimerWheel::contains(uint32_t id) const
+{
+    return m_ids.find(id) != m_ids.end();
+}
+
+size_t TimerWheel::size() const
+{
+    return m_ids.size();
+}
+
+TimerWheel::Tick TimerWheel::now() const
+{
+    return m_now;
+}
+
+int32_t TimerWheel::allocNode()
+{
+    if (!m_freeNodes.empty()) {
+        const int32_t idx = m_freeNodes.back();
+        m_freeNodes.pop_back();
+        return idx;
+    }
+
+    m_nodes.emplace_back();
+    return static_cast<int32_t>(m_nodes.size() - 1);
+}
+
+void TimerWheel::freeNode(int32_t idx)
+{
+    Node& n = m_nodes[idx];
+    n.id = 0;
+    n.state = State::Free;
+    n.call = nullptr;
+    m_freeNodes.push_back(idx);
+}
+
+TimerWheel::List& TimerWheel::list(int32_t idx)
+{
+    if (idx < LEVELS * LEVEL_SIZE) {
+        return m_lists[idx];
+    }
+
+    return m_expiring[idx - LEVELS * LEVEL_SIZE];
+}
+
+void TimerWheel::link(int32_t idx, int32_t listIdx)
+{
+    List& l = list(listIdx);
+    Node& n = m_nodes[idx];
+    n.list = listIdx;
+    n.prev = l.tail;
+    n.next = NONE;
+    if (l.tail != NONE) {
+        m_nodes[l.tail].next = idx;
+    } else {
+        l.head = idx;
+    }
+    l.tail = idx;
+
+    if (listIdx < LEVELS * LEVEL_SIZE) {
+        ++m_counts[listIdx >> LEVEL_BITS];
+    }
+}
+
+void TimerWheel::unlink(int32_t idx)
+{
+    Node& n = m_nodes[idx];
+    if (n.list == NONE) {
+        return;
+    }
+
+    List& l = list(n.list);
+    if (n.prev != NONE) {
+        m_nodes[n.prev].next = n.next;
+    } else {
+        l.head = n.next;
+    }
+
+    if (n.next != NONE) {
+        m_nodes[n.next].prev = n.prev;
+    } else {
+        l.tail = n.prev;
+    }
+
+    if (n.list < LEVELS * LEVEL_SIZE) {
+        --m_counts[n.list >> LEVEL_BITS];
+    }
+
+    n.list = NONE;
+    n.prev = NONE;
+    n.next = NONE;
+}
+
+void TimerWheel::schedule(int32_t idx)
+{
+    const Tick deadline = m_nodes[idx].deadline;
+    const Tick delta = deadline > m_now ? deadline - m_now : 0;
+    const Tick expires = m_now + std::min(delta, MAX_RANGE);
+
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (Tick(1) << (LEVEL_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    const int slot = static_cast<int>((expires >> (LEVEL_BITS * level)) & LEVEL_MASK);
+    link(idx, level * LEVEL_SIZE + slot);
+}
+
+void TimerWheel::cascade(int level, int slot)
+{
+    List& l = m_lists[level * LEVEL_SIZE + slot];
+    int32_t idx = l.head;
+    l = List();
+
+    while (idx != NONE) {
+        Node& n = m_nodes[idx];
+        const int32_t next = n.next;
+        n.list = NONE;
+        n.prev = NONE;
+        n.next = NONE;
+        --m_counts[level];
+        schedule(idx);
+        idx = next;
+    }
+}
+
+void TimerWheel::advance(Tick ticks)
+{
+    for (Tick i = 0; i < ticks; ++i) {
+        const Tick tick = m_now;
+        const int index = static_cast<int>(tick & LEVEL_MASK);
+        if (index == 0) {
+            for (int level = 1; level < LEVELS; ++level) {
+                const int slot = static_cast<int>((tick >> (LEVEL_BITS * level)) & LEVEL_MASK);
+                cascade(level, slot);
+                if (slot != 0) {
+                    break;
+                }
+            }
+        }
+
+        ++m_now;
+
+        if (m_lists[index].head != NONE) {
+            expire(index, tick);
+        }
+    }
+}
+
+void TimerWheel::expire(int32_t slot, Tick tick)
+{
+    //! NOTE Move the slot to the own expiring list, so that the callbacks
+    //! can add and cancel the timers and advance recursively
+    const int32_t expiringList = LEVELS * LEVEL_SIZE + static_cast<int32_t>(m_expiring.size());
+    m_expiring.push_back(m_lists[slot]);
+    m_lists[slot] = List();
+    for (int32_t idx = m_expiring.back().head; idx != NONE; idx = m_nodes[idx].next) {
+        m_nodes[idx].list = expiringList;
+        --m_counts[0];
+    }
+
+    while (true) {
+        const int32_t idx = list(expiringList).head;
+        if (idx == NONE) {
+            break;
+        }
+
+        unlink(idx);
+        m_nodes[idx].state = State::Running;
+        Call call = std::move(m_nodes[idx].call);
+
+        call();
+
+        Node& n = m_nodes[idx];
+        if (n.state == State::Cancelled) {
+            freeNode(idx);
+        } else if (n.period == 0) {
+            m_ids.erase(n.id);
+            freeNode(idx);
+        } else {
+            n.state = State::Scheduled;
+            n.call = std::move(call);
+            n.deadline = tick + n.period;
+            schedule(idx);
+        }
+    }
+
+    IF_ASSERT_FAILED(static_cast<int32_t>(m_expiring.size()) == expiringList - LEVELS * LEVEL_SIZE + 1) {
+        return;
+    }
+    m_expiring.pop_back();
+}
+
+TimerWheel::Tick TimerWheel::nextExpiry() const
+{
+    const size_t higherCount = m_counts[1] + m_counts[2] + m_counts[3];
+    if (m_counts[0] == 0 && higherCount == 0) {
+        return NO_EXPIRY;
+    }
+
+    for (Tick i = 0; i < LEVEL_SIZE; ++i) {
+        const Tick tick = m_now + i;
+        const int index = static_cast<int>(tick & LEVEL_MASK);
+        if (index == 0 && higherCount > 0) {
+            //! NOTE Cascade
+            return i + 1;
+        }
+
+        if (m_lists[index].head != NONE) {
+            return i + 1;
+        }
+    }
+
+    return NO_EXPIRY;
+}
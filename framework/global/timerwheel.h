@@ -0,0 +1,113 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace muse {
+//! NOTE Hierarchical timing wheel (4 levels of 64 slots, the deadlines up to 2^24 ticks are exact,
+//! the farther ones are cascaded again). Add, cancel and expire are O(1).
+//! Does not depend on the event loop and is not thread-safe: the owner advances it by ticks
+//! and can sleep until nextExpiry, so the timers with the deadlines in the same tick are expired in one wakeup.
+//! The timers with the same deadline are expired in the order of adding.
+//! Timers may be added and cancelled from the callbacks, advance may be called recursively from the callbacks.
+class TimerWheel
+{
+public:
+    using Tick = uint64_t;
+    using Call = std::function<void ()>;
+
+    static constexpr Tick NO_EXPIRY = std::numeric_limits<Tick>::max();
+
+    TimerWheel() = default;
+
+    //! NOTE The timer expires on the delay-th processed tick (0 is the same as 1),
+    //! then, if the period is not 0, every period ticks
+    uint32_t /*id*/ add(Tick delay, Tick period, const Call& call);
+    bool cancel(uint32_t id);
+    bool contains(uint32_t id) const;
+
+    size_t size() const;
+    Tick now() const; // the next tick to process
+
+    void advance(Tick ticks = 1);
+
+    //! NOTE The number of ticks to advance to reach the next tick that may have expirations.
+    //! It is exact within the first level (64 ticks), otherwise it is the next cascade.
+    Tick nextExpiry() const;
+
+private:
+    static constexpr int LEVEL_BITS = 6;
+    static constexpr int LEVEL_SIZE = 1 << LEVEL_BITS;
+    static constexpr int LEVEL_MASK = LEVEL_SIZE - 1;
+    static constexpr int LEVELS = 4;
+    static constexpr Tick MAX_RANGE = (Tick(1) << (LEVEL_BITS * LEVELS)) - 1;
+
+    static constexpr int32_t NONE = -1;
+
+    enum class State : uint8_t {
+        Free,
+        Scheduled,
+        Running,
+        Cancelled // while running
+    };
+
+    struct List {
+        int32_t head = NONE;
+        int32_t tail = NONE;
+    };
+
+    struct Node {
+        uint32_t id = 0;
+        State state = State::Free;
+        int32_t list = NONE;
+        int32_t prev = NONE;
+        int32_t next = NONE;
+        Tick deadline = 0;
+        Tick period = 0;
+        Call call;
+    };
+
+    int32_t allocNode();
+    void freeNode(int32_t idx);
+
+    List& list(int32_t idx);
+    void link(int32_t idx, int32_t list);
+    void unlink(int32_t idx);
+    void schedule(int32_t idx);
+    void cascade(int level, int slot);
+    void expire(int32_t slot, Tick tick);
+
+    std::vector<Node> m_nodes;
+    std::vector<int32_t> m_freeNodes;
+    std::unordered_map<uint32_t, int32_t> m_ids;
+    List m_lists[LEVELS * LEVEL_SIZE];
+    size_t m_counts[LEVELS] = {};
+    std::vector<List> m_expiring; // one list per nested advance
+    uint32_t m_lastId = 0;
+    Tick m_now = 0;
+};
+}
@@ -117,10 +117,10 @@ void ByteArray::detach()
     }
 
     if (m_raw.data) {
-        m_data->resize(m_raw.size + 1);
-        m_data->operator [](m_raw.size) = 0;
+        //! NOTE The empty data can be shared with the copies of the raw array
+        m_data = std::make_shared<Data>(m_raw.size + 1);
         std::memcpy(m_data->data(), m_raw.data, m_raw.size);
-        m_raw.data = nullptr;
+        m_raw = RawData();
         return;
     }
 
@@ -144,6 +144,11 @@ bool ByteArray::empty() const
     return size() == 0;
 }
 
+bool ByteArray::isMapped() const
+{
+    return m_raw.file != nullptr;
+}
+
 void ByteArray::reserve(size_t nsize)
 {
     if (nsize + 1 <= m_data->capacity()) {
@@ -30,6 +30,11 @@
 #include <QByteArray>
 #endif
 
+namespace muse::io {
+struct path_t;
+class MappedFile;
+}
+
 namespace muse {
 class ByteArray
 {
@@ -45,6 +50,17 @@ public:
     static ByteArray fromRawData(const uint8_t* data, size_t size);
     static ByteArray fromRawData(const char* data, size_t size);
 
+    //! NOTE Read-only view of the mapped file, not copied.
+    //! The mapping is released when the last copy of the array is destroyed,
+    //! modifying the array detaches it (copies the data).
+    //! Like raw data, it isn't null-terminated and constVData() is empty, use constData() and size().
+    //! Only for files the caller controls for the lifetime of the array: the content of the file isn't copied,
+    //! so it changes if the file is rewritten, and truncating it raises SIGBUS in the readers.
+    static ByteArray fromMappedFile(const std::shared_ptr<io::MappedFile>& file);
+
+    //! NOTE Maps the file, if it can't be mapped (not a regular file, no mapping on the platform), reads it
+    static ByteArray fromMappedFile(const io::path_t& filePath, bool* ok = nullptr);
+
     bool operator==(const ByteArray& other) const;
     bool operator!=(const ByteArray& other) const { return !operator==(other); }
 
@@ -55,6 +71,7 @@ public:
     const std::vector<uint8_t>& constVData() const;
     size_t size() const;
     bool empty() const;
+    bool isMapped() const;
 
     ByteArray& insert(size_t pos, uint8_t b);
     void push_back(uint8_t b);
@@ -101,6 +118,7 @@ private:
     struct RawData {
         const uint8_t* data = nullptr;
         size_t size = 0;
+        std::shared_ptr<io::MappedFile> file;
     };
 
     void detach();
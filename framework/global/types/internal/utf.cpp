@@ -0,0 +1,396 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "utf.h"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || (defined(_M_AMD64) || defined(_M_X64))
+#include <emmintrin.h>
+#define UTF_SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define UTF_AVX2
+#endif
+#elif defined(__arm64__) || defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define UTF_NEON
+#endif
+
+using namespace muse;
+using namespace muse::utf;
+
+static constexpr char32_t SURROGATE_MIN = 0xD800;
+static constexpr char32_t SURROGATE_MAX = 0xDFFF;
+static constexpr char32_t LEAD_SURROGATE_MAX = 0xDBFF;
+static constexpr char32_t CODE_POINT_MAX = 0x10FFFF;
+
+static inline bool isSurrogate(char32_t c)
+{
+    return c >= SURROGATE_MIN && c <= SURROGATE_MAX;
+}
+
+static inline bool isContinuation(uint8_t b)
+{
+    return (b & 0xC0) == 0x80;
+}
+
+//! NOTE Decodes one not ASCII sequence, rejects the same as utf8::next:
+//! invalid lead, incomplete sequence, overlong form, surrogates and code points above U+10FFFF
+static inline bool decode(const uint8_t*& p, const uint8_t* end, char32_t& cp)
+{
+    const uint8_t b0 = p[0];
+    const ptrdiff_t left = end - p;
+
+    if (b0 < 0xC2) { // continuation or overlong 2 bytes
+        return false;
+    }
+
+    if (b0 < 0xE0) {
+        if (left < 2 || !isContinuation(p[1])) {
+            return false;
+        }
+        cp = (char32_t(b0 & 0x1F) << 6) | (p[1] & 0x3F);
+        p += 2;
+        return true;
+    }
+
+    if (b0 < 0xF0) {
+        if (left < 3 || !isContinuation(p[1]) || !isContinuation(p[2])) {
+            return false;
+        }
+        cp = (char32_t(b0 & 0x0F) << 12) | (char32_t(p[1] & 0x3F) << 6) | (p[2] & 0x3F);
+        if (cp < 0x800 || isSurrogate(cp)) {
+            return false;
+        }
+        p += 3;
+        return true;
+    }
+
+    if (b0 < 0xF5) {
+        if (left < 4 || !isContinuation(p[1]) || !isContinuation(p[2]) || !isContinuation(p[3])) {
+            return false;
+        }
+        cp = (char32_t(b0 & 0x07) << 18) | (char32_t(p[1] & 0x3F) << 12) | (char32_t(p[2] & 0x3F) << 6) | (p[3] & 0x3F);
+        if (cp < 0x10000 || cp > CODE_POINT_MAX) {
+            return false;
+        }
+        p += 4;
+        return true;
+    }
+
+    return false;
+}
+
+template<typename T>
+static inline T* encode(char32_t cp, T* out)
+{
+    if (cp < 0x80) {
+        *out++ = static_cast<T>(cp);
+    } else if (cp < 0x800) {
+        *out++ = static_cast<T>(0xC0 | (cp >> 6));
+        *out++ = static_cast<T>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *out++ = static_cast<T>(0xE0 | (cp >> 12));
+        *out++ = static_cast<T>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<T>(0x80 | (cp & 0x3F));
+    } else {
+        *out++ = static_cast<T>(0xF0 | (cp >> 18));
+        *out++ = static_cast<T>(0x80 | ((cp >> 12) & 0x3F));
+        *out++ = static_cast<T>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<T>(0x80 | (cp & 0x3F));
+    }
+    return out;
+}
+
+//! NOTE Converts the ASCII block from the current position, stops before the first not ASCII block
+static inline void asciiToUtf16(const uint8_t*& p, const uint8_t* end, char16_t*& out)
+{
+#if defined(UTF_AVX2)
+    while (end - p >= 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 16),
+                            _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16))));
+        p += 32;
+        out += 32;
+    }
+#endif
+
+#if defined(UTF_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(v, zero));
+        p += 16;
+        out += 16;
+    }
+#elif defined(UTF_NEON)
+    while (end - p >= 16) {
+        const uint8x16_t v = vld1q_u8(p);
+        if (vmaxvq_u8(v) >= 0x80) {
+            break;
+        }
+        vst1q_u16(reinterpret_cast<uint16_t*>(out), vmovl_u8(vget_low_u8(v)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(out + 8), vmovl_high_u8(v));
+        p += 16;
+        out += 16;
+    }
+#else
+    (void)end;
+    (void)out;
+#endif
+}
+
+static inline void asciiFromUtf16(const char16_t*& p, const char16_t* end, uint8_t*& out)
+{
+#if defined(UTF_AVX2)
+    const __m256i highMask256 = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    while (end - p >= 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), highMask256)) {
+            break;
+        }
+        // packus works per 128 bit lane
+        const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), packed);
+        p += 32;
+        out += 32;
+    }
+#endif
+
+#if defined(UTF_SSE2)
+    const __m128i highMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    while (end - p >= 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+        const __m128i high = _mm_and_si128(_mm_or_si128(a, b), highMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+        p += 16;
+        out += 16;
+    }
+#elif defined(UTF_NEON)
+    while (end - p >= 16) {
+        const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(p));
+        const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(p + 8));
+        if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+            break;
+        }
+        vst1q_u8(out, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        p += 16;
+        out += 16;
+    }
+#else
+    (void)end;
+    (void)out;
+#endif
+}
+
+size_t utf::utf16LengthOfUtf8(const char* src, size_t len)
+{
+    // every not continuation byte gives one unit, 4 bytes sequences give a surrogate pair
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i) {
+        count += !isContinuation(p[i]);
+        count += p[i] >= 0xF0;
+    }
+    return count;
+}
+
+size_t utf::utf8LengthOfUtf16(const char16_t* src, size_t len)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const char16_t c = src[i];
+        // a surrogate pair gives 4 bytes, 2 per surrogate
+        count += 1 + (c >= 0x80) + (c >= 0x800 && !isSurrogate(c));
+    }
+    return count;
+}
+
+size_t utf::utf8LengthOfUtf32(const char32_t* src, size_t len)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < len; ++i) {
+        const char32_t c = src[i];
+        count += 1 + (c >= 0x80) + (c >= 0x800) + (c >= 0x10000);
+    }
+    return count;
+}
+
+Result utf::utf8to16(const char* src, size_t len, char16_t* dst)
+{
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* p = begin;
+    const uint8_t* end = begin + len;
+    char16_t* out = dst;
+
+    while (p < end) {
+        asciiToUtf16(p, end, out);
+
+        // the rest of the block
+        while (p < end && *p < 0x80) {
+            *out++ = *p++;
+        }
+        if (p == end) {
+            break;
+        }
+
+        // not ASCII run
+        while (p < end && *p >= 0x80) {
+            char32_t cp = 0;
+            if (!decode(p, end, cp)) {
+                return { static_cast<size_t>(p - begin), static_cast<size_t>(out - dst), false };
+            }
+
+            if (cp > 0xFFFF) {
+                *out++ = static_cast<char16_t>((cp >> 10) + 0xD7C0);
+                *out++ = static_cast<char16_t>((cp & 0x3FF) + 0xDC00);
+            } else {
+                *out++ = static_cast<char16_t>(cp);
+            }
+        }
+    }
+
+    return { len, static_cast<size_t>(out - dst), true };
+}
+
+Result utf::utf16to8(const char16_t* src, size_t len, char* dst)
+{
+    const char16_t* p = src;
+    const char16_t* end = src + len;
+    uint8_t* begin = reinterpret_cast<uint8_t*>(dst);
+    uint8_t* out = begin;
+
+    while (p < end) {
+        asciiFromUtf16(p, end, out);
+
+        // the block with not ASCII characters (or the tail)
+        const char16_t* blockEnd = (end - p > 16) ? p + 16 : end;
+        while (p < blockEnd) {
+            const char16_t c = *p;
+            if (c < 0x80) {
+                *out++ = static_cast<uint8_t>(c);
+            } else if (c < 0x800) {
+                *out++ = static_cast<uint8_t>(0xC0 | (c >> 6));
+                *out++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            } else if (!isSurrogate(c)) {
+                *out++ = static_cast<uint8_t>(0xE0 | (c >> 12));
+                *out++ = static_cast<uint8_t>(0x80 | ((c >> 6) & 0x3F));
+                *out++ = static_cast<uint8_t>(0x80 | (c & 0x3F));
+            } else {
+                // lead surrogate must be followed by trail
+                if (c > LEAD_SURROGATE_MAX || p + 1 == end || p[1] < 0xDC00 || p[1] > SURROGATE_MAX) {
+                    return { static_cast<size_t>(p - src), static_cast<size_t>(out - begin), false };
+                }
+                const char32_t cp = 0x10000 + ((char32_t(c) - SURROGATE_MIN) << 10) + (char32_t(p[1]) - 0xDC00);
+                out = encode(cp, out);
+                ++p;
+            }
+            ++p;
+        }
+    }
+
+    return { len, static_cast<size_t>(out - begin), true };
+}
+
+Result utf::utf8to32(const char* src, size_t len, char32_t* dst)
+{
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* p = begin;
+    const uint8_t* end = begin + len;
+    char32_t* out = dst;
+
+    while (p < end) {
+        if (*p < 0x80) {
+            *out++ = *p++;
+            continue;
+        }
+
+        char32_t cp = 0;
+        if (!decode(p, end, cp)) {
+            return { static_cast<size_t>(p - begin), static_cast<size_t>(out - dst), false };
+        }
+        *out++ = cp;
+    }
+
+    return { len, static_cast<size_t>(out - dst), true };
+}
+
+Result utf::utf32to8(const char32_t* src, size_t len, char* dst)
+{
+    char* out = dst;
+    for (size_t i = 0; i < len; ++i) {
+        const char32_t cp = src[i];
+        if (cp > CODE_POINT_MAX || isSurrogate(cp)) {
+            return { i, static_cast<size_t>(out - dst), false };
+        }
+        out = encode(cp, out);
+    }
+
+    return { len, static_cast<size_t>(out - dst), true };
+}
+
+bool utf::isValidUtf8(const char* src, size_t len)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(src);
+    const uint8_t* end = p + len;
+
+    while (p < end) {
+#if defined(UTF_SSE2)
+        while (end - p >= 16 && _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) == 0) {
+            p += 16;
+        }
+#elif defined(UTF_NEON)
+        while (end - p >= 16 && vmaxvq_u8(vld1q_u8(p)) < 0x80) {
+            p += 16;
+        }
+#endif
+        if (p == end) {
+            break;
+        }
+
+        if (*p < 0x80) {
+            ++p;
+            continue;
+        }
+
+        char32_t cp = 0;
+        if (!decode(p, end, cp)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,51 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_GLOBAL_UTF_H
+#define MUSE_GLOBAL_UTF_H
+
+#include <cstddef>
+
+//! NOTE Transcoding between UTF-8, UTF-16 and UTF-32 into preallocated buffers.
+//! The ASCII runs are converted by blocks (SSE2/AVX2/NEON when available).
+//! The input is validated as utfcpp does: the conversion stops at the first invalid sequence,
+//! the result contains everything converted before it.
+namespace muse::utf {
+struct Result {
+    size_t read = 0;     // input code units converted (position of the error if not ok)
+    size_t written = 0;  // output code units
+    bool ok = true;
+};
+
+//! NOTE Exact output size for valid input, an upper bound for invalid
+size_t utf16LengthOfUtf8(const char* src, size_t len);
+size_t utf8LengthOfUtf16(const char16_t* src, size_t len);
+size_t utf8LengthOfUtf32(const char32_t* src, size_t len);
+
+Result utf8to16(const char* src, size_t len, char16_t* dst);
+Result utf16to8(const char16_t* src, size_t len, char* dst);
+Result utf8to32(const char* src, size_t len, char32_t* dst); // dst size: len
+Result utf32to8(const char32_t* src, size_t len, char* dst);
+
+bool isValidUtf8(const char* src, size_t len);
+}
+
+#endif // MUSE_GLOBAL_UTF_H
@@ -29,7 +29,9 @@
 #include <exception>
 #include <iomanip>
 #include <iterator>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #ifdef SYSTEM_UTFCPP
@@ -39,6 +41,7 @@
 #endif
 
 #include "bytearray.h"
+#include "internal/utf.h"
 
 #include "log.h"
 
@@ -89,24 +92,9 @@ static double toDouble_helper(const char* str, bool* ok)
     return v;
 }
 
-static void ltrim_helper(std::u16string& s)
+static bool isSpace_helper(char16_t ch)
 {
-    s.erase(s.begin(), std::find_if(s.begin(), s.end(), [](char16_t ch) {
-        return !std::isspace(ch);
-    }));
-}
-
-static void rtrim_helper(std::u16string& s)
-{
-    s.erase(std::find_if(s.rbegin(), s.rend(), [](char16_t ch) {
-        return !std::isspace(ch);
-    }).base(), s.end());
-}
-
-static void trim_helper(std::u16string& s)
-{
-    ltrim_helper(s);
-    rtrim_helper(s);
+    return std::isspace(ch);
 }
 
 // ============================
@@ -233,43 +221,51 @@ UtfCodec::Encoding UtfCodec::xmlEncoding(const ByteArray& data)
 
 void UtfCodec::utf8to16(std::string_view src, std::u16string& dst)
 {
-    try {
-        utf8::utf8to16(src.begin(), src.end(), std::back_inserter(dst));
-    } catch (const std::exception& e) {
-        LOGE() << e.what();
+    const size_t offset = dst.size();
+    dst.resize(offset + utf::utf16LengthOfUtf8(src.data(), src.size()));
+    const utf::Result r = utf::utf8to16(src.data(), src.size(), dst.data() + offset);
+    dst.resize(offset + r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid UTF-8 at " << r.read;
     }
 }
 
 void UtfCodec::utf16to8(std::u16string_view src, std::string& dst)
 {
-    try {
-        utf8::utf16to8(src.begin(), src.end(), std::back_inserter(dst));
-    } catch (const std::exception& e) {
-        LOGE() << e.what();
+    const size_t offset = dst.size();
+    dst.resize(offset + utf::utf8LengthOfUtf16(src.data(), src.size()));
+    const utf::Result r = utf::utf16to8(src.data(), src.size(), dst.data() + offset);
+    dst.resize(offset + r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid UTF-16 at " << r.read;
     }
 }
 
 void UtfCodec::utf8to32(std::string_view src, std::u32string& dst)
 {
-    try {
-        utf8::utf8to32(src.begin(), src.end(), std::back_inserter(dst));
-    } catch (const std::exception& e) {
-        LOGE() << e.what();
+    const size_t offset = dst.size();
+    dst.resize(offset + src.size());
+    const utf::Result r = utf::utf8to32(src.data(), src.size(), dst.data() + offset);
+    dst.resize(offset + r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid UTF-8 at " << r.read;
     }
 }
 
 void UtfCodec::utf32to8(std::u32string_view src, std::string& dst)
 {
-    try {
-        utf8::utf32to8(src.begin(), src.end(), std::back_inserter(dst));
-    } catch (const std::exception& e) {
-        LOGE() << e.what();
+    const size_t offset = dst.size();
+    dst.resize(offset + utf::utf8LengthOfUtf32(src.data(), src.size()));
+    const utf::Result r = utf::utf32to8(src.data(), src.size(), dst.data() + offset);
+    dst.resize(offset + r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid code point at " << r.read;
     }
 }
 
 bool UtfCodec::isValidUtf8(const std::string_view& src)
 {
-    return utf8::is_valid(src.begin(), src.end());
+    return utf::isValidUtf8(src.data(), src.size());
 }
 
 void UtfCodec::replaceInvalid(std::string_view src, std::string& dst)
@@ -285,14 +281,11 @@ void UtfCodec::replaceInvalid(std::string_view src, std::string& dst)
 // String
 // ============================
 
-String::String()
-{
-    m_data = std::make_shared<std::u16string>();
-}
-
 String::String(const char16_t* str)
 {
-    m_data = std::make_shared<std::u16string>(str ? str : u"");
+    if (str) {
+        setData(std::u16string_view(str));
+    }
 #ifdef MUSE_STRING_DEBUG_HACK
     updateDebugView();
 #endif
@@ -300,8 +293,8 @@ String::String(const char16_t* str)
 
 String::String(const Char& ch)
 {
-    m_data = std::make_shared<std::u16string>();
-    *m_data.get() += ch.unicode();
+    m_inline[0] = ch.unicode();
+    m_inlineSize = 1;
 #ifdef MUSE_STRING_DEBUG_HACK
     updateDebugView();
 #endif
@@ -310,16 +303,15 @@ String::String(const Char& ch)
 String::String(const Char* unicode, size_t size)
 {
     if (!unicode) {
-        m_data = std::make_shared<std::u16string>();
         return;
     }
 
     static_assert(sizeof(Char) == sizeof(char16_t));
     const char16_t* str = reinterpret_cast<const char16_t*>(unicode);
     if (size == muse::nidx) {
-        m_data = std::make_shared<std::u16string>(str);
+        setData(std::u16string_view(str));
     } else {
-        m_data = std::make_shared<std::u16string>(str, size);
+        setData(std::u16string_view(str, size));
     }
 
 #ifdef MUSE_STRING_DEBUG_HACK
@@ -327,6 +319,24 @@ String::String(const Char* unicode, size_t size)
 #endif
 }
 
+String& String::operator=(const String& s)
+{
+    if (this != &s) {
+        reset();
+        copyData(s);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& s) noexcept
+{
+    if (this != &s) {
+        reset();
+        moveData(s);
+    }
+    return *this;
+}
+
 #ifdef MUSE_STRING_DEBUG_HACK
 void String::updateDebugView()
 {
@@ -339,11 +349,6 @@ void String::updateDebugView()
 
 #endif
 
-const std::u16string& String::constStr() const
-{
-    return *m_data.get();
-}
-
 struct String::Mutator {
     std::u16string& s;
     String* self = nullptr;
@@ -365,29 +370,153 @@ struct String::Mutator {
     void resize(size_t n) { s.resize(n); }
     void clear() { s.clear(); }
     void push_back(char16_t c) { s.push_back(c); }
-    void insert(size_t p, const std::u16string& v) { s.insert(p, v); }
+    void insert(size_t p, std::u16string_view v) { s.insert(p, v); }
     void erase(size_t p, size_t n) { s.erase(p, n); }
 
-    std::u16string& operator=(const std::u16string& v) { return s.operator=(v); }
+    std::u16string& operator=(std::u16string_view v) { return s.operator=(v); }
     std::u16string& operator=(const char16_t* v) { return s.operator=(v); }
     std::u16string& operator=(const char16_t v) { return s.operator=(v); }
 
-    std::u16string& operator+=(const std::u16string& v) { return s.operator+=(v); }
+    std::u16string& operator+=(std::u16string_view v) { return s.operator+=(v); }
     std::u16string& operator+=(const char16_t* v) { return s.operator+=(v); }
     std::u16string& operator+=(const char16_t v) { return s.operator+=(v); }
     char16_t& operator[](size_t i) { return s.operator[](i); }
 };
 
+//! NOTE Moves the string to the shared storage, the returned reference stays valid until the string is modified
 String::Mutator String::mutStr(bool do_detach)
 {
-    if (do_detach) {
+    if (!m_shared) {
+        setShared(std::make_shared<std::u16string>(m_inline, m_inlineSize));
+    } else if (do_detach) {
         detach();
     }
     return Mutator(*m_data.get(), this);
 }
 
+//! NOTE Detaches and returns the characters for in-place modification, the size is not changed
+char16_t* String::mutData()
+{
+    if (!m_shared) {
+        return m_inline;
+    }
+
+    detach();
+    return m_data->data();
+}
+
+//! NOTE Replaces the content with `size` characters to be filled by the caller
+char16_t* String::initData(size_t size)
+{
+    if (size <= INLINE_CAPACITY) {
+        reset();
+        m_inlineSize = static_cast<uint8_t>(size);
+        return m_inline;
+    }
+
+    if (m_shared && m_data.use_count() == 1) {
+        m_data->resize(size);
+    } else {
+        setShared(std::make_shared<std::u16string>(size, u'\0'));
+    }
+    return m_data->data();
+}
+
+void String::setData(std::u16string_view str)
+{
+    if (str.size() <= INLINE_CAPACITY) {
+        //! NOTE The source may point to this string
+        char16_t buf[INLINE_CAPACITY];
+        std::char_traits<char16_t>::copy(buf, str.data(), str.size());
+        reset();
+        std::char_traits<char16_t>::copy(m_inline, buf, str.size());
+        m_inlineSize = static_cast<uint8_t>(str.size());
+        return;
+    }
+
+    if (m_shared && m_data.use_count() == 1) {
+        m_data->assign(str.data(), str.size());
+    } else {
+        setShared(std::make_shared<std::u16string>(str));
+    }
+}
+
+void String::setData(std::u16string&& str)
+{
+    if (str.size() <= INLINE_CAPACITY) {
+        setData(std::u16string_view(str));
+        return;
+    }
+
+    setShared(std::make_shared<std::u16string>(std::move(str)));
+}
+
+void String::appendData(std::u16string_view str)
+{
+    const size_t size = this->size();
+    if (!m_shared) {
+        if (size + str.size() <= INLINE_CAPACITY) {
+            std::char_traits<char16_t>::move(m_inline + size, str.data(), str.size());
+            m_inlineSize = static_cast<uint8_t>(size + str.size());
+            return;
+        }
+
+        auto data = std::make_shared<std::u16string>();
+        data->reserve(size + str.size());
+        data->append(m_inline, size);
+        data->append(str);
+        setShared(std::move(data));
+        return;
+    }
+
+    //! NOTE If the source points to this string, the previous data is kept alive by the other owners
+    detach();
+    m_data->append(str);
+}
+
+//! NOTE The new characters are zeros, like std::u16string::resize
+void String::resizeData(size_t size)
+{
+    if (!m_shared) {
+        if (size <= INLINE_CAPACITY) {
+            if (size > m_inlineSize) {
+                std::char_traits<char16_t>::assign(m_inline + m_inlineSize, size - m_inlineSize, u'\0');
+            }
+            m_inlineSize = static_cast<uint8_t>(size);
+            return;
+        }
+
+        auto data = std::make_shared<std::u16string>(m_inline, m_inlineSize);
+        data->resize(size);
+        setShared(std::move(data));
+        return;
+    }
+
+    if (size <= INLINE_CAPACITY && size <= m_data->size() && m_data.use_count() > 1) {
+        setData(std::u16string_view(*m_data).substr(0, size));
+        return;
+    }
+
+    detach();
+    m_data->resize(size);
+}
+
+void String::setShared(std::shared_ptr<std::u16string>&& data)
+{
+    if (m_shared) {
+        m_data = std::move(data);
+    } else {
+        new (&m_data) std::shared_ptr<std::u16string>(std::move(data));
+        m_shared = true;
+    }
+    m_inlineSize = 0;
+}
+
 void String::reserve(size_t i)
 {
+    if (!m_shared && i <= INLINE_CAPACITY) {
+        return;
+    }
     mutStr().reserve(i);
 }
 
@@ -442,7 +571,7 @@ bool String::operator ==(const char* s) const
 
 void String::detach()
 {
-    if (!m_data) {
+    if (!m_shared) {
         return;
     }
 
@@ -455,13 +584,21 @@ void String::detach()
 
 String& String::operator=(const char16_t* str)
 {
-    mutStr() = str;
+    setData(str ? std::u16string_view(str) : std::u16string_view());
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
     return *this;
 }
 
 String& String::operator +=(const char16_t* s)
 {
-    mutStr() += s;
+    if (s) {
+        appendData(std::u16string_view(s));
+    }
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
     return *this;
 }
 
@@ -472,31 +609,106 @@ char16_t String::operator [](size_t i) const
 
 char16_t& String::operator [](size_t i)
 {
-    return mutStr()[i];
+    return mutData()[i];
 }
 
 String& String::append(Char ch)
 {
-    mutStr() += ch.unicode();
+    const char16_t c = ch.unicode();
+    appendData(std::u16string_view(&c, 1));
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
     return *this;
 }
 
 String& String::append(const String& s)
 {
-    mutStr() += s.constStr();
+    appendData(s.constStr());
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
     return *this;
 }
 
 String& String::prepend(Char ch)
 {
-    mutStr() = ch.unicode() + constStr();
-    return *this;
+    return insert(0, String(ch));
 }
 
 String& String::prepend(const String& s)
 {
-    mutStr() = s.constStr() + constStr();
-    return *this;
+    return insert(0, s);
+}
+
+namespace {
+//! NOTE The table is split into shards with own locks,
+//! so threads interning different strings rarely wait for each other
+class InternTable
+{
+public:
+    static InternTable& instance()
+    {
+        static InternTable t;
+        return t;
+    }
+
+    std::shared_ptr<std::u16string> intern(std::u16string_view str)
+    {
+        const size_t hash = std::hash<std::u16string_view> {}(str);
+        Shard& shard = m_shards[hash % SHARDS_COUNT];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.strings.find(str);
+        if (it != shard.strings.end()) {
+            return it->second;
+        }
+
+        if (shard.strings.size() >= shard.sweepSize) {
+            sweep(shard);
+        }
+
+        auto data = std::make_shared<std::u16string>(str);
+        shard.strings.emplace(std::u16string_view(*data), data);
+        return data;
+    }
+
+private:
+    static constexpr size_t SHARDS_COUNT = 32;
+    static constexpr size_t SWEEP_MIN_SIZE = 1024;
+
+    struct Shard {
+        std::mutex mutex;
+        //! NOTE The key views the value
+        std::unordered_map<std::u16string_view, std::shared_ptr<std::u16string> > strings;
+        size_t sweepSize = SWEEP_MIN_SIZE;
+    };
+
+    //! NOTE Removes the strings held only by the table. A new reference can only be taken
+    //! from a holder or under the lock, so the use count of 1 can't grow meanwhile.
+    //! The next sweep is when the table doubles, so it is amortized over the insertions
+    static void sweep(Shard& shard)
+    {
+        for (auto it = shard.strings.begin(); it != shard.strings.end();) {
+            if (it->second.use_count() == 1) {
+                it = shard.strings.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        shard.sweepSize = std::max(SWEEP_MIN_SIZE, shard.strings.size() * 2);
+    }
+
+    Shard m_shards[SHARDS_COUNT];
+};
+}
+
+String String::interned() const
+{
+    String s;
+    s.setShared(InternTable::instance().intern(constStr()));
+    return s;
 }
 
 String String::fromUtf16LE(const ByteArray& data)
@@ -574,7 +786,12 @@ String String::fromUtf8(const char* str)
 String String::fromUtf8(const std::string_view str)
 {
     String s;
-    UtfCodec::utf8to16(str, s.mutStr());
+    char16_t* data = s.initData(utf::utf16LengthOfUtf8(str.data(), str.size()));
+    const utf::Result r = utf::utf8to16(str.data(), str.size(), data);
+    if (!r.ok) {
+        s.resizeData(r.written);
+        LOGE() << "Invalid UTF-8 at " << r.read;
+    }
     return s;
 }
 
@@ -583,19 +800,21 @@ String String::fromUtf8(const ByteArray& data)
     if (data.empty()) {
         return String();
     }
-    String s;
-    UtfCodec::utf8to16(std::string_view(data.constChar(), data.size()), s.mutStr());
-    return s;
+    return fromUtf8(std::string_view(data.constChar(), data.size()));
 }
 
 ByteArray String::toUtf8() const
 {
-    ByteArray ba;
-    std::u16string_view v(constStr());
-    try {
-        utf8::utf16to8(v.begin(), v.end(), std::back_inserter(ba));
-    } catch (const std::exception& e) {
-        LOGE() << e.what();
+    const std::u16string_view str = constStr();
+    if (str.empty()) {
+        return ByteArray();
+    }
+
+    ByteArray ba(utf::utf8LengthOfUtf16(str.data(), str.size()));
+    const utf::Result r = utf::utf16to8(str.data(), str.size(), reinterpret_cast<char*>(ba.data()));
+    ba.resize(r.written);
+    if (!r.ok) {
+        LOGE() << "Invalid UTF-16 at " << r.read;
     }
     return ba;
 }
@@ -608,8 +827,7 @@ String String::fromAscii(const char* str, size_t size)
 
     size = (size == muse::nidx) ? std::strlen(str) : size;
     String s;
-    std::u16string& data = s.mutStr();
-    data.resize(size);
+    char16_t* data = s.initData(size);
     for (size_t i = 0; i < size; ++i) {
         data[i] = Char::fromAscii(str[i]).unicode();
     }
@@ -638,9 +856,7 @@ ByteArray String::toAscii(bool* ok) const
 
 String String::fromStdString(const std::string& str)
 {
-    String s;
-    UtfCodec::utf8to16(std::string_view(str), s.mutStr());
-    return s;
+    return fromUtf8(std::string_view(str));
 }
 
 std::string String::toStdString() const
@@ -652,7 +868,7 @@ std::string String::toStdString() const
 
 std::u16string String::toStdU16String() const
 {
-    return constStr();
+    return std::u16string(constStr());
 }
 
 String String::fromUcs4(const char32_t* str, size_t size)
@@ -667,9 +883,7 @@ String String::fromUcs4(const char32_t* str, size_t size)
     std::string s8;
     UtfCodec::utf32to8(v32, s8);
 
-    String s;
-    UtfCodec::utf8to16(s8, s.mutStr());
-    return s;
+    return fromUtf8(std::string_view(s8));
 }
 
 String String::fromUcs4(char32_t chr)
@@ -688,7 +902,7 @@ std::u32string String::toStdU32String() const
 
 std::wstring String::toStdWString() const
 {
-    const std::u16string& u16 = constStr();
+    const std::u16string_view u16 = constStr();
     std::wstring ws;
     ws.resize(u16.size());
 
@@ -704,12 +918,12 @@ std::wstring String::toStdWString() const
 const String String::fromStdWString(const std::wstring& str)
 {
     String s;
-    s.mutStr().resize(str.size());
+    char16_t* data = s.initData(str.size());
 
     static_assert(sizeof(wchar_t) >= sizeof(char16_t));
 
     for (size_t i = 0; i < str.size(); ++i) {
-        s[i] = static_cast<char16_t>(str.at(i));
+        data[i] = static_cast<char16_t>(str.at(i));
     }
 
     return s;
@@ -723,7 +937,7 @@ String String::fromQString(const QString& str)
     const char16_t* u = reinterpret_cast<const char16_t*>(qu);
 
     String s;
-    s.mutStr() = std::u16string(u, u + str.size());
+    s.setData(std::u16string_view(u, static_cast<size_t>(str.size())));
     return s;
 }
 
@@ -747,7 +961,10 @@ bool String::empty() const
 
 void String::clear()
 {
-    mutStr().clear();
+    reset();
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
 }
 
 Char String::at(size_t i) const
@@ -768,9 +985,9 @@ bool String::contains(const String& str, CaseSensitivity cs) const
     if (cs == CaseSensitivity::CaseSensitive) {
         return constStr().find(str.constStr()) != std::u16string::npos;
     } else {
-        std::u16string self = constStr();
+        std::u16string self(constStr());
         std::transform(self.begin(), self.end(), self.begin(), [](char16_t c){ return Char::toLower(c); });
-        std::u16string other = str.constStr();
+        std::u16string other(str.constStr());
         std::transform(other.begin(), other.end(), other.begin(), [](char16_t c){ return Char::toLower(c); });
         return self.find(other) != std::u16string::npos;
     }
@@ -802,7 +1019,7 @@ int String::count(const String& str) const
 {
     int count = 0;
     std::string::size_type pos = 0;
-    std::u16string otherStr = str.constStr();
+    const std::u16string_view otherStr = str.constStr();
     while ((pos = constStr().find(otherStr, pos)) != std::string::npos) {
         ++count;
         pos += str.size();
@@ -992,9 +1209,7 @@ StringList String::split(const std::regex& re, SplitBehavior behavior) const
             continue;
         }
 
-        String sub;
-        UtfCodec::utf8to16(s, sub.mutStr());
-        out.push_back(std::move(sub));
+        out.push_back(fromUtf8(std::string_view(s)));
     }
 
     return out;
@@ -1014,9 +1229,7 @@ StringList String::search(const std::regex& re, std::initializer_list<int> match
             // skip
             continue;
         }
-        String sub;
-        UtfCodec::utf8to16(s, sub.mutStr());
-        out.push_back(std::move(sub));
+        out.push_back(fromUtf8(std::string_view(s)));
     }
 
     return out;
@@ -1060,13 +1273,21 @@ String& String::replace(const String& before, const String& after)
 
 String& String::replace(char16_t before, char16_t after)
 {
-    Mutator h = mutStr();
-    std::u16string& str = h.s;
-    for (size_t i = 0; i < str.size(); ++i) {
-        if (str.at(i) == before) {
+    const size_t pos = constStr().find(before);
+    if (pos == std::u16string_view::npos) {
+        return *this;
+    }
+
+    const size_t size = this->size();
+    char16_t* str = mutData();
+    for (size_t i = pos; i < size; ++i) {
+        if (str[i] == before) {
             str[i] = after;
         }
     }
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
     return *this;
 }
 
@@ -1095,18 +1316,32 @@ String& String::replace(const std::wregex& re, const String& after)
     originw = toStdWString();
     std::wstring replacedw = std::regex_replace(originw, re, afterw);
 
-    mutStr().clear();
-    mutStr().resize(replacedw.size());
-
+    char16_t* data = initData(replacedw.size());
     for (size_t i = 0; i < replacedw.size(); ++i) {
-        mutStr()[i] = static_cast<char16_t>(replacedw.at(i));
+        data[i] = static_cast<char16_t>(replacedw.at(i));
     }
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
 
     return *this;
 }
 
 String& String::insert(size_t position, const String& str)
 {
+    const std::u16string_view v = str.constStr();
+    if (!m_shared && position <= m_inlineSize && m_inlineSize + v.size() <= INLINE_CAPACITY) {
+        char16_t buf[INLINE_CAPACITY];
+        std::char_traits<char16_t>::copy(buf, v.data(), v.size());
+        std::char_traits<char16_t>::move(m_inline + position + v.size(), m_inline + position, m_inlineSize - position);
+        std::char_traits<char16_t>::copy(m_inline + position, buf, v.size());
+        m_inlineSize = static_cast<uint8_t>(m_inlineSize + v.size());
+#ifdef MUSE_STRING_DEBUG_HACK
+        updateDebugView();
+#endif
+        return *this;
+    }
+
     mutStr().insert(position, str.constStr());
     return *this;
 }
@@ -1120,13 +1355,23 @@ String& String::remove(char16_t ch)
 {
     auto it = constStr().find(ch);
     if (it != std::u16string::npos) {
-        mutStr().erase(it, 1);
+        remove(it, 1);
     }
     return *this;
 }
 
 String& String::remove(size_t position, size_t n)
 {
+    if (!m_shared && position <= m_inlineSize) {
+        n = std::min(n, m_inlineSize - position);
+        std::char_traits<char16_t>::move(m_inline + position, m_inline + position + n, m_inlineSize - position - n);
+        m_inlineSize = static_cast<uint8_t>(m_inlineSize - n);
+#ifdef MUSE_STRING_DEBUG_HACK
+        updateDebugView();
+#endif
+        return *this;
+    }
+
     mutStr().erase(position, n);
     return *this;
 }
@@ -1142,7 +1387,10 @@ void String::chop(size_t n)
 
 void String::truncate(size_t position)
 {
-    mutStr().resize(position);
+    resizeData(position);
+#ifdef MUSE_STRING_DEBUG_HACK
+    updateDebugView();
+#endif
 }
 
 static constexpr bool is1To9(char16_t chr)
@@ -1157,8 +1405,7 @@ void String::doArgs(std::u16string& out, const std::vector<std::u16string_view>&
         size_t argIdxToInsertAfter = muse::nidx;
     };
 
-    const std::u16string& str = constStr();
-    const std::u16string_view view(str);
+    const std::u16string_view view = constStr();
     std::vector<Part> parts;
 
     {
@@ -1200,45 +1447,55 @@ void String::doArgs(std::u16string& out, const std::vector<std::u16string_view>&
 
 String String::arg(const String& val) const
 {
+    std::u16string out;
+    doArgs(out, { std::u16string_view(val.constStr()) });
     String s;
-    doArgs(s.mutStr(), { std::u16string_view(val.constStr()) });
+    s.setData(std::move(out));
     return s;
 }
 
 String String::arg(const String& val1, const String& val2) const
 {
+    std::u16string out;
+    doArgs(out, { std::u16string_view(val1.constStr()), std::u16string_view(val2.constStr()) });
     String s;
-    doArgs(s.mutStr(), { std::u16string_view(val1.constStr()), std::u16string_view(val2.constStr()) });
+    s.setData(std::move(out));
     return s;
 }
 
 String String::arg(const String& val1, const String& val2, const String& val3) const
 {
+    std::u16string out;
+    doArgs(out, { std::u16string_view(val1.constStr()),
+                  std::u16string_view(val2.constStr()),
+                  std::u16string_view(val3.constStr()) });
     String s;
-    doArgs(s.mutStr(), { std::u16string_view(val1.constStr()),
-                         std::u16string_view(val2.constStr()),
-                         std::u16string_view(val3.constStr()) });
+    s.setData(std::move(out));
     return s;
 }
 
 String String::arg(const String& val1, const String& val2, const String& val3, const String& val4) const
 {
+    std::u16string out;
+    doArgs(out, { std::u16string_view(val1.constStr()),
+                  std::u16string_view(val2.constStr()),
+                  std::u16string_view(val3.constStr()),
+                  std::u16string_view(val4.constStr()) });
     String s;
-    doArgs(s.mutStr(), { std::u16string_view(val1.constStr()),
-                         std::u16string_view(val2.constStr()),
-                         std::u16string_view(val3.constStr()),
-                         std::u16string_view(val4.constStr()) });
+    s.setData(std::move(out));
     return s;
 }
 
 String String::arg(const String& val1, const String& val2, const String& val3, const String& val4, const String& val5) const
 {
+    std::u16string out;
+    doArgs(out, { std::u16string_view(val1.constStr()),
+                  std::u16string_view(val2.constStr()),
+                  std::u16string_view(val3.constStr()),
+                  std::u16string_view(val4.constStr()),
+                  std::u16string_view(val5.constStr()) });
     String s;
-    doArgs(s.mutStr(), { std::u16string_view(val1.constStr()),
-                         std::u16string_view(val2.constStr()),
-                         std::u16string_view(val3.constStr()),
-                         std::u16string_view(val4.constStr()),
-                         std::u16string_view(val5.constStr()) });
+    s.setData(std::move(out));
     return s;
 }
 
@@ -1248,7 +1505,7 @@ String String::mid(size_t pos, size_t count) const
     if (pos > size()) {
         return s;
     }
-    s.mutStr() = constStr().substr(pos, count);
+    s.setData(constStr().substr(pos, count));
     return s;
 }
 
@@ -1264,9 +1521,13 @@ String String::right(size_t n) const
 
 String String::trimmed() const
 {
-    String s = *this;
-    trim_helper(s.mutStr());
-    return s;
+    const std::u16string_view str = constStr();
+    const auto first = std::find_if_not(str.begin(), str.end(), isSpace_helper);
+    const auto last = std::find_if_not(str.rbegin(), std::make_reverse_iterator(first), isSpace_helper).base();
+    if (first == str.begin() && last == str.end()) {
+        return *this;
+    }
+    return mid(static_cast<size_t>(first - str.begin()), static_cast<size_t>(last - first));
 }
 
 String String::simplified() const
@@ -1340,8 +1601,8 @@ String String::toLower() const
     return String::fromQString(qs.toLower());
 #else
     String s = *this;
-    std::u16string& us = s.mutStr();
-    std::transform(us.begin(), us.end(), us.begin(), [](char16_t c){ return Char::toLower(c); });
+    char16_t* us = s.mutData();
+    std::transform(us, us + s.size(), us, [](char16_t c){ return Char::toLower(c); });
     return s;
 #endif
 }
@@ -1354,8 +1615,8 @@ String String::toUpper() const
     return String::fromQString(qs.toUpper());
 #else
     String s = *this;
-    std::u16string& us = s.mutStr();
-    std::transform(us.begin(), us.end(), us.begin(), [](char16_t c){ return Char::toUpper(c); });
+    char16_t* us = s.mutData();
+    std::transform(us, us + s.size(), us, [](char16_t c){ return Char::toUpper(c); });
     return s;
 #endif
 }
@@ -199,14 +199,23 @@ public:
 // ============================
 class StringList;
 class AsciiStringView;
+//! NOTE The layout of String (a union and the flags) must not depend on the packing of the including code,
+//! some code includes the headers under #pragma pack
+#pragma pack(push, 8)
 class String
 {
 public:
 
-    String();
+    inline String() {}
     String(const char16_t* str);
     String(const Char& ch);
     String(const Char* unicode, size_t size = muse::nidx);
+    inline String(const String& s) { copyData(s); }
+    inline String(String&& s) noexcept { moveData(s); }
+    inline ~String() { reset(); }
+
+    String& operator=(const String& s);
+    String& operator=(String&& s) noexcept;
 
 #ifndef NO_QT_SUPPORT
     String(const QString& str) { *this = fromQString(str); }
@@ -225,7 +234,7 @@ public:
     String& operator=(const char16_t* str);
     void reserve(size_t i);
 
-    inline bool operator ==(const String& s) const { return constStr() == s.constStr(); }
+    inline bool operator ==(const String& s) const { return isSameData(s) || constStr() == s.constStr(); }
     inline bool operator !=(const String& s) const { return !operator ==(s); }
 
     bool isEqualIgnoreCase(const String& s) const;
@@ -271,6 +280,8 @@ public:
     static String fromStdString(const std::string& str);
     std::string toStdString() const;
     std::u16string toStdU16String() const;
+    //! NOTE Valid while the string is not modified, moved or destroyed
+    inline std::u16string_view toStdU16StringView() const { return constStr(); }
 
     static String fromUcs4(const char32_t* str, size_t size = muse::nidx);
     static String fromUcs4(char32_t chr);
@@ -367,16 +378,90 @@ public:
     static String number(size_t n);
     static String number(double n, int prec = 6);
 
-    inline size_t hash() const { return std::hash<std::u16string> {}(constStr()); }
+    inline size_t hash() const { return std::hash<std::u16string_view> {}(constStr()); }
+
+    //! NOTE Returns a copy that shares storage with all equal interned strings,
+    //! so comparing interned strings is a pointer comparison.
+    //! The storage is kept while any copy holds it, the table drops unused entries as it grows.
+    //! Use it for identifiers (tag names, keys, codes), not for arbitrary text
+    String interned() const;
 
 private:
     struct Mutator;
-    const std::u16string& constStr() const;
+
+    //! NOTE Short strings are stored inline, without allocations.
+    //! Longer ones are shared between copies and detached on write.
+    //! The String is 32 bytes (was 16, a shared_ptr). Before, every string, even an empty one,
+    //! also had its own heap block of the control block and std::u16string (64 bytes with the malloc overhead).
+    //! Most strings (tags, attribute values, names) fit 11 code units, so they take 32 bytes instead of 80,
+    //! and longer ones take 16 bytes more. The capacity is what fits 32 bytes with the size and the flag.
+    static constexpr size_t INLINE_CAPACITY = 11;
+
+    inline std::u16string_view constStr() const
+    {
+        return m_shared ? std::u16string_view(*m_data) : std::u16string_view(m_inline, m_inlineSize);
+    }
+
+    inline bool isSameData(const String& s) const { return m_shared && s.m_shared && m_data == s.m_data; }
+
     Mutator mutStr(bool do_detach = true);
+    char16_t* mutData();
+    char16_t* initData(size_t size);
+    void setData(std::u16string_view str);
+    void setData(std::u16string&& str);
+    void appendData(std::u16string_view str);
+    void resizeData(size_t size);
+    void setShared(std::shared_ptr<std::u16string>&& data);
+
+    inline void copyData(const String& s)
+    {
+        if (s.m_shared) {
+            new (&m_data) std::shared_ptr<std::u16string>(s.m_data);
+        } else {
+            std::memcpy(m_inline, s.m_inline, sizeof(m_inline));
+        }
+        m_inlineSize = s.m_inlineSize;
+        m_shared = s.m_shared;
+#ifdef MUSE_STRING_DEBUG_HACK
+        dview = s.dview;
+#endif
+    }
+
+    inline void moveData(String& s)
+    {
+        if (s.m_shared) {
+            new (&m_data) std::shared_ptr<std::u16string>(std::move(s.m_data));
+            s.m_data.~shared_ptr();
+        } else {
+            std::memcpy(m_inline, s.m_inline, sizeof(m_inline));
+        }
+        m_inlineSize = s.m_inlineSize;
+        m_shared = s.m_shared;
+        s.m_inlineSize = 0;
+        s.m_shared = false;
+#ifdef MUSE_STRING_DEBUG_HACK
+        dview = std::move(s.dview);
+#endif
+    }
+
+    inline void reset()
+    {
+        if (m_shared) {
+            m_data.~shared_ptr();
+            m_shared = false;
+        }
+        m_inlineSize = 0;
+    }
+
     void detach();
     void doArgs(std::u16string& out, const std::vector<std::u16string_view>& args) const;
 
-    std::shared_ptr<std::u16string> m_data;
+    union {
+        char16_t m_inline[INLINE_CAPACITY] = {};
+        std::shared_ptr<std::u16string> m_data;
+    };
+    uint8_t m_inlineSize = 0;
+    bool m_shared = false;
 
 #ifdef MUSE_STRING_DEBUG_HACK
     //! HACK On MacOS with clang there are problems with debugging - the value of the std::u16string is not visible.
@@ -385,6 +470,13 @@ private:
     std::string dview;
 #endif
 };
+#pragma pack(pop)
+
+#ifndef MUSE_STRING_DEBUG_HACK
+static_assert(alignof(String) == alignof(std::shared_ptr<std::u16string>),
+              "the layout of String must not depend on the packing of the including code");
+static_assert(sizeof(String) <= 32, "the inline capacity must fit 32 bytes");
+#endif
 
 class StringList : public std::vector<String>
 {
@@ -102,9 +102,9 @@ struct NoteEvent
     explicit NoteEvent(ArrangementContext&& arrangementCtx,
                        PitchContext&& pitchCtx,
                        ExpressionContext&& expressionCtx)
-        : m_arrangementCtx(arrangementCtx),
-        m_pitchCtx(pitchCtx),
-        m_expressionCtx(expressionCtx)
+        : m_arrangementCtx(std::move(arrangementCtx)),
+        m_pitchCtx(std::move(pitchCtx)),
+        m_expressionCtx(std::move(expressionCtx))
     {
     }
 
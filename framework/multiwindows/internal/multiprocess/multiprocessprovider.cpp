@@ -26,6 +26,7 @@
 #include <QTimer>
 #include <QEventLoop>
 
+#include "async/async.h"
 #include "types/uri.h"
 #include "settings.h"
 #include "log.h"
@@ -62,6 +63,7 @@ MultiProcessProvider::~MultiProcessProvider()
 
 void MultiProcessProvider::initOnGlobal()
 {
+    m_mainThreadId = std::this_thread::get_id();
     m_ipcChannel = new IpcChannel();
     m_selfID = m_ipcChannel->selfID().toStdString();
     LOGI() << "our instance id is: " << m_selfID;
@@ -392,6 +394,9 @@ void MultiProcessProvider::settingsSetValue(const std::string& key, const Val& v
 
 muse::ipc::IpcLock* MultiProcessProvider::lock(const std::string& name)
 {
+    //! NOTE The resources are also locked on other threads (settings are written on the writer thread)
+    std::lock_guard<std::mutex> lock(m_locksMutex);
+
     auto it = m_locks.find(name);
     if (it != m_locks.end()) {
         return it->second;
@@ -417,6 +422,14 @@ void MultiProcessProvider::notifyAboutResourceChanged(const std::string& name)
         return;
     }
 
+    //! NOTE The channel is not thread-safe, so the notification is sent from the main thread
+    if (std::this_thread::get_id() != m_mainThreadId) {
+        async::Async::call(this, [this, name]() {
+            notifyAboutResourceChanged(name);
+        }, m_mainThreadId);
+        return;
+    }
+
     QStringList args;
     args << QString::fromStdString(name);
     m_ipcChannel->broadcast(METHOD_RESOURCE_CHANGED, args);
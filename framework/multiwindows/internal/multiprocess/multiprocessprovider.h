@@ -23,6 +23,8 @@
 #pragma once
 
 #include <map>
+#include <mutex>
+#include <thread>
 
 #include "../../imultiwindowsprovider.h"
 #include "imultiprocessprovider.h"
@@ -114,6 +116,9 @@ private:
     async::Notification m_instancesChanged;
     async::Channel<std::string> m_resourceChanged;
 
+    std::thread::id m_mainThreadId;
+
+    std::mutex m_locksMutex;
     std::map<std::string, muse::ipc::IpcLock*> m_locks;
 };
 }
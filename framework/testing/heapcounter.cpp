@@ -0,0 +1,112 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "heapcounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define MUSE_TESTING_HEAPCOUNTER_DISABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define MUSE_TESTING_HEAPCOUNTER_DISABLED
+#endif
+#endif
+
+using namespace muse::testing;
+
+static std::atomic<bool> s_counting = false;
+static std::atomic<size_t> s_allocs = 0;
+static std::atomic<long long> s_liveBytes = 0;
+static std::atomic<long long> s_peakBytes = 0;
+
+#ifndef MUSE_TESTING_HEAPCOUNTER_DISABLED
+
+//! NOTE The size is stored before the block, so that delete knows how many bytes are freed
+static constexpr size_t ALLOC_HEADER = alignof(std::max_align_t);
+
+void* operator new(size_t size)
+{
+    void* p = std::malloc(size + ALLOC_HEADER);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    *static_cast<size_t*>(p) = size;
+    if (s_counting) {
+        ++s_allocs;
+        long long live = s_liveBytes += static_cast<long long>(size);
+        long long peak = s_peakBytes;
+        while (live > peak && !s_peakBytes.compare_exchange_weak(peak, live)) {
+        }
+    }
+    return static_cast<char*>(p) + ALLOC_HEADER;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+
+    void* p = static_cast<char*>(ptr) - ALLOC_HEADER;
+    if (s_counting) {
+        s_liveBytes -= static_cast<long long>(*static_cast<size_t*>(p));
+    }
+    std::free(p);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+#endif
+
+bool HeapCounter::isAvailable()
+{
+#ifdef MUSE_TESTING_HEAPCOUNTER_DISABLED
+    return false;
+#else
+    return true;
+#endif
+}
+
+void HeapCounter::start()
+{
+    s_allocs = 0;
+    s_liveBytes = 0;
+    s_peakBytes = 0;
+    s_counting = true;
+}
+
+HeapCounter::Stats HeapCounter::stop()
+{
+    s_counting = false;
+
+    Stats stats;
+    stats.allocs = s_allocs;
+    stats.liveBytes = s_liveBytes;
+    stats.peakBytes = s_peakBytes;
+    return stats;
+}
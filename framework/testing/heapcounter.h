@@ -0,0 +1,48 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2026 MuseScore Limited and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_TESTING_HEAPCOUNTER_H
+#define MUSE_TESTING_HEAPCOUNTER_H
+
+#include <cstddef>
+
+namespace muse::testing {
+//! NOTE Counts the heap allocations (global operator new) between start and stop, for the benchmarks.
+//! The test target must be built with heapcounter.cpp, which replaces the global operator new and delete.
+//! Not available with the address sanitizer, it replaces them itself.
+class HeapCounter
+{
+public:
+
+    struct Stats {
+        size_t allocs = 0;
+        long long liveBytes = 0;    // allocated and not yet freed since start
+        long long peakBytes = 0;
+    };
+
+    static bool isAvailable();
+
+    static void start();
+    static Stats stop();
+};
+}
+
+#endif // MUSE_TESTING_HEAPCOUNTER_H